@@ -0,0 +1,481 @@
+﻿/*************************************************************************************/
+/*
+ * 파일명: CircleMeasurement.cpp
+ *
+ * 개요:
+ *   - 디스플레이/키 입력 없이 동작하는(헤드리스) 원형 부품 측정 애플리케이션.
+ *   - 프레임 취득 → 원 탐색(Mmod) → 서브픽셀 엣지 측정(Mmeas) → 부품별 기록(CSV)을
+ *     스레드별 단계로 나누어 파이프라인으로 처리한다.
+ *
+ * 핵심 요약:
+ *   - 입력: 디지타이저(MdigGrab), 시퀀스 파일(MbufImportSequence), 번호가 붙은
+ *           이미지 파일 목록(디렉터리) 중 SOURCE_MODE로 선택.
+ *   - 단계: [취득] → [탐색: MmodFind(M_SHAPE_CIRCLE)] → [정밀화: M_CIRCLE 마커로
+ *           링 영역에서 서브픽셀 원 맞춤] → [기록: 부품/원별 위치·지름 CSV].
+ *   - 파이프라인: 단계 사이를 크기 제한 큐로 연결, 프레임 버퍼는 풀(FRAME_POOL_SIZE)에서
+ *                재사용 → 느린 단계가 앞 단계를 자연스럽게 억제(backpressure).
+ *   - 성능: 전체 처리량(parts/s)과 단계별 누적 처리 시간을 출력해 병목 단계를 확인.
+ *
+ * 저작권:
+ *   © Matrox Electronic Systems Ltd., 1992-2025. All Rights Reserved
+ */
+#include <mil.h>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <vector>
+
+/* 입력 소스 선택 */
+#define SOURCE_DIGITIZER        0L    /* 카메라(디지타이저) */
+#define SOURCE_SEQUENCE         1L    /* 시퀀스 파일(AVI 등) */
+#define SOURCE_FILE_LIST        2L    /* 번호가 붙은 이미지 파일 목록 */
+#define SOURCE_MODE             SOURCE_FILE_LIST
+
+#define SEQUENCE_FILE           M_TEMP_DIR MIL_TEXT("MilSequence.avi")
+#define FILE_LIST_FORMAT        MIL_TEXT("Parts/Part%04d.mim")
+#define FILE_NAME_LENGTH_MAX    256
+#define DIGITIZER_NB_FRAMES     1000L /* 디지타이저 입력 시 측정할 부품 수 */
+#define SOURCE_NB_FRAMES_MAX    100000L
+
+/* 출력 기록 파일 */
+#define OUTPUT_FILE             MIL_TEXT("CircleMeasurement.csv")
+
+/* 원 탐색 파라미터 */
+#define MODEL_RADIUS            30.0
+#define MIN_SCALE_FACTOR_VALUE  0.8
+#define MAX_SCALE_FACTOR_VALUE  1.2
+#define ACCEPTANCE_VALUE        60.0
+#define MAX_CIRCLES_PER_PART    64L
+
+/* 서브픽셀 정밀화: 탐색 반지름 기준 ±링 폭 안에서 엣지 측정 */
+#define RING_HALF_WIDTH         6.0
+
+/* 파이프라인 파라미터 */
+#define FRAME_POOL_SIZE         8L    /* 동시에 처리 중일 수 있는 프레임 수 */
+#define QUEUE_CAPACITY          FRAME_POOL_SIZE
+
+/*****************************************************************************/
+/* 크기 제한 블로킹 큐: 단계 사이 전달용                                    */
+/*****************************************************************************/
+template <class T>
+class PIPELINE_QUEUE
+{
+public:
+   explicit PIPELINE_QUEUE(size_t Capacity) : m_Capacity(Capacity) {}
+
+   /* 가득 차 있으면 빈 자리가 날 때까지 대기 */
+   void Push(const T& Item)
+   {
+      std::unique_lock<std::mutex> Lock(m_Mutex);
+      m_NotFull.wait(Lock, [this] { return m_Items.size() < m_Capacity; });
+      m_Items.push_back(Item);
+      m_NotEmpty.notify_one();
+   }
+
+   /* 비어 있으면 항목이 들어올 때까지 대기 */
+   T Pop()
+   {
+      std::unique_lock<std::mutex> Lock(m_Mutex);
+      m_NotEmpty.wait(Lock, [this] { return !m_Items.empty(); });
+      T Item = m_Items.front();
+      m_Items.pop_front();
+      m_NotFull.notify_one();
+      return Item;
+   }
+
+private:
+   size_t                  m_Capacity;
+   std::deque<T>           m_Items;
+   std::mutex              m_Mutex;
+   std::condition_variable m_NotEmpty, m_NotFull;
+};
+
+/* 한 부품(프레임)의 측정 레코드 */
+typedef struct
+{
+   MIL_INT    PartIndex;                     /* 부품 번호(-1: 스트림 종료 표시) */
+   MIL_ID     Frame;                         /* 프레임 풀 버퍼(정밀화 후 반환) */
+   MIL_INT    NbCircles;
+   MIL_DOUBLE XPosition[MAX_CIRCLES_PER_PART];
+   MIL_DOUBLE YPosition[MAX_CIRCLES_PER_PART];
+   MIL_DOUBLE Radius[MAX_CIRCLES_PER_PART];
+   MIL_DOUBLE Score[MAX_CIRCLES_PER_PART];
+   MIL_INT    Refined[MAX_CIRCLES_PER_PART]; /* 서브픽셀 정밀화 성공 여부 */
+} PART_RECORD;
+
+/* 단계 사이에서는 레코드 포인터만 전달 */
+typedef PIPELINE_QUEUE<PART_RECORD*> RECORD_QUEUE;
+typedef PIPELINE_QUEUE<MIL_ID>       FRAME_QUEUE;
+
+/* 파이프라인 공유 데이터 */
+typedef struct
+{
+   MIL_ID       MilSystem;
+   MIL_ID       MilDigitizer;       /* SOURCE_DIGITIZER일 때만 사용 */
+   MIL_INT      NbFrames;           /* 처리할 프레임 수 */
+   FRAME_QUEUE* FreeFrames;         /* 재사용 가능한 프레임 버퍼 */
+   RECORD_QUEUE* FindQueue;         /* 취득 → 탐색 */
+   RECORD_QUEUE* MeasureQueue;      /* 탐색 → 정밀화 */
+   RECORD_QUEUE* WriteQueue;        /* 정밀화 → 기록 */
+   MIL_DOUBLE   StageTime[4];       /* 단계별 누적 처리 시간(초) */
+   MIL_INT      NbCirclesWritten;
+} PIPELINE;
+
+/* 단계 함수 */
+void AcquisitionStage(PIPELINE* Pipeline);
+void FindStage(PIPELINE* Pipeline);
+void MeasureStage(PIPELINE* Pipeline);
+void WriteStage(PIPELINE* Pipeline);
+
+/* 입력 소스 보조 함수 */
+MIL_INT CountSourceFrames(MIL_ID MilDigitizer);
+void    SourceFrameSize(MIL_ID MilDigitizer, MIL_INT* SizeX, MIL_INT* SizeY);
+void    FileListName(MIL_INT Index, MIL_TEXT_CHAR* FileName);
+
+/* 단계 시간 측정 인덱스 */
+#define STAGE_ACQUISITION  0
+#define STAGE_FIND         1
+#define STAGE_MEASURE      2
+#define STAGE_WRITE        3
+
+/*****************************************************************************/
+/* 메인: 자원 할당 → 단계 스레드 시작 → 종료 대기 → 처리량 보고            */
+/*****************************************************************************/
+int MosMain(void)
+{
+   MIL_ID     MilApplication, MilSystem, MilDigitizer = M_NULL;
+   MIL_INT    SizeX, SizeY, n;
+   MIL_DOUBLE TotalTime = 0.0;
+   MIL_ID     FramePool[FRAME_POOL_SIZE];
+
+   /* 1) 애플리케이션/시스템 할당(디스플레이 없음) */
+   MappAlloc(M_NULL, M_DEFAULT, &MilApplication);
+   MsysAlloc(MilApplication, M_SYSTEM_DEFAULT, M_DEFAULT, M_DEFAULT, &MilSystem);
+   if (SOURCE_MODE == SOURCE_DIGITIZER)
+      MdigAlloc(MilSystem, M_DEFAULT, MIL_TEXT("M_DEFAULT"), M_DEFAULT, &MilDigitizer);
+
+   MosPrintf(MIL_TEXT("\nCIRCLE MEASUREMENT PIPELINE:\n"));
+   MosPrintf(MIL_TEXT("----------------------------\n\n"));
+
+   /* 2) 입력 소스 확인 */
+   PIPELINE Pipeline = {};
+   Pipeline.MilSystem    = MilSystem;
+   Pipeline.MilDigitizer = MilDigitizer;
+   Pipeline.NbFrames     = CountSourceFrames(MilDigitizer);
+   if (Pipeline.NbFrames == 0)
+   {
+      MosPrintf(MIL_TEXT("No input frame available.\n\n"));
+      if (MilDigitizer)
+         MdigFree(MilDigitizer);
+      MappFreeDefault(MilApplication, MilSystem, M_NULL, M_NULL, M_NULL);
+      return 1;
+   }
+   SourceFrameSize(MilDigitizer, &SizeX, &SizeY);
+
+   /* 3) 프레임 풀과 단계 간 큐 준비 */
+   FRAME_QUEUE  FreeFrames(FRAME_POOL_SIZE);
+   RECORD_QUEUE FindQueue(QUEUE_CAPACITY), MeasureQueue(QUEUE_CAPACITY), WriteQueue(QUEUE_CAPACITY);
+   for (n = 0; n < FRAME_POOL_SIZE; n++)
+   {
+      MbufAlloc2d(MilSystem, SizeX, SizeY, 8 + M_UNSIGNED,
+                  M_IMAGE + M_PROC + ((SOURCE_MODE == SOURCE_DIGITIZER) ? M_GRAB : 0),
+                  &FramePool[n]);
+      FreeFrames.Push(FramePool[n]);
+   }
+   Pipeline.FreeFrames   = &FreeFrames;
+   Pipeline.FindQueue    = &FindQueue;
+   Pipeline.MeasureQueue = &MeasureQueue;
+   Pipeline.WriteQueue   = &WriteQueue;
+
+   MosPrintf(MIL_TEXT("Measuring %d parts (%d x %d)...\n\n"),
+             (int)Pipeline.NbFrames, (int)SizeX, (int)SizeY);
+
+   /* 4) 단계별 스레드 시작 → 모두 종료될 때까지 대기 */
+   MappTimer(M_DEFAULT, M_TIMER_RESET, M_NULL);
+   std::thread AcquisitionThread(AcquisitionStage, &Pipeline);
+   std::thread FindThread(FindStage, &Pipeline);
+   std::thread MeasureThread(MeasureStage, &Pipeline);
+   std::thread WriteThread(WriteStage, &Pipeline);
+
+   AcquisitionThread.join();
+   FindThread.join();
+   MeasureThread.join();
+   WriteThread.join();
+   MappTimer(M_DEFAULT, M_TIMER_READ, &TotalTime);
+
+   /* 5) 처리량 보고 */
+   MosPrintf(MIL_TEXT("%d parts, %d circles measured in %.3f s.\n"),
+             (int)Pipeline.NbFrames, (int)Pipeline.NbCirclesWritten, TotalTime);
+   MosPrintf(MIL_TEXT("Throughput: %.1f parts/s (%.2f ms/part).\n\n"),
+             Pipeline.NbFrames / TotalTime, 1000.0 * TotalTime / Pipeline.NbFrames);
+   MosPrintf(MIL_TEXT("Stage          Busy time (ms/part)\n\n"));
+   MosPrintf(MIL_TEXT("Acquisition    %.3f\n"), 1000.0 * Pipeline.StageTime[STAGE_ACQUISITION] / Pipeline.NbFrames);
+   MosPrintf(MIL_TEXT("Find           %.3f\n"), 1000.0 * Pipeline.StageTime[STAGE_FIND]        / Pipeline.NbFrames);
+   MosPrintf(MIL_TEXT("Measure        %.3f\n"), 1000.0 * Pipeline.StageTime[STAGE_MEASURE]     / Pipeline.NbFrames);
+   MosPrintf(MIL_TEXT("Write          %.3f\n\n"), 1000.0 * Pipeline.StageTime[STAGE_WRITE]     / Pipeline.NbFrames);
+   MosPrintf(MIL_TEXT("Records written to %s.\n"), OUTPUT_FILE);
+
+   /* 6) 해제 */
+   for (n = 0; n < FRAME_POOL_SIZE; n++)
+      MbufFree(FramePool[n]);
+   if (MilDigitizer)
+      MdigFree(MilDigitizer);
+   MappFreeDefault(MilApplication, MilSystem, M_NULL, M_NULL, M_NULL);
+   return 0;
+}
+
+/*****************************************************************************/
+/* [취득 단계] 풀에서 빈 프레임을 받아 채운 뒤 탐색 큐로 전달              */
+/*****************************************************************************/
+void AcquisitionStage(PIPELINE* Pipeline)
+{
+   MIL_TEXT_CHAR FileName[FILE_NAME_LENGTH_MAX];
+   MIL_DOUBLE    StartTime, EndTime;
+
+   if (SOURCE_MODE == SOURCE_SEQUENCE)
+      MbufImportSequence(SEQUENCE_FILE, M_DEFAULT, M_NULL, M_NULL, M_NULL, M_NULL, M_NULL, M_OPEN);
+
+   for (MIL_INT n = 0; n < Pipeline->NbFrames; n++)
+   {
+      /* 빈 프레임 대기(모두 사용 중이면 뒤 단계가 반환할 때까지 멈춤) */
+      MIL_ID Frame = Pipeline->FreeFrames->Pop();
+
+      MappTimer(M_DEFAULT, M_TIMER_READ, &StartTime);
+      switch (SOURCE_MODE)
+      {
+      case SOURCE_DIGITIZER:
+         MdigGrab(Pipeline->MilDigitizer, Frame);
+         break;
+      case SOURCE_SEQUENCE:
+         MbufImportSequence(SEQUENCE_FILE, M_DEFAULT, M_LOAD, M_NULL, &Frame, n, 1, M_READ);
+         break;
+      default:
+         FileListName(n, FileName);
+         MbufLoad(FileName, Frame);
+         break;
+      }
+      MappTimer(M_DEFAULT, M_TIMER_READ, &EndTime);
+      Pipeline->StageTime[STAGE_ACQUISITION] += EndTime - StartTime;
+
+      PART_RECORD* Record = new PART_RECORD;
+      Record->PartIndex = n;
+      Record->Frame     = Frame;
+      Record->NbCircles = 0;
+      Pipeline->FindQueue->Push(Record);
+   }
+
+   if (SOURCE_MODE == SOURCE_SEQUENCE)
+      MbufImportSequence(SEQUENCE_FILE, M_DEFAULT, M_NULL, M_NULL, M_NULL, M_NULL, M_NULL, M_CLOSE);
+
+   /* 스트림 종료 표시 */
+   PART_RECORD* EndRecord = new PART_RECORD;
+   EndRecord->PartIndex = -1;
+   EndRecord->Frame     = M_NULL;
+   Pipeline->FindQueue->Push(EndRecord);
+}
+
+/*****************************************************************************/
+/* [탐색 단계] 원 모델 탐색 → 대략적 위치/반지름을 레코드에 저장            */
+/*****************************************************************************/
+void FindStage(PIPELINE* Pipeline)
+{
+   MIL_ID     MilSearchContext, MilResult;
+   MIL_DOUBLE StartTime, EndTime;
+
+   /* 스레드 전용 컨텍스트/결과 */
+   MmodAlloc(Pipeline->MilSystem, M_SHAPE_CIRCLE, M_DEFAULT, &MilSearchContext);
+   MmodAllocResult(Pipeline->MilSystem, M_SHAPE_CIRCLE, &MilResult);
+   MmodDefine(MilSearchContext, M_CIRCLE, M_DEFAULT, MODEL_RADIUS, M_DEFAULT, M_DEFAULT, M_DEFAULT);
+   MmodControl(MilSearchContext, 0,         M_SCALE_MIN_FACTOR, MIN_SCALE_FACTOR_VALUE);
+   MmodControl(MilSearchContext, 0,         M_SCALE_MAX_FACTOR, MAX_SCALE_FACTOR_VALUE);
+   MmodControl(MilSearchContext, M_DEFAULT, M_ACCEPTANCE,       ACCEPTANCE_VALUE);
+   MmodControl(MilSearchContext, M_DEFAULT, M_NUMBER,           MAX_CIRCLES_PER_PART);
+   MmodPreprocess(MilSearchContext, M_DEFAULT);
+
+   for (;;)
+   {
+      PART_RECORD* Record = Pipeline->FindQueue->Pop();
+      if (Record->PartIndex < 0)
+      {
+         Pipeline->MeasureQueue->Push(Record);
+         break;
+      }
+
+      MappTimer(M_DEFAULT, M_TIMER_READ, &StartTime);
+      MmodFind(MilSearchContext, Record->Frame, MilResult);
+      MmodGetResult(MilResult, M_DEFAULT, M_NUMBER + M_TYPE_MIL_INT, &Record->NbCircles);
+      if (Record->NbCircles > MAX_CIRCLES_PER_PART)
+         Record->NbCircles = MAX_CIRCLES_PER_PART;
+      if (Record->NbCircles > 0)
+      {
+         MmodGetResult(MilResult, M_DEFAULT, M_POSITION_X, Record->XPosition);
+         MmodGetResult(MilResult, M_DEFAULT, M_POSITION_Y, Record->YPosition);
+         MmodGetResult(MilResult, M_DEFAULT, M_RADIUS,     Record->Radius);
+         MmodGetResult(MilResult, M_DEFAULT, M_SCORE,      Record->Score);
+      }
+      MappTimer(M_DEFAULT, M_TIMER_READ, &EndTime);
+      Pipeline->StageTime[STAGE_FIND] += EndTime - StartTime;
+
+      Pipeline->MeasureQueue->Push(Record);
+   }
+
+   MmodFree(MilResult);
+   MmodFree(MilSearchContext);
+}
+
+/*****************************************************************************/
+/* [정밀화 단계] 원마다 링 영역에서 서브픽셀 원 측정 → 프레임 반환          */
+/*****************************************************************************/
+void MeasureStage(PIPELINE* Pipeline)
+{
+   MIL_ID     MilCircleMarker;
+   MIL_INT    NbFound;
+   MIL_DOUBLE StartTime, EndTime, InnerRadius;
+
+   MmeasAllocMarker(Pipeline->MilSystem, M_CIRCLE, M_DEFAULT, &MilCircleMarker);
+
+   for (;;)
+   {
+      PART_RECORD* Record = Pipeline->MeasureQueue->Pop();
+      if (Record->PartIndex < 0)
+      {
+         Pipeline->WriteQueue->Push(Record);
+         break;
+      }
+
+      MappTimer(M_DEFAULT, M_TIMER_READ, &StartTime);
+      for (MIL_INT i = 0; i < Record->NbCircles; i++)
+      {
+         /* 탐색 결과를 중심으로 한 링 안에서 원 엣지 측정 */
+         InnerRadius = Record->Radius[i] - RING_HALF_WIDTH;
+         MmeasSetMarker(MilCircleMarker, M_RING_CENTER, Record->XPosition[i], Record->YPosition[i]);
+         MmeasSetMarker(MilCircleMarker, M_RING_RADII,
+                        (InnerRadius > 1.0) ? InnerRadius : 1.0, Record->Radius[i] + RING_HALF_WIDTH);
+         MmeasFindMarker(M_DEFAULT, Record->Frame, MilCircleMarker, M_DEFAULT);
+
+         NbFound = 0;
+         MmeasGetResult(MilCircleMarker, M_NUMBER + M_TYPE_MIL_INT, &NbFound, M_NULL);
+         Record->Refined[i] = (NbFound > 0) ? M_YES : M_NO;
+         if (NbFound > 0)
+         {
+            MmeasGetResult(MilCircleMarker, M_POSITION, &Record->XPosition[i], &Record->YPosition[i]);
+            MmeasGetResult(MilCircleMarker, M_RADIUS,   &Record->Radius[i],    M_NULL);
+         }
+      }
+      MappTimer(M_DEFAULT, M_TIMER_READ, &EndTime);
+      Pipeline->StageTime[STAGE_MEASURE] += EndTime - StartTime;
+
+      /* 픽셀 데이터는 더 이상 필요 없으므로 프레임을 풀에 반환 */
+      Pipeline->FreeFrames->Push(Record->Frame);
+      Record->Frame = M_NULL;
+      Pipeline->WriteQueue->Push(Record);
+   }
+
+   MmeasFree(MilCircleMarker);
+}
+
+/*****************************************************************************/
+/* [기록 단계] 부품/원별 위치·지름 레코드를 CSV로 기록                      */
+/*****************************************************************************/
+void WriteStage(PIPELINE* Pipeline)
+{
+   MIL_DOUBLE StartTime, EndTime;
+   FILE*      OutputFile = MosFopen(OUTPUT_FILE, MIL_TEXT("w"));
+
+   if (OutputFile)
+      MosFprintf(OutputFile, MIL_TEXT("Part,Circle,X,Y,Diameter,Score,Refined\n"));
+
+   for (;;)
+   {
+      PART_RECORD* Record = Pipeline->WriteQueue->Pop();
+      if (Record->PartIndex < 0)
+      {
+         delete Record;
+         break;
+      }
+
+      MappTimer(M_DEFAULT, M_TIMER_READ, &StartTime);
+      if (OutputFile)
+      {
+         for (MIL_INT i = 0; i < Record->NbCircles; i++)
+         {
+            MosFprintf(OutputFile, MIL_TEXT("%d,%d,%.3f,%.3f,%.3f,%.2f,%d\n"),
+                       (int)Record->PartIndex, (int)i,
+                       Record->XPosition[i], Record->YPosition[i],
+                       2.0 * Record->Radius[i], Record->Score[i],
+                       (Record->Refined[i] == M_YES) ? 1 : 0);
+         }
+      }
+      Pipeline->NbCirclesWritten += Record->NbCircles;
+      MappTimer(M_DEFAULT, M_TIMER_READ, &EndTime);
+      Pipeline->StageTime[STAGE_WRITE] += EndTime - StartTime;
+
+      delete Record;
+   }
+
+   if (OutputFile)
+      MosFclose(OutputFile);
+}
+
+/*****************************************************************************/
+/* 입력 소스 보조 함수                                                      */
+/*****************************************************************************/
+
+/* 파일 목록의 n번째 파일 이름 */
+void FileListName(MIL_INT Index, MIL_TEXT_CHAR* FileName)
+{
+   MosSprintf(FileName, FILE_NAME_LENGTH_MAX, FILE_LIST_FORMAT, (int)Index);
+}
+
+/* 처리할 프레임 수 */
+MIL_INT CountSourceFrames(MIL_ID MilDigitizer)
+{
+   MIL_TEXT_CHAR FileName[FILE_NAME_LENGTH_MAX];
+   MIL_INT       NbFrames = 0;
+
+   switch (SOURCE_MODE)
+   {
+   case SOURCE_DIGITIZER:
+      NbFrames = MilDigitizer ? DIGITIZER_NB_FRAMES : 0;
+      break;
+   case SOURCE_SEQUENCE:
+      MbufDiskInquire(SEQUENCE_FILE, M_NUMBER_OF_IMAGES, &NbFrames);
+      break;
+   default:
+      /* 파일이 없을 때까지 번호를 올려가며 확인(오류 출력 억제) */
+      MappControl(M_DEFAULT, M_ERROR, M_PRINT_DISABLE);
+      for (NbFrames = 0; NbFrames < SOURCE_NB_FRAMES_MAX; NbFrames++)
+      {
+         FileListName(NbFrames, FileName);
+         if (MbufDiskInquire(FileName, M_SIZE_X, M_NULL) <= 0)
+            break;
+      }
+      MappControl(M_DEFAULT, M_ERROR, M_PRINT_ENABLE);
+      break;
+   }
+   return NbFrames;
+}
+
+/* 프레임 크기 */
+void SourceFrameSize(MIL_ID MilDigitizer, MIL_INT* SizeX, MIL_INT* SizeY)
+{
+   MIL_TEXT_CHAR FileName[FILE_NAME_LENGTH_MAX];
+
+   switch (SOURCE_MODE)
+   {
+   case SOURCE_DIGITIZER:
+      MdigInquire(MilDigitizer, M_SIZE_X, SizeX);
+      MdigInquire(MilDigitizer, M_SIZE_Y, SizeY);
+      break;
+   case SOURCE_SEQUENCE:
+      MbufDiskInquire(SEQUENCE_FILE, M_SIZE_X, SizeX);
+      MbufDiskInquire(SEQUENCE_FILE, M_SIZE_Y, SizeY);
+      break;
+   default:
+      FileListName(0, FileName);
+      MbufDiskInquire(FileName, M_SIZE_X, SizeX);
+      MbufDiskInquire(FileName, M_SIZE_Y, SizeY);
+      break;
+   }
+}
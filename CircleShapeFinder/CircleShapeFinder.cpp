@@ -12,14 +12,30 @@
  *   - 간단 예제: 고정 반지름, 다중 발생 탐색.
  *   - 복잡 예제1: 스케일 범위 확대(M_SCALE_MIN_FACTOR), 엣지 추출 정밀도/스무딩 조정.
  *   - 복잡 예제2: 보정(McalAssociate) 적용, 수용도/최소 분리/극성 제약으로 오검출 억제.
+ *                보정 연계 타깃 버퍼를 재사용하고, 픽셀 결과를 McalTransformCoordinateList
+ *                1회로 월드 좌표 일괄 변환(영상마다 복원/연계 반복 제거).
  *   - 소형 원: M_RESOLUTION_COARSENESS_LEVEL 낮춰 작은 원 검출 민감도 향상.
+ *   - 추적 모드: 이전 프레임들로 원별 위치/반지름을 예측 → 작은 ROI(Child)와 좁은 스케일
+ *               범위로만 탐색, 손실 트랙은 그 주변만 재탐색, 설정 주기(0이면 트랙이 없을 때만)의 전체 탐색으로 새 원 포착.
  *   - 시각화: 그래픽 리스트를 디스플레이에 연결(M_ASSOCIATED_GRAPHIC_LIST_ID) 후 MmodDraw.
+ *   - 배치 오버레이: 결과 전체(위치 십자/박스/원 윤곽)를 점수 구간별 선분 목록으로 모아
+ *                   구간(색)당 MgraLines 1회로 그래픽 리스트에 기록 → 발생 수와 무관한 API 호출 수.
+ *   - 다중 반지름: 한 컨텍스트에 반지름/스케일 범위가 다른 M_CIRCLE 모델 여러 개 정의 →
+ *                 MmodFind 1회(엣지 추출 1회)로 탐색 후 M_INDEX로 모델별 결과 분리.
  *   - 성능: MappTimer(M_SYNCHRONOUS)로 탐색 시간(ms) 로깅.
  *
  * 저작권:
  *   © Matrox Electronic Systems Ltd., 1992-2025. All Rights Reserved
  */
 #include <mil.h>
+#include <math.h>
+#include <vector>
+#include <algorithm>
+
+/* 헤드리스 실행 모드: 1이면 디스플레이 없이 실행
+   - MdispAlloc 없음(MilDisplay = M_NULL), 디스플레이 호출은 건너뛰고 주석은 그래픽 리스트에만 기록
+   - 버퍼는 M_DISP 없이 할당, 키 대기는 막지 않음 */
+#include "../Common/MilHeadless.h"
 
 //***************************************************************************
 // 예제 소개 출력
@@ -41,7 +57,7 @@ void PrintHeader()
    MosPrintf(MIL_TEXT("calibration, geometric model finder.\n\n"));
 
    MosPrintf(MIL_TEXT("Press any key to continue.\n\n"));
-   MosGetch();
+   WaitForKey(0);
 }
 
 /* 예제 함수 선언 */
@@ -49,6 +65,44 @@ void SimpleCircleSearchExample(MIL_ID MilSystem, MIL_ID MilDisplay);
 void ComplexCircleSearchExample1(MIL_ID MilSystem, MIL_ID MilDisplay);
 void ComplexCircleSearchExample2(MIL_ID MilSystem, MIL_ID MilDisplay);
 void SmallCircleSearchExample(MIL_ID MilSystem, MIL_ID MilDisplay);
+void OverlayRenderingBenchmark(MIL_ID MilSystem, MIL_ID MilDisplay);
+void MultiRadiusCircleSearchExample(MIL_ID MilSystem, MIL_ID MilDisplay);
+void CircleTrackingExample(MIL_ID MilSystem, MIL_ID MilDisplay);
+
+/*****************************************************************************/
+/* 배치 오버레이 렌더러: 결과 전체를 점수 구간(색)별 선분 목록으로 구성      */
+/*****************************************************************************/
+/* 점수 구간: 구간 최소 점수(내림차순)와 표시 색 */
+#define OVERLAY_NB_SCORE_BUCKETS    3
+static const MIL_DOUBLE OverlayBucketMinScore[OVERLAY_NB_SCORE_BUCKETS] = { 90.0, 70.0, 0.0 };
+static const MIL_DOUBLE OverlayBucketColor[OVERLAY_NB_SCORE_BUCKETS]    = { M_COLOR_GREEN, M_COLOR_YELLOW, M_COLOR_RED };
+
+/* 그릴 요소 선택 플래그 */
+#define OVERLAY_DRAW_POSITION       0x1L
+#define OVERLAY_DRAW_BOX            0x2L
+#define OVERLAY_DRAW_CIRCLE         0x4L
+#define OVERLAY_DRAW_ALL            (OVERLAY_DRAW_POSITION + OVERLAY_DRAW_BOX + OVERLAY_DRAW_CIRCLE)
+
+/* 십자 반길이(픽셀), 원 윤곽 근사 선분 수 */
+#define OVERLAY_CROSS_HALF_SIZE     5.0
+#define OVERLAY_CIRCLE_SEGMENTS     32
+
+/* 한 구간의 선분 목록(MgraLines M_DEFAULT: 시작점/끝점 쌍) */
+typedef struct
+{
+   std::vector<MIL_DOUBLE> X1, Y1, X2, Y2;
+} OVERLAY_SEGMENT_LIST;
+
+typedef struct
+{
+   OVERLAY_SEGMENT_LIST Bucket[OVERLAY_NB_SCORE_BUCKETS];
+} CIRCLE_OVERLAY_BATCH;
+
+void OverlayBatchBuild(CIRCLE_OVERLAY_BATCH& Batch, MIL_INT NumResults,
+                       const MIL_DOUBLE* XPosition, const MIL_DOUBLE* YPosition,
+                       const MIL_DOUBLE* Radius, const MIL_DOUBLE* Score,
+                       MIL_DOUBLE MinScore, MIL_INT DrawFlags);
+MIL_INT OverlayBatchDraw(const CIRCLE_OVERLAY_BATCH& Batch, MIL_ID GraphicList);
 
 /*****************************************************************************/
 /* 메인: 시스템/디스플레이 할당 → 예제 4개 실행 → 해제 */
@@ -62,7 +116,11 @@ int MosMain(void)
    /* 기본 오브젝트 할당(호스트 시스템 + 윈도우 디스플레이) */
    MappAlloc(M_NULL, M_DEFAULT, &MilApplication);
    MsysAlloc(MilApplication, M_SYSTEM_HOST, M_DEFAULT, M_DEFAULT, &MilSystem);
+#if MIL_HEADLESS
+   MilDisplay = M_NULL;
+#else
    MdispAlloc(MilSystem, M_DEFAULT, MIL_TEXT("M_DEFAULT"), M_WINDOWED, &MilDisplay);
+#endif
 
    /* 소개 출력 */
    //PrintHeader();
@@ -72,9 +130,12 @@ int MosMain(void)
    ComplexCircleSearchExample1(MilSystem, MilDisplay);
    //ComplexCircleSearchExample2(MilSystem, MilDisplay);
    //SmallCircleSearchExample(MilSystem, MilDisplay);
-   
+   OverlayRenderingBenchmark(MilSystem, MilDisplay);
+   MultiRadiusCircleSearchExample(MilSystem, MilDisplay);
+   CircleTrackingExample(MilSystem, MilDisplay);
+
    /* 해제 */
-   MdispFree(MilDisplay);
+   if (MilDisplay) MdispFree(MilDisplay);
    MappFreeDefault(MilApplication, MilSystem, M_NULL, M_NULL, M_NULL);
    return 0;
 }
@@ -112,11 +173,11 @@ void SimpleCircleSearchExample(MIL_ID MilSystem, MIL_ID MilDisplay)
 
    /* 타깃 이미지 로드 & 표시 */
    MbufRestore(TEST_IMG, MilSystem, &MilImage);
-   MdispSelect(MilDisplay, MilImage);
+   if (MilDisplay) MdispSelect(MilDisplay, MilImage);
 
    /* 그래픽 리스트 생성 & 디스플레이에 연결(오버레이용) */
    MgraAllocList(MilSystem, M_DEFAULT, &GraphicList);
-   MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, GraphicList);
+   if (MilDisplay) MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, GraphicList);
 
    /* 서클 파인더 컨텍스트/결과 할당 */
    MmodAlloc(MilSystem, M_SHAPE_CIRCLE, M_DEFAULT, &MilSearchContext);
@@ -182,7 +243,7 @@ void SimpleCircleSearchExample(MIL_ID MilSystem, MIL_ID MilDisplay)
    }
 
    MosPrintf(MIL_TEXT("Press any key to continue.\n\n"));
-   MosGetch();
+   WaitForKey(0);
 
    /* 해제 */
    MgraFree(GraphicList);
@@ -202,6 +263,7 @@ void SimpleCircleSearchExample(MIL_ID MilSystem, MIL_ID MilDisplay)
 #define MODEL_RADIUS_1            300.0
 #define SMOOTHNESS_VALUE_1        75.0
 #define MIN_SCALE_FACTOR_VALUE_1  0.1
+#define DISPLAY2_MIN_SCORE        90.0     /* 디스플레이 2: 이 점수 이상만 출력/표시 */
 
 void ComplexCircleSearchExample1(MIL_ID MilSystem, MIL_ID MilDisplay)
 {
@@ -224,19 +286,23 @@ void ComplexCircleSearchExample1(MIL_ID MilSystem, MIL_ID MilDisplay)
 
    /* 타깃 표시 */
    MbufRestore(TEST_IMG, MilSystem, &MilImage); // TEST_IMG 내가 사용하려고 하는 테스트 이미지
-   MdispSelect(MilDisplay, MilImage);
+   if (MilDisplay) MdispSelect(MilDisplay, MilImage);
 
+#if MIL_HEADLESS
+   MilDisplay2 = M_NULL;
+#else
    MdispAlloc(MilSystem, M_DEFAULT, MIL_TEXT("M_DEFAULT"), M_DEFAULT, &MilDisplay2);
    MdispSelect(MilDisplay2, MilImage);
    MdispControl(MilDisplay2, M_TITLE, MIL_TEXT("Display 2 - Score >= 90% only"));
+#endif
 
    /* 그래픽 리스트 연결 */
    MgraAllocList(MilSystem, M_DEFAULT, &GraphicList);
-   MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, GraphicList);
+   if (MilDisplay) MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, GraphicList);
 
    /* 그래픽 리스트 연결2 */
    MgraAllocList(MilSystem, M_DEFAULT, &GraphicList2);
-   MdispControl(MilDisplay2, M_ASSOCIATED_GRAPHIC_LIST_ID,GraphicList2);
+   if (MilDisplay2) MdispControl(MilDisplay2, M_ASSOCIATED_GRAPHIC_LIST_ID,GraphicList2);
 
    /* 컨텍스트/결과 할당 */
    MmodAlloc(MilSystem, M_SHAPE_CIRCLE, M_DEFAULT, &MilSearchContext);
@@ -313,26 +379,17 @@ void ComplexCircleSearchExample1(MIL_ID MilSystem, MIL_ID MilDisplay)
       MgraClear(M_DEFAULT, GraphicList2);
 
 
-      // 내가 수정하려 하는 코드
       for (i = 0; i < NumResults; i++)
       {
-         if (Score[i] > 90.0L) {
+         if (Score[i] >= DISPLAY2_MIN_SCORE)
             MosPrintf(MIL_TEXT("%-9d%-13.2f%-13.2f%-8.2f%-5.2f%%\n"), i, XPosition[i], YPosition[i], Radius[i], Score[i]);
-
-            // 위치
-            MgraControl(M_DEFAULT, M_COLOR, PositionDrawColor);
-            MmodDraw(M_DEFAULT, MilResult, GraphicList2, M_DRAW_POSITION, i, M_DEFAULT);
-
-            // 박스 
-            MgraControl(M_DEFAULT, M_COLOR, BoxDrawColor);
-            MmodDraw(M_DEFAULT, MilResult, GraphicList2, M_DRAW_BOX, i, M_DEFAULT);
-
-            // 엣지
-            MgraControl(M_DEFAULT, M_COLOR, ModelDrawColor);
-            MmodDraw(M_DEFAULT, MilResult, GraphicList2, M_DRAW_EDGES, i, M_DEFAULT);
-         }
-         
       }
+
+      /* 필터 통과 결과 전체를 한 번에 구성 → 색(구간)당 MgraLines 1회 */
+      CIRCLE_OVERLAY_BATCH OverlayBatch;
+      OverlayBatchBuild(OverlayBatch, NumResults, XPosition, YPosition, Radius, Score,
+                        DISPLAY2_MIN_SCORE, OVERLAY_DRAW_ALL);
+      OverlayBatchDraw(OverlayBatch, GraphicList2);
    }
    else
    {
@@ -340,7 +397,7 @@ void ComplexCircleSearchExample1(MIL_ID MilSystem, MIL_ID MilDisplay)
    }
 
    MosPrintf(MIL_TEXT("Press any key to continue.\n\n"));
-   MosGetch();
+   WaitForKey(0);
 
    /* 해제 */
    
@@ -353,11 +410,11 @@ void ComplexCircleSearchExample1(MIL_ID MilSystem, MIL_ID MilDisplay)
 
 
    // 1) 디스플레이에서 이미지 선택 해제
-   MdispSelect(MilDisplay, M_NULL);
+   if (MilDisplay) MdispSelect(MilDisplay, M_NULL);
    if (MilDisplay2) MdispSelect(MilDisplay2, M_NULL);
 
    // 2) 디스플레이에 붙인 그래픽 리스트 분리
-   MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, M_NULL);
+   if (MilDisplay) MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, M_NULL);
    if (MilDisplay2) MdispControl(MilDisplay2, M_ASSOCIATED_GRAPHIC_LIST_ID, M_NULL);
 
    // 3) 그래픽 리스트 free
@@ -390,66 +447,143 @@ void ComplexCircleSearchExample1(MIL_ID MilSystem, MIL_ID MilDisplay)
 #define MIN_SEPARATION_SCALE_VALUE_2  1.5
 #define MIN_SEPARATION_XY_VALUE_2     30.0
 
-void ComplexCircleSearchExample2(MIL_ID MilSystem, MIL_ID MilDisplay)
+#define CALIBRATED_NB_LOOP            50L
+
+/* 보정 탐색 엔진: 보정이 연계된 타깃 버퍼를 한 번만 준비하고 재사용 */
+typedef struct
 {
-   MIL_ID MilImage, MilCalibration, GraphicList;
-   MIL_ID MilSearchContext, MilResult;
+   MIL_ID  Calibration;      /* 보정 컨텍스트(1회 복원) */
+   MIL_ID  Target;           /* 보정이 연계된 재사용 타깃 버퍼(프레임을 여기로 직접 로드/그랩) */
+   MIL_ID  SearchContext;
+   MIL_ID  Result;
+   MIL_INT MaxOccurrences;
+   /* 픽셀→월드 일괄 변환용 좌표 목록(발생당 중심 + 림 2점) */
+   std::vector<MIL_DOUBLE> PixelX, PixelY, WorldX, WorldY;
+} CALIBRATED_CIRCLE_ENGINE;
+
+/* 엔진 할당: 보정 복원 → 타깃 버퍼 할당 → 연계(1회) → 컨텍스트 준비 */
+void CalibratedEngineAlloc(MIL_ID MilSystem, MIL_INT MaxOccurrences, CALIBRATED_CIRCLE_ENGINE& Engine)
+{
+   McalRestore(COMPLEX_CIRCLE_SEARCH_CALIBRATION_2, MilSystem, M_DEFAULT, &Engine.Calibration);
+   MbufAlloc2d(MilSystem,
+               MbufDiskInquire(COMPLEX_CIRCLE_SEARCH_TARGET_IMAGE_2, M_SIZE_X, M_NULL),
+               MbufDiskInquire(COMPLEX_CIRCLE_SEARCH_TARGET_IMAGE_2, M_SIZE_Y, M_NULL),
+               MbufDiskInquire(COMPLEX_CIRCLE_SEARCH_TARGET_IMAGE_2, M_TYPE,   M_NULL),
+               M_IMAGE + M_PROC + DISPLAY_ATTRIBUTE, &Engine.Target);
+   McalAssociate(Engine.Calibration, Engine.Target, M_DEFAULT);
 
-   MIL_DOUBLE PositionDrawColor = M_COLOR_RED;
-   MIL_DOUBLE ModelDrawColor    = M_COLOR_GREEN;
-   MIL_INT    NumResults = 0L;
+   /* 컨텍스트/결과 할당 및 모델 정의 */
+   MmodAlloc(MilSystem, M_SHAPE_CIRCLE, M_DEFAULT, &Engine.SearchContext);
+   MmodAllocResult(MilSystem, M_SHAPE_CIRCLE, &Engine.Result);
+   MmodDefine(Engine.SearchContext, M_CIRCLE, M_DEFAULT, MODEL_RADIUS_2, M_DEFAULT, M_DEFAULT, M_DEFAULT);
+
+   /* 엣지 추출/스무딩, 수용도, 최소 분리, 극성(반전) 설정 */
+   MmodControl(Engine.SearchContext, M_CONTEXT, M_DETAIL_LEVEL, M_VERY_HIGH);
+   MmodControl(Engine.SearchContext, M_CONTEXT, M_SMOOTHNESS,  SMOOTHNESS_VALUE_2);
+   MmodControl(Engine.SearchContext, M_DEFAULT, M_ACCEPTANCE,  ACCEPTANCE_VALUE_2);
+   MmodControl(Engine.SearchContext, 0,         M_MIN_SEPARATION_SCALE, MIN_SEPARATION_SCALE_VALUE_2);
+   MmodControl(Engine.SearchContext, 0,         M_MIN_SEPARATION_X,     MIN_SEPARATION_XY_VALUE_2);
+   MmodControl(Engine.SearchContext, 0,         M_MIN_SEPARATION_Y,     MIN_SEPARATION_XY_VALUE_2);
+   MmodControl(Engine.SearchContext, 0,         M_POLARITY,             M_REVERSE);
+   MmodControl(Engine.SearchContext, M_DEFAULT, M_NUMBER, NUMBER_OF_MODELS_2);
+   MmodPreprocess(Engine.SearchContext, M_DEFAULT);
+
+   /* 결과는 픽셀 단위로 받고, 월드 변환은 엔진이 한 번에 수행 */
+   MmodControl(Engine.Result, M_DEFAULT, M_RESULT_OUTPUT_UNITS, M_PIXEL);
+
+   /* 변환 목록 사전 할당 */
+   Engine.MaxOccurrences = MaxOccurrences;
+   Engine.PixelX.resize(3 * MaxOccurrences);
+   Engine.PixelY.resize(3 * MaxOccurrences);
+   Engine.WorldX.resize(3 * MaxOccurrences);
+   Engine.WorldY.resize(3 * MaxOccurrences);
+}
+
+/* Target 버퍼 탐색 → 월드 단위 결과(중심/반지름/점수) 반환, 발생 수 반환 */
+MIL_INT CalibratedEngineFind(CALIBRATED_CIRCLE_ENGINE& Engine,
+                             MIL_DOUBLE* XWorld, MIL_DOUBLE* YWorld,
+                             MIL_DOUBLE* RadiusWorld, MIL_DOUBLE* Score)
+{
+   MIL_INT NumResults = 0;
+   MIL_DOUBLE* PixelX = &Engine.PixelX[0];
+   MIL_DOUBLE* PixelY = &Engine.PixelY[0];
+
+   MmodFind(Engine.SearchContext, Engine.Target, Engine.Result);
+   MmodGetResult(Engine.Result, M_DEFAULT, M_NUMBER + M_TYPE_MIL_INT, &NumResults);
+   if ((NumResults < 1) || (NumResults > Engine.MaxOccurrences))
+      return NumResults;
+
+   /* 픽셀 결과: 중심은 목록 앞부분, 반지름은 임시로 림 위치 자리에 */
+   MmodGetResult(Engine.Result, M_DEFAULT, M_POSITION_X, PixelX);
+   MmodGetResult(Engine.Result, M_DEFAULT, M_POSITION_Y, PixelY);
+   MmodGetResult(Engine.Result, M_DEFAULT, M_RADIUS,     PixelX + NumResults);
+   MmodGetResult(Engine.Result, M_DEFAULT, M_SCORE,      Score);
+
+   /* 림 2점(+X, +Y 방향) 구성: 비등방 보정에서도 반지름을 평균으로 추정 */
+   for (MIL_INT i = 0; i < NumResults; i++)
+   {
+      MIL_DOUBLE R = PixelX[NumResults + i];
+      PixelX[NumResults + i]     = PixelX[i] + R;
+      PixelY[NumResults + i]     = PixelY[i];
+      PixelX[2 * NumResults + i] = PixelX[i];
+      PixelY[2 * NumResults + i] = PixelY[i] + R;
+   }
+
+   /* 중심 + 림 점 전체를 한 번의 호출로 월드 변환 */
+   McalTransformCoordinateList(Engine.Target, M_PIXEL_TO_WORLD, 3 * NumResults,
+                               PixelX, PixelY, &Engine.WorldX[0], &Engine.WorldY[0]);
+
+   for (MIL_INT i = 0; i < NumResults; i++)
+   {
+      MIL_DOUBLE Dx1 = Engine.WorldX[NumResults + i]     - Engine.WorldX[i];
+      MIL_DOUBLE Dy1 = Engine.WorldY[NumResults + i]     - Engine.WorldY[i];
+      MIL_DOUBLE Dx2 = Engine.WorldX[2 * NumResults + i] - Engine.WorldX[i];
+      MIL_DOUBLE Dy2 = Engine.WorldY[2 * NumResults + i] - Engine.WorldY[i];
+      XWorld[i]      = Engine.WorldX[i];
+      YWorld[i]      = Engine.WorldY[i];
+      RadiusWorld[i] = 0.5 * (sqrt(Dx1 * Dx1 + Dy1 * Dy1) + sqrt(Dx2 * Dx2 + Dy2 * Dy2));
+   }
+   return NumResults;
+}
+
+void CalibratedEngineFree(CALIBRATED_CIRCLE_ENGINE& Engine)
+{
+   MmodFree(Engine.Result);
+   MmodFree(Engine.SearchContext);
+   MbufFree(Engine.Target);
+   McalFree(Engine.Calibration);
+}
+
+void ComplexCircleSearchExample2(MIL_ID MilSystem, MIL_ID MilDisplay)
+{
+   CALIBRATED_CIRCLE_ENGINE Engine;
+   MIL_ID     GraphicList, MilSource, MilImage, MilCalibration;
+   MIL_INT    NumResults = 0L, n;
    MIL_DOUBLE Score[MODEL_MAX_OCCURRENCES], XPosition[MODEL_MAX_OCCURRENCES],
               YPosition[MODEL_MAX_OCCURRENCES], Radius[MODEL_MAX_OCCURRENCES],
-              Time = 0.0;
+              Time = 0.0, RestoreLoopTime = 0.0, EngineLoopTime = 0.0;
    int i;
 
-   /* 타깃/보정 로드 및 연계 → 표시 */
-   MbufRestore(COMPLEX_CIRCLE_SEARCH_TARGET_IMAGE_2, MilSystem, &MilImage);
-   McalRestore(COMPLEX_CIRCLE_SEARCH_CALIBRATION_2, MilSystem, M_DEFAULT, &MilCalibration);
-   McalAssociate(MilCalibration, MilImage, M_DEFAULT);
-   MdispSelect(MilDisplay, MilImage);
+   /* 엔진 준비(보정 복원/연계는 여기서 1회) 후 타깃 로드 → 표시 */
+   CalibratedEngineAlloc(MilSystem, MODEL_MAX_OCCURRENCES, Engine);
+   MbufLoad(COMPLEX_CIRCLE_SEARCH_TARGET_IMAGE_2, Engine.Target);
+   if (MilDisplay) MdispSelect(MilDisplay, Engine.Target);
 
    /* 그래픽 리스트 연결 */
    MgraAllocList(MilSystem, M_DEFAULT, &GraphicList);
-   MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, GraphicList);
-
-   /* 컨텍스트/결과 할당 및 모델 정의 */
-   MmodAlloc(MilSystem, M_SHAPE_CIRCLE, M_DEFAULT, &MilSearchContext);
-   MmodAllocResult(MilSystem, M_SHAPE_CIRCLE, &MilResult);
-   MmodDefine(MilSearchContext, M_CIRCLE, M_DEFAULT, MODEL_RADIUS_2, M_DEFAULT, M_DEFAULT, M_DEFAULT);
-
-   /* 엣지 추출/스무딩, 수용도, 최소 분리, 극성(반전) 설정 */
-   MmodControl(MilSearchContext, M_CONTEXT, M_DETAIL_LEVEL, M_VERY_HIGH);
-   MmodControl(MilSearchContext, M_CONTEXT, M_SMOOTHNESS,  SMOOTHNESS_VALUE_2);
-   MmodControl(MilSearchContext, M_DEFAULT, M_ACCEPTANCE,  ACCEPTANCE_VALUE_2);
-   MmodControl(MilSearchContext, 0,         M_MIN_SEPARATION_SCALE, MIN_SEPARATION_SCALE_VALUE_2);
-   MmodControl(MilSearchContext, 0,         M_MIN_SEPARATION_X,     MIN_SEPARATION_XY_VALUE_2);
-   MmodControl(MilSearchContext, 0,         M_MIN_SEPARATION_Y,     MIN_SEPARATION_XY_VALUE_2);
-   MmodControl(MilSearchContext, 0,         M_POLARITY,             M_REVERSE);
-
-   /* 발생 개수 설정 */
-   MmodControl(MilSearchContext, M_DEFAULT, M_NUMBER, NUMBER_OF_MODELS_2);
+   if (MilDisplay) MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, GraphicList);
 
-   /* 사전처리/탐색/시간 */
-   MmodPreprocess(MilSearchContext, M_DEFAULT);
+   /* 탐색/시간 */
    MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
-   MmodFind(MilSearchContext, MilImage, MilResult);
+   NumResults = CalibratedEngineFind(Engine, XPosition, YPosition, Radius, Score);
    MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
 
-   /* 결과 수 */
-   MmodGetResult(MilResult, M_DEFAULT, M_NUMBER + M_TYPE_MIL_INT, &NumResults);
-
    MosPrintf(MIL_TEXT("\nUsing model finder M_SHAPE_CIRCLE with a calibrated target:\n"));
    MosPrintf(MIL_TEXT("-----------------------------------------------------------\n\n"));
    MosPrintf(MIL_TEXT("A circle model was defined with a nominal radius of %-3.1f%.\n\n"), MODEL_RADIUS_2);
 
    if ((NumResults >= 1) && (NumResults <= MODEL_MAX_OCCURRENCES))
    {
-      MmodGetResult(MilResult, M_DEFAULT, M_POSITION_X, XPosition);
-      MmodGetResult(MilResult, M_DEFAULT, M_POSITION_Y, YPosition);
-      MmodGetResult(MilResult, M_DEFAULT, M_RADIUS,     Radius);
-      MmodGetResult(MilResult, M_DEFAULT, M_SCORE,      Score);
-
       MosPrintf(MIL_TEXT("Found despite: Occlusion / Low contrast / Noisy edges\n\n"));
       MosPrintf(MIL_TEXT("Result   X-Position   Y-Position   Radius   Score\n\n"));
       for (i = 0; i < NumResults; i++)
@@ -459,26 +593,68 @@ void ComplexCircleSearchExample2(MIL_ID MilSystem, MIL_ID MilDisplay)
       }
       MosPrintf(MIL_TEXT("\nThe search time was %.1f ms.\n\n"), Time * 1000.0);
 
-      /* 오버레이 */
-      MgraControl(M_DEFAULT, M_COLOR, PositionDrawColor);
-      MmodDraw(M_DEFAULT, MilResult, GraphicList, M_DRAW_POSITION, M_DEFAULT, M_DEFAULT);
-      MgraControl(M_DEFAULT, M_COLOR, ModelDrawColor);
-      MmodDraw(M_DEFAULT, MilResult, GraphicList, M_DRAW_EDGES, M_DEFAULT, M_DEFAULT);
+      /* 오버레이(픽셀 결과 기준 그리기) */
+      MgraControl(M_DEFAULT, M_COLOR, M_COLOR_RED);
+      MmodDraw(M_DEFAULT, Engine.Result, GraphicList, M_DRAW_POSITION, M_DEFAULT, M_DEFAULT);
+      MgraControl(M_DEFAULT, M_COLOR, M_COLOR_GREEN);
+      MmodDraw(M_DEFAULT, Engine.Result, GraphicList, M_DRAW_EDGES, M_DEFAULT, M_DEFAULT);
    }
    else
    {
       MosPrintf(MIL_TEXT("The circles were not found or too many occurrences!\n\n"));
    }
 
+   /* 반복 계측 비교: 프레임마다 연계 + 월드 결과 조회 vs 엔진 재사용 + 일괄 변환
+      - 디스크 입출력은 양쪽 모두 타이머 밖에서 1회(프레임은 메모리의 원본에서 복사) */
+   MbufRestore(COMPLEX_CIRCLE_SEARCH_TARGET_IMAGE_2, MilSystem, &MilSource);
+   MbufRestore(COMPLEX_CIRCLE_SEARCH_TARGET_IMAGE_2, MilSystem, &MilImage);
+   McalRestore(COMPLEX_CIRCLE_SEARCH_CALIBRATION_2, MilSystem, M_DEFAULT, &MilCalibration);
+
+   MmodControl(Engine.Result, M_DEFAULT, M_RESULT_OUTPUT_UNITS, M_WORLD);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (n = 0; n < CALIBRATED_NB_LOOP; n++)
+   {
+      MbufCopy(MilSource, MilImage);
+      McalAssociate(MilCalibration, MilImage, M_DEFAULT);
+      MmodFind(Engine.SearchContext, MilImage, Engine.Result);
+      MmodGetResult(Engine.Result, M_DEFAULT, M_NUMBER + M_TYPE_MIL_INT, &NumResults);
+      if ((NumResults >= 1) && (NumResults <= MODEL_MAX_OCCURRENCES))
+      {
+         MmodGetResult(Engine.Result, M_DEFAULT, M_POSITION_X, XPosition);
+         MmodGetResult(Engine.Result, M_DEFAULT, M_POSITION_Y, YPosition);
+         MmodGetResult(Engine.Result, M_DEFAULT, M_RADIUS,     Radius);
+         MmodGetResult(Engine.Result, M_DEFAULT, M_SCORE,      Score);
+      }
+      McalAssociate(M_NULL, MilImage, M_DEFAULT);
+   }
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &RestoreLoopTime);
+   MmodControl(Engine.Result, M_DEFAULT, M_RESULT_OUTPUT_UNITS, M_PIXEL);
+
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (n = 0; n < CALIBRATED_NB_LOOP; n++)
+   {
+      MbufCopy(MilSource, Engine.Target);
+      CalibratedEngineFind(Engine, XPosition, YPosition, Radius, Score);
+   }
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &EngineLoopTime);
+
+   McalFree(MilCalibration);
+   MbufFree(MilImage);
+   MbufFree(MilSource);
+
+   MosPrintf(MIL_TEXT("Associate + world results per image:    %.2f ms/image\n"),
+             RestoreLoopTime * 1000.0 / CALIBRATED_NB_LOOP);
+   MosPrintf(MIL_TEXT("Reused calibrated target + batch world: %.2f ms/image\n\n"),
+             EngineLoopTime * 1000.0 / CALIBRATED_NB_LOOP);
+
    MosPrintf(MIL_TEXT("Press any key to continue.\n\n"));
-   MosGetch();
+   WaitForKey(0);
 
    /* 해제 */
-   McalFree(MilCalibration);
+   if (MilDisplay) MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, M_NULL);
+   if (MilDisplay) MdispSelect(MilDisplay, M_NULL);
    MgraFree(GraphicList);
-   MbufFree(MilImage);
-   MmodFree(MilSearchContext);
-   MmodFree(MilResult);
+   CalibratedEngineFree(Engine);
 }
 
 /******************************************************************************/
@@ -500,12 +676,12 @@ void SmallCircleSearchExample(MIL_ID MilSystem, MIL_ID MilDisplay)
 
    /* 타깃 로드/표시 */
    MbufRestore(SMALL_CIRCLE_IMAGE, MilSystem, &MilImage);
-   MdispControl(MilDisplay, M_TITLE, MIL_TEXT("Target image"));
-   MdispSelect(MilDisplay, MilImage);
+   if (MilDisplay) MdispControl(MilDisplay, M_TITLE, MIL_TEXT("Target image"));
+   if (MilDisplay) MdispSelect(MilDisplay, MilImage);
 
    /* 그래픽 리스트 연결 */
    MgraAllocList(MilSystem, M_DEFAULT, &GraphicList);
-   MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, GraphicList);
+   if (MilDisplay) MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, GraphicList);
 
    /* 컨텍스트/결과 할당, 모델 정의 */
    MmodAlloc(MilSystem, M_SHAPE_CIRCLE, M_DEFAULT, &MilSearchContext);
@@ -522,7 +698,7 @@ void SmallCircleSearchExample(MIL_ID MilSystem, MIL_ID MilDisplay)
    MosPrintf(MIL_TEXT("A circle model was defined with a nominal radius of %-3.1f%.\n\n"), MODEL_RADIUS_3);
    MosPrintf(MIL_TEXT("a) M_RESOLUTION_COARSENESS_LEVEL = 50 (default)\n"));
    MosPrintf(MIL_TEXT("Press any key to continue.\n"));
-   MosGetch();
+   WaitForKey(0);
 
    /* 람다: 탐색/결과 출력/오버레이 공통 처리 */
    auto FindAndDisplayResults = [&]()
@@ -548,13 +724,11 @@ void SmallCircleSearchExample(MIL_ID MilSystem, MIL_ID MilDisplay)
          }
          MosPrintf(MIL_TEXT("\nThe search time was %.1f ms.\n\n"), Time * 1000.0);
 
-         /* 각 결과에 엣지/박스/포지션 오버레이 */
-         for (int i = 0; i < NumResults; i++)
-         {
-            MgraControl(M_DEFAULT, M_COLOR, M_COLOR_RED);
-            MmodDraw(M_DEFAULT, MilResult, GraphicList,
-                     M_DRAW_EDGES + M_DRAW_BOX + M_DRAW_POSITION, i, M_DEFAULT);
-         }
+         /* 전체 결과에 원/박스/포지션 오버레이(점수 구간별 색, 구간당 1회 그리기) */
+         CIRCLE_OVERLAY_BATCH OverlayBatch;
+         OverlayBatchBuild(OverlayBatch, NumResults, XPosition, YPosition, Radius, Score,
+                           0.0, OVERLAY_DRAW_ALL);
+         OverlayBatchDraw(OverlayBatch, GraphicList);
       }
       else
       {
@@ -568,7 +742,7 @@ void SmallCircleSearchExample(MIL_ID MilSystem, MIL_ID MilDisplay)
    MosPrintf(MIL_TEXT("Some occurrences are missed. Decreasing M_RESOLUTION_COARSENESS_LEVEL helps.\n\n"));
    MosPrintf(MIL_TEXT("b) M_RESOLUTION_COARSENESS_LEVEL = 40\n"));
    MosPrintf(MIL_TEXT("Press any key to continue.\n"));
-   MosGetch();
+   WaitForKey(0);
 
    /* 주석 제거 후 coarseness 낮추고 재탐색 */
    MgraClear(M_DEFAULT, GraphicList);
@@ -577,7 +751,7 @@ void SmallCircleSearchExample(MIL_ID MilSystem, MIL_ID MilDisplay)
 
    MosPrintf(MIL_TEXT("Now, all occurrences are found with higher scores.\n\n"));
    MosPrintf(MIL_TEXT("Press any key to end.\n"));
-   MosGetch();
+   WaitForKey(0);
 
    /* 해제 */
    MgraFree(GraphicList);
@@ -585,3 +759,834 @@ void SmallCircleSearchExample(MIL_ID MilSystem, MIL_ID MilDisplay)
    MmodFree(MilSearchContext);
    MmodFree(MilResult);
 }
+
+/******************************************************************************/
+/* [배치 오버레이] 결과 전체를 선분 목록으로 구성 → 색(구간)당 1회 그리기      */
+/******************************************************************************/
+
+/* 선분 1개 추가 */
+static void OverlayAddSegment(OVERLAY_SEGMENT_LIST& List,
+                              MIL_DOUBLE X1, MIL_DOUBLE Y1, MIL_DOUBLE X2, MIL_DOUBLE Y2)
+{
+   List.X1.push_back(X1);
+   List.Y1.push_back(Y1);
+   List.X2.push_back(X2);
+   List.Y2.push_back(Y2);
+}
+
+/* 결과 배열 → 구간별 선분 목록(MinScore 미만은 제외) */
+void OverlayBatchBuild(CIRCLE_OVERLAY_BATCH& Batch, MIL_INT NumResults,
+                       const MIL_DOUBLE* XPosition, const MIL_DOUBLE* YPosition,
+                       const MIL_DOUBLE* Radius, const MIL_DOUBLE* Score,
+                       MIL_DOUBLE MinScore, MIL_INT DrawFlags)
+{
+   /* 원 윤곽 근사용 단위원 좌표(1회 계산)
+      - 함수 지역 static은 첫 호출 시 한 번만, 스레드 안전하게 초기화됨(C++11) */
+   struct UNIT_CIRCLE
+   {
+      MIL_DOUBLE Cos[OVERLAY_CIRCLE_SEGMENTS + 1], Sin[OVERLAY_CIRCLE_SEGMENTS + 1];
+   };
+   static const UNIT_CIRCLE UnitCircle = []()
+   {
+      UNIT_CIRCLE Unit;
+      for (MIL_INT s = 0; s <= OVERLAY_CIRCLE_SEGMENTS; s++)
+      {
+         MIL_DOUBLE Angle = (2.0 * 3.14159265358979323846 * s) / OVERLAY_CIRCLE_SEGMENTS;
+         Unit.Cos[s] = cos(Angle);
+         Unit.Sin[s] = sin(Angle);
+      }
+      return Unit;
+   }();
+   const MIL_DOUBLE* UnitCos = UnitCircle.Cos;
+   const MIL_DOUBLE* UnitSin = UnitCircle.Sin;
+
+   /* 선분 수를 미리 예약(재할당 방지) */
+   MIL_INT SegmentsPerResult = ((DrawFlags & OVERLAY_DRAW_POSITION) ? 2 : 0) +
+                               ((DrawFlags & OVERLAY_DRAW_BOX)      ? 4 : 0) +
+                               ((DrawFlags & OVERLAY_DRAW_CIRCLE)   ? OVERLAY_CIRCLE_SEGMENTS : 0);
+   for (MIL_INT b = 0; b < OVERLAY_NB_SCORE_BUCKETS; b++)
+   {
+      OVERLAY_SEGMENT_LIST& List = Batch.Bucket[b];
+      List.X1.clear(); List.Y1.clear(); List.X2.clear(); List.Y2.clear();
+      List.X1.reserve(NumResults * SegmentsPerResult);
+      List.Y1.reserve(NumResults * SegmentsPerResult);
+      List.X2.reserve(NumResults * SegmentsPerResult);
+      List.Y2.reserve(NumResults * SegmentsPerResult);
+   }
+
+   for (MIL_INT i = 0; i < NumResults; i++)
+   {
+      if (Score[i] < MinScore)
+         continue;
+
+      /* 점수 구간 선택(구간 최소 점수 내림차순) */
+      MIL_INT b = 0;
+      while (b < OVERLAY_NB_SCORE_BUCKETS - 1 && Score[i] < OverlayBucketMinScore[b])
+         b++;
+      OVERLAY_SEGMENT_LIST& List = Batch.Bucket[b];
+
+      MIL_DOUBLE X = XPosition[i], Y = YPosition[i], R = Radius[i];
+
+      /* 위치: 십자 */
+      if (DrawFlags & OVERLAY_DRAW_POSITION)
+      {
+         OverlayAddSegment(List, X - OVERLAY_CROSS_HALF_SIZE, Y, X + OVERLAY_CROSS_HALF_SIZE, Y);
+         OverlayAddSegment(List, X, Y - OVERLAY_CROSS_HALF_SIZE, X, Y + OVERLAY_CROSS_HALF_SIZE);
+      }
+
+      /* 박스: 원에 외접하는 정사각형 */
+      if (DrawFlags & OVERLAY_DRAW_BOX)
+      {
+         OverlayAddSegment(List, X - R, Y - R, X + R, Y - R);
+         OverlayAddSegment(List, X + R, Y - R, X + R, Y + R);
+         OverlayAddSegment(List, X + R, Y + R, X - R, Y + R);
+         OverlayAddSegment(List, X - R, Y + R, X - R, Y - R);
+      }
+
+      /* 원 윤곽: 정다각형 근사 */
+      if (DrawFlags & OVERLAY_DRAW_CIRCLE)
+      {
+         for (MIL_INT s = 0; s < OVERLAY_CIRCLE_SEGMENTS; s++)
+         {
+            OverlayAddSegment(List, X + R * UnitCos[s],     Y + R * UnitSin[s],
+                                    X + R * UnitCos[s + 1], Y + R * UnitSin[s + 1]);
+         }
+      }
+   }
+}
+
+/* 구간별 MgraLines 1회(+색 지정) → 그린 호출 수 반환 */
+MIL_INT OverlayBatchDraw(const CIRCLE_OVERLAY_BATCH& Batch, MIL_ID GraphicList)
+{
+   MIL_INT NbDrawCalls = 0;
+   for (MIL_INT b = 0; b < OVERLAY_NB_SCORE_BUCKETS; b++)
+   {
+      const OVERLAY_SEGMENT_LIST& List = Batch.Bucket[b];
+      if (List.X1.empty())
+         continue;
+
+      MgraControl(M_DEFAULT, M_COLOR, OverlayBucketColor[b]);
+      MgraLines(M_DEFAULT, GraphicList, (MIL_INT)List.X1.size(),
+                &List.X1[0], &List.Y1[0], &List.X2[0], &List.Y2[0], M_DEFAULT);
+      NbDrawCalls++;
+   }
+   return NbDrawCalls;
+}
+
+/******************************************************************************/
+/* [오버레이 벤치마크] 발생별 그리기 vs 배치 그리기 (1,000+ 발생)             */
+/******************************************************************************/
+#define OVERLAY_BENCH_GRID             32L      /* 32 x 32 = 1024 발생 */
+#define OVERLAY_BENCH_CELL_SIZE        64L
+#define OVERLAY_BENCH_NB_LOOP          20L
+
+void OverlayRenderingBenchmark(MIL_ID MilSystem, MIL_ID MilDisplay)
+{
+   MIL_ID     MilImage, GraphicList;
+   MIL_INT    NumResults = OVERLAY_BENCH_GRID * OVERLAY_BENCH_GRID;
+   MIL_INT    ImageSize  = OVERLAY_BENCH_GRID * OVERLAY_BENCH_CELL_SIZE;
+   MIL_INT    NbDrawCalls = 0, NbListEntries = 0;
+   MIL_DOUBLE BuildTime, RedrawTime, BatchBuildTime = 0.0, DisplayBuildTime;
+   std::vector<MIL_DOUBLE> Score(NumResults), XPosition(NumResults),
+                           YPosition(NumResults), Radius(NumResults);
+
+   MosPrintf(MIL_TEXT("\nOverlay rendering of %d circle occurrences:\n"), (int)NumResults);
+   MosPrintf(MIL_TEXT("------------------------------------------\n\n"));
+
+   /* 격자 위에 합성 결과 생성(반지름/점수는 결정적 의사난수) */
+   for (MIL_INT i = 0; i < NumResults; i++)
+   {
+      XPosition[i] = (MIL_DOUBLE)((i % OVERLAY_BENCH_GRID) * OVERLAY_BENCH_CELL_SIZE + OVERLAY_BENCH_CELL_SIZE / 2);
+      YPosition[i] = (MIL_DOUBLE)((i / OVERLAY_BENCH_GRID) * OVERLAY_BENCH_CELL_SIZE + OVERLAY_BENCH_CELL_SIZE / 2);
+      Radius[i]    = 12.0 + (MIL_DOUBLE)((i * 7) % 17);
+      Score[i]     = 50.0 + (MIL_DOUBLE)((i * 37) % 51);
+   }
+
+   MbufAlloc2d(MilSystem, ImageSize, ImageSize, 8 + M_UNSIGNED, M_IMAGE + M_PROC + DISPLAY_ATTRIBUTE, &MilImage);
+   MbufClear(MilImage, 0);
+   MgraAllocList(MilSystem, M_DEFAULT, &GraphicList);
+
+   MosPrintf(MIL_TEXT("Method        Draw calls   List entries   Build (ms)   Redraw (ms)\n\n"));
+
+   for (MIL_INT Method = 0; Method < 2; Method++)
+   {
+      /* (1) 그래픽 리스트 구성 시간 */
+      MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+      for (MIL_INT n = 0; n < OVERLAY_BENCH_NB_LOOP; n++)
+      {
+         MgraClear(M_DEFAULT, GraphicList);
+         if (Method == 0)
+         {
+            /* 발생별: 색 지정 + 위치/박스/원 각각 호출(기존 루프 방식) */
+            NbDrawCalls = 0;
+            for (MIL_INT i = 0; i < NumResults; i++)
+            {
+               MIL_INT b = 0;
+               while (b < OVERLAY_NB_SCORE_BUCKETS - 1 && Score[i] < OverlayBucketMinScore[b])
+                  b++;
+               MgraControl(M_DEFAULT, M_COLOR, OverlayBucketColor[b]);
+               MgraLine(M_DEFAULT, GraphicList, XPosition[i] - OVERLAY_CROSS_HALF_SIZE, YPosition[i],
+                                                XPosition[i] + OVERLAY_CROSS_HALF_SIZE, YPosition[i]);
+               MgraLine(M_DEFAULT, GraphicList, XPosition[i], YPosition[i] - OVERLAY_CROSS_HALF_SIZE,
+                                                XPosition[i], YPosition[i] + OVERLAY_CROSS_HALF_SIZE);
+               MgraRect(M_DEFAULT, GraphicList, XPosition[i] - Radius[i], YPosition[i] - Radius[i],
+                                                XPosition[i] + Radius[i], YPosition[i] + Radius[i]);
+               MgraArc(M_DEFAULT, GraphicList, XPosition[i], YPosition[i], Radius[i], Radius[i], 0.0, 360.0);
+               NbDrawCalls += 4;
+            }
+         }
+         else
+         {
+            /* 배치: 구간(색)당 MgraLines 1회 */
+            CIRCLE_OVERLAY_BATCH OverlayBatch;
+            OverlayBatchBuild(OverlayBatch, NumResults, &XPosition[0], &YPosition[0],
+                              &Radius[0], &Score[0], 0.0, OVERLAY_DRAW_ALL);
+            NbDrawCalls = OverlayBatchDraw(OverlayBatch, GraphicList);
+         }
+      }
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &BuildTime);
+      MgraInquireList(GraphicList, M_LIST, M_DEFAULT, M_NUMBER_OF_GRAPHICS, &NbListEntries);
+
+      /* (2) 재그리기 시간: 디스플레이 갱신과 같은 리스트 재생을 이미지로 수행 */
+      MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+      for (MIL_INT n = 0; n < OVERLAY_BENCH_NB_LOOP; n++)
+         MgraDraw(GraphicList, MilImage, M_DEFAULT);
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &RedrawTime);
+
+      MosPrintf(MIL_TEXT("%-14s%-13d%-15d%-13.3f%-.3f\n"),
+                (Method == 0) ? MIL_TEXT("Per-result") : MIL_TEXT("Batched"),
+                (int)NbDrawCalls, (int)NbListEntries,
+                BuildTime * 1000.0 / OVERLAY_BENCH_NB_LOOP,
+                RedrawTime * 1000.0 / OVERLAY_BENCH_NB_LOOP);
+      BatchBuildTime = BuildTime;
+   }
+
+   /* 배치 결과를 디스플레이에 표시 */
+   MbufClear(MilImage, 0);
+   if (MilDisplay) MdispSelect(MilDisplay, MilImage);
+   if (MilDisplay) MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, GraphicList);
+
+   /* 디스플레이 지원 비용: 디스플레이에 연결된 리스트를 같은 배치로 다시 구성 */
+   MosPrintf(MIL_TEXT("\nDisplay support cost (batched overlay rebuild):\n"));
+   if (MilDisplay)
+   {
+      CIRCLE_OVERLAY_BATCH OverlayBatch;
+      MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+      for (MIL_INT n = 0; n < OVERLAY_BENCH_NB_LOOP; n++)
+      {
+         MgraClear(M_DEFAULT, GraphicList);
+         OverlayBatchBuild(OverlayBatch, NumResults, &XPosition[0], &YPosition[0],
+                           &Radius[0], &Score[0], 0.0, OVERLAY_DRAW_ALL);
+         OverlayBatchDraw(OverlayBatch, GraphicList);
+      }
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &DisplayBuildTime);
+      MosPrintf(MIL_TEXT("Detached list: %.3f ms, displayed list: %.3f ms (display %.3f ms)\n"),
+                BatchBuildTime * 1000.0 / OVERLAY_BENCH_NB_LOOP,
+                DisplayBuildTime * 1000.0 / OVERLAY_BENCH_NB_LOOP,
+                (DisplayBuildTime - BatchBuildTime) * 1000.0 / OVERLAY_BENCH_NB_LOOP);
+   }
+   else
+      MosPrintf(MIL_TEXT("No display allocated (headless build): %.3f ms per rebuild.\n"),
+                BatchBuildTime * 1000.0 / OVERLAY_BENCH_NB_LOOP);
+
+   MosPrintf(MIL_TEXT("\nPress any key to end.\n\n"));
+   WaitForKey(0);
+
+   /* 해제 */
+   if (MilDisplay) MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, M_NULL);
+   if (MilDisplay) MdispSelect(MilDisplay, M_NULL);
+   MgraFree(GraphicList);
+   MbufFree(MilImage);
+}
+
+/******************************************************************************/
+/* [다중 반지름 예제] 한 컨텍스트에 M_CIRCLE 모델 여러 개 → MmodFind 1회      */
+/******************************************************************************/
+#define MULTI_RADIUS_TARGET_IMAGE     SIMPLE_CIRCLE_SEARCH_TARGET_IMAGE
+#define MULTI_RADIUS_NB_MODELS        4L       /* 최대 모델 수(이미지에서 찾은 반지름 군 수만큼) */
+#define MULTI_RADIUS_SCALE_TOLERANCE  0.1      /* 모델별 스케일 범위: 1 ± 10% */
+#define MULTI_RADIUS_MAX_OCCURRENCES  200L
+#define MULTI_RADIUS_NB_LOOP          20L
+#define MULTI_RADIUS_SURVEY_RADIUS    30.0     /* 반지름 조사용 모델 반지름 */
+#define MULTI_RADIUS_SURVEY_MIN_SCALE 0.25     /* 반지름 조사 스케일 범위 */
+#define MULTI_RADIUS_SURVEY_MAX_SCALE 4.0
+
+/* 모델 정의 + 모델별 스케일 범위 설정(모델 인덱스 = 정의 순서) */
+static void DefineCircleModel(MIL_ID MilSearchContext, MIL_INT ModelIndex, MIL_DOUBLE Radius)
+{
+   MmodDefine(MilSearchContext, M_CIRCLE, M_DEFAULT, Radius, M_DEFAULT, M_DEFAULT, M_DEFAULT);
+   MmodControl(MilSearchContext, ModelIndex, M_SCALE_MIN_FACTOR, 1.0 - MULTI_RADIUS_SCALE_TOLERANCE);
+   MmodControl(MilSearchContext, ModelIndex, M_SCALE_MAX_FACTOR, 1.0 + MULTI_RADIUS_SCALE_TOLERANCE);
+   MmodControl(MilSearchContext, ModelIndex, M_NUMBER,           M_ALL);
+}
+
+/* 공칭 반지름 조사: 넓은 스케일 범위로 1회 탐색한 반지름을 ±MULTI_RADIUS_SCALE_TOLERANCE 군으로 묶고,
+   발생 수가 많은 군부터 최대 MaxModels개의 평균 반지름을 오름차순으로 반환(모델 수 반환) */
+static MIL_INT MultiRadiusSurvey(MIL_ID MilSystem, MIL_ID MilImage, MIL_DOUBLE* Nominal, MIL_INT MaxModels)
+{
+   MIL_ID  MilSurveyContext, MilSurveyResult;
+   MIL_INT NumResults = 0, NbModels = 0;
+   std::vector<MIL_DOUBLE> Radii;
+   std::vector< std::pair<MIL_INT, MIL_DOUBLE> > Groups;   /* (발생 수, 평균 반지름) */
+
+   MmodAlloc(MilSystem, M_SHAPE_CIRCLE, M_DEFAULT, &MilSurveyContext);
+   MmodAllocResult(MilSystem, M_SHAPE_CIRCLE, &MilSurveyResult);
+   MmodDefine(MilSurveyContext, M_CIRCLE, M_DEFAULT, MULTI_RADIUS_SURVEY_RADIUS, M_DEFAULT, M_DEFAULT, M_DEFAULT);
+   MmodControl(MilSurveyContext, 0, M_SCALE_MIN_FACTOR, MULTI_RADIUS_SURVEY_MIN_SCALE);
+   MmodControl(MilSurveyContext, 0, M_SCALE_MAX_FACTOR, MULTI_RADIUS_SURVEY_MAX_SCALE);
+   MmodControl(MilSurveyContext, 0, M_NUMBER,           M_ALL);
+   MmodPreprocess(MilSurveyContext, M_DEFAULT);
+   MmodFind(MilSurveyContext, MilImage, MilSurveyResult);
+
+   MmodGetResult(MilSurveyResult, M_DEFAULT, M_NUMBER + M_TYPE_MIL_INT, &NumResults);
+   if (NumResults > 0)
+   {
+      Radii.resize(NumResults);
+      MmodGetResult(MilSurveyResult, M_DEFAULT, M_RADIUS, &Radii[0]);
+      std::sort(Radii.begin(), Radii.end());
+
+      /* 군의 첫 반지름보다 (1 + 2 * 허용치)배 넘게 크면 새 군 */
+      MIL_INT First = 0;
+      for (MIL_INT i = 1; i <= NumResults; i++)
+      {
+         if (i == NumResults || Radii[i] > Radii[First] * (1.0 + 2.0 * MULTI_RADIUS_SCALE_TOLERANCE))
+         {
+            MIL_DOUBLE Sum = 0.0;
+            for (MIL_INT k = First; k < i; k++)
+               Sum += Radii[k];
+            Groups.push_back(std::make_pair(i - First, Sum / (i - First)));
+            First = i;
+         }
+      }
+
+      std::stable_sort(Groups.begin(), Groups.end(),
+                       [](const std::pair<MIL_INT, MIL_DOUBLE>& A, const std::pair<MIL_INT, MIL_DOUBLE>& B)
+                       { return A.first > B.first; });
+      NbModels = std::min((MIL_INT)Groups.size(), MaxModels);
+      for (MIL_INT m = 0; m < NbModels; m++)
+         Nominal[m] = Groups[m].second;
+      std::sort(Nominal, Nominal + NbModels);
+   }
+
+   MmodFree(MilSurveyResult);
+   MmodFree(MilSurveyContext);
+   return NbModels;
+}
+
+void MultiRadiusCircleSearchExample(MIL_ID MilSystem, MIL_ID MilDisplay)
+{
+   MIL_ID     MilImage, GraphicList;
+   MIL_ID     MilMultiContext, MilMultiResult;                /* 다중 모델(1회 탐색) */
+   MIL_ID     MilSingleContext[MULTI_RADIUS_NB_MODELS];       /* 반지름별 단일 모델 */
+   MIL_ID     MilSingleResult;
+   MIL_INT    NumResults = 0L, NumSingleResults, NbModels, m, i, n;
+   MIL_INT    ModelIndex[MULTI_RADIUS_MAX_OCCURRENCES];
+   MIL_INT    NbPerModel[MULTI_RADIUS_NB_MODELS] = { 0 };
+   MIL_DOUBLE ScoreSum[MULTI_RADIUS_NB_MODELS] = { 0.0 }, BestScore[MULTI_RADIUS_NB_MODELS] = { 0.0 };
+   MIL_DOUBLE MultiRadiusNominal[MULTI_RADIUS_NB_MODELS];
+   MIL_DOUBLE Score[MULTI_RADIUS_MAX_OCCURRENCES], XPosition[MULTI_RADIUS_MAX_OCCURRENCES],
+              YPosition[MULTI_RADIUS_MAX_OCCURRENCES], Radius[MULTI_RADIUS_MAX_OCCURRENCES];
+   MIL_DOUBLE MultiTime = 0.0, SequentialTime = 0.0;
+
+   MosPrintf(MIL_TEXT("\nUsing model finder M_SHAPE_CIRCLE with several nominal radii:\n"));
+   MosPrintf(MIL_TEXT("--------------------------------------------------------------\n\n"));
+
+   /* 타깃 로드/표시, 그래픽 리스트 연결 */
+   MbufRestore(MULTI_RADIUS_TARGET_IMAGE, MilSystem, &MilImage);
+   if (MilDisplay) MdispSelect(MilDisplay, MilImage);
+   MgraAllocList(MilSystem, M_DEFAULT, &GraphicList);
+   if (MilDisplay) MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, GraphicList);
+
+   /* 이미지에 실제로 있는 반지름으로 모델 구성 */
+   NbModels = MultiRadiusSurvey(MilSystem, MilImage, MultiRadiusNominal, MULTI_RADIUS_NB_MODELS);
+   if (NbModels == 0)
+   {
+      MosPrintf(MIL_TEXT("No circles were found in the target image.\n\n"));
+      if (MilDisplay) MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, M_NULL);
+      if (MilDisplay) MdispSelect(MilDisplay, M_NULL);
+      MgraFree(GraphicList);
+      MbufFree(MilImage);
+      return;
+   }
+   MosPrintf(MIL_TEXT("%d distinct radii were measured in the target image.\n\n"), (int)NbModels);
+
+   /* 다중 모델 컨텍스트: 반지름마다 M_CIRCLE 모델 1개 */
+   MmodAlloc(MilSystem, M_SHAPE_CIRCLE, M_DEFAULT, &MilMultiContext);
+   MmodAllocResult(MilSystem, M_SHAPE_CIRCLE, &MilMultiResult);
+   for (m = 0; m < NbModels; m++)
+      DefineCircleModel(MilMultiContext, m, MultiRadiusNominal[m]);
+   MmodControl(MilMultiContext, M_CONTEXT, M_DETAIL_LEVEL, M_VERY_HIGH);
+   MmodPreprocess(MilMultiContext, M_DEFAULT);
+
+   /* 비교용: 반지름마다 별도 컨텍스트(기존 예제 방식) */
+   MmodAllocResult(MilSystem, M_SHAPE_CIRCLE, &MilSingleResult);
+   for (m = 0; m < NbModels; m++)
+   {
+      MmodAlloc(MilSystem, M_SHAPE_CIRCLE, M_DEFAULT, &MilSingleContext[m]);
+      DefineCircleModel(MilSingleContext[m], 0, MultiRadiusNominal[m]);
+      MmodControl(MilSingleContext[m], M_CONTEXT, M_DETAIL_LEVEL, M_VERY_HIGH);
+      MmodPreprocess(MilSingleContext[m], M_DEFAULT);
+   }
+
+   /* 워밍업(첫 호출 지연 제거) */
+   MmodFind(MilMultiContext, MilImage, MilMultiResult);
+   for (m = 0; m < NbModels; m++)
+      MmodFind(MilSingleContext[m], MilImage, MilSingleResult);
+
+   /* (1) 다중 모델: 이미지당 MmodFind 1회 */
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (n = 0; n < MULTI_RADIUS_NB_LOOP; n++)
+      MmodFind(MilMultiContext, MilImage, MilMultiResult);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &MultiTime);
+
+   /* (2) 순차 단일 모델: 이미지당 MmodFind N회 */
+   NumSingleResults = 0;
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (n = 0; n < MULTI_RADIUS_NB_LOOP; n++)
+   {
+      for (m = 0; m < NbModels; m++)
+         MmodFind(MilSingleContext[m], MilImage, MilSingleResult);
+   }
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &SequentialTime);
+
+   /* 순차 방식의 총 발생 수(결과 일치 확인용) */
+   for (m = 0; m < NbModels; m++)
+   {
+      MIL_INT NumModelResults = 0;
+      MmodFind(MilSingleContext[m], MilImage, MilSingleResult);
+      MmodGetResult(MilSingleResult, M_DEFAULT, M_NUMBER + M_TYPE_MIL_INT, &NumModelResults);
+      NumSingleResults += NumModelResults;
+   }
+
+   /* 다중 모델 결과를 M_INDEX(모델 인덱스)로 분리 */
+   MmodGetResult(MilMultiResult, M_DEFAULT, M_NUMBER + M_TYPE_MIL_INT, &NumResults);
+   if ((NumResults >= 1) && (NumResults <= MULTI_RADIUS_MAX_OCCURRENCES))
+   {
+      MmodGetResult(MilMultiResult, M_DEFAULT, M_INDEX + M_TYPE_MIL_INT, ModelIndex);
+      MmodGetResult(MilMultiResult, M_DEFAULT, M_POSITION_X, XPosition);
+      MmodGetResult(MilMultiResult, M_DEFAULT, M_POSITION_Y, YPosition);
+      MmodGetResult(MilMultiResult, M_DEFAULT, M_RADIUS,     Radius);
+      MmodGetResult(MilMultiResult, M_DEFAULT, M_SCORE,      Score);
+
+      for (i = 0; i < NumResults; i++)
+      {
+         if ((ModelIndex[i] >= 0) && (ModelIndex[i] < NbModels))
+         {
+            NbPerModel[ModelIndex[i]]++;
+            ScoreSum[ModelIndex[i]] += Score[i];
+            BestScore[ModelIndex[i]] = std::max(BestScore[ModelIndex[i]], Score[i]);
+         }
+      }
+
+      /* 1회 탐색 결과를 모델 인덱스별로 보고 */
+      MosPrintf(MIL_TEXT("Model   Nominal radius   Occurrences   Mean score   Best score\n\n"));
+      for (m = 0; m < NbModels; m++)
+      {
+         MosPrintf(MIL_TEXT("%-8d%-17.1f%-14d%-13.2f%.2f\n"), (int)m, MultiRadiusNominal[m], (int)NbPerModel[m],
+                   NbPerModel[m] > 0 ? ScoreSum[m] / NbPerModel[m] : 0.0, BestScore[m]);
+      }
+      MosPrintf(MIL_TEXT("\n"));
+
+      /* 전체 결과 오버레이(점수 구간별 색) */
+      CIRCLE_OVERLAY_BATCH OverlayBatch;
+      OverlayBatchBuild(OverlayBatch, NumResults, XPosition, YPosition, Radius, Score,
+                        0.0, OVERLAY_DRAW_ALL);
+      OverlayBatchDraw(OverlayBatch, GraphicList);
+   }
+   else
+   {
+      MosPrintf(MIL_TEXT("The circles were not found or too many occurrences!\n\n"));
+   }
+
+   MosPrintf(MIL_TEXT("Single context, %d models (1 MmodFind):     %.2f ms/image, %d occurrences\n"),
+             (int)NbModels, MultiTime * 1000.0 / MULTI_RADIUS_NB_LOOP, (int)NumResults);
+   MosPrintf(MIL_TEXT("%d single-model contexts (%d MmodFind): %.2f ms/image, %d occurrences\n"),
+             (int)NbModels, (int)NbModels,
+             SequentialTime * 1000.0 / MULTI_RADIUS_NB_LOOP, (int)NumSingleResults);
+   if (MultiTime > 0.0)
+      MosPrintf(MIL_TEXT("The single-pass search is %.1f times faster.\n\n"), SequentialTime / MultiTime);
+
+   MosPrintf(MIL_TEXT("Press any key to continue.\n\n"));
+   WaitForKey(0);
+
+   /* 해제 */
+   if (MilDisplay) MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, M_NULL);
+   if (MilDisplay) MdispSelect(MilDisplay, M_NULL);
+   for (m = 0; m < NbModels; m++)
+      MmodFree(MilSingleContext[m]);
+   MmodFree(MilSingleResult);
+   MmodFree(MilMultiResult);
+   MmodFree(MilMultiContext);
+   MgraFree(GraphicList);
+   MbufFree(MilImage);
+}
+
+/******************************************************************************/
+/* [추적 예제] 컨베이어 영상에서 예측 ROI + 좁은 스케일 범위로 원 추적         */
+/******************************************************************************/
+#define TRACK_TARGET_IMAGE          SIMPLE_CIRCLE_SEARCH_TARGET_IMAGE
+#define TRACK_MODEL_RADIUS          30.0
+#define TRACK_FULL_MIN_SCALE        0.8      /* 전체 탐색 스케일 범위 */
+#define TRACK_FULL_MAX_SCALE        1.25
+#define TRACK_SCALE_TOLERANCE       0.05     /* 추적 탐색 스케일 범위: 예측 ± 5% */
+#define TRACK_NB_SCALE_BINS         6L       /* 전체 범위를 덮는 추적 컨텍스트 수 */
+#define TRACK_ROI_MARGIN            8.0      /* 예측 오차 여유(픽셀) */
+#define TRACK_MAX_MISSES            2L       /* 연속 미검출 허용 횟수 → 초과 시 주변 재탐색 */
+#define TRACK_DISCOVERY_PERIOD      10L      /* 기본 발견 탐색 주기(프레임), 0이면 트랙이 없을 때만 */
+#define TRACK_VELOCITY_GAIN         0.5      /* 속도 갱신 가중치(알파 필터) */
+#define TRACK_MAX_TRACKS            MODEL_MAX_OCCURRENCES
+#define TRACK_NB_FRAMES             200L
+#define TRACK_MOTION_AMPLITUDE      40.0     /* 시뮬 컨베이어 흔들림 진폭(픽셀) */
+#define TRACK_MOTION_PERIOD         100.0    /* 진동 주기(프레임) */
+
+typedef struct
+{
+   MIL_DOUBLE X, Y;         /* 마지막 위치 */
+   MIL_DOUBLE Vx, Vy;       /* 프레임당 속도 */
+   MIL_DOUBLE Radius;
+   MIL_DOUBLE Score;
+   MIL_INT    Misses;       /* 연속 미검출 횟수 */
+} CIRCLE_TRACK;
+
+typedef struct
+{
+   MIL_ID  FullContext;                          /* 발견 탐색 / 손실 트랙 주변 재탐색(전체 스케일) */
+   MIL_ID  TrackContext[TRACK_NB_SCALE_BINS];    /* 스케일 구간별(사전처리 1회) 좁은 범위 탐색 */
+   MIL_DOUBLE BinScale[TRACK_NB_SCALE_BINS];
+   MIL_ID  Result;
+   MIL_ID  RoiChild;                             /* 예측 ROI(MbufChildMove로 재사용) */
+   MIL_INT ImageSizeX, ImageSizeY;
+   MIL_INT DiscoveryPeriod;                      /* 전체 영상 발견 탐색 주기(프레임), 0이면 트랙이 없을 때만 */
+   MIL_INT NbFrames;
+   MIL_INT NbFullSearches, NbRoiSearches, NbReacquireSearches;
+   MIL_INT NbTracksLost, NbTracksLeft;
+   std::vector<CIRCLE_TRACK> Tracks;
+} CIRCLE_TRACKER;
+
+void CircleTrackerAlloc(MIL_ID MilSystem, MIL_ID MilFrame, MIL_INT DiscoveryPeriod, CIRCLE_TRACKER& Tracker)
+{
+   Tracker.ImageSizeX = MbufInquire(MilFrame, M_SIZE_X, M_NULL);
+   Tracker.ImageSizeY = MbufInquire(MilFrame, M_SIZE_Y, M_NULL);
+   Tracker.DiscoveryPeriod = DiscoveryPeriod;
+   Tracker.NbFrames       = 0;
+   Tracker.NbFullSearches = 0;
+   Tracker.NbRoiSearches  = 0;
+   Tracker.NbReacquireSearches = 0;
+   Tracker.NbTracksLost   = 0;
+   Tracker.NbTracksLeft   = 0;
+   Tracker.Tracks.reserve(TRACK_MAX_TRACKS);
+
+   MmodAllocResult(MilSystem, M_SHAPE_CIRCLE, &Tracker.Result);
+
+   /* 전체 탐색 컨텍스트 */
+   MmodAlloc(MilSystem, M_SHAPE_CIRCLE, M_DEFAULT, &Tracker.FullContext);
+   MmodDefine(Tracker.FullContext, M_CIRCLE, M_DEFAULT, TRACK_MODEL_RADIUS, M_DEFAULT, M_DEFAULT, M_DEFAULT);
+   MmodControl(Tracker.FullContext, 0, M_SCALE_MIN_FACTOR, TRACK_FULL_MIN_SCALE);
+   MmodControl(Tracker.FullContext, 0, M_SCALE_MAX_FACTOR, TRACK_FULL_MAX_SCALE);
+   MmodControl(Tracker.FullContext, M_DEFAULT, M_NUMBER, TRACK_MAX_TRACKS);
+   MmodPreprocess(Tracker.FullContext, M_DEFAULT);
+
+   /* 추적 컨텍스트: 구간 중심 스케일(M_SCALE) ± 허용치, 발생 1개.
+      프레임마다 스케일을 바꿔 다시 사전처리하지 않도록 구간별로 미리 준비 */
+   MIL_DOUBLE Ratio = pow(TRACK_FULL_MAX_SCALE / TRACK_FULL_MIN_SCALE, 1.0 / TRACK_NB_SCALE_BINS);
+   for (MIL_INT b = 0; b < TRACK_NB_SCALE_BINS; b++)
+   {
+      Tracker.BinScale[b] = TRACK_FULL_MIN_SCALE * pow(Ratio, b + 0.5);
+      MmodAlloc(MilSystem, M_SHAPE_CIRCLE, M_DEFAULT, &Tracker.TrackContext[b]);
+      MmodDefine(Tracker.TrackContext[b], M_CIRCLE, M_DEFAULT, TRACK_MODEL_RADIUS, M_DEFAULT, M_DEFAULT, M_DEFAULT);
+      MmodControl(Tracker.TrackContext[b], 0, M_SCALE,            Tracker.BinScale[b]);
+      MmodControl(Tracker.TrackContext[b], 0, M_SCALE_MIN_FACTOR, (1.0 - TRACK_SCALE_TOLERANCE) / sqrt(Ratio));
+      MmodControl(Tracker.TrackContext[b], 0, M_SCALE_MAX_FACTOR, (1.0 + TRACK_SCALE_TOLERANCE) * sqrt(Ratio));
+      MmodControl(Tracker.TrackContext[b], M_DEFAULT, M_NUMBER, 1);
+      MmodPreprocess(Tracker.TrackContext[b], M_DEFAULT);
+   }
+
+   /* ROI Child: 크기/위치는 탐색마다 MbufChildMove로 변경 */
+   MbufChild2d(MilFrame, 0, 0, 1, 1, &Tracker.RoiChild);
+}
+
+void CircleTrackerFree(CIRCLE_TRACKER& Tracker)
+{
+   MbufFree(Tracker.RoiChild);
+   for (MIL_INT b = 0; b < TRACK_NB_SCALE_BINS; b++)
+      MmodFree(Tracker.TrackContext[b]);
+   MmodFree(Tracker.FullContext);
+   MmodFree(Tracker.Result);
+}
+
+/* ROI 설정: (CenterX, CenterY) ± HalfSize를 영상 안으로 잘라 RoiChild를 이동.
+   잘린 ROI가 MinSize보다 작으면 false(탐색할 만큼 보이지 않음) */
+static bool CircleTrackerMoveRoi(CIRCLE_TRACKER& Tracker, MIL_DOUBLE CenterX, MIL_DOUBLE CenterY,
+                                 MIL_DOUBLE HalfSize, MIL_DOUBLE MinSize, MIL_INT& OffX, MIL_INT& OffY)
+{
+   MIL_INT EndX = (MIL_INT)(CenterX + HalfSize), EndY = (MIL_INT)(CenterY + HalfSize);
+   OffX = (MIL_INT)(CenterX - HalfSize);
+   OffY = (MIL_INT)(CenterY - HalfSize);
+   OffX = (OffX < 0) ? 0 : OffX;
+   OffY = (OffY < 0) ? 0 : OffY;
+   EndX = (EndX > Tracker.ImageSizeX - 1) ? Tracker.ImageSizeX - 1 : EndX;
+   EndY = (EndY > Tracker.ImageSizeY - 1) ? Tracker.ImageSizeY - 1 : EndY;
+   MIL_INT SizeX = EndX - OffX + 1, SizeY = EndY - OffY + 1;
+   if (SizeX < MinSize || SizeY < MinSize)
+      return false;
+   MbufChildMove(Tracker.RoiChild, OffX, OffY, SizeX, SizeY, M_DEFAULT);
+   return true;
+}
+
+/* 탐색 결과 중 (PredX, PredY)에 가장 가까운 발생 → 영상 좌표로 반환 */
+static bool CircleTrackerNearest(CIRCLE_TRACKER& Tracker, MIL_INT OffX, MIL_INT OffY,
+                                 MIL_DOUBLE PredX, MIL_DOUBLE PredY, CIRCLE_TRACK& Found)
+{
+   MIL_INT NumResults = 0, Best = -1;
+   MIL_DOUBLE BestDist = 0.0;
+   MmodGetResult(Tracker.Result, M_DEFAULT, M_NUMBER + M_TYPE_MIL_INT, &NumResults);
+   for (MIL_INT i = 0; i < NumResults; i++)
+   {
+      MIL_DOUBLE X, Y;
+      MmodGetResult(Tracker.Result, i, M_POSITION_X, &X);
+      MmodGetResult(Tracker.Result, i, M_POSITION_Y, &Y);
+      MIL_DOUBLE Dist = (X + OffX - PredX) * (X + OffX - PredX) + (Y + OffY - PredY) * (Y + OffY - PredY);
+      if (Best < 0 || Dist < BestDist)
+      {
+         Best = i;
+         BestDist = Dist;
+      }
+   }
+   if (Best < 0)
+      return false;
+   MmodGetResult(Tracker.Result, Best, M_POSITION_X, &Found.X);
+   MmodGetResult(Tracker.Result, Best, M_POSITION_Y, &Found.Y);
+   MmodGetResult(Tracker.Result, Best, M_RADIUS,     &Found.Radius);
+   MmodGetResult(Tracker.Result, Best, M_SCORE,      &Found.Score);
+   Found.X += OffX;
+   Found.Y += OffY;
+   return true;
+}
+
+/* 발견 탐색: 전체 영상을 탐색해 기존 트랙과 겹치지 않는 원만 새 트랙으로 추가
+   - 트랙이 없을 때, 그리고 DiscoveryPeriod 프레임마다 실행(새로 들어온 원 포착)
+   - 영상 크기에 비례하는 비용이므로 추적만 한 프레임과 따로 집계 */
+static void CircleTrackerDiscover(CIRCLE_TRACKER& Tracker, MIL_ID MilFrame)
+{
+   MIL_INT    NumResults = 0;
+   MIL_DOUBLE XPosition[TRACK_MAX_TRACKS], YPosition[TRACK_MAX_TRACKS],
+              Radius[TRACK_MAX_TRACKS], Score[TRACK_MAX_TRACKS];
+
+   MmodFind(Tracker.FullContext, MilFrame, Tracker.Result);
+   MmodGetResult(Tracker.Result, M_DEFAULT, M_NUMBER + M_TYPE_MIL_INT, &NumResults);
+   if (NumResults > TRACK_MAX_TRACKS)
+      NumResults = TRACK_MAX_TRACKS;
+   if (NumResults > 0)
+   {
+      MmodGetResult(Tracker.Result, M_DEFAULT, M_POSITION_X, XPosition);
+      MmodGetResult(Tracker.Result, M_DEFAULT, M_POSITION_Y, YPosition);
+      MmodGetResult(Tracker.Result, M_DEFAULT, M_RADIUS,     Radius);
+      MmodGetResult(Tracker.Result, M_DEFAULT, M_SCORE,      Score);
+   }
+
+   size_t NbExisting = Tracker.Tracks.size();
+   for (MIL_INT i = 0; i < NumResults && (MIL_INT)Tracker.Tracks.size() < TRACK_MAX_TRACKS; i++)
+   {
+      /* 기존 트랙의 반지름 이내면 같은 원 → 건너뜀 */
+      bool Known = false;
+      for (size_t t = 0; t < NbExisting && !Known; t++)
+      {
+         const CIRCLE_TRACK& Old = Tracker.Tracks[t];
+         MIL_DOUBLE Dx = XPosition[i] - Old.X, Dy = YPosition[i] - Old.Y;
+         Known = (Dx * Dx + Dy * Dy < Old.Radius * Old.Radius);
+      }
+      if (!Known)
+      {
+         CIRCLE_TRACK Track = { XPosition[i], YPosition[i], 0.0, 0.0, Radius[i], Score[i], 0 };
+         Tracker.Tracks.push_back(Track);
+      }
+   }
+   Tracker.NbFullSearches++;
+}
+
+/* 한 프레임 처리
+   - 트랙별 예측 ROI(영상 경계로 자름)에서 좁은 스케일 범위로 탐색
+   - 미검출이 TRACK_MAX_MISSES를 넘으면 그 트랙의 넓힌 ROI만 전체 스케일로 재탐색,
+     그래도 없으면 트랙 제거(전체 영상 재탐색 없음)
+   - 예측 중심이 영상 밖이면 시야를 벗어난 것으로 보고 제거(미검출로 세지 않음)
+   - 트랙이 없거나 DiscoveryPeriod 프레임마다 발견 탐색으로 새 원 추가(실행했으면 true 반환) */
+bool CircleTrackerProcess(CIRCLE_TRACKER& Tracker, MIL_ID MilFrame)
+{
+   std::vector<CIRCLE_TRACK> Kept;
+   Kept.reserve(Tracker.Tracks.size());
+
+   for (size_t t = 0; t < Tracker.Tracks.size(); t++)
+   {
+      CIRCLE_TRACK Track = Tracker.Tracks[t];
+
+      /* 등속 예측 */
+      MIL_DOUBLE PredX = Track.X + Track.Vx;
+      MIL_DOUBLE PredY = Track.Y + Track.Vy;
+      if (PredX < 0.0 || PredY < 0.0 || PredX >= Tracker.ImageSizeX || PredY >= Tracker.ImageSizeY)
+      {
+         Tracker.NbTracksLeft++;
+         continue;
+      }
+
+      /* ROI: 예측 반지름의 최대 스케일 + 여유, 영상 밖 부분은 잘라냄(원이 절반 이상 보이면 탐색) */
+      MIL_DOUBLE HalfSize = Track.Radius * (1.0 + 2.0 * TRACK_SCALE_TOLERANCE) + TRACK_ROI_MARGIN;
+      MIL_INT OffX, OffY;
+      CIRCLE_TRACK Found;
+      bool Detected = false;
+      if (CircleTrackerMoveRoi(Tracker, PredX, PredY, HalfSize, Track.Radius, OffX, OffY))
+      {
+         /* 예측 스케일에 가장 가까운 구간의 컨텍스트 선택 */
+         MIL_DOUBLE Scale = Track.Radius / TRACK_MODEL_RADIUS;
+         MIL_INT Bin = 0;
+         for (MIL_INT b = 1; b < TRACK_NB_SCALE_BINS; b++)
+         {
+            if (fabs(Tracker.BinScale[b] - Scale) < fabs(Tracker.BinScale[Bin] - Scale))
+               Bin = b;
+         }
+         MmodFind(Tracker.TrackContext[Bin], Tracker.RoiChild, Tracker.Result);
+         Tracker.NbRoiSearches++;
+         Detected = CircleTrackerNearest(Tracker, OffX, OffY, PredX, PredY, Found);
+      }
+
+      /* 허용 횟수 초과: 이 트랙 주변만 넓혀 전체 스케일 범위로 재탐색 */
+      if (!Detected && Track.Misses + 1 > TRACK_MAX_MISSES)
+      {
+         MIL_DOUBLE WideHalfSize = TRACK_MODEL_RADIUS * TRACK_FULL_MAX_SCALE
+                                 + (1 + Track.Misses) * (fabs(Track.Vx) + fabs(Track.Vy))
+                                 + 2.0 * TRACK_ROI_MARGIN;
+         if (CircleTrackerMoveRoi(Tracker, PredX, PredY, WideHalfSize, Track.Radius, OffX, OffY))
+         {
+            MmodFind(Tracker.FullContext, Tracker.RoiChild, Tracker.Result);
+            Tracker.NbReacquireSearches++;
+            Detected = CircleTrackerNearest(Tracker, OffX, OffY, PredX, PredY, Found);
+         }
+         if (!Detected)
+         {
+            Tracker.NbTracksLost++;
+            continue;
+         }
+      }
+
+      if (Detected)
+      {
+         /* 속도 갱신(알파 필터) 후 위치 확정 */
+         Track.Vx += TRACK_VELOCITY_GAIN * ((Found.X - Track.X) - Track.Vx);
+         Track.Vy += TRACK_VELOCITY_GAIN * ((Found.Y - Track.Y) - Track.Vy);
+         Track.X = Found.X;
+         Track.Y = Found.Y;
+         Track.Radius = Found.Radius;
+         Track.Score = Found.Score;
+         Track.Misses = 0;
+      }
+      else
+      {
+         /* 미검출: 예측으로 진행 */
+         Track.X = PredX;
+         Track.Y = PredY;
+         Track.Misses++;
+      }
+      Kept.push_back(Track);
+   }
+   Tracker.Tracks.swap(Kept);
+
+   bool Discover = Tracker.Tracks.empty() ||
+                   (Tracker.DiscoveryPeriod > 0 && (Tracker.NbFrames % Tracker.DiscoveryPeriod) == 0);
+   if (Discover)
+      CircleTrackerDiscover(Tracker, MilFrame);
+   Tracker.NbFrames++;
+   return Discover;
+}
+
+void CircleTrackingExample(MIL_ID MilSystem, MIL_ID MilDisplay)
+{
+   MIL_ID     MilSource, MilFrame, GraphicList;
+   MIL_DOUBLE Time, TrackTime = 0.0, DiscoveryTime = 0.0, FullTime = 0.0;
+   MIL_INT    n, NbTrackFrames = 0, NbDiscoveryFrames = 0;
+   CIRCLE_TRACKER Tracker;
+
+   MosPrintf(MIL_TEXT("\nTracking circles on a moving conveyor:\n"));
+   MosPrintf(MIL_TEXT("--------------------------------------\n\n"));
+
+   /* 원본 + 프레임 버퍼(컨베이어 이동을 MimTranslate로 시뮬) */
+   MbufRestore(TRACK_TARGET_IMAGE, MilSystem, &MilSource);
+   MbufRestore(TRACK_TARGET_IMAGE, MilSystem, &MilFrame);
+   if (MilDisplay) MdispSelect(MilDisplay, MilFrame);
+   MgraAllocList(MilSystem, M_DEFAULT, &GraphicList);
+   if (MilDisplay) MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, GraphicList);
+
+   CircleTrackerAlloc(MilSystem, MilFrame, TRACK_DISCOVERY_PERIOD, Tracker);
+
+   for (n = 0; n < TRACK_NB_FRAMES; n++)
+   {
+      /* 다음 프레임 생성 */
+      MIL_DOUBLE Phase = 2.0 * 3.14159265358979323846 * n / TRACK_MOTION_PERIOD;
+      MimTranslate(MilSource, MilFrame, TRACK_MOTION_AMPLITUDE * sin(Phase),
+                   0.25 * TRACK_MOTION_AMPLITUDE * sin(2.0 * Phase), M_BILINEAR + M_OVERSCAN_CLEAR);
+
+      /* (1) 추적 모드: 발견 탐색이 섞인 프레임은 따로 집계 */
+      MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+      bool Discovered = CircleTrackerProcess(Tracker, MilFrame);
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+      if (Discovered)
+      {
+         DiscoveryTime += Time;
+         NbDiscoveryFrames++;
+      }
+      else
+      {
+         TrackTime += Time;
+         NbTrackFrames++;
+      }
+
+      /* (2) 비교: 매 프레임 전체 탐색 */
+      MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+      MmodFind(Tracker.FullContext, MilFrame, Tracker.Result);
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+      FullTime += Time;
+
+      /* 현재 트랙 표시 */
+      std::vector<MIL_DOUBLE> X, Y, R, S;
+      for (size_t t = 0; t < Tracker.Tracks.size(); t++)
+      {
+         X.push_back(Tracker.Tracks[t].X);
+         Y.push_back(Tracker.Tracks[t].Y);
+         R.push_back(Tracker.Tracks[t].Radius);
+         S.push_back(Tracker.Tracks[t].Score);
+      }
+      MgraClear(M_DEFAULT, GraphicList);
+      if (!X.empty())
+      {
+         CIRCLE_OVERLAY_BATCH OverlayBatch;
+         OverlayBatchBuild(OverlayBatch, (MIL_INT)X.size(), &X[0], &Y[0], &R[0], &S[0],
+                           0.0, OVERLAY_DRAW_POSITION + OVERLAY_DRAW_CIRCLE);
+         OverlayBatchDraw(OverlayBatch, GraphicList);
+      }
+      MosPrintf(MIL_TEXT("Frame %3d: %2d tracks.\r"), (int)n, (int)Tracker.Tracks.size());
+   }
+
+   MosPrintf(MIL_TEXT("\n\nImage size: %d x %d, %d frames.\n"),
+             (int)Tracker.ImageSizeX, (int)Tracker.ImageSizeY, (int)TRACK_NB_FRAMES);
+   MosPrintf(MIL_TEXT("Full search every frame: %.2f ms/frame\n"), FullTime * 1000.0 / TRACK_NB_FRAMES);
+   MosPrintf(MIL_TEXT("Tracking mode, overall:  %.2f ms/frame\n"),
+             (TrackTime + DiscoveryTime) * 1000.0 / TRACK_NB_FRAMES);
+   MosPrintf(MIL_TEXT("  Tracked-only frames:   %.2f ms/frame (%d frames)\n"),
+             NbTrackFrames > 0 ? TrackTime * 1000.0 / NbTrackFrames : 0.0, (int)NbTrackFrames);
+   MosPrintf(MIL_TEXT("  Discovery frames:      %.2f ms/frame (%d frames, period %d)\n"),
+             NbDiscoveryFrames > 0 ? DiscoveryTime * 1000.0 / NbDiscoveryFrames : 0.0, (int)NbDiscoveryFrames,
+             (int)Tracker.DiscoveryPeriod);
+   MosPrintf(MIL_TEXT("  %d ROI searches, %d lost-track ROI re-searches, %d discovery searches\n"),
+             (int)Tracker.NbRoiSearches, (int)Tracker.NbReacquireSearches, (int)Tracker.NbFullSearches);
+   MosPrintf(MIL_TEXT("  %d tracks lost, %d tracks left the field of view.\n\n"),
+             (int)Tracker.NbTracksLost, (int)Tracker.NbTracksLeft);
+
+   MosPrintf(MIL_TEXT("Press any key to end.\n\n"));
+   WaitForKey(0);
+
+   /* 해제 */
+   CircleTrackerFree(Tracker);
+   if (MilDisplay) MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, M_NULL);
+   if (MilDisplay) MdispSelect(MilDisplay, M_NULL);
+   MgraFree(GraphicList);
+   MbufFree(MilFrame);
+   MbufFree(MilSource);
+}
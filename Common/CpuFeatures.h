@@ -0,0 +1,94 @@
+﻿/*************************************************************************************/
+/*
+ * 파일명: CpuFeatures.h
+ *
+ * 개요:
+ *   - 예제 공용 CPU 기능 판별: AVX2/SSSE3 커널을 /arch 설정 없이 빌드하고 실행 시점에 선택.
+ *
+ * 핵심 요약:
+ *   - AVX2_TARGET: AVX2 커널 함수에 붙이는 지정자.
+ *       MSVC는 /arch 설정과 무관하게 AVX2 인트린식을 컴파일하므로 비어 있음,
+ *       GCC/Clang은 함수 단위 target("avx2") 속성.
+ *   - SSSE3_TARGET: SSSE3(pshufb) 커널 함수 지정자(MSVC는 비어 있음, GCC/Clang은 target("ssse3")).
+ *       __SSSE3__ 같은 컴파일러 매크로는 MSVC가 정의하지 않으므로 빌드 옵션으로 고르지 않음.
+ *   - CPU_HAS_AVX2_KERNEL, CPU_HAS_SSSE3_KERNEL: x86/x64 빌드에서만 1(그 외에는 스칼라 경로만 빌드).
+ *   - CpuHasAvx2(): CPUID(AVX2) + OS의 YMM 레지스터 저장 지원(XGETBV)을 한 번 확인해 캐시.
+ *   - CpuHasSsse3(): CPUID(SSSE3)를 한 번 확인해 캐시.
+ *   - 같은 바이너리가 AVX2 없는 PC에서도 스칼라 경로로 동작.
+ *
+ * 저작권:
+ *   © Matrox Electronic Systems Ltd., 1992-2025. All Rights Reserved
+ */
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define CPU_HAS_AVX2_KERNEL  1
+#define CPU_HAS_SSSE3_KERNEL 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define AVX2_TARGET
+#define SSSE3_TARGET
+#else
+#define AVX2_TARGET  __attribute__((target("avx2")))
+#define SSSE3_TARGET __attribute__((target("ssse3")))
+#endif
+#else
+#define CPU_HAS_AVX2_KERNEL  0
+#define CPU_HAS_SSSE3_KERNEL 0
+#define AVX2_TARGET
+#define SSSE3_TARGET
+#endif
+
+/* AVX2 사용 가능 여부(첫 호출에서 한 번 판별) */
+inline bool CpuHasAvx2()
+{
+#if !CPU_HAS_AVX2_KERNEL
+   return false;
+#elif defined(_MSC_VER)
+   static const bool HasAvx2 = []()
+   {
+      int Info[4];
+      __cpuid(Info, 0);
+      if (Info[0] < 7)
+         return false;
+
+      /* AVX + OSXSAVE, 그리고 OS가 XMM/YMM 상태를 저장하는지(XCR0 비트 1, 2) */
+      __cpuid(Info, 1);
+      const int OsxSave = 1 << 27, Avx = 1 << 28;
+      if ((Info[2] & (OsxSave | Avx)) != (OsxSave | Avx))
+         return false;
+      if ((_xgetbv(0) & 0x6) != 0x6)
+         return false;
+
+      __cpuidex(Info, 7, 0);
+      return (Info[1] & (1 << 5)) != 0;   /* EBX 비트 5: AVX2 */
+   }();
+   return HasAvx2;
+#else
+   static const bool HasAvx2 = (__builtin_cpu_supports("avx2") != 0);
+   return HasAvx2;
+#endif
+}
+
+/* SSSE3 사용 가능 여부(첫 호출에서 한 번 판별) */
+inline bool CpuHasSsse3()
+{
+#if !CPU_HAS_SSSE3_KERNEL
+   return false;
+#elif defined(_MSC_VER)
+   static const bool HasSsse3 = []()
+   {
+      int Info[4];
+      __cpuid(Info, 1);
+      return (Info[2] & (1 << 9)) != 0;   /* ECX 비트 9: SSSE3 */
+   }();
+   return HasSsse3;
+#else
+   static const bool HasSsse3 = (__builtin_cpu_supports("ssse3") != 0);
+   return HasSsse3;
+#endif
+}
+
+#endif /* CPU_FEATURES_H */
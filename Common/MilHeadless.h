@@ -0,0 +1,54 @@
+﻿/*************************************************************************************/
+/*
+ * 파일명: MilHeadless.h
+ *
+ * 개요:
+ *   - 예제 공용 헤드리스(화면 없음) 실행 지원: 모니터 없는 검사 서버에서는 MIL_HEADLESS=1로 빌드.
+ *
+ * 핵심 요약:
+ *   - MIL_HEADLESS: 기본값 0. vcxproj는 MilHeadless.props(msbuild /p:MilHeadless=true)로,
+ *     그 밖의 빌드는 /DMIL_HEADLESS=1로 켬.
+ *   - DISPLAY_ATTRIBUTE: 이미지 버퍼 할당 속성(헤드리스면 0, 아니면 M_DISP).
+ *   - WaitForKey(HeadlessKey): 키 대기. 헤드리스면 막지 않고 눌린 키가 없으면 HeadlessKey 반환.
+ *   - WaitForStop(HeadlessTime): 연속 취득/처리 정지 대기. 헤드리스면 HeadlessTime초 후 진행.
+ *
+ * 저작권:
+ *   © Matrox Electronic Systems Ltd., 1992-2025. All Rights Reserved
+ */
+#ifndef MIL_HEADLESS_H
+#define MIL_HEADLESS_H
+
+#include <mil.h>
+
+#ifndef MIL_HEADLESS
+#define MIL_HEADLESS 0
+#endif
+
+#if MIL_HEADLESS
+#define DISPLAY_ATTRIBUTE 0
+#else
+#define DISPLAY_ATTRIBUTE M_DISP
+#endif
+
+/* 키 대기: 헤드리스 모드에서는 막지 않고, 눌린 키가 없으면 HeadlessKey 반환 */
+inline MIL_INT WaitForKey(MIL_INT HeadlessKey)
+{
+#if MIL_HEADLESS
+   return MosKbhit() ? MosGetch() : HeadlessKey;
+#else
+   return MosGetch();
+#endif
+}
+
+/* 정지 대기: 헤드리스 모드에서는 HeadlessTime초 동안만 계속한 뒤 진행 */
+inline void WaitForStop(MIL_DOUBLE HeadlessTime)
+{
+#if MIL_HEADLESS
+   MappTimer(M_DEFAULT, M_TIMER_WAIT, &HeadlessTime);
+   WaitForKey(0);
+#else
+   MosGetch();
+#endif
+}
+
+#endif /* MIL_HEADLESS_H */
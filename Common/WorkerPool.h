@@ -0,0 +1,127 @@
+﻿/*************************************************************************************/
+/*
+ * 파일명: WorkerPool.h
+ *
+ * 개요:
+ *   - 예제 공용 상주 작업자 스레드 풀: 프레임마다 std::thread를 만들고 join하는 비용 없이
+ *     작업(행 띠, 타일 등)을 여러 코어에 나눠 실행.
+ *
+ * 핵심 요약:
+ *   - WorkerPoolAlloc(Pool, NbThreads): NbThreads - 1개의 작업자 생성(호출 스레드가 나머지 1개).
+ *   - WorkerPoolRun(Pool, NbTasks, Task): Task(0 .. NbTasks-1)를 풀에서 나눠 실행하고
+ *     모두 끝나면 반환. 작업 번호는 원자적 카운터로 배분(먼저 끝난 스레드가 다음 작업).
+ *   - WorkerPoolFree(Pool): 작업자 종료 후 join.
+ *   - 한 풀에서 동시에 WorkerPoolRun을 호출하지 않음(호출자 1개 기준).
+ *
+ * 저작권:
+ *   © Matrox Electronic Systems Ltd., 1992-2025. All Rights Reserved
+ */
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+#include <mil.h>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+typedef struct WORKER_POOL
+{
+   std::vector<std::thread>      Threads;
+   std::mutex                    Lock;
+   std::condition_variable       Wake;         /* 새 작업 배치 알림 */
+   std::condition_variable       Done;         /* 작업자 전원 완료 알림 */
+   std::function<void(MIL_INT)>  Task;
+   MIL_INT                       NbTasks;
+   std::atomic<MIL_INT>          NextTask;
+   MIL_INT                       NbBusy;       /* 현재 배치를 아직 끝내지 않은 작업자 수 */
+   MIL_UINT64                    Generation;   /* 배치 번호(작업자가 새 배치를 구분) */
+   bool                          Stop;
+} WORKER_POOL;
+
+/* 남은 작업 번호를 가져가며 실행 */
+inline void WorkerPoolDrain(WORKER_POOL& Pool)
+{
+   for (MIL_INT Index = Pool.NextTask++; Index < Pool.NbTasks; Index = Pool.NextTask++)
+      Pool.Task(Index);
+}
+
+inline void WorkerPoolThread(WORKER_POOL* Pool)
+{
+   MIL_UINT64 Seen = 0;
+   for (;;)
+   {
+      {
+         std::unique_lock<std::mutex> Guard(Pool->Lock);
+         Pool->Wake.wait(Guard, [&]() { return Pool->Stop || Pool->Generation != Seen; });
+         if (Pool->Stop)
+            return;
+         Seen = Pool->Generation;
+      }
+
+      WorkerPoolDrain(*Pool);
+
+      std::lock_guard<std::mutex> Guard(Pool->Lock);
+      if (--Pool->NbBusy == 0)
+         Pool->Done.notify_one();
+   }
+}
+
+inline void WorkerPoolAlloc(WORKER_POOL& Pool, MIL_INT NbThreads)
+{
+   Pool.NbTasks    = 0;
+   Pool.NextTask   = 0;
+   Pool.NbBusy     = 0;
+   Pool.Generation = 0;
+   Pool.Stop       = false;
+   for (MIL_INT t = 1; t < NbThreads; t++)
+      Pool.Threads.push_back(std::thread(WorkerPoolThread, &Pool));
+}
+
+/* 풀의 스레드 수(호출 스레드 포함) */
+inline MIL_INT WorkerPoolSize(const WORKER_POOL& Pool)
+{
+   return (MIL_INT)Pool.Threads.size() + 1;
+}
+
+inline void WorkerPoolRun(WORKER_POOL& Pool, MIL_INT NbTasks, const std::function<void(MIL_INT)>& Task)
+{
+   /* 작업이 1개이거나 작업자가 없으면 호출 스레드에서 바로 실행 */
+   if (NbTasks <= 1 || Pool.Threads.empty())
+   {
+      for (MIL_INT Index = 0; Index < NbTasks; Index++)
+         Task(Index);
+      return;
+   }
+
+   {
+      std::lock_guard<std::mutex> Guard(Pool.Lock);
+      Pool.Task     = Task;
+      Pool.NbTasks  = NbTasks;
+      Pool.NextTask = 0;
+      Pool.NbBusy   = (MIL_INT)Pool.Threads.size();
+      Pool.Generation++;
+   }
+   Pool.Wake.notify_all();
+
+   WorkerPoolDrain(Pool);
+
+   std::unique_lock<std::mutex> Guard(Pool.Lock);
+   Pool.Done.wait(Guard, [&]() { return Pool.NbBusy == 0; });
+}
+
+inline void WorkerPoolFree(WORKER_POOL& Pool)
+{
+   {
+      std::lock_guard<std::mutex> Guard(Pool.Lock);
+      Pool.Stop = true;
+   }
+   Pool.Wake.notify_all();
+   for (size_t t = 0; t < Pool.Threads.size(); t++)
+      Pool.Threads[t].join();
+   Pool.Threads.clear();
+}
+
+#endif /* WORKER_POOL_H */
@@ -7,11 +7,905 @@
  *   그래픽 함수를 이용하여 환영 메시지를 화면에 표시하는 예제입니다.
  *   또한, 에러가 발생했을 때 이를 확인하는 방법을 보여줍니다.
  *
+ *   시작 지연 프로파일러(startup profiler):
+ *   MappAllocDefault() 대신 자원을 하나씩 할당하면서 각 단계의 시간과
+ *   Mim/Mmod/Mgra/Mcal 모듈의 "첫 호출" 시간을 측정합니다. 첫 호출에는
+ *   DLL 로드와 내부 초기화가 포함되므로, 사전 준비(pre-warm) API로 부팅 중에
+ *   모든 모듈을 한 번씩 호출하고 작업 버퍼를 미리 할당해 두면
+ *   첫 번째 검사 부품이 천 번째 부품보다 느려지지 않습니다.
+ *   같은 실행에서 사전 준비 없는 풀과 사전 준비한 풀의 첫 부품 지연을 비교합니다.
+ *
+ *   주석 배치 렌더러(annotation batch):
+ *   도형마다 Mgra를 호출하는 대신 명령 버퍼에 모으고 같은 색 구간을 합친 뒤
+ *   한 번에(수평 띠별 병렬 가능) 래스터화합니다. 환영 그래픽도 이 배치로 그리며,
+ *   검사 결과 수천 개의 주석 비용과 그려진 화소를 Mgra 호출 방식과 비교합니다.
+ *
  * 저작권(Copyright):
  *   © Matrox Electronic Systems Ltd., 1992-2025.
  *   All Rights Reserved.
  */
 #include <mil.h>   // MIL( Matrox Imaging Library ) 헤더 포함
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <thread>
+#include "../Common/WorkerPool.h"
+
+/* 시작 지연 프로파일러 설정 */
+#define IMAGE_SIZE_X         640L   // 표시/작업 버퍼 크기
+#define IMAGE_SIZE_Y         480L
+#define POOL_NB_BUFFERS      4      // 미리 할당해 둘 작업 버퍼 개수
+#define NB_PARTS             1000   // 검사할 가상 부품 개수
+#define PART_RADIUS          40.0   // 가상 부품(원) 반지름 [pixel]
+#define PIXEL_SIZE_MM        0.05   // 보정용 화소 크기 [mm/pixel]
+#define PROFILE_MAX_STEPS    16
+#define DISPLAY_NB_ROUND     2      // 디스플레이 비용: 선택/해제 순서를 번갈아 측정하는 라운드 수
+
+/* 헤드리스(화면 없음) 실행 모드 */
+// 모니터 없는 검사 서버에서는 MIL_HEADLESS=1 로 빌드합니다.
+//  - MdispAlloc/MdispSelect 생략, 이미지 버퍼는 M_DISP 없이 할당
+//  - 키 대기는 막지 않음(눌린 키가 없으면 바로 종료)
+#include "../Common/MilHeadless.h"
+
+/* 모듈별 시간 인덱스 */
+enum { MODULE_MBUF = 0, MODULE_MGRA, MODULE_MIM, MODULE_MMOD, MODULE_MCAL, NB_MODULES };
+static const MIL_TEXT_CHAR* ModuleName[NB_MODULES] =
+    { MIL_TEXT("Mbuf"), MIL_TEXT("Mgra"), MIL_TEXT("Mim"), MIL_TEXT("Mmod"), MIL_TEXT("Mcal") };
+
+/*------------------------------------------------------------*/
+/* 시작 프로파일: 단계 이름과 소요 시간(ms)을 순서대로 기록     */
+/*------------------------------------------------------------*/
+typedef struct
+{
+    const MIL_TEXT_CHAR* Name[PROFILE_MAX_STEPS];
+    double Ms[PROFILE_MAX_STEPS];
+    int Count;
+    std::chrono::steady_clock::time_point Start;  // 전체 시작 시각
+    std::chrono::steady_clock::time_point Mark;   // 직전 단계 종료 시각
+} STARTUP_PROFILE;
+
+static double ElapsedMs(std::chrono::steady_clock::time_point From,
+                        std::chrono::steady_clock::time_point To)
+{
+    return std::chrono::duration<double, std::milli>(To - From).count();
+}
+
+void ProfileStart(STARTUP_PROFILE& Profile)
+{
+    Profile.Count = 0;
+    Profile.Start = Profile.Mark = std::chrono::steady_clock::now();
+}
+
+// 직전 단계 이후 흐른 시간을 Name 단계로 기록
+void ProfileStep(STARTUP_PROFILE& Profile, const MIL_TEXT_CHAR* Name)
+{
+    std::chrono::steady_clock::time_point Now = std::chrono::steady_clock::now();
+    if (Profile.Count < PROFILE_MAX_STEPS)
+    {
+        Profile.Name[Profile.Count] = Name;
+        Profile.Ms[Profile.Count] = ElapsedMs(Profile.Mark, Now);
+        Profile.Count++;
+    }
+    Profile.Mark = Now;
+}
+
+void ProfilePrint(const STARTUP_PROFILE& Profile, const MIL_TEXT_CHAR* Title)
+{
+    MosPrintf(MIL_TEXT("\n%s:\n"), Title);
+    MosPrintf(MIL_TEXT("----------------------------------------\n\n"));
+    for (int i = 0; i < Profile.Count; i++)
+        MosPrintf(MIL_TEXT("  %-28s %9.2f ms\n"), Profile.Name[i], Profile.Ms[i]);
+    MosPrintf(MIL_TEXT("  %-28s %9.2f ms\n\n"), MIL_TEXT("Total"),
+              ElapsedMs(Profile.Start, Profile.Mark));
+}
+
+/*------------------------------------------------------------*/
+/* 사전 준비(pre-warm) 자원 모음                               */
+/*------------------------------------------------------------*/
+// 검사 루프에서 쓰는 모든 MIL 객체를 부팅 중에 만들어 두고 재사용합니다.
+typedef struct
+{
+    MIL_ID Buffers[POOL_NB_BUFFERS];  // 작업 버퍼(할당 + 초기화로 메모리 확정)
+    MIL_ID GraContext;                // 그래픽 컨텍스트
+    MIL_ID ModContext;                // 원 모델 탐색 컨텍스트
+    MIL_ID ModResult;                 // 탐색 결과
+    MIL_ID CalContext;                // 화소 -> mm 보정 컨텍스트
+    bool ModReady;                    // 원 모델 정의 + 전처리 완료 여부
+    bool CalReady;                    // 보정 설정 완료 여부
+} PREWARM_POOL;
+
+// 풀 자원 할당만 수행합니다(모델 전처리, 보정 설정 등 모듈 호출 없음).
+// Profile이 있으면 할당 단계별 시간을 기록합니다.
+void MilPrewarmAlloc(MIL_ID MilSystem, PREWARM_POOL& Pool, STARTUP_PROFILE* Profile)
+{
+    for (int i = 0; i < POOL_NB_BUFFERS; i++)
+    {
+        MbufAlloc2d(MilSystem, IMAGE_SIZE_X, IMAGE_SIZE_Y, 8 + M_UNSIGNED,
+                    M_IMAGE + M_PROC, &Pool.Buffers[i]);
+        MbufClear(Pool.Buffers[i], 0);
+    }
+    if (Profile) ProfileStep(*Profile, MIL_TEXT("Work buffers alloc"));
+
+    MgraAlloc(MilSystem, &Pool.GraContext);
+    if (Profile) ProfileStep(*Profile, MIL_TEXT("MgraAlloc"));
+
+    MmodAlloc(MilSystem, M_SHAPE_CIRCLE, M_DEFAULT, &Pool.ModContext);
+    MmodAllocResult(MilSystem, M_SHAPE_CIRCLE, &Pool.ModResult);
+    if (Profile) ProfileStep(*Profile, MIL_TEXT("MmodAlloc"));
+
+    McalAlloc(MilSystem, M_DEFAULT, M_DEFAULT, &Pool.CalContext);
+    if (Profile) ProfileStep(*Profile, MIL_TEXT("McalAlloc"));
+
+    Pool.ModReady = false;
+    Pool.CalReady = false;
+}
+
+// 원 모델 정의 + 전처리. 사전 준비하지 않은 풀은 첫 부품 검사 중에 수행됩니다.
+static void PoolPrepareMod(PREWARM_POOL& Pool)
+{
+    MmodDefine(Pool.ModContext, M_CIRCLE, M_DEFAULT, PART_RADIUS,
+               M_DEFAULT, M_DEFAULT, M_DEFAULT);
+    MmodPreprocess(Pool.ModContext, M_DEFAULT);
+    Pool.ModReady = true;
+}
+
+// 화소 -> mm 균일 보정 설정. 사전 준비하지 않은 풀은 첫 부품 검사 중에 수행됩니다.
+static void PoolPrepareCal(PREWARM_POOL& Pool)
+{
+    McalUniform(Pool.CalContext, 0.0, 0.0, PIXEL_SIZE_MM, PIXEL_SIZE_MM, 0.0, M_DEFAULT);
+    Pool.CalReady = true;
+}
+
+// 각 모듈을 실제 검사와 같은 방식으로 한 번씩 호출해 DLL 로드/내부 초기화를 끝냅니다.
+void MilPrewarmTouch(PREWARM_POOL& Pool, STARTUP_PROFILE* Profile)
+{
+    MIL_ID Src = Pool.Buffers[0];
+    MIL_ID Dst = Pool.Buffers[1];
+    MIL_DOUBLE WorldX, WorldY;
+
+    MgraControl(Pool.GraContext, M_COLOR, 255);
+    MgraArcFill(Pool.GraContext, Src, IMAGE_SIZE_X / 2, IMAGE_SIZE_Y / 2,
+                PART_RADIUS, PART_RADIUS, 0.0, 360.0);
+    if (Profile) ProfileStep(*Profile, MIL_TEXT("First Mgra call"));
+
+    MimConvolve(Src, Dst, M_SMOOTH);
+    if (Profile) ProfileStep(*Profile, MIL_TEXT("First Mim call"));
+
+    PoolPrepareMod(Pool);
+    if (Profile) ProfileStep(*Profile, MIL_TEXT("MmodDefine + preprocess"));
+
+    MmodFind(Pool.ModContext, Dst, Pool.ModResult);
+    if (Profile) ProfileStep(*Profile, MIL_TEXT("First Mmod call"));
+
+    PoolPrepareCal(Pool);
+    if (Profile) ProfileStep(*Profile, MIL_TEXT("McalUniform"));
+
+    McalTransformCoordinate(Pool.CalContext, M_PIXEL_TO_WORLD,
+                            IMAGE_SIZE_X / 2, IMAGE_SIZE_Y / 2, &WorldX, &WorldY);
+    if (Profile) ProfileStep(*Profile, MIL_TEXT("First Mcal call"));
+
+    // 사전 준비에 쓴 버퍼를 다시 깨끗하게 정리
+    MbufClear(Src, 0);
+    MbufClear(Dst, 0);
+}
+
+// 사전 준비 API: 할당 + 모듈 호출을 한 번에 수행
+void MilPrewarm(MIL_ID MilSystem, PREWARM_POOL& Pool, STARTUP_PROFILE* Profile)
+{
+    MilPrewarmAlloc(MilSystem, Pool, Profile);
+    MilPrewarmTouch(Pool, Profile);
+}
+
+void MilPrewarmFree(PREWARM_POOL& Pool)
+{
+    McalFree(Pool.CalContext);
+    MmodFree(Pool.ModResult);
+    MmodFree(Pool.ModContext);
+    MgraFree(Pool.GraContext);
+    for (int i = 0; i < POOL_NB_BUFFERS; i++)
+        MbufFree(Pool.Buffers[i]);
+}
+
+/*------------------------------------------------------------*/
+/* 가상 부품 1개 검사: 그리기 -> 평활화 -> 원 탐색 -> mm 변환   */
+/*------------------------------------------------------------*/
+// ModuleMs[]에 모듈별 소요 시간을 기록하고 전체 시간을 반환합니다.
+double InspectPart(PREWARM_POOL& Pool, MIL_INT Part, double ModuleMs[NB_MODULES])
+{
+    MIL_ID Src = Pool.Buffers[(2 * Part) % POOL_NB_BUFFERS];
+    MIL_ID Dst = Pool.Buffers[(2 * Part + 1) % POOL_NB_BUFFERS];
+    MIL_DOUBLE CenterX = IMAGE_SIZE_X / 4 + (Part * 7) % (IMAGE_SIZE_X / 2);
+    MIL_DOUBLE CenterY = IMAGE_SIZE_Y / 4 + (Part * 13) % (IMAGE_SIZE_Y / 2);
+    MIL_DOUBLE FoundX = 0.0, FoundY = 0.0, WorldX, WorldY;
+    MIL_INT NbFound = 0;
+
+    std::chrono::steady_clock::time_point TClear = std::chrono::steady_clock::now();
+    MbufClear(Src, 0);
+    std::chrono::steady_clock::time_point T0 = std::chrono::steady_clock::now();
+    MgraControl(Pool.GraContext, M_COLOR, 255);
+    MgraArcFill(Pool.GraContext, Src, CenterX, CenterY, PART_RADIUS, PART_RADIUS, 0.0, 360.0);
+    std::chrono::steady_clock::time_point T1 = std::chrono::steady_clock::now();
+
+    MimConvolve(Src, Dst, M_SMOOTH);
+    std::chrono::steady_clock::time_point T2 = std::chrono::steady_clock::now();
+
+    // 사전 준비하지 않은 풀은 첫 부품에서 모델 전처리와 보정 설정 비용을 냅니다.
+    if (!Pool.ModReady)
+        PoolPrepareMod(Pool);
+    MmodFind(Pool.ModContext, Dst, Pool.ModResult);
+    MmodGetResult(Pool.ModResult, M_DEFAULT, M_NUMBER + M_TYPE_MIL_INT, &NbFound);
+    if (NbFound > 0)
+    {
+        MmodGetResult(Pool.ModResult, 0, M_CENTER_X, &FoundX);
+        MmodGetResult(Pool.ModResult, 0, M_CENTER_Y, &FoundY);
+    }
+    std::chrono::steady_clock::time_point T3 = std::chrono::steady_clock::now();
+
+    if (!Pool.CalReady)
+        PoolPrepareCal(Pool);
+    McalTransformCoordinate(Pool.CalContext, M_PIXEL_TO_WORLD, FoundX, FoundY, &WorldX, &WorldY);
+    std::chrono::steady_clock::time_point T4 = std::chrono::steady_clock::now();
+
+    ModuleMs[MODULE_MBUF] = ElapsedMs(TClear, T0);
+    ModuleMs[MODULE_MGRA] = ElapsedMs(T0, T1);
+    ModuleMs[MODULE_MIM] = ElapsedMs(T1, T2);
+    ModuleMs[MODULE_MMOD] = ElapsedMs(T2, T3);
+    ModuleMs[MODULE_MCAL] = ElapsedMs(T3, T4);
+    return ElapsedMs(TClear, T4);
+}
+
+static double Median(std::vector<double> Values)
+{
+    std::nth_element(Values.begin(), Values.begin() + Values.size() / 2, Values.end());
+    return Values[Values.size() / 2];
+}
+
+// NB_PARTS개 부품을 검사하고 1번째 / 중앙값 / 마지막 부품 시간을 비교합니다.
+// 1번째 부품 시간(ms)을 반환합니다.
+double InspectionLatencyReport(PREWARM_POOL& Pool, bool Prewarmed)
+{
+    std::vector<double> Total(NB_PARTS);
+    std::vector<double> Module[NB_MODULES];
+    double ModuleMs[NB_MODULES];
+
+    for (int m = 0; m < NB_MODULES; m++)
+        Module[m].resize(NB_PARTS);
+
+    for (MIL_INT Part = 0; Part < NB_PARTS; Part++)
+    {
+        Total[Part] = InspectPart(Pool, Part, ModuleMs);
+        for (int m = 0; m < NB_MODULES; m++)
+            Module[m][Part] = ModuleMs[m];
+    }
+
+    MosPrintf(MIL_TEXT("INSPECTION LATENCY (%d parts, pre-warm %s):\n"),
+              NB_PARTS, Prewarmed ? MIL_TEXT("on") : MIL_TEXT("off"));
+    MosPrintf(MIL_TEXT("----------------------------------------\n\n"));
+    MosPrintf(MIL_TEXT("  %-8s %10s %10s %10s\n"),
+              MIL_TEXT(""), MIL_TEXT("Part 1"), MIL_TEXT("Median"), MIL_TEXT("Last"));
+    for (int m = 0; m < NB_MODULES; m++)
+        MosPrintf(MIL_TEXT("  %-8s %7.3f ms %7.3f ms %7.3f ms\n"), ModuleName[m],
+                  Module[m][0], Median(Module[m]), Module[m][NB_PARTS - 1]);
+    MosPrintf(MIL_TEXT("  %-8s %7.3f ms %7.3f ms %7.3f ms\n\n"), MIL_TEXT("Total"),
+              Total[0], Median(Total), Total[NB_PARTS - 1]);
+    MosPrintf(MIL_TEXT("  Part 1 / median = %.1fx\n\n"), Total[0] / Median(Total));
+    return Total[0];
+}
+
+/*------------------------------------------------------------*/
+/* 디스플레이 지원 비용                                        */
+/*------------------------------------------------------------*/
+// 검사 루프: 부품마다 검사한 뒤 결과(평활화 영상)를 화면 버퍼 MilImage에 보여 줍니다.
+// 부품당 평균 시간(ms)을 반환합니다.
+static double TimeInspectionLoop(PREWARM_POOL& Pool, MIL_ID MilImage)
+{
+    double ModuleMs[NB_MODULES];
+    MIL_DOUBLE Time;
+
+    MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+    for (MIL_INT Part = 0; Part < NB_PARTS; Part++)
+    {
+        InspectPart(Pool, Part, ModuleMs);
+        MbufCopy(Pool.Buffers[(2 * Part + 1) % POOL_NB_BUFFERS], MilImage);
+    }
+    MthrWait(M_DEFAULT, M_THREAD_WAIT, M_NULL);
+    MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+    return Time * 1000.0 / NB_PARTS;
+}
+
+// 시작 시 Mdisp 단계 시간과, 같은 검사 루프를 MilImage가 디스플레이에 선택된 상태와
+// 선택 해제된 상태로 실행했을 때의 부품당 시간 차이(화면 갱신 비용)를 보고합니다.
+// 측정하지 않는 1회로 워밍업한 뒤, 라운드마다 선택/해제 측정 순서를 번갈아 평균합니다.
+// 헤드리스 빌드에서는 표시할 디스플레이가 없으므로 선택 해제 경로만 측정합니다.
+void DisplayCostReport(PREWARM_POOL& Pool, MIL_ID MilDisplay, MIL_ID MilImage, double StartupDisplayMs)
+{
+    MIL_ID Backup;
+    double TimeDisplayed = 0.0, TimeHidden = 0.0;
+
+    // 환영 그래픽을 보존하기 위해 백업 후 측정, 끝나면 복원
+    MbufClone(MilImage, M_DEFAULT, M_DEFAULT, M_DEFAULT, M_DEFAULT, M_IMAGE + M_PROC,
+              M_COPY_SOURCE_DATA, &Backup);
+
+    TimeInspectionLoop(Pool, MilImage);
+#if !MIL_HEADLESS
+    // 짝수 라운드는 선택 → 해제, 홀수 라운드는 해제 → 선택 순서
+    for (int Round = 0; Round < DISPLAY_NB_ROUND; Round++)
+    {
+        for (int Pass = 0; Pass < 2; Pass++)
+        {
+            bool Selected = ((Round + Pass) % 2) == 0;
+            MdispSelect(MilDisplay, Selected ? MilImage : M_NULL);
+            if (Selected)
+                TimeDisplayed += TimeInspectionLoop(Pool, MilImage) / DISPLAY_NB_ROUND;
+            else
+                TimeHidden += TimeInspectionLoop(Pool, MilImage) / DISPLAY_NB_ROUND;
+        }
+    }
+#else
+    TimeHidden = TimeInspectionLoop(Pool, MilImage);
+#endif
+
+    MbufCopy(Backup, MilImage);
+    MbufFree(Backup);
+#if !MIL_HEADLESS
+    MdispSelect(MilDisplay, MilImage);
+#endif
+
+    MosPrintf(MIL_TEXT("DISPLAY SUPPORT COST (inspection loop, %d parts):\n"), NB_PARTS);
+    MosPrintf(MIL_TEXT("----------------------------------------\n\n"));
+#if !MIL_HEADLESS
+    MosPrintf(MIL_TEXT("  Startup (MdispAlloc + MdispSelect) %9.2f ms\n"), StartupDisplayMs);
+    MosPrintf(MIL_TEXT("  Per part, display selected         %9.4f ms\n"), TimeDisplayed);
+    MosPrintf(MIL_TEXT("  Per part, no display selected      %9.4f ms\n"), TimeHidden);
+    MosPrintf(MIL_TEXT("  Display support per part           %9.4f ms\n\n"), TimeDisplayed - TimeHidden);
+#else
+    MosPrintf(MIL_TEXT("  Per part, no display               %9.4f ms\n"), TimeHidden);
+    MosPrintf(MIL_TEXT("  Headless build: no display to compare against.\n\n"));
+#endif
+}
+
+/*------------------------------------------------------------*/
+/* 주석 배치 렌더러(retained-mode annotation batch)            */
+/*------------------------------------------------------------*/
+// 검사 결과 주석(선/사각형/원/텍스트)을 Mgra 호출 하나씩 그리는 대신
+//  - 작은 명령 버퍼(ANNOT_COMMAND, 정수 좌표)에 모아 두고
+//  - 같은 색이 연속되는 명령은 하나의 색 구간(ANNOT_COLOR_RUN)으로 합친 뒤
+//  - 8비트 호스트 버퍼에 한 번에 래스터화합니다(수평 띠 단위 병렬 가능).
+// 명령은 렌더마다 한 번 Y 범위로 띠에 분류하고, 띠는 자기 행만 그리므로 스레드 간 쓰기 충돌이
+// 없습니다. 띠는 렌더러(ANNOT_RENDERER)의 상주 작업자 풀에서 실행합니다.
+// 텍스트는 글꼴 래스터화를 MIL에 맡겨 MgraText로 그리며, 텍스트 명령마다 래스터 패스를 끊어
+// 추가 순서(나중 명령이 위)를 지킵니다.
+// 호스트 주소가 없거나 8비트가 아닌 버퍼는 Mgra 호출로 재생(replay)합니다.
+#define ANNOT_NB_RESULTS      2000   // 벤치마크: 프레임당 검사 결과 수
+#define ANNOT_NB_LOOP         20     // 벤치마크: 반복 프레임 수
+#define ANNOT_CROSS_SIZE      4      // 결과 위치 십자 반길이 [pixel]
+
+enum { ANNOT_LINE = 0, ANNOT_RECT, ANNOT_RECT_FILL, ANNOT_ARC, ANNOT_ARC_FILL, ANNOT_TEXT };
+
+// 명령 1개 = 20바이트. 원/타원은 (X1, Y1) 중심, (X2, Y2) 반지름, 텍스트는 X2가 문자열 인덱스
+typedef struct
+{
+    MIL_INT32 Kind;
+    MIL_INT32 X1, Y1, X2, Y2;
+} ANNOT_COMMAND;
+
+// 같은 색으로 그릴 연속 명령 구간
+typedef struct
+{
+    MIL_DOUBLE Color;
+    MIL_INT First;
+    MIL_INT Count;
+} ANNOT_COLOR_RUN;
+
+typedef struct
+{
+    std::vector<ANNOT_COMMAND> Commands;
+    std::vector<ANNOT_COLOR_RUN> Runs;
+    std::vector<std::basic_string<MIL_TEXT_CHAR> > Texts;
+    MIL_DOUBLE Color;    // 다음 명령에 적용할 색
+} ANNOTATION_BATCH;
+
+// 렌더러: 띠 작업자 풀과 렌더마다 다시 쓰는 띠 분류 버퍼
+typedef struct
+{
+    WORKER_POOL Pool;
+    std::vector<MIL_INT32> BandStart;       // 띠 b의 명령 = BandCommands[BandStart[b] .. BandStart[b + 1])
+    std::vector<MIL_INT32> BandCommands;    // 띠별 명령 인덱스(추가 순서)
+    std::vector<MIL_INT32> BandCursor;      // 띠별 다음에 그릴 BandCommands 위치
+    std::vector<MIL_UINT8> Values;          // 명령별 8비트 색
+} ANNOT_RENDERER;
+
+void AnnotBegin(ANNOTATION_BATCH& Batch)
+{
+    Batch.Commands.clear();
+    Batch.Runs.clear();
+    Batch.Texts.clear();
+    Batch.Color = 255.0;
+}
+
+void AnnotColor(ANNOTATION_BATCH& Batch, MIL_DOUBLE Color)
+{
+    Batch.Color = Color;
+}
+
+// 명령 추가: 직전 구간과 색이 같으면 그 구간에 합침
+static void AnnotPush(ANNOTATION_BATCH& Batch, MIL_INT32 Kind,
+                      MIL_INT X1, MIL_INT Y1, MIL_INT X2, MIL_INT Y2)
+{
+    ANNOT_COMMAND Command = { Kind, (MIL_INT32)X1, (MIL_INT32)Y1, (MIL_INT32)X2, (MIL_INT32)Y2 };
+    if (Batch.Runs.empty() || Batch.Runs.back().Color != Batch.Color)
+    {
+        ANNOT_COLOR_RUN Run = { Batch.Color, (MIL_INT)Batch.Commands.size(), 0 };
+        Batch.Runs.push_back(Run);
+    }
+    Batch.Commands.push_back(Command);
+    Batch.Runs.back().Count++;
+}
+
+void AnnotLine(ANNOTATION_BATCH& Batch, MIL_INT X1, MIL_INT Y1, MIL_INT X2, MIL_INT Y2)
+{
+    AnnotPush(Batch, ANNOT_LINE, X1, Y1, X2, Y2);
+}
+
+void AnnotRect(ANNOTATION_BATCH& Batch, MIL_INT X1, MIL_INT Y1, MIL_INT X2, MIL_INT Y2)
+{
+    AnnotPush(Batch, ANNOT_RECT, X1, Y1, X2, Y2);
+}
+
+void AnnotRectFill(ANNOTATION_BATCH& Batch, MIL_INT X1, MIL_INT Y1, MIL_INT X2, MIL_INT Y2)
+{
+    AnnotPush(Batch, ANNOT_RECT_FILL, X1, Y1, X2, Y2);
+}
+
+// 전체 원/타원(0~360도)만 지원
+void AnnotArc(ANNOTATION_BATCH& Batch, MIL_INT CenterX, MIL_INT CenterY, MIL_INT RadiusX, MIL_INT RadiusY)
+{
+    AnnotPush(Batch, ANNOT_ARC, CenterX, CenterY, RadiusX, RadiusY);
+}
+
+void AnnotArcFill(ANNOTATION_BATCH& Batch, MIL_INT CenterX, MIL_INT CenterY, MIL_INT RadiusX, MIL_INT RadiusY)
+{
+    AnnotPush(Batch, ANNOT_ARC_FILL, CenterX, CenterY, RadiusX, RadiusY);
+}
+
+void AnnotText(ANNOTATION_BATCH& Batch, MIL_INT X, MIL_INT Y, const MIL_TEXT_CHAR* Text)
+{
+    Batch.Texts.push_back(Text);
+    AnnotPush(Batch, ANNOT_TEXT, X, Y, (MIL_INT)Batch.Texts.size() - 1, 0);
+}
+
+// NbThreads: 띠 래스터화에 쓸 스레드 수(호출 스레드 포함)
+void AnnotRendererAlloc(ANNOT_RENDERER& Renderer, MIL_INT NbThreads)
+{
+    WorkerPoolAlloc(Renderer.Pool, std::max(NbThreads, (MIL_INT)1));
+}
+
+void AnnotRendererFree(ANNOT_RENDERER& Renderer)
+{
+    WorkerPoolFree(Renderer.Pool);
+}
+
+/* 래스터화: 한 띠(Y0 <= y < Y1)에 해당하는 부분만 그림 */
+typedef struct
+{
+    MIL_UINT8* Base;
+    MIL_INT Pitch;
+    MIL_INT SizeX;
+    MIL_INT Y0, Y1;
+} ANNOT_BAND;
+
+static inline void AnnotSpan(const ANNOT_BAND& Band, MIL_INT Y, MIL_INT X0, MIL_INT X1, MIL_UINT8 Value)
+{
+    if (Y < Band.Y0 || Y >= Band.Y1)
+        return;
+    if (X0 > X1) std::swap(X0, X1);
+    X0 = std::max(X0, (MIL_INT)0);
+    X1 = std::min(X1, Band.SizeX - 1);
+    if (X0 <= X1)
+        memset(Band.Base + Y * Band.Pitch + X0, Value, (size_t)(X1 - X0 + 1));
+}
+
+// 올림 나눗셈(Denominator > 0)
+static inline MIL_INT AnnotCeilDiv(MIL_INT Numerator, MIL_INT Denominator)
+{
+    return Numerator >= 0 ? (Numerator + Denominator - 1) / Denominator : -((-Numerator) / Denominator);
+}
+
+// 선분: 띠에 걸친 행만 방문하고, 행마다 화소 구간을 닫힌 식으로 구함(Bresenham과 같은 반올림).
+// 시작점부터 걸어오지 않으므로 띠 경계와 무관하게 같은 화소가 찍힘
+static void AnnotRasterLine(const ANNOT_BAND& Band, MIL_INT X1, MIL_INT Y1, MIL_INT X2, MIL_INT Y2, MIL_UINT8 Value)
+{
+    if (Y1 == Y2)
+    {
+        AnnotSpan(Band, Y1, X1, X2, Value);
+        return;
+    }
+
+    MIL_INT Adx = std::abs(X2 - X1);
+    MIL_INT Ady = std::abs(Y2 - Y1);
+    if (Adx > Ady)
+    {
+        // X 주축: 열 오프셋 T의 행 오프셋은 round(T * Ady / Adx) → 행 오프셋 M의 열 구간을 역산
+        if (X1 > X2) { std::swap(X1, X2); std::swap(Y1, Y2); }
+        MIL_INT Sy = Y1 < Y2 ? 1 : -1;
+        MIL_INT Top = std::max(std::min(Y1, Y2), Band.Y0);
+        MIL_INT Bottom = std::min(std::max(Y1, Y2), Band.Y1 - 1);
+        for (MIL_INT Y = Top; Y <= Bottom; Y++)
+        {
+            MIL_INT M = (Y - Y1) * Sy;
+            MIL_INT T0 = std::max(AnnotCeilDiv((2 * M - 1) * Adx, 2 * Ady), (MIL_INT)0);
+            MIL_INT T1 = std::min(AnnotCeilDiv((2 * M + 1) * Adx, 2 * Ady) - 1, Adx);
+            AnnotSpan(Band, Y, X1 + T0, X1 + T1, Value);
+        }
+    }
+    else
+    {
+        // Y 주축: 행마다 화소 1개, 열 오프셋은 round(M * Adx / Ady)
+        if (Y1 > Y2) { std::swap(X1, X2); std::swap(Y1, Y2); }
+        MIL_INT Sx = X1 < X2 ? 1 : -1;
+        MIL_INT Top = std::max(Y1, Band.Y0);
+        MIL_INT Bottom = std::min(Y2, Band.Y1 - 1);
+        for (MIL_INT Y = Top; Y <= Bottom; Y++)
+        {
+            MIL_INT X = X1 + Sx * ((2 * (Y - Y1) * Adx + Ady) / (2 * Ady));
+            AnnotSpan(Band, Y, X, X, Value);
+        }
+    }
+}
+
+// 타원의 행별 반폭: |Dy| > Ry이면 -1
+static inline MIL_INT AnnotHalfWidth(MIL_INT Dy, MIL_INT Rx, MIL_INT Ry)
+{
+    if (Dy < 0) Dy = -Dy;
+    if (Dy > Ry) return -1;
+    if (Ry == 0) return Rx;
+    double t = (double)Dy / (double)Ry;
+    return (MIL_INT)(Rx * std::sqrt(1.0 - t * t) + 0.5);
+}
+
+static void AnnotRasterArc(const ANNOT_BAND& Band, MIL_INT Cx, MIL_INT Cy, MIL_INT Rx, MIL_INT Ry,
+                           bool Fill, MIL_UINT8 Value)
+{
+    MIL_INT Top = std::max(Cy - Ry, Band.Y0);
+    MIL_INT Bottom = std::min(Cy + Ry, Band.Y1 - 1);
+    for (MIL_INT Y = Top; Y <= Bottom; Y++)
+    {
+        MIL_INT Dy = Y - Cy;
+        MIL_INT Half = AnnotHalfWidth(Dy, Rx, Ry);
+        if (Fill)
+        {
+            AnnotSpan(Band, Y, Cx - Half, Cx + Half, Value);
+            continue;
+        }
+        // 윤곽: 바깥쪽 이웃 행의 반폭 다음부터 이 행의 반폭까지 → 끊김 없는 윤곽
+        MIL_INT Outer = AnnotHalfWidth((Dy < 0 ? Dy - 1 : Dy + 1), Rx, Ry);
+        MIL_INT Inner = std::min(Outer + 1, Half);
+        AnnotSpan(Band, Y, Cx - Half, Cx - Inner, Value);
+        AnnotSpan(Band, Y, Cx + Inner, Cx + Half, Value);
+    }
+}
+
+static void AnnotRasterCommand(const ANNOT_BAND& Band, const ANNOT_COMMAND& C, MIL_UINT8 Value)
+{
+    switch (C.Kind)
+    {
+    case ANNOT_LINE:
+        AnnotRasterLine(Band, C.X1, C.Y1, C.X2, C.Y2, Value);
+        break;
+    case ANNOT_RECT:
+        AnnotSpan(Band, C.Y1, C.X1, C.X2, Value);
+        AnnotSpan(Band, C.Y2, C.X1, C.X2, Value);
+        for (MIL_INT Y = std::max((MIL_INT)std::min(C.Y1, C.Y2) + 1, Band.Y0);
+             Y < std::min((MIL_INT)std::max(C.Y1, C.Y2), Band.Y1); Y++)
+        {
+            AnnotSpan(Band, Y, C.X1, C.X1, Value);
+            AnnotSpan(Band, Y, C.X2, C.X2, Value);
+        }
+        break;
+    case ANNOT_RECT_FILL:
+        for (MIL_INT Y = std::max((MIL_INT)std::min(C.Y1, C.Y2), Band.Y0);
+             Y <= std::min((MIL_INT)std::max(C.Y1, C.Y2), Band.Y1 - 1); Y++)
+            AnnotSpan(Band, Y, C.X1, C.X2, Value);
+        break;
+    case ANNOT_ARC:
+    case ANNOT_ARC_FILL:
+        AnnotRasterArc(Band, C.X1, C.Y1, C.X2, C.Y2, C.Kind == ANNOT_ARC_FILL, Value);
+        break;
+    default:    // ANNOT_TEXT: AnnotRender에서 MgraText로 처리
+        break;
+    }
+}
+
+// 명령이 닿는 행 범위(텍스트 제외)
+static void AnnotCommandRows(const ANNOT_COMMAND& C, MIL_INT& Top, MIL_INT& Bottom)
+{
+    if (C.Kind == ANNOT_ARC || C.Kind == ANNOT_ARC_FILL)
+    {
+        Top = (MIL_INT)C.Y1 - std::abs(C.Y2);
+        Bottom = (MIL_INT)C.Y1 + std::abs(C.Y2);
+    }
+    else
+    {
+        Top = std::min(C.Y1, C.Y2);
+        Bottom = std::max(C.Y1, C.Y2);
+    }
+}
+
+// 행 Y가 속한 띠: 띠 b = [SizeY * b / NbBands, SizeY * (b + 1) / NbBands)
+static inline MIL_INT AnnotBandOf(MIL_INT Y, MIL_INT SizeY, MIL_INT NbBands)
+{
+    return ((Y + 1) * NbBands - 1) / SizeY;
+}
+
+// 명령을 Y 범위로 띠에 분류(렌더당 1회): 띠 b의 명령 = BandCommands[BandStart[b] .. BandStart[b + 1])
+static void AnnotBucket(const ANNOTATION_BATCH& Batch, ANNOT_RENDERER& Renderer, MIL_INT SizeY, MIL_INT NbBands)
+{
+    MIL_INT NbCommands = (MIL_INT)Batch.Commands.size();
+    std::vector<MIL_INT32>& Start = Renderer.BandStart;
+    std::vector<MIL_INT32>& Cursor = Renderer.BandCursor;
+
+    Start.assign(NbBands + 1, 0);
+    for (int Pass = 0; Pass < 2; Pass++)
+    {
+        for (MIL_INT i = 0; i < NbCommands; i++)
+        {
+            const ANNOT_COMMAND& C = Batch.Commands[i];
+            MIL_INT Top, Bottom;
+            if (C.Kind == ANNOT_TEXT)
+                continue;
+            AnnotCommandRows(C, Top, Bottom);
+            Top = std::max(Top, (MIL_INT)0);
+            Bottom = std::min(Bottom, SizeY - 1);
+            if (Top > Bottom)
+                continue;
+            for (MIL_INT b = AnnotBandOf(Top, SizeY, NbBands); b <= AnnotBandOf(Bottom, SizeY, NbBands); b++)
+            {
+                if (Pass == 0)
+                    Start[b + 1]++;
+                else
+                    Renderer.BandCommands[Cursor[b]++] = (MIL_INT32)i;
+            }
+        }
+        if (Pass == 0)
+        {
+            for (MIL_INT b = 0; b < NbBands; b++)
+                Start[b + 1] += Start[b];
+            Renderer.BandCommands.resize(Start[NbBands]);
+            Cursor.assign(Start.begin(), Start.end() - 1);
+        }
+    }
+    Cursor.assign(Start.begin(), Start.end() - 1);
+
+    // 명령별 8비트 색(색 구간에서)
+    Renderer.Values.resize(NbCommands);
+    for (size_t r = 0; r < Batch.Runs.size(); r++)
+    {
+        const ANNOT_COLOR_RUN& Run = Batch.Runs[r];
+        MIL_UINT8 Value = (MIL_UINT8)std::min(std::max(Run.Color, 0.0), 255.0);
+        for (MIL_INT i = Run.First; i < Run.First + Run.Count; i++)
+            Renderer.Values[i] = Value;
+    }
+}
+
+// 띠 b에서 명령 인덱스가 End보다 작은 남은 명령을 그림(띠마다 자기 커서만 갱신)
+static void AnnotRasterBand(const ANNOTATION_BATCH& Batch, ANNOT_RENDERER& Renderer, ANNOT_BAND Band,
+                            MIL_INT b, MIL_INT End)
+{
+    MIL_INT32& k = Renderer.BandCursor[b];
+    for (; k < Renderer.BandStart[b + 1] && Renderer.BandCommands[k] < End; k++)
+    {
+        MIL_INT i = Renderer.BandCommands[k];
+        AnnotRasterCommand(Band, Batch.Commands[i], Renderer.Values[i]);
+    }
+}
+
+/* Mgra 재생: 명령 [First, End) 구간. 대체 경로(호스트 주소 없음/8비트 아님)와 텍스트용 */
+static void AnnotReplay(const ANNOTATION_BATCH& Batch, MIL_ID MilGraContext, MIL_ID MilDest,
+                        MIL_INT First, MIL_INT End)
+{
+    for (size_t r = 0; r < Batch.Runs.size(); r++)
+    {
+        const ANNOT_COLOR_RUN& Run = Batch.Runs[r];
+        MIL_INT RunFirst = std::max(Run.First, First);
+        MIL_INT RunEnd = std::min(Run.First + Run.Count, End);
+        if (RunFirst >= RunEnd)
+            continue;
+        MgraControl(MilGraContext, M_COLOR, Run.Color);   // 색 구간당 1회
+        for (MIL_INT i = RunFirst; i < RunEnd; i++)
+        {
+            const ANNOT_COMMAND& C = Batch.Commands[i];
+            switch (C.Kind)
+            {
+            case ANNOT_LINE:      MgraLine(MilGraContext, MilDest, C.X1, C.Y1, C.X2, C.Y2); break;
+            case ANNOT_RECT:      MgraRect(MilGraContext, MilDest, C.X1, C.Y1, C.X2, C.Y2); break;
+            case ANNOT_RECT_FILL: MgraRectFill(MilGraContext, MilDest, C.X1, C.Y1, C.X2, C.Y2); break;
+            case ANNOT_ARC:       MgraArc(MilGraContext, MilDest, C.X1, C.Y1, C.X2, C.Y2, 0.0, 360.0); break;
+            case ANNOT_ARC_FILL:  MgraArcFill(MilGraContext, MilDest, C.X1, C.Y1, C.X2, C.Y2, 0.0, 360.0); break;
+            case ANNOT_TEXT:      MgraText(MilGraContext, MilDest, C.X1, C.Y1, Batch.Texts[C.X2].c_str()); break;
+            }
+        }
+    }
+}
+
+// 배치를 MilImage에 추가 순서대로 그림. NbBands > 1이면 수평 띠별로 Renderer의 작업자 풀에서 병렬 래스터화.
+// 텍스트 명령이 나올 때마다 래스터 패스를 끊고 MgraText로 그리므로, 텍스트와 도형이 겹쳐도
+// 나중에 추가한 명령이 위에 그려짐
+void AnnotRender(const ANNOTATION_BATCH& Batch, ANNOT_RENDERER& Renderer, MIL_ID MilGraContext,
+                 MIL_ID MilImage, MIL_INT NbBands)
+{
+    MIL_INT NbCommands = (MIL_INT)Batch.Commands.size();
+    MIL_UINT8* Base = (MIL_UINT8*)MbufInquire(MilImage, M_HOST_ADDRESS, M_NULL);
+    MIL_INT SizeBit = MbufInquire(MilImage, M_SIZE_BIT, M_NULL);
+    MIL_INT NbColorBands = MbufInquire(MilImage, M_SIZE_BAND, M_NULL);
+    if (Base == M_NULL || SizeBit != 8 || NbColorBands != 1)
+    {
+        AnnotReplay(Batch, MilGraContext, MilImage, 0, NbCommands);
+        return;
+    }
+
+    ANNOT_BAND Band;
+    Band.Base = Base;
+    Band.Pitch = MbufInquire(MilImage, M_PITCH_BYTE, M_NULL);
+    Band.SizeX = MbufInquire(MilImage, M_SIZE_X, M_NULL);
+    MIL_INT SizeY = MbufInquire(MilImage, M_SIZE_Y, M_NULL);
+
+    NbBands = std::min(std::max(NbBands, (MIL_INT)1), SizeY);
+    AnnotBucket(Batch, Renderer, SizeY, NbBands);
+
+    // 텍스트 없는 구간은 띠별 래스터화, 텍스트 구간은 MgraText
+    for (MIL_INT First = 0; First < NbCommands; )
+    {
+        MIL_INT End = First;
+        while (End < NbCommands && Batch.Commands[End].Kind != ANNOT_TEXT)
+            End++;
+        if (End > First)
+        {
+            WorkerPoolRun(Renderer.Pool, NbBands, [&](MIL_INT b)
+            {
+                ANNOT_BAND Part = Band;
+                Part.Y0 = SizeY * b / NbBands;
+                Part.Y1 = SizeY * (b + 1) / NbBands;
+                AnnotRasterBand(Batch, Renderer, Part, b, End);
+            });
+
+            // 호스트 포인터로 쓴 내용을 MIL(디스플레이 포함)에 알림
+            MbufControl(MilImage, M_MODIFIED, M_DEFAULT);
+        }
+
+        First = End;
+        while (End < NbCommands && Batch.Commands[End].Kind == ANNOT_TEXT)
+            End++;
+        if (End > First)
+            AnnotReplay(Batch, MilGraContext, MilImage, First, End);
+        First = End;
+    }
+}
+
+/*------------------------------------------------------------*/
+/* 주석 배치 벤치마크: Mgra 호출 vs 배치(1 스레드 / 띠 병렬)   */
+/*------------------------------------------------------------*/
+// 격자 위 ANNOT_NB_RESULTS개 검사 결과마다 박스 + 십자 + 원(4개 도형)을 그립니다.
+// 불량(10개 중 1개)은 다른 색이므로 색 구간 수는 결과 수보다 훨씬 적습니다.
+static void BuildResultAnnotations(ANNOTATION_BATCH& Batch, MIL_INT SizeX, MIL_INT SizeY)
+{
+    MIL_INT Grid = (MIL_INT)std::ceil(std::sqrt((double)ANNOT_NB_RESULTS));
+    MIL_INT CellX = SizeX / Grid, CellY = SizeY / Grid;
+    MIL_INT Radius = std::max(std::min(CellX, CellY) / 2 - 2, (MIL_INT)2);
+
+    AnnotBegin(Batch);
+    for (MIL_INT i = 0; i < ANNOT_NB_RESULTS; i++)
+    {
+        MIL_INT X = (i % Grid) * CellX + CellX / 2;
+        MIL_INT Y = (i / Grid) * CellY + CellY / 2;
+        AnnotColor(Batch, (i % 10 == 0) ? 0x5F : 0xF0);
+        AnnotRect(Batch, X - Radius, Y - Radius, X + Radius, Y + Radius);
+        AnnotLine(Batch, X - ANNOT_CROSS_SIZE, Y, X + ANNOT_CROSS_SIZE, Y);
+        AnnotLine(Batch, X, Y - ANNOT_CROSS_SIZE, X, Y + ANNOT_CROSS_SIZE);
+        AnnotArc(Batch, X, Y, Radius - 1, Radius - 1);
+    }
+}
+
+// 0이 아닌 화소 수
+static MIL_INT CountNonZero(MIL_ID MilSystem, MIL_ID MilImage)
+{
+    MIL_ID MilStatContext = MimAlloc(MilSystem, M_STATISTICS_CONTEXT, M_DEFAULT, M_NULL);
+    MIL_ID MilStatResult = MimAllocResult(MilSystem, M_DEFAULT, M_STATISTICS_RESULT, M_NULL);
+    MIL_DOUBLE Number = 0.0;
+    MimControl(MilStatContext, M_STAT_NUMBER, M_ENABLE);
+    MimControl(MilStatContext, M_CONDITION, M_NOT_EQUAL);
+    MimControl(MilStatContext, M_COND_LOW, 0);
+    MimStatCalculate(MilStatContext, MilImage, MilStatResult, M_DEFAULT);
+    MimGetResult(MilStatResult, M_STAT_NUMBER, &Number);
+    MimFree(MilStatResult);
+    MimFree(MilStatContext);
+    return (MIL_INT)Number;
+}
+
+void AnnotationBatchBenchmark(MIL_ID MilSystem, MIL_ID MilGraContext)
+{
+    MIL_ID MilTarget, MilReference, MilDiff;
+    MIL_INT SizeX = 2048, SizeY = 2048;
+    MIL_INT NbCores = std::max((MIL_INT)std::thread::hardware_concurrency(), (MIL_INT)1);
+    MIL_DOUBLE TimePerCall, TimeBatch, TimeBands;
+    ANNOTATION_BATCH Batch;
+    ANNOT_RENDERER Renderer;
+
+    MbufAlloc2d(MilSystem, SizeX, SizeY, 8 + M_UNSIGNED, M_IMAGE + M_PROC, &MilTarget);
+    MbufAlloc2d(MilSystem, SizeX, SizeY, 8 + M_UNSIGNED, M_IMAGE + M_PROC, &MilReference);
+    MbufAlloc2d(MilSystem, SizeX, SizeY, 8 + M_UNSIGNED, M_IMAGE + M_PROC, &MilDiff);
+    MbufClear(MilTarget, 0);
+    AnnotRendererAlloc(Renderer, NbCores);
+
+    // (1) 결과마다 Mgra 호출(색 지정 + 도형 4개)
+    MIL_INT Grid = (MIL_INT)std::ceil(std::sqrt((double)ANNOT_NB_RESULTS));
+    MIL_INT CellX = SizeX / Grid, CellY = SizeY / Grid;
+    MIL_INT Radius = std::max(std::min(CellX, CellY) / 2 - 2, (MIL_INT)2);
+    MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+    for (MIL_INT n = 0; n < ANNOT_NB_LOOP; n++)
+    {
+        for (MIL_INT i = 0; i < ANNOT_NB_RESULTS; i++)
+        {
+            MIL_INT X = (i % Grid) * CellX + CellX / 2;
+            MIL_INT Y = (i / Grid) * CellY + CellY / 2;
+            MgraControl(MilGraContext, M_COLOR, (i % 10 == 0) ? 0x5F : 0xF0);
+            MgraRect(MilGraContext, MilTarget, X - Radius, Y - Radius, X + Radius, Y + Radius);
+            MgraLine(MilGraContext, MilTarget, X - ANNOT_CROSS_SIZE, Y, X + ANNOT_CROSS_SIZE, Y);
+            MgraLine(MilGraContext, MilTarget, X, Y - ANNOT_CROSS_SIZE, X, Y + ANNOT_CROSS_SIZE);
+            MgraArc(MilGraContext, MilTarget, X, Y, Radius - 1, Radius - 1, 0.0, 360.0);
+        }
+    }
+    MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimePerCall);
+
+    // (2) 배치 구성 + 1 스레드 래스터화
+    MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+    for (MIL_INT n = 0; n < ANNOT_NB_LOOP; n++)
+    {
+        BuildResultAnnotations(Batch, SizeX, SizeY);
+        AnnotRender(Batch, Renderer, MilGraContext, MilTarget, 1);
+    }
+    MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeBatch);
+
+    // (3) 배치 구성 + 띠 병렬 래스터화
+    MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+    for (MIL_INT n = 0; n < ANNOT_NB_LOOP; n++)
+    {
+        BuildResultAnnotations(Batch, SizeX, SizeY);
+        AnnotRender(Batch, Renderer, MilGraContext, MilTarget, NbCores);
+    }
+    MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeBands);
+
+    // 정확도: 띠 병렬 배치 vs 같은 배치의 Mgra 재생, 띠 병렬 vs 1 스레드(빈 버퍼에서 각각 1회)
+    MbufClear(MilTarget, 0);
+    AnnotRender(Batch, Renderer, MilGraContext, MilTarget, NbCores);
+    MbufClear(MilReference, 0);
+    AnnotReplay(Batch, MilGraContext, MilReference, 0, (MIL_INT)Batch.Commands.size());
+    MIL_INT NbDrawn = CountNonZero(MilSystem, MilReference);
+    MimArith(MilTarget, MilReference, MilDiff, M_SUB_ABS);
+    MIL_INT NbDiffMgra = CountNonZero(MilSystem, MilDiff);
+    MbufClear(MilReference, 0);
+    AnnotRender(Batch, Renderer, MilGraContext, MilReference, 1);
+    MimArith(MilTarget, MilReference, MilDiff, M_SUB_ABS);
+    MIL_INT NbDiffBands = CountNonZero(MilSystem, MilDiff);
+
+    MosPrintf(MIL_TEXT("ANNOTATION BATCH (%d results, %d primitives, %d colour runs, %dx%d):\n"),
+              ANNOT_NB_RESULTS, (int)Batch.Commands.size(), (int)Batch.Runs.size(), (int)SizeX, (int)SizeY);
+    MosPrintf(MIL_TEXT("----------------------------------------\n\n"));
+    MosPrintf(MIL_TEXT("  Mgra call per primitive     %9.3f ms/frame\n"), TimePerCall * 1000.0 / ANNOT_NB_LOOP);
+    MosPrintf(MIL_TEXT("  Batch, 1 thread             %9.3f ms/frame\n"), TimeBatch * 1000.0 / ANNOT_NB_LOOP);
+    MosPrintf(MIL_TEXT("  Batch, %2d bands             %9.3f ms/frame\n"), (int)NbCores, TimeBands * 1000.0 / ANNOT_NB_LOOP);
+    MosPrintf(MIL_TEXT("  Speed-up (bands vs Mgra)    %9.1fx\n"), TimeBands > 0.0 ? TimePerCall / TimeBands : 0.0);
+    MosPrintf(MIL_TEXT("  Pixels differing from Mgra  %9d of %d drawn by Mgra\n"), (int)NbDiffMgra, (int)NbDrawn);
+    MosPrintf(MIL_TEXT("  Pixels differing, %2d bands  %9d vs 1 thread\n\n"), (int)NbCores, (int)NbDiffBands);
+
+    AnnotRendererFree(Renderer);
+    MbufFree(MilDiff);
+    MbufFree(MilReference);
+    MbufFree(MilTarget);
+}
 
  /*------------------------------------------------------------*/
  /* 프로그램 시작 함수                                         */
@@ -23,56 +917,110 @@
     MIL_ID MilSystem;       // 시스템 ID
     MIL_ID MilDisplay;      // 디스플레이(화면) ID
     MIL_ID MilImage;        // 이미지 버퍼 ID
+    PREWARM_POOL Pool;      // 사전 준비 자원
+    PREWARM_POOL ColdPool;  // 비교용: 할당만 하고 모듈 첫 호출은 하지 않은 자원
+    STARTUP_PROFILE Profile;
+    ANNOTATION_BATCH Welcome; // 환영 그래픽 주석 배치
+    ANNOT_RENDERER WelcomeRenderer; // 환영 그래픽 렌더러(1 스레드)
+    double StartupDisplayMs = 0.0;  // 시작 단계 중 디스플레이 관련 시간
 
     /*--------------------------------------------------------*/
     /* 1. MIL의 기본 자원 할당                               */
     /*--------------------------------------------------------*/
-    // MappAllocDefault() 함수는 기본적인 MIL 자원을 한 번에 생성하는 함수입니다.
-    //  - M_DEFAULT : 기본 설정으로 시스템을 선택
-    //  - MilApplication, MilSystem, MilDisplay, MilImage 등은 각각의 자원 ID를 반환받습니다.
-    //  - M_NULL : 사용하지 않는 디지타이저(Grabber)는 생략
-    MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem, &MilDisplay, M_NULL, &MilImage);
+    // MappAllocDefault()는 아래 자원을 한 번에 생성하지만, 단계별 시작 시간을
+    // 측정하기 위해 애플리케이션/시스템/디스플레이/이미지를 하나씩 할당합니다.
+    //  - M_SYSTEM_DEFAULT : MILConfig에 설정된 기본 시스템 선택
+    //  - 이미지는 표시(M_DISP)와 처리(M_PROC)가 모두 가능한 8비트 버퍼
+    ProfileStart(Profile);
+    MappAlloc(M_NULL, M_DEFAULT, &MilApplication);
+    ProfileStep(Profile, MIL_TEXT("MappAlloc"));
+
+    MsysAlloc(M_DEFAULT, M_SYSTEM_DEFAULT, M_DEFAULT, M_DEFAULT, &MilSystem);
+    ProfileStep(Profile, MIL_TEXT("MsysAlloc"));
+
+#if MIL_HEADLESS
+    MilDisplay = M_NULL;
+#else
+    MdispAlloc(MilSystem, M_DEFAULT, MIL_TEXT("M_DEFAULT"), M_DEFAULT, &MilDisplay);
+    ProfileStep(Profile, MIL_TEXT("MdispAlloc"));
+    StartupDisplayMs += Profile.Ms[Profile.Count - 1];
+#endif
+
+    MbufAlloc2d(MilSystem, IMAGE_SIZE_X, IMAGE_SIZE_Y, 8 + M_UNSIGNED,
+                M_IMAGE + DISPLAY_ATTRIBUTE + M_PROC, &MilImage);
+    MbufClear(MilImage, 0);
+    ProfileStep(Profile, MIL_TEXT("MbufAlloc2d"));
+
+#if !MIL_HEADLESS
+    MdispSelect(MilDisplay, MilImage);
+    ProfileStep(Profile, MIL_TEXT("MdispSelect"));
+    StartupDisplayMs += Profile.Ms[Profile.Count - 1];
+#endif
+
+    // 작업 버퍼/컨텍스트 할당만 수행. 모듈 설정과 첫 호출은 첫 부품 검사 중에 일어납니다.
+    MilPrewarmAlloc(MilSystem, ColdPool, &Profile);
+    ProfilePrint(Profile, MIL_TEXT("STARTUP PROFILE"));
 
     /*--------------------------------------------------------*/
     /* 2. 자원 할당 후 에러가 없는 경우 그래픽 처리 수행     */
     /*--------------------------------------------------------*/
     if (!MappGetError(M_DEFAULT, M_GLOBAL, M_NULL)) // 에러가 없으면 실행
     {
-        /* 그래픽 요소(텍스트, 사각형) 그리기 */
+        /* 검사 루프의 첫 부품과 정상 상태 부품의 지연 비교: 같은 실행에서 사전 준비 없이 → 사전 준비 후 */
+        // DLL 로드/모듈 초기화는 프로세스당 한 번이므로, 사전 준비 없는 풀은 할당 이외의 어떤
+        // 모듈 호출(환영 그래픽의 MgraFont/MgraText 포함)보다 먼저 측정합니다.
+        // 따라서 아래 사전 준비 시간에는 DLL 로드가 빠져 있고, 부팅 중 실제 비용은 더 큽니다.
+        double ColdFirstMs = InspectionLatencyReport(ColdPool, false);
+        MilPrewarmFree(ColdPool);
 
-        // 텍스트 색상 설정 (0xF0은 밝은 회색 계열)
-        MgraControl(M_DEFAULT, M_COLOR, 0xF0);
+        ProfileStart(Profile);
+        MilPrewarm(MilSystem, Pool, &Profile);
+        ProfilePrint(Profile, MIL_TEXT("PRE-WARM PROFILE (DLLs already loaded)"));
+        double PrewarmMs = ElapsedMs(Profile.Start, Profile.Mark);
+        double WarmFirstMs = InspectionLatencyReport(Pool, true);
 
-        // 기본 큰 글꼴 설정
-        MgraFont(M_DEFAULT, M_FONT_DEFAULT_LARGE);
+        MosPrintf(MIL_TEXT("PRE-WARM EFFECT (same run):\n"));
+        MosPrintf(MIL_TEXT("----------------------------------------\n\n"));
+        MosPrintf(MIL_TEXT("  Part 1 without pre-warm            %9.3f ms\n"), ColdFirstMs);
+        MosPrintf(MIL_TEXT("  Part 1 with pre-warm               %9.3f ms\n"), WarmFirstMs);
+        MosPrintf(MIL_TEXT("  Pre-warm (DLLs already loaded)     %9.3f ms\n\n"), PrewarmMs);
 
-        // 이미지 버퍼 위에 텍스트 출력 (좌표 160, 230)
-        MgraText(M_DEFAULT, MilImage, 10L, 20L, MIL_TEXT(" Welcome to MIL !!! "));
+        /* 그래픽 요소(텍스트, 사각형) 그리기: 배치에 모은 뒤 한 번에 래스터화 */
+        AnnotBegin(Welcome);
 
-        // 색상 변경 (0xC0은 좀 더 어두운 회색)
-        MgraControl(M_DEFAULT, M_COLOR, 0xC0);
+        // 텍스트 색상 설정 (0xF0은 밝은 회색 계열)
+        AnnotColor(Welcome, 0xF0);
 
+        // 기본 큰 글꼴 설정(텍스트는 MgraText로 그려짐)
+        MgraFont(M_DEFAULT, M_FONT_DEFAULT_LARGE);
 
+        // 이미지 버퍼 위에 텍스트 출력 (좌표 10, 20)
+        AnnotText(Welcome, 10L, 20L, MIL_TEXT(" Welcome to MIL !!! "));
 
+        // 색상 변경 (0xC0은 좀 더 어두운 회색)
+        AnnotColor(Welcome, 0xC0);
 
         // 라인 그리기
-        MgraLine(M_DEFAULT, MilImage, 50L, 100L, 50L, 200L);
-
+        AnnotLine(Welcome, 50L, 100L, 50L, 200L);
 
-        // 사각형 3개를 그려 장식 효과 (겹치는 테두리)
-        MgraRect(M_DEFAULT, MilImage, 100L, 150L, 530L, 340L);
-        MgraRect(M_DEFAULT, MilImage, 120L, 170L, 510L, 320L);
-        MgraRect(M_DEFAULT, MilImage, 140L, 190L, 490L, 300L);
+        // 사각형 3개를 그려 장식 효과 (겹치는 테두리): 같은 색이므로 한 구간으로 합쳐짐
+        AnnotRect(Welcome, 100L, 150L, 530L, 340L);
+        AnnotRect(Welcome, 120L, 170L, 510L, 320L);
+        AnnotRect(Welcome, 140L, 190L, 490L, 300L);
 
         // 색상 변경 
-        MgraControl(M_DEFAULT, M_COLOR, 0x5F);  // 안되는 코드
+        AnnotColor(Welcome, 0x5F);
 
         // 사각형 채우는 함수
-        MgraRectFill(M_DEFAULT, MilImage, 140L, 190L, 490L, 300L);
+        AnnotRectFill(Welcome, 140L, 190L, 490L, 300L);
 
         // 원 그리기
-        MgraArc(M_DEFAULT,MilImage,100L,100L,50L,50LL,0L,360L);
-        MgraArcFill(M_DEFAULT,MilImage, 200L, 100L, 50L, 50L, 0L, 360L);
+        AnnotArc(Welcome, 100L, 100L, 50L, 50L);
+        AnnotArcFill(Welcome, 200L, 100L, 50L, 50L);
+
+        AnnotRendererAlloc(WelcomeRenderer, 1);
+        AnnotRender(Welcome, WelcomeRenderer, M_DEFAULT, MilImage, 1);
+        AnnotRendererFree(WelcomeRenderer);
 
 
         /* 콘솔창에 텍스트 메시지 출력 */
@@ -80,23 +1028,31 @@
         MosPrintf(MIL_TEXT("------------------\n\n"));
         MosPrintf(MIL_TEXT("System allocation successful.\n\n"));
         MosPrintf(MIL_TEXT("     \"Welcome to MIL !!!\"\n\n"));
+
+        /* 화면 표시가 검사 루프에 더하는 비용 */
+        DisplayCostReport(Pool, MilDisplay, MilImage, StartupDisplayMs);
+
+        /* 검사 결과 수천 개 주석: Mgra 호출 vs 배치 */
+        AnnotationBatchBenchmark(MilSystem, Pool.GraContext);
     }
     else
     {
         /* 에러가 발생한 경우 콘솔에 메시지 출력 */
         MosPrintf(MIL_TEXT("System allocation error !\n\n"));
+        Pool = ColdPool;    // 할당한 자원은 해제 단계에서 함께 해제
     }
 
     /*--------------------------------------------------------*/
     /* 3. 키 입력 대기 후 종료 처리                          */
     /*--------------------------------------------------------*/
     MosPrintf(MIL_TEXT("Press any key to end.\n"));
-    MosGetch();  // 사용자 키 입력 대기
+    WaitForKey(0);  // 사용자 키 입력 대기(헤드리스면 대기 없음)
 
     /*--------------------------------------------------------*/
     /* 4. 사용한 MIL 자원 해제                                */
     /*--------------------------------------------------------*/
-    // MappFreeDefault()는 MappAllocDefault()로 생성한 모든 자원을 한 번에 해제
+    // MappFreeDefault()는 개별 할당한 자원도 역순으로 한 번에 해제합니다.
+    MilPrewarmFree(Pool);
     MappFreeDefault(MilApplication, MilSystem, MilDisplay, M_NULL, MilImage);
 
     return 0;  // 프로그램 정상 종료
@@ -4,9 +4,17 @@
 // 
 // Synopsis:   This program demonstrates how to use the function MimBoundingBox to compute
 //             the corners of the smallest rectangular region including all the foreground 
-//             pixels of an image. This region is thereafter alternately used and ignored 
-//             according to the region support capability of the subsequent operations 
-//             performed on the image.
+//             pixels of an image. This region is thereafter used by the statistics and
+//             by an opening restricted to the tiles it meets, instead of being ignored
+//             for the morphology that does not support regions.
+// 
+//             A fused single-pass kernel then computes the bounding box together with the
+//             foreground statistics and is compared against the separate MIL calls.
+//             An integral-image service then answers region statistics in O(1) per
+//             rectangle for many regions at once, and run-length encoded masks restrict
+//             statistics and morphology to the pixels of sparse regions. A tiled
+//             morphology engine opens only the tiles that meet the region, and a
+//             parallel connected-component labeler returns one box per object.
 // 
 // Copyright © Matrox Electronic Systems Ltd., 1992-2025.
 // All Rights Reserved
@@ -14,6 +22,17 @@
 //////////////////////////////////////////////////////////////////////////////////////////
 
 #include <mil.h>
+#include <cmath>
+#include <algorithm>
+#include <limits>
+#include <atomic>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include "../Common/CpuFeatures.h"
 #define IMAGE_FILE                     M_IMAGE_PATH MIL_TEXT("Preprocessing/Cookie.mim")
 
 // Example description.                                                     
@@ -24,11 +43,1820 @@ void PrintHeader()
             MIL_TEXT("[SYNOPSIS]\n")
             MIL_TEXT("This program demonstrates how to use the function MimBoundingBox to compute\n")
             MIL_TEXT("the corners of the smallest rectangular region including all the foreground\n")
-            MIL_TEXT("pixels of a depth map. This region is thereafter alternately used and ignored\n")
-            MIL_TEXT("according to the region support capability of the subsequent operations\n")
-            MIL_TEXT("performed on the image.\n\n")
+            MIL_TEXT("pixels of a depth map. This region is thereafter used by the statistics and\n")
+            MIL_TEXT("by an opening restricted to the tiles it meets, instead of being ignored\n")
+            MIL_TEXT("for the morphology that does not support regions.\n\n")
             MIL_TEXT("[MODULES USED]\n")
-            MIL_TEXT("Modules used: application, buffer, display, image processing, system.\n\n"));
+            MIL_TEXT("Modules used: application, blob, buffer, display, graphics,\n")
+            MIL_TEXT("image processing, system.\n\n"));
+   }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Fused bounding-box and region statistics kernel.
+//
+// One pass over the image returns the bounding box of the pixels greater than the
+// threshold together with their count, sum, sum of squares, min and max, i.e. what
+// MimBoundingBox() followed by a conditional MimStatCalculate() returns in two passes.
+// The image is split into row bands, one per thread, whose partial results are merged.
+// 8-bit images use AVX2 when the CPU supports it (checked at run time, so the project
+// needs no /arch:AVX2); other depths use the scalar loop. Signed buffers are rejected.
+//////////////////////////////////////////////////////////////////////////////////////////
+#define FUSED_NB_LOOP                  10
+#define FUSED_BENCH_SIZE_SMALL         4096
+#define FUSED_BENCH_SIZE_LARGE         8192
+
+#if CPU_HAS_AVX2_KERNEL
+static inline int CountTrailingZeros(MIL_UINT32 Bits)
+   {
+#if defined(_MSC_VER)
+   unsigned long Index;
+   _BitScanForward(&Index, Bits);
+   return (int)Index;
+#else
+   return __builtin_ctz(Bits);
+#endif
+   }
+
+static inline int CountLeadingZeros(MIL_UINT32 Bits)
+   {
+#if defined(_MSC_VER)
+   unsigned long Index;
+   _BitScanReverse(&Index, Bits);
+   return 31 - (int)Index;
+#else
+   return __builtin_clz(Bits);
+#endif
+   }
+
+static inline int PopCount(MIL_UINT32 Bits)
+   {
+#if defined(_MSC_VER)
+   return (int)__popcnt(Bits);
+#else
+   return __builtin_popcount(Bits);
+#endif
+   }
+#endif
+
+struct RegionStats
+   {
+   MIL_INT    TopLeftX, TopLeftY;        // Bounding box, -1 when no pixel passes.
+   MIL_INT    BottomRightX, BottomRightY;
+   MIL_INT64  Count;
+   MIL_DOUBLE Sum, SumOfSquares;
+   MIL_INT    Min, Max;
+   };
+
+static void ResetRegionStats(RegionStats& Stats)
+   {
+   Stats.TopLeftX = Stats.TopLeftY = Stats.BottomRightX = Stats.BottomRightY = -1;
+   Stats.Count = 0;
+   Stats.Sum = Stats.SumOfSquares = 0.0;
+   Stats.Min = std::numeric_limits<MIL_INT>::max();
+   Stats.Max = -1;
+   }
+
+static void MergeRegionStats(RegionStats& Dst, const RegionStats& Src)
+   {
+   if (Src.Count == 0)
+      return;
+   if (Dst.Count == 0)
+      {
+      Dst = Src;
+      return;
+      }
+   Dst.TopLeftX     = std::min(Dst.TopLeftX, Src.TopLeftX);
+   Dst.TopLeftY     = std::min(Dst.TopLeftY, Src.TopLeftY);
+   Dst.BottomRightX = std::max(Dst.BottomRightX, Src.BottomRightX);
+   Dst.BottomRightY = std::max(Dst.BottomRightY, Src.BottomRightY);
+   Dst.Count        += Src.Count;
+   Dst.Sum          += Src.Sum;
+   Dst.SumOfSquares += Src.SumOfSquares;
+   Dst.Min          = std::min(Dst.Min, Src.Min);
+   Dst.Max          = std::max(Dst.Max, Src.Max);
+   }
+
+#if CPU_HAS_AVX2_KERNEL
+// AVX2 part of an 8-bit row, 32 pixels per step; returns the number of pixels processed.
+AVX2_TARGET static MIL_INT FusedStatsRowAvx2(const MIL_UINT8* Row, MIL_INT SizeX, MIL_INT MinValue,
+                                             MIL_INT& First, MIL_INT& Last, RegionStats& Band,
+                                             MIL_UINT64& Sum, MIL_UINT64& SumOfSquares)
+   {
+   MIL_INT x = 0;
+   // Unsigned x >= MinValue <=> max(x, MinValue) == x.
+   const __m256i Limit = _mm256_set1_epi8((char)MinValue);
+   const __m256i Zero  = _mm256_setzero_si256();
+   __m256i MinAcc = _mm256_set1_epi8((char)0xFF), MaxAcc = Zero;
+   __m256i SumAcc = Zero, SqAcc = Zero;
+   for (; x + 32 <= SizeX; x += 32)
+      {
+      __m256i Pixels = _mm256_loadu_si256((const __m256i*)(Row + x));
+      __m256i Mask   = _mm256_cmpeq_epi8(_mm256_max_epu8(Pixels, Limit), Pixels);
+      MIL_UINT32 Bits = (MIL_UINT32)_mm256_movemask_epi8(Mask);
+      if (Bits == 0)
+         continue;
+      if (First < 0)
+         First = x + CountTrailingZeros(Bits);
+      Last = x + 31 - CountLeadingZeros(Bits);
+      Band.Count += PopCount(Bits);
+
+      __m256i Kept = _mm256_and_si256(Pixels, Mask);
+      MaxAcc = _mm256_max_epu8(MaxAcc, Kept);
+      MinAcc = _mm256_min_epu8(MinAcc, _mm256_or_si256(Pixels, _mm256_andnot_si256(Mask, _mm256_set1_epi8((char)0xFF))));
+      SumAcc = _mm256_add_epi64(SumAcc, _mm256_sad_epu8(Kept, Zero));
+      __m256i Lo = _mm256_unpacklo_epi8(Kept, Zero), Hi = _mm256_unpackhi_epi8(Kept, Zero);
+      __m256i Sq = _mm256_add_epi32(_mm256_madd_epi16(Lo, Lo), _mm256_madd_epi16(Hi, Hi));
+      // Each 32-bit lane gains at most 4*255^2 per step; widen to 64 bits right away.
+      SqAcc = _mm256_add_epi64(SqAcc, _mm256_add_epi64(_mm256_unpacklo_epi32(Sq, Zero),
+                                                      _mm256_unpackhi_epi32(Sq, Zero)));
+      }
+   MIL_UINT64 Lanes[4];
+   MIL_UINT8  Bytes[32];
+   _mm256_storeu_si256((__m256i*)Lanes, SumAcc);
+   Sum += Lanes[0] + Lanes[1] + Lanes[2] + Lanes[3];
+   _mm256_storeu_si256((__m256i*)Lanes, SqAcc);
+   SumOfSquares += Lanes[0] + Lanes[1] + Lanes[2] + Lanes[3];
+   _mm256_storeu_si256((__m256i*)Bytes, MaxAcc);
+   for (int i = 0; i < 32; i++)
+      Band.Max = std::max(Band.Max, (MIL_INT)Bytes[i]);
+   _mm256_storeu_si256((__m256i*)Bytes, MinAcc);
+   for (int i = 0; i < 32; i++)
+      Band.Min = std::min(Band.Min, (MIL_INT)Bytes[i]);
+   return x;
+   }
+#endif
+
+// Kernel for rows [StartY, EndY). Pixels pass when Pixel >= MinValue.
+template <class PixelType>
+static void FusedStatsRows(const MIL_UINT8* Base, MIL_INT Pitch, MIL_INT SizeX,
+                           MIL_INT StartY, MIL_INT EndY, MIL_INT MinValue, bool UseAvx2, RegionStats* Stats)
+   {
+   RegionStats Band;
+   ResetRegionStats(Band);
+   MIL_UINT64 Sum = 0, SumOfSquares = 0;
+
+   for (MIL_INT y = StartY; y < EndY; y++)
+      {
+      const PixelType* Row = (const PixelType*)(Base + y * Pitch);
+      MIL_INT First = -1, Last = -1;
+      MIL_INT x = 0;
+
+#if CPU_HAS_AVX2_KERNEL
+      if (sizeof(PixelType) == 1 && UseAvx2 && MinValue > 0 && MinValue <= 0xFF)
+         x = FusedStatsRowAvx2((const MIL_UINT8*)Row, SizeX, MinValue, First, Last, Band, Sum, SumOfSquares);
+#endif
+      // Remaining pixels (all of them on the scalar path).
+      for (; x < SizeX; x++)
+         {
+         MIL_INT Pixel = Row[x];
+         if (Pixel >= MinValue)
+            {
+            if (First < 0)
+               First = x;
+            Last = x;
+            Band.Count++;
+            Sum          += (MIL_UINT64)Pixel;
+            SumOfSquares += (MIL_UINT64)(Pixel * Pixel);
+            Band.Min = std::min(Band.Min, Pixel);
+            Band.Max = std::max(Band.Max, Pixel);
+            }
+         }
+
+      if (First >= 0)
+         {
+         if (Band.TopLeftY < 0)
+            {
+            Band.TopLeftY = y;
+            Band.TopLeftX = First;
+            Band.BottomRightX = Last;
+            }
+         Band.TopLeftX     = std::min(Band.TopLeftX, First);
+         Band.BottomRightX = std::max(Band.BottomRightX, Last);
+         Band.BottomRightY = y;
+         }
+      }
+
+   Band.Sum          = (MIL_DOUBLE)Sum;
+   Band.SumOfSquares = (MIL_DOUBLE)SumOfSquares;
+   *Stats = Band;
+   }
+
+// True for an 8 or 16-bit unsigned monochrome buffer with a host address, the only
+// kind of buffer the host kernels of this example read directly.
+static bool IsHostMonoUnsigned(MIL_ID MilImage)
+   {
+   MIL_INT SizeBit = MbufInquire(MilImage, M_SIZE_BIT, M_NULL);
+   return MbufInquire(MilImage, M_HOST_ADDRESS, M_NULL) != M_NULL &&
+          (SizeBit == 8 || SizeBit == 16) &&
+          MbufInquire(MilImage, M_SIZE_BAND, M_NULL) == 1 &&
+          MbufInquire(MilImage, M_SIGN, M_NULL) != M_SIGNED;
+   }
+
+// Bounding box and statistics of the pixels strictly greater than Threshold.
+// Supports 8 and 16-bit unsigned monochrome buffers with a host address; returns false
+// (Stats left reset) for any other buffer, e.g. signed pixels.
+bool FusedBoundingBoxStats(MIL_ID MilImage, MIL_DOUBLE Threshold, MIL_INT NbThreads, RegionStats& Stats)
+   {
+   ResetRegionStats(Stats);
+   if (!IsHostMonoUnsigned(MilImage))
+      return false;
+
+   MIL_INT SizeX   = MbufInquire(MilImage, M_SIZE_X, M_NULL);
+   MIL_INT SizeY   = MbufInquire(MilImage, M_SIZE_Y, M_NULL);
+   MIL_INT SizeBit = MbufInquire(MilImage, M_SIZE_BIT, M_NULL);
+   MIL_INT Pitch   = MbufInquire(MilImage, M_PITCH_BYTE, M_NULL);
+   const MIL_UINT8* Base = (const MIL_UINT8*)MbufInquire(MilImage, M_HOST_ADDRESS, M_NULL);
+   bool UseAvx2 = CpuHasAvx2();
+
+   // Pixel > Threshold <=> Pixel >= floor(Threshold) + 1 for integer pixels.
+   MIL_INT MinValue = (MIL_INT)floor(Threshold) + 1;
+   MinValue = std::max(MinValue, (MIL_INT)0);
+
+   NbThreads = std::max(std::min(NbThreads, SizeY), (MIL_INT)1);
+   std::vector<RegionStats> Partial(NbThreads);
+   std::vector<std::thread> Workers;
+   MIL_INT RowsPerThread = (SizeY + NbThreads - 1) / NbThreads;
+
+   auto Kernel = (SizeBit > 8) ? FusedStatsRows<MIL_UINT16> : FusedStatsRows<MIL_UINT8>;
+   for (MIL_INT t = 1; t < NbThreads; t++)
+      {
+      MIL_INT StartY = std::min(t * RowsPerThread, SizeY);
+      Workers.push_back(std::thread(Kernel, Base, Pitch, SizeX, StartY,
+                                    std::min(StartY + RowsPerThread, SizeY), MinValue, UseAvx2, &Partial[t]));
+      }
+   Kernel(Base, Pitch, SizeX, 0, std::min(RowsPerThread, SizeY), MinValue, UseAvx2, &Partial[0]);
+   for (auto& Worker : Workers)
+      Worker.join();
+
+   for (const auto& Band : Partial)
+      MergeRegionStats(Stats, Band);
+   return true;
+   }
+
+// Times the fused kernel against MimBoundingBox() + a conditional MimStatCalculate()
+// computing the same values, on the example image scaled to large sizes.
+void FusedStatsBenchmark(MIL_ID MilSystem, MIL_DOUBLE Threshold)
+   {
+   MIL_ID MilSource = MbufRestore(IMAGE_FILE, MilSystem, M_NULL);
+   const MIL_INT Sizes[] = { FUSED_BENCH_SIZE_SMALL, FUSED_BENCH_SIZE_LARGE };
+   MIL_INT NbCores = std::max((MIL_INT)std::thread::hardware_concurrency(), (MIL_INT)1);
+
+   MIL_ID MilStatContext = MimAlloc(MilSystem, M_STATISTICS_CONTEXT, M_DEFAULT, M_NULL);
+   MIL_ID MilStatResult  = MimAllocResult(MilSystem, M_DEFAULT, M_STATISTICS_RESULT, M_NULL);
+   MimControl(MilStatContext, M_STAT_NUMBER, M_ENABLE);
+   MimControl(MilStatContext, M_STAT_SUM, M_ENABLE);
+   MimControl(MilStatContext, M_STAT_SUM_OF_SQUARES, M_ENABLE);
+   MimControl(MilStatContext, M_STAT_MIN, M_ENABLE);
+   MimControl(MilStatContext, M_STAT_MAX, M_ENABLE);
+   MimControl(MilStatContext, M_CONDITION, M_GREATER);
+   MimControl(MilStatContext, M_COND_LOW, Threshold);
+
+   MosPrintf(MIL_TEXT("Fused bounding box + statistics kernel (pixels > %.0f):\n"), Threshold);
+   MosPrintf(MIL_TEXT("Kernel: %s\n\n"),
+             (MbufInquire(MilSource, M_SIZE_BIT, M_NULL) > 8) ? MIL_TEXT("scalar (16-bit pixels)") :
+             CpuHasAvx2() ? MIL_TEXT("AVX2 (8-bit pixels, run-time dispatch)") : MIL_TEXT("scalar (no AVX2 on this CPU)"));
+   MosPrintf(MIL_TEXT("Size          MIL calls (ms)   Fused 1 thread (ms)   Fused %2d threads (ms)   Results\n"),
+             (int)NbCores);
+
+   for (MIL_INT s = 0; s < (MIL_INT)(sizeof(Sizes) / sizeof(Sizes[0])); s++)
+      {
+      MIL_ID MilLarge = MbufAlloc2d(MilSystem, Sizes[s], Sizes[s], MbufInquire(MilSource, M_TYPE, M_NULL),
+                                    M_IMAGE + M_PROC, M_NULL);
+      MimResize(MilSource, MilLarge, M_FILL_DESTINATION, M_FILL_DESTINATION, M_NEAREST_NEIGHBOR);
+
+      MIL_INT    TopLeftX = 0, TopLeftY = 0, BottomRightX = 0, BottomRightY = 0;
+      MIL_DOUBLE Number = 0, Sum = 0, SumOfSquares = 0, Min = 0, Max = 0;
+      MIL_DOUBLE TimeMil, TimeSingle, TimeMulti;
+      RegionStats Stats;
+
+      // (a) Separate MIL calls: one pass for the box, one for the statistics.
+      MimBoundingBox(MilLarge, M_GREATER, Threshold, M_NULL, M_BOTH_CORNERS,
+                     &TopLeftX, &TopLeftY, &BottomRightX, &BottomRightY, M_DEFAULT);
+      MimStatCalculate(MilStatContext, MilLarge, MilStatResult, M_DEFAULT);
+      MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+      for (MIL_INT n = 0; n < FUSED_NB_LOOP; n++)
+         {
+         MimBoundingBox(MilLarge, M_GREATER, Threshold, M_NULL, M_BOTH_CORNERS,
+                        &TopLeftX, &TopLeftY, &BottomRightX, &BottomRightY, M_DEFAULT);
+         MimStatCalculate(MilStatContext, MilLarge, MilStatResult, M_DEFAULT);
+         }
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeMil);
+      MimGetResult(MilStatResult, M_STAT_NUMBER, &Number);
+      MimGetResult(MilStatResult, M_STAT_SUM, &Sum);
+      MimGetResult(MilStatResult, M_STAT_SUM_OF_SQUARES, &SumOfSquares);
+      MimGetResult(MilStatResult, M_STAT_MIN, &Min);
+      MimGetResult(MilStatResult, M_STAT_MAX, &Max);
+
+      // (b) Fused kernel, single thread then all cores.
+      if (!FusedBoundingBoxStats(MilLarge, Threshold, 1, Stats))
+         {
+         MosPrintf(MIL_TEXT("%5d x %-5d %-17.2fskipped: fused kernel needs an unsigned 8 or 16-bit host buffer\n"),
+                   (int)Sizes[s], (int)Sizes[s], TimeMil * 1000.0 / FUSED_NB_LOOP);
+         MbufFree(MilLarge);
+         continue;
+         }
+      MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+      for (MIL_INT n = 0; n < FUSED_NB_LOOP; n++)
+         FusedBoundingBoxStats(MilLarge, Threshold, 1, Stats);
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeSingle);
+
+      MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+      for (MIL_INT n = 0; n < FUSED_NB_LOOP; n++)
+         FusedBoundingBoxStats(MilLarge, Threshold, NbCores, Stats);
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeMulti);
+
+      bool Match = Stats.TopLeftX == TopLeftX && Stats.TopLeftY == TopLeftY &&
+                   Stats.BottomRightX == BottomRightX && Stats.BottomRightY == BottomRightY &&
+                   (MIL_DOUBLE)Stats.Count == Number && Stats.Sum == Sum &&
+                   (MIL_DOUBLE)Stats.Min == Min && (MIL_DOUBLE)Stats.Max == Max &&
+                   fabs(Stats.SumOfSquares - SumOfSquares) <= 1e-9 * SumOfSquares;
+
+      MosPrintf(MIL_TEXT("%5d x %-5d %-17.2f%-22.2f%-24.2f%s\n"), (int)Sizes[s], (int)Sizes[s],
+                TimeMil * 1000.0 / FUSED_NB_LOOP, TimeSingle * 1000.0 / FUSED_NB_LOOP,
+                TimeMulti * 1000.0 / FUSED_NB_LOOP, Match ? MIL_TEXT("identical") : MIL_TEXT("DIFFERENT"));
+      MbufFree(MilLarge);
+      }
+   MosPrintf(MIL_TEXT("\n"));
+
+   MimFree(MilStatResult);
+   MimFree(MilStatContext);
+   MbufFree(MilSource);
+   }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Integral-image service.
+//
+// Summed-area tables of the pixels and of their squares are built once per frame; the
+// sum, mean and variance of any rectangle then cost four lookups each, whatever its size.
+// Tables have one extra leading row and column of zeros and use 64-bit accumulators.
+// The build is a parallel prefix sum: each thread integrates its band of rows locally,
+// the band bottom rows are chained sequentially, then each thread adds its band offset.
+//////////////////////////////////////////////////////////////////////////////////////////
+#define INTEGRAL_BENCH_SIZE            4096
+#define INTEGRAL_PAD_SIZE_X            24
+#define INTEGRAL_PAD_SIZE_Y            16
+#define INTEGRAL_PAD_PITCH_X           36
+#define INTEGRAL_PAD_PITCH_Y           36
+
+struct IntegralImage
+   {
+   MIL_INT                 SizeX, SizeY;
+   MIL_INT                 Stride;          // SizeX + 1.
+   std::vector<MIL_UINT64> Sum;
+   std::vector<MIL_UINT64> SumOfSquares;
+   };
+
+// Local integration of rows [StartY, EndY): table rows StartY+1 .. EndY.
+template <class PixelType>
+static void IntegralBandLocal(const MIL_UINT8* Base, MIL_INT Pitch, MIL_INT StartY, MIL_INT EndY,
+                              IntegralImage* Table)
+   {
+   MIL_INT Stride = Table->Stride;
+   for (MIL_INT y = StartY; y < EndY; y++)
+      {
+      const PixelType* Row = (const PixelType*)(Base + y * Pitch);
+      MIL_UINT64* Sum   = &Table->Sum[(y + 1) * Stride];
+      MIL_UINT64* Sq    = &Table->SumOfSquares[(y + 1) * Stride];
+      const MIL_UINT64* SumAbove = (y > StartY) ? Sum - Stride : nullptr;
+      const MIL_UINT64* SqAbove  = (y > StartY) ? Sq - Stride : nullptr;
+      MIL_UINT64 RowSum = 0, RowSq = 0;
+
+      Sum[0] = Sq[0] = 0;
+      for (MIL_INT x = 0; x < Table->SizeX; x++)
+         {
+         MIL_UINT64 Pixel = Row[x];
+         RowSum += Pixel;
+         RowSq  += Pixel * Pixel;
+         Sum[x + 1] = RowSum + (SumAbove ? SumAbove[x + 1] : 0);
+         Sq[x + 1]  = RowSq  + (SqAbove  ? SqAbove[x + 1]  : 0);
+         }
+      }
+   }
+
+// Adds the integrated value of all rows above the band to rows [StartY, EndY).
+static void IntegralBandOffset(const MIL_UINT64* SumOffset, const MIL_UINT64* SqOffset,
+                               MIL_INT StartY, MIL_INT EndY, IntegralImage* Table)
+   {
+   MIL_INT Stride = Table->Stride;
+   for (MIL_INT y = StartY; y < EndY; y++)
+      {
+      MIL_UINT64* Sum = &Table->Sum[(y + 1) * Stride];
+      MIL_UINT64* Sq  = &Table->SumOfSquares[(y + 1) * Stride];
+      for (MIL_INT x = 1; x < Stride; x++)
+         {
+         Sum[x] += SumOffset[x];
+         Sq[x]  += SqOffset[x];
+         }
+      }
+   }
+
+// Builds both tables for an 8 or 16-bit unsigned monochrome buffer with a host address;
+// returns false (empty tables) for any other buffer.
+bool IntegralImageBuild(MIL_ID MilImage, MIL_INT NbThreads, IntegralImage& Table)
+   {
+   if (!IsHostMonoUnsigned(MilImage))
+      {
+      Table.SizeX = Table.SizeY = 0;
+      Table.Stride = 1;
+      Table.Sum.clear();
+      Table.SumOfSquares.clear();
+      return false;
+      }
+
+   MIL_INT SizeBit = MbufInquire(MilImage, M_SIZE_BIT, M_NULL);
+   MIL_INT Pitch   = MbufInquire(MilImage, M_PITCH_BYTE, M_NULL);
+   const MIL_UINT8* Base = (const MIL_UINT8*)MbufInquire(MilImage, M_HOST_ADDRESS, M_NULL);
+
+   Table.SizeX  = MbufInquire(MilImage, M_SIZE_X, M_NULL);
+   Table.SizeY  = MbufInquire(MilImage, M_SIZE_Y, M_NULL);
+   Table.Stride = Table.SizeX + 1;
+   Table.Sum.resize(Table.Stride * (Table.SizeY + 1));
+   Table.SumOfSquares.resize(Table.Stride * (Table.SizeY + 1));
+   std::fill(Table.Sum.begin(), Table.Sum.begin() + Table.Stride, 0);
+   std::fill(Table.SumOfSquares.begin(), Table.SumOfSquares.begin() + Table.Stride, 0);
+
+   NbThreads = std::max(std::min(NbThreads, Table.SizeY), (MIL_INT)1);
+   MIL_INT RowsPerThread = (Table.SizeY + NbThreads - 1) / NbThreads;
+   auto Local = (SizeBit > 8) ? IntegralBandLocal<MIL_UINT16> : IntegralBandLocal<MIL_UINT8>;
+   std::vector<std::thread> Workers;
+
+   // 1) Each band integrated on its own.
+   for (MIL_INT t = 1; t < NbThreads; t++)
+      {
+      MIL_INT StartY = std::min(t * RowsPerThread, Table.SizeY);
+      Workers.push_back(std::thread(Local, Base, Pitch, StartY,
+                                    std::min(StartY + RowsPerThread, Table.SizeY), &Table));
+      }
+   Local(Base, Pitch, 0, std::min(RowsPerThread, Table.SizeY), &Table);
+   for (auto& Worker : Workers)
+      Worker.join();
+   Workers.clear();
+
+   // 2) Offsets of each band = running total of the bottom rows of the bands above it.
+   std::vector<MIL_UINT64> SumOffsets(NbThreads * Table.Stride, 0);
+   std::vector<MIL_UINT64> SqOffsets(NbThreads * Table.Stride, 0);
+   for (MIL_INT t = 1; t < NbThreads; t++)
+      {
+      MIL_INT LastRow = std::min(t * RowsPerThread, Table.SizeY);   // Table row of band t-1 bottom.
+      const MIL_UINT64* Sum = &Table.Sum[LastRow * Table.Stride];
+      const MIL_UINT64* Sq  = &Table.SumOfSquares[LastRow * Table.Stride];
+      for (MIL_INT x = 0; x < Table.Stride; x++)
+         {
+         SumOffsets[t * Table.Stride + x] = SumOffsets[(t - 1) * Table.Stride + x] + Sum[x];
+         SqOffsets[t * Table.Stride + x]  = SqOffsets[(t - 1) * Table.Stride + x] + Sq[x];
+         }
+      }
+
+   // 3) Offsets added in parallel (the first band needs none).
+   for (MIL_INT t = 1; t < NbThreads; t++)
+      {
+      MIL_INT StartY = std::min(t * RowsPerThread, Table.SizeY);
+      Workers.push_back(std::thread(IntegralBandOffset, &SumOffsets[t * Table.Stride], &SqOffsets[t * Table.Stride],
+                                    StartY, std::min(StartY + RowsPerThread, Table.SizeY), &Table));
+      }
+   for (auto& Worker : Workers)
+      Worker.join();
+   return true;
+   }
+
+// O(1) rectangle queries; the rectangle must lie inside the image.
+inline MIL_UINT64 IntegralRectSum(const std::vector<MIL_UINT64>& Data, MIL_INT Stride,
+                                  MIL_INT OffsetX, MIL_INT OffsetY, MIL_INT SizeX, MIL_INT SizeY)
+   {
+   const MIL_UINT64* Top    = &Data[OffsetY * Stride + OffsetX];
+   const MIL_UINT64* Bottom = &Data[(OffsetY + SizeY) * Stride + OffsetX];
+   return Bottom[SizeX] - Bottom[0] - Top[SizeX] + Top[0];
+   }
+
+inline MIL_UINT64 IntegralSum(const IntegralImage& Table, MIL_INT OffsetX, MIL_INT OffsetY,
+                              MIL_INT SizeX, MIL_INT SizeY)
+   {
+   return IntegralRectSum(Table.Sum, Table.Stride, OffsetX, OffsetY, SizeX, SizeY);
+   }
+
+inline MIL_DOUBLE IntegralMean(const IntegralImage& Table, MIL_INT OffsetX, MIL_INT OffsetY,
+                               MIL_INT SizeX, MIL_INT SizeY)
+   {
+   return (MIL_DOUBLE)IntegralSum(Table, OffsetX, OffsetY, SizeX, SizeY) / (MIL_DOUBLE)(SizeX * SizeY);
+   }
+
+inline MIL_DOUBLE IntegralVariance(const IntegralImage& Table, MIL_INT OffsetX, MIL_INT OffsetY,
+                                   MIL_INT SizeX, MIL_INT SizeY)
+   {
+   MIL_DOUBLE Count = (MIL_DOUBLE)(SizeX * SizeY);
+   MIL_DOUBLE Mean  = (MIL_DOUBLE)IntegralSum(Table, OffsetX, OffsetY, SizeX, SizeY) / Count;
+   MIL_DOUBLE MeanOfSquares =
+      (MIL_DOUBLE)IntegralRectSum(Table.SumOfSquares, Table.Stride, OffsetX, OffsetY, SizeX, SizeY) / Count;
+   return std::max(MeanOfSquares - Mean * Mean, 0.0);
+   }
+
+// Per-pad brightness check on a pad grid: one MimStatCalculate per pad on a moved child
+// buffer versus one integral build followed by O(1) queries.
+void IntegralStatsBenchmark(MIL_ID MilSystem)
+   {
+   MIL_INT NbCores = std::max((MIL_INT)std::thread::hardware_concurrency(), (MIL_INT)1);
+   MIL_ID  MilSource = MbufRestore(IMAGE_FILE, MilSystem, M_NULL);
+   MIL_ID  MilBoard  = MbufAlloc2d(MilSystem, INTEGRAL_BENCH_SIZE, INTEGRAL_BENCH_SIZE,
+                                   MbufInquire(MilSource, M_TYPE, M_NULL), M_IMAGE + M_PROC, M_NULL);
+   MimResize(MilSource, MilBoard, M_FILL_DESTINATION, M_FILL_DESTINATION, M_BILINEAR);
+
+   // Pad layout.
+   std::vector<MIL_INT> PadX, PadY;
+   for (MIL_INT y = 0; y + INTEGRAL_PAD_SIZE_Y <= INTEGRAL_BENCH_SIZE; y += INTEGRAL_PAD_PITCH_Y)
+      for (MIL_INT x = 0; x + INTEGRAL_PAD_SIZE_X <= INTEGRAL_BENCH_SIZE; x += INTEGRAL_PAD_PITCH_X)
+         {
+         PadX.push_back(x);
+         PadY.push_back(y);
+         }
+   MIL_INT NbPads = (MIL_INT)PadX.size();
+   std::vector<MIL_DOUBLE> MilMean(NbPads), MilVariance(NbPads), FastMean(NbPads), FastVariance(NbPads);
+
+   MosPrintf(MIL_TEXT("Integral image: mean and variance of %d pads (%d x %d) on a %d x %d image:\n\n"),
+             (int)NbPads, INTEGRAL_PAD_SIZE_X, INTEGRAL_PAD_SIZE_Y, INTEGRAL_BENCH_SIZE, INTEGRAL_BENCH_SIZE);
+
+   // (a) One statistics call per pad.
+   MIL_ID MilStatContext = MimAlloc(MilSystem, M_STATISTICS_CONTEXT, M_DEFAULT, M_NULL);
+   MIL_ID MilStatResult  = MimAllocResult(MilSystem, M_DEFAULT, M_STATISTICS_RESULT, M_NULL);
+   MimControl(MilStatContext, M_STAT_MEAN, M_ENABLE);
+   MimControl(MilStatContext, M_STAT_STANDARD_DEVIATION, M_ENABLE);
+   MIL_ID MilPad = MbufChild2d(MilBoard, 0, 0, INTEGRAL_PAD_SIZE_X, INTEGRAL_PAD_SIZE_Y, M_NULL);
+   MIL_DOUBLE TimeMil, TimeBuild, TimeQuery, StdDev;
+
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (MIL_INT p = 0; p < NbPads; p++)
+      {
+      MbufChildMove(MilPad, PadX[p], PadY[p], INTEGRAL_PAD_SIZE_X, INTEGRAL_PAD_SIZE_Y, M_DEFAULT);
+      MimStatCalculate(MilStatContext, MilPad, MilStatResult, M_DEFAULT);
+      MimGetResult(MilStatResult, M_STAT_MEAN, &MilMean[p]);
+      MimGetResult(MilStatResult, M_STAT_STANDARD_DEVIATION, &StdDev);
+      MilVariance[p] = StdDev * StdDev;
+      }
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeMil);
+
+   // (b) Integral tables once, then O(1) per pad.
+   IntegralImage Table;
+   if (!IntegralImageBuild(MilBoard, NbCores, Table))
+      {
+      MosPrintf(MIL_TEXT("MimStatCalculate per pad:   %8.2f ms\n"), TimeMil * 1000.0);
+      MosPrintf(MIL_TEXT("Integral image skipped: it needs an unsigned 8 or 16-bit host buffer.\n\n"));
+      MbufFree(MilPad);
+      MimFree(MilStatResult);
+      MimFree(MilStatContext);
+      MbufFree(MilBoard);
+      MbufFree(MilSource);
+      return;
+      }
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   IntegralImageBuild(MilBoard, NbCores, Table);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeBuild);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (MIL_INT p = 0; p < NbPads; p++)
+      {
+      FastMean[p]     = IntegralMean(Table, PadX[p], PadY[p], INTEGRAL_PAD_SIZE_X, INTEGRAL_PAD_SIZE_Y);
+      FastVariance[p] = IntegralVariance(Table, PadX[p], PadY[p], INTEGRAL_PAD_SIZE_X, INTEGRAL_PAD_SIZE_Y);
+      }
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeQuery);
+
+   // MIL may use a population or a sample standard deviation; compare the means exactly
+   // and the variances within that ratio.
+   MIL_DOUBLE MaxMeanError = 0.0, MaxVarianceError = 0.0;
+   MIL_DOUBLE SampleRatio = (MIL_DOUBLE)(INTEGRAL_PAD_SIZE_X * INTEGRAL_PAD_SIZE_Y) /
+                            (INTEGRAL_PAD_SIZE_X * INTEGRAL_PAD_SIZE_Y - 1);
+   for (MIL_INT p = 0; p < NbPads; p++)
+      {
+      MaxMeanError = std::max(MaxMeanError, fabs(FastMean[p] - MilMean[p]));
+      MIL_DOUBLE Error = std::min(fabs(FastVariance[p] - MilVariance[p]),
+                                  fabs(FastVariance[p] * SampleRatio - MilVariance[p]));
+      MaxVarianceError = std::max(MaxVarianceError, Error);
+      }
+
+   MosPrintf(MIL_TEXT("MimStatCalculate per pad:   %8.2f ms\n"), TimeMil * 1000.0);
+   MosPrintf(MIL_TEXT("Integral build (%2d threads): %7.2f ms\n"), (int)NbCores, TimeBuild * 1000.0);
+   MosPrintf(MIL_TEXT("Integral queries:           %8.2f ms (%.1f ns per pad)\n"),
+             TimeQuery * 1000.0, TimeQuery * 1.0e9 / NbPads);
+   MosPrintf(MIL_TEXT("Speedup: %.1fx, max mean difference %.2g, max variance difference %.2g.\n\n"),
+             TimeMil / (TimeBuild + TimeQuery), MaxMeanError, MaxVarianceError);
+
+   MbufFree(MilPad);
+   MimFree(MilStatResult);
+   MimFree(MilStatContext);
+   MbufFree(MilBoard);
+   MbufFree(MilSource);
+   }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Run-length encoded region masks.
+//
+// A mask is a list of horizontal runs [StartX, EndX) sorted by row then column, with an
+// index of the first run of every row. Masks can be built from a graphic list (as for
+// MbufSetRegion), from a threshold or from blob results, combined with union and
+// intersection, dilated, and used to drive statistics and morphology that only visit
+// the pixels inside the runs, so the cost follows the region area rather than the image.
+//////////////////////////////////////////////////////////////////////////////////////////
+#define RLE_BENCH_SIZE                 8192
+#define RLE_BENCH_NB_ZONES             200
+#define RLE_BENCH_ZONE_SIZE            64
+#define RLE_NB_LOOP                    10
+#define RLE_CHECK_RADIUS               2
+
+struct PixelRun
+   {
+   MIL_INT32 StartX, EndX;   // [StartX, EndX)
+   };
+
+struct RunLengthMask
+   {
+   MIL_INT               SizeX, SizeY;
+   std::vector<PixelRun> Runs;
+   std::vector<MIL_INT>  RowStart;   // Runs of row y: [RowStart[y], RowStart[y + 1]).
+   };
+
+static void RleBegin(RunLengthMask& Mask, MIL_INT SizeX, MIL_INT SizeY)
+   {
+   Mask.SizeX = SizeX;
+   Mask.SizeY = SizeY;
+   Mask.Runs.clear();
+   Mask.RowStart.assign(SizeY + 1, 0);
+   }
+
+MIL_INT RleArea(const RunLengthMask& Mask)
+   {
+   MIL_INT Area = 0;
+   for (const auto& Run : Mask.Runs)
+      Area += Run.EndX - Run.StartX;
+   return Area;
+   }
+
+// Runs of the pixels >= MinValue of host rows; Mask must have been begun at the image size.
+template <class PixelType>
+static void RleFromRows(const MIL_UINT8* Base, MIL_INT Pitch, MIL_INT MinValue, RunLengthMask& Mask)
+   {
+   for (MIL_INT y = 0; y < Mask.SizeY; y++)
+      {
+      const PixelType* Row = (const PixelType*)(Base + y * Pitch);
+      MIL_INT Start = -1;
+      for (MIL_INT x = 0; x <= Mask.SizeX; x++)
+         {
+         bool Inside = (x < Mask.SizeX) && (Row[x] >= MinValue);
+         if (Inside && Start < 0)
+            Start = x;
+         else if (!Inside && Start >= 0)
+            {
+            Mask.Runs.push_back({ (MIL_INT32)Start, (MIL_INT32)x });
+            Start = -1;
+            }
+         }
+      Mask.RowStart[y + 1] = (MIL_INT)Mask.Runs.size();
+      }
+   }
+
+// Pixels greater than Threshold. 8 and 16-bit unsigned monochrome host buffers are read
+// directly; any other buffer is binarized by MimBinarize on its own system and the 0/255
+// result is read back with MbufGet2d.
+void RleFromThreshold(MIL_ID MilImage, MIL_DOUBLE Threshold, RunLengthMask& Mask)
+   {
+   MIL_INT SizeX = MbufInquire(MilImage, M_SIZE_X, M_NULL);
+   MIL_INT SizeY = MbufInquire(MilImage, M_SIZE_Y, M_NULL);
+
+   RleBegin(Mask, SizeX, SizeY);
+   if (IsHostMonoUnsigned(MilImage))
+      {
+      MIL_INT Pitch = MbufInquire(MilImage, M_PITCH_BYTE, M_NULL);
+      const MIL_UINT8* Base = (const MIL_UINT8*)MbufInquire(MilImage, M_HOST_ADDRESS, M_NULL);
+      MIL_INT MinValue = std::max((MIL_INT)floor(Threshold) + 1, (MIL_INT)0);
+      if (MbufInquire(MilImage, M_SIZE_BIT, M_NULL) > 8)
+         RleFromRows<MIL_UINT16>(Base, Pitch, MinValue, Mask);
+      else
+         RleFromRows<MIL_UINT8>(Base, Pitch, MinValue, Mask);
+      return;
+      }
+
+   MIL_ID MilBinary = MbufAlloc2d(MbufInquire(MilImage, M_OWNER_SYSTEM, M_NULL), SizeX, SizeY,
+                                  8 + M_UNSIGNED, M_IMAGE + M_PROC, M_NULL);
+   std::vector<MIL_UINT8> Binary(SizeX * SizeY);
+   MimBinarize(MilImage, MilBinary, M_GREATER, Threshold, M_NULL);
+   MbufGet2d(MilBinary, 0, 0, SizeX, SizeY, Binary.data());
+   MbufFree(MilBinary);
+   RleFromRows<MIL_UINT8>(Binary.data(), SizeX, 1, Mask);
+   }
+
+// Filled shapes of a graphic list, i.e. the region MbufSetRegion would set from it.
+// The graphics are drawn in 255 and their own colors are restored afterwards, so the
+// caller's list is left untouched.
+void RleFromGraphicList(MIL_ID MilSystem, MIL_ID MilGraphicList, MIL_INT SizeX, MIL_INT SizeY,
+                        RunLengthMask& Mask)
+   {
+   MIL_INT NbGraphics = 0;
+   MgraInquireList(MilGraphicList, M_LIST, M_DEFAULT, M_NUMBER_OF_GRAPHICS, &NbGraphics);
+   std::vector<MIL_DOUBLE> Colors(NbGraphics);
+   for (MIL_INT g = 0; g < NbGraphics; g++)
+      MgraInquireList(MilGraphicList, M_GRAPHIC_INDEX(g), M_DEFAULT, M_COLOR, &Colors[g]);
+
+   MIL_ID MilMaskImage = MbufAlloc2d(MilSystem, SizeX, SizeY, 8 + M_UNSIGNED, M_IMAGE + M_PROC, M_NULL);
+   MbufClear(MilMaskImage, 0);
+   MgraControlList(MilGraphicList, M_ALL, M_DEFAULT, M_COLOR, 255);
+   MgraDraw(MilGraphicList, MilMaskImage, M_DEFAULT);
+   for (MIL_INT g = 0; g < NbGraphics; g++)
+      MgraControlList(MilGraphicList, M_GRAPHIC_INDEX(g), M_DEFAULT, M_COLOR, Colors[g]);
+   RleFromThreshold(MilMaskImage, 0, Mask);
+   MbufFree(MilMaskImage);
+   }
+
+// Blobs of a blob result (all included blobs).
+void RleFromBlobs(MIL_ID MilSystem, MIL_ID MilBlobResult, MIL_INT SizeX, MIL_INT SizeY,
+                  RunLengthMask& Mask)
+   {
+   MIL_ID MilMaskImage = MbufAlloc2d(MilSystem, SizeX, SizeY, 8 + M_UNSIGNED, M_IMAGE + M_PROC, M_NULL);
+   MbufClear(MilMaskImage, 0);
+   MIL_DOUBLE PreviousColor = MgraInquire(M_DEFAULT, M_COLOR, M_NULL);
+   MgraColor(M_DEFAULT, 255);
+   MblobDraw(M_DEFAULT, MilBlobResult, MilMaskImage, M_DRAW_BLOBS, M_INCLUDED_BLOBS, M_DEFAULT);
+   MgraColor(M_DEFAULT, PreviousColor);
+   RleFromThreshold(MilMaskImage, 0, Mask);
+   MbufFree(MilMaskImage);
+   }
+
+// Merges the sorted runs of one row of A and B. Union keeps pixels in either,
+// intersection pixels in both.
+static void RleMergeRow(const PixelRun* A, const PixelRun* AEnd, const PixelRun* B, const PixelRun* BEnd,
+                        bool Union, std::vector<PixelRun>& Out)
+   {
+   if (Union)
+      {
+      while (A != AEnd || B != BEnd)
+         {
+         // Take the run starting first, then absorb every run touching it.
+         PixelRun Run = (B == BEnd || (A != AEnd && A->StartX <= B->StartX)) ? *A++ : *B++;
+         for (;;)
+            {
+            if (A != AEnd && A->StartX <= Run.EndX)
+               Run.EndX = std::max(Run.EndX, (A++)->EndX);
+            else if (B != BEnd && B->StartX <= Run.EndX)
+               Run.EndX = std::max(Run.EndX, (B++)->EndX);
+            else
+               break;
+            }
+         Out.push_back(Run);
+         }
+      }
+   else
+      {
+      while (A != AEnd && B != BEnd)
+         {
+         MIL_INT32 Start = std::max(A->StartX, B->StartX);
+         MIL_INT32 End   = std::min(A->EndX, B->EndX);
+         if (Start < End)
+            Out.push_back({ Start, End });
+         if (A->EndX < B->EndX)
+            A++;
+         else
+            B++;
+         }
+      }
+   }
+
+// Both masks must have the same size; returns false (Result unchanged) otherwise.
+static bool RleCombine(const RunLengthMask& A, const RunLengthMask& B, bool Union, RunLengthMask& Result)
+   {
+   assert(A.SizeX == B.SizeX && A.SizeY == B.SizeY);
+   if (A.SizeX != B.SizeX || A.SizeY != B.SizeY)
+      return false;
+
+   RunLengthMask Out;
+   RleBegin(Out, A.SizeX, A.SizeY);
+   for (MIL_INT y = 0; y < A.SizeY; y++)
+      {
+      const PixelRun* ARuns = A.Runs.data();
+      const PixelRun* BRuns = B.Runs.data();
+      RleMergeRow(ARuns + A.RowStart[y], ARuns + A.RowStart[y + 1],
+                  BRuns + B.RowStart[y], BRuns + B.RowStart[y + 1], Union, Out.Runs);
+      Out.RowStart[y + 1] = (MIL_INT)Out.Runs.size();
+      }
+   Result.SizeX = Out.SizeX;
+   Result.SizeY = Out.SizeY;
+   Result.Runs.swap(Out.Runs);
+   Result.RowStart.swap(Out.RowStart);
+   return true;
+   }
+
+bool RleUnion(const RunLengthMask& A, const RunLengthMask& B, RunLengthMask& Result)
+   {
+   return RleCombine(A, B, true, Result);
+   }
+
+bool RleIntersection(const RunLengthMask& A, const RunLengthMask& B, RunLengthMask& Result)
+   {
+   return RleCombine(A, B, false, Result);
+   }
+
+// Dilation by a (2 * Radius + 1) square: runs widened by Radius, then each row is the
+// union of the widened rows within Radius above and below.
+void RleDilate(const RunLengthMask& Mask, MIL_INT Radius, RunLengthMask& Result)
+   {
+   RunLengthMask Wide, Out;
+   RleBegin(Wide, Mask.SizeX, Mask.SizeY);
+   for (MIL_INT y = 0; y < Mask.SizeY; y++)
+      {
+      for (MIL_INT r = Mask.RowStart[y]; r < Mask.RowStart[y + 1]; r++)
+         {
+         PixelRun Run = { (MIL_INT32)std::max(Mask.Runs[r].StartX - Radius, (MIL_INT)0),
+                          (MIL_INT32)std::min(Mask.Runs[r].EndX + Radius, Mask.SizeX) };
+         if (!Wide.Runs.empty() && (MIL_INT)Wide.Runs.size() > Wide.RowStart[y] && Wide.Runs.back().EndX >= Run.StartX)
+            Wide.Runs.back().EndX = std::max(Wide.Runs.back().EndX, Run.EndX);
+         else
+            Wide.Runs.push_back(Run);
+         }
+      Wide.RowStart[y + 1] = (MIL_INT)Wide.Runs.size();
+      }
+
+   RleBegin(Out, Mask.SizeX, Mask.SizeY);
+   std::vector<PixelRun> Row, Merged;
+   for (MIL_INT y = 0; y < Mask.SizeY; y++)
+      {
+      Row.clear();
+      for (MIL_INT yy = std::max(y - Radius, (MIL_INT)0); yy <= std::min(y + Radius, Mask.SizeY - 1); yy++)
+         {
+         Merged.clear();
+         RleMergeRow(Row.data(), Row.data() + Row.size(),
+                     Wide.Runs.data() + Wide.RowStart[yy], Wide.Runs.data() + Wide.RowStart[yy + 1], true, Merged);
+         Row.swap(Merged);
+         }
+      Out.Runs.insert(Out.Runs.end(), Row.begin(), Row.end());
+      Out.RowStart[y + 1] = (MIL_INT)Out.Runs.size();
+      }
+   Result.SizeX = Out.SizeX;
+   Result.SizeY = Out.SizeY;
+   Result.Runs.swap(Out.Runs);
+   Result.RowStart.swap(Out.RowStart);
+   }
+
+// Statistics of the pixels inside the mask; only the runs are read.
+template <class PixelType>
+static void RleStatsT(const MIL_UINT8* Base, MIL_INT Pitch, const RunLengthMask& Mask, RegionStats& Stats)
+   {
+   MIL_UINT64 Sum = 0, SumOfSquares = 0;
+   ResetRegionStats(Stats);
+   for (MIL_INT y = 0; y < Mask.SizeY; y++)
+      {
+      const PixelType* Row = (const PixelType*)(Base + y * Pitch);
+      for (MIL_INT r = Mask.RowStart[y]; r < Mask.RowStart[y + 1]; r++)
+         {
+         const PixelRun& Run = Mask.Runs[r];
+         for (MIL_INT x = Run.StartX; x < Run.EndX; x++)
+            {
+            MIL_UINT64 Pixel = Row[x];
+            Sum          += Pixel;
+            SumOfSquares += Pixel * Pixel;
+            Stats.Min = std::min(Stats.Min, (MIL_INT)Pixel);
+            Stats.Max = std::max(Stats.Max, (MIL_INT)Pixel);
+            }
+         if (Stats.TopLeftY < 0)
+            {
+            Stats.TopLeftY = y;
+            Stats.TopLeftX = Run.StartX;
+            Stats.BottomRightX = Run.EndX - 1;
+            }
+         Stats.TopLeftX     = std::min(Stats.TopLeftX, (MIL_INT)Run.StartX);
+         Stats.BottomRightX = std::max(Stats.BottomRightX, (MIL_INT)Run.EndX - 1);
+         Stats.BottomRightY = y;
+         Stats.Count += Run.EndX - Run.StartX;
+         }
+      }
+   Stats.Sum          = (MIL_DOUBLE)Sum;
+   Stats.SumOfSquares = (MIL_DOUBLE)SumOfSquares;
+   }
+
+// True when the mask covers exactly the image, so every run lies inside it.
+static bool RleFitsImage(const RunLengthMask& Mask, MIL_ID MilImage)
+   {
+   return Mask.SizeX == MbufInquire(MilImage, M_SIZE_X, M_NULL) &&
+          Mask.SizeY == MbufInquire(MilImage, M_SIZE_Y, M_NULL);
+   }
+
+// True when the row index and every run lie inside the mask size.
+static bool RleRunsInside(const RunLengthMask& Mask)
+   {
+   if ((MIL_INT)Mask.RowStart.size() != Mask.SizeY + 1 || Mask.RowStart[0] != 0 ||
+       Mask.RowStart[Mask.SizeY] != (MIL_INT)Mask.Runs.size())
+      return false;
+   for (MIL_INT y = 0; y < Mask.SizeY; y++)
+      {
+      if (Mask.RowStart[y] > Mask.RowStart[y + 1])
+         return false;
+      for (MIL_INT r = Mask.RowStart[y]; r < Mask.RowStart[y + 1]; r++)
+         if (Mask.Runs[r].StartX < 0 || Mask.Runs[r].StartX >= Mask.Runs[r].EndX || Mask.Runs[r].EndX > Mask.SizeX)
+            return false;
+      }
+   return true;
+   }
+
+// Supports 8 and 16-bit unsigned monochrome host buffers of the mask size; returns false
+// (Stats left reset) for any other buffer.
+bool RleStats(MIL_ID MilImage, const RunLengthMask& Mask, RegionStats& Stats)
+   {
+   ResetRegionStats(Stats);
+   if (!IsHostMonoUnsigned(MilImage) || !RleFitsImage(Mask, MilImage))
+      return false;
+
+   MIL_INT Pitch = MbufInquire(MilImage, M_PITCH_BYTE, M_NULL);
+   const MIL_UINT8* Base = (const MIL_UINT8*)MbufInquire(MilImage, M_HOST_ADDRESS, M_NULL);
+   if (MbufInquire(MilImage, M_SIZE_BIT, M_NULL) > 8)
+      RleStatsT<MIL_UINT16>(Base, Pitch, Mask, Stats);
+   else
+      RleStatsT<MIL_UINT8>(Base, Pitch, Mask, Stats);
+   return true;
+   }
+
+// 3x3 grayscale erosion (Erode = true) or dilation of the pixels inside the mask; the
+// destination is written only inside the runs, neighbors outside the mask are still read.
+template <class PixelType>
+static void RleRank3x3T(const MIL_UINT8* SrcBase, MIL_INT SrcPitch, MIL_UINT8* DstBase, MIL_INT DstPitch,
+                        const RunLengthMask& Mask, bool Erode)
+   {
+   for (MIL_INT y = 0; y < Mask.SizeY; y++)
+      {
+      const PixelType* Rows[3];
+      for (MIL_INT k = 0; k < 3; k++)
+         Rows[k] = (const PixelType*)(SrcBase + std::min(std::max(y + k - 1, (MIL_INT)0), Mask.SizeY - 1) * SrcPitch);
+      PixelType* Dst = (PixelType*)(DstBase + y * DstPitch);
+
+      for (MIL_INT r = Mask.RowStart[y]; r < Mask.RowStart[y + 1]; r++)
+         {
+         for (MIL_INT x = Mask.Runs[r].StartX; x < Mask.Runs[r].EndX; x++)
+            {
+            MIL_INT Left = std::max(x - 1, (MIL_INT)0), Right = std::min(x + 1, Mask.SizeX - 1);
+            PixelType Value = Rows[1][x];
+            for (MIL_INT k = 0; k < 3; k++)
+               {
+               PixelType a = Rows[k][Left], b = Rows[k][x], c = Rows[k][Right];
+               Value = Erode ? std::min(Value, std::min(a, std::min(b, c)))
+                             : std::max(Value, std::max(a, std::max(b, c)));
+               }
+            Dst[x] = Value;
+            }
+         }
+      }
+   }
+
+// Src and Dst must be different 8 or 16-bit unsigned monochrome host buffers of the same
+// size and type as well as of the mask size; returns false (Dst untouched) otherwise.
+bool RleRank3x3(MIL_ID MilSrc, MIL_ID MilDst, const RunLengthMask& Mask, bool Erode)
+   {
+   if (MilSrc == MilDst || !IsHostMonoUnsigned(MilSrc) || !IsHostMonoUnsigned(MilDst) ||
+       !RleFitsImage(Mask, MilSrc) || !RleFitsImage(Mask, MilDst) ||
+       MbufInquire(MilSrc, M_TYPE, M_NULL) != MbufInquire(MilDst, M_TYPE, M_NULL))
+      return false;
+
+   const MIL_UINT8* Src = (const MIL_UINT8*)MbufInquire(MilSrc, M_HOST_ADDRESS, M_NULL);
+   MIL_UINT8*       Dst = (MIL_UINT8*)MbufInquire(MilDst, M_HOST_ADDRESS, M_NULL);
+   MIL_INT SrcPitch = MbufInquire(MilSrc, M_PITCH_BYTE, M_NULL);
+   MIL_INT DstPitch = MbufInquire(MilDst, M_PITCH_BYTE, M_NULL);
+   if (MbufInquire(MilSrc, M_SIZE_BIT, M_NULL) > 8)
+      RleRank3x3T<MIL_UINT16>(Src, SrcPitch, Dst, DstPitch, Mask, Erode);
+   else
+      RleRank3x3T<MIL_UINT8>(Src, SrcPitch, Dst, DstPitch, Mask, Erode);
+   return true;
+   }
+
+// Toggles (XOR 255) the pixels inside the runs of an 8-bit host buffer of the mask size.
+// On a 0/255 image of the same region only the pixels where the two differ remain set.
+static void RleToggle(const RunLengthMask& Mask, MIL_ID MilImage)
+   {
+   MIL_INT Pitch = MbufInquire(MilImage, M_PITCH_BYTE, M_NULL);
+   MIL_UINT8* Base = (MIL_UINT8*)MbufInquire(MilImage, M_HOST_ADDRESS, M_NULL);
+   for (MIL_INT y = 0; y < Mask.SizeY; y++)
+      for (MIL_INT r = Mask.RowStart[y]; r < Mask.RowStart[y + 1]; r++)
+         for (MIL_INT x = Mask.Runs[r].StartX; x < Mask.Runs[r].EndX; x++)
+            Base[y * Pitch + x] ^= 0xFF;
+   }
+
+// 0/255 image of the mask.
+static void RleDraw(const RunLengthMask& Mask, MIL_ID MilImage)
+   {
+   MbufClear(MilImage, 0);
+   RleToggle(Mask, MilImage);
+   }
+
+// Number of non-zero pixels (inside the region of the buffer, if any), from MimStatCalculate.
+static MIL_INT CountNonZero(MIL_ID MilSystem, MIL_ID MilImage)
+   {
+   MIL_ID MilStatContext = MimAlloc(MilSystem, M_STATISTICS_CONTEXT, M_DEFAULT, M_NULL);
+   MIL_ID MilStatResult  = MimAllocResult(MilSystem, M_DEFAULT, M_STATISTICS_RESULT, M_NULL);
+   MIL_DOUBLE Number = 0.0;
+   MimControl(MilStatContext, M_STAT_NUMBER, M_ENABLE);
+   MimControl(MilStatContext, M_CONDITION, M_NOT_EQUAL);
+   MimControl(MilStatContext, M_COND_LOW, 0);
+   MimStatCalculate(MilStatContext, MilImage, MilStatResult, M_DEFAULT);
+   MimGetResult(MilStatResult, M_STAT_NUMBER, &Number);
+   MimFree(MilStatResult);
+   MimFree(MilStatContext);
+   return (MIL_INT)Number;
+   }
+
+// Union, intersection, dilation and blob masks versus the MIL operations on 0/255 images
+// (MimArith M_OR/M_AND, MimDilate, Mblob); prints the number of differing pixels.
+static void RleCheckOperations(MIL_ID MilSystem, const RunLengthMask& A, const RunLengthMask& B)
+   {
+   MIL_ID MilMaskA = MbufAlloc2d(MilSystem, A.SizeX, A.SizeY, 8 + M_UNSIGNED, M_IMAGE + M_PROC, M_NULL);
+   MIL_ID MilMaskB = MbufAlloc2d(MilSystem, A.SizeX, A.SizeY, 8 + M_UNSIGNED, M_IMAGE + M_PROC, M_NULL);
+   MIL_ID MilWork  = MbufAlloc2d(MilSystem, A.SizeX, A.SizeY, 8 + M_UNSIGNED, M_IMAGE + M_PROC, M_NULL);
+   RunLengthMask Result;
+   MIL_INT NbUnion, NbIntersection, NbDilate, NbBlobs;
+   RleDraw(A, MilMaskA);
+   RleDraw(B, MilMaskB);
+
+   RleUnion(A, B, Result);
+   MimArith(MilMaskA, MilMaskB, MilWork, M_OR);
+   RleToggle(Result, MilWork);
+   NbUnion = CountNonZero(MilSystem, MilWork);
+
+   RleIntersection(A, B, Result);
+   MimArith(MilMaskA, MilMaskB, MilWork, M_AND);
+   RleToggle(Result, MilWork);
+   NbIntersection = CountNonZero(MilSystem, MilWork);
+
+   RleDilate(A, RLE_CHECK_RADIUS, Result);
+   MimDilate(MilMaskA, MilWork, RLE_CHECK_RADIUS, M_BINARY);
+   RleToggle(Result, MilWork);
+   NbDilate = CountNonZero(MilSystem, MilWork);
+
+   MIL_ID MilBlobContext = MblobAlloc(MilSystem, M_DEFAULT, M_DEFAULT, M_NULL);
+   MIL_ID MilBlobResult  = MblobAllocResult(MilSystem, M_DEFAULT, M_DEFAULT, M_NULL);
+   MblobCalculate(MilBlobContext, MilMaskA, M_NULL, MilBlobResult);
+   RleFromBlobs(MilSystem, MilBlobResult, A.SizeX, A.SizeY, Result);
+   MbufCopy(MilMaskA, MilWork);
+   RleToggle(Result, MilWork);
+   NbBlobs = CountNonZero(MilSystem, MilWork);
+   MblobFree(MilBlobResult);
+   MblobFree(MilBlobContext);
+
+   MosPrintf(MIL_TEXT("Mask operations versus MIL, differing pixels: union (M_OR) %d, intersection (M_AND) %d,\n")
+             MIL_TEXT("dilation by %d (MimDilate) %d, mask from blobs (Mblob) %d.\n"),
+             (int)NbUnion, (int)NbIntersection, RLE_CHECK_RADIUS, (int)NbDilate, (int)NbBlobs);
+
+   MbufFree(MilWork);
+   MbufFree(MilMaskB);
+   MbufFree(MilMaskA);
+   }
+
+// Sparse inspection zones on a regular grid of the benchmark image, drawn in a graphic
+// list as for MbufSetRegion; Offset shifts every zone diagonally.
+static MIL_ID AllocZoneList(MIL_ID MilSystem, MIL_INT Offset)
+   {
+   MIL_ID MilZones = MgraAllocList(MilSystem, M_DEFAULT, M_NULL);
+   MIL_INT NbPerSide = (MIL_INT)ceil(sqrt((MIL_DOUBLE)RLE_BENCH_NB_ZONES));
+   MIL_INT Spacing   = RLE_BENCH_SIZE / NbPerSide;
+   for (MIL_INT z = 0; z < RLE_BENCH_NB_ZONES; z++)
+      {
+      MIL_INT x = (z % NbPerSide) * Spacing + Spacing / 4 + Offset, y = (z / NbPerSide) * Spacing + Spacing / 4 + Offset;
+      MgraRectFill(M_DEFAULT, MilZones, x, y, x + RLE_BENCH_ZONE_SIZE - 1, y + RLE_BENCH_ZONE_SIZE - 1);
+      }
+   return MilZones;
+   }
+
+// Sparse inspection zones on a large image: MbufSetRegion + MimStatCalculate and a full
+// MimErode versus the same work driven by a run-length mask. The masked erosion is checked
+// pixel by pixel against MimErode inside the zones, and the other mask operations against
+// their MIL equivalents.
+void RleBenchmark(MIL_ID MilSystem)
+   {
+   MIL_ID MilSource = MbufRestore(IMAGE_FILE, MilSystem, M_NULL);
+   MIL_ID MilLarge  = MbufAlloc2d(MilSystem, RLE_BENCH_SIZE, RLE_BENCH_SIZE, MbufInquire(MilSource, M_TYPE, M_NULL),
+                                  M_IMAGE + M_PROC, M_NULL);
+   MIL_ID MilEroded = MbufAlloc2d(MilSystem, RLE_BENCH_SIZE, RLE_BENCH_SIZE, MbufInquire(MilSource, M_TYPE, M_NULL),
+                                  M_IMAGE + M_PROC, M_NULL);
+   MIL_ID MilRleEroded = MbufAlloc2d(MilSystem, RLE_BENCH_SIZE, RLE_BENCH_SIZE, MbufInquire(MilSource, M_TYPE, M_NULL),
+                                     M_IMAGE + M_PROC, M_NULL);
+   MimResize(MilSource, MilLarge, M_FILL_DESTINATION, M_FILL_DESTINATION, M_BILINEAR);
+
+   if (!IsHostMonoUnsigned(MilLarge) || !IsHostMonoUnsigned(MilEroded) || !IsHostMonoUnsigned(MilRleEroded))
+      {
+      MosPrintf(MIL_TEXT("Run-length mask benchmark skipped: it needs unsigned 8 or 16-bit host buffers.\n\n"));
+      MbufFree(MilRleEroded);
+      MbufFree(MilEroded);
+      MbufFree(MilLarge);
+      MbufFree(MilSource);
+      return;
+      }
+
+   MIL_ID MilZones = AllocZoneList(MilSystem, 0);
+
+   MIL_DOUBLE TimeBuild, TimeMilStats, TimeRleStats, TimeMilErode, TimeRleErode, Mean = 0.0;
+   RunLengthMask Zones;
+   RegionStats   Stats;
+
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   RleFromGraphicList(MilSystem, MilZones, RLE_BENCH_SIZE, RLE_BENCH_SIZE, Zones);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeBuild);
+
+   MosPrintf(MIL_TEXT("Run-length mask: %d zones of %d x %d on a %d x %d image (%.2f%% of the pixels, %d runs):\n\n"),
+             RLE_BENCH_NB_ZONES, RLE_BENCH_ZONE_SIZE, RLE_BENCH_ZONE_SIZE, RLE_BENCH_SIZE, RLE_BENCH_SIZE,
+             100.0 * RleArea(Zones) / (RLE_BENCH_SIZE * RLE_BENCH_SIZE), (int)Zones.Runs.size());
+
+   // Statistics in the region.
+   MIL_ID MilStatContext = MimAlloc(MilSystem, M_STATISTICS_CONTEXT, M_DEFAULT, M_NULL);
+   MIL_ID MilStatResult  = MimAllocResult(MilSystem, M_DEFAULT, M_STATISTICS_RESULT, M_NULL);
+   MimControl(MilStatContext, M_STAT_MEAN, M_ENABLE);
+   MbufSetRegion(MilLarge, MilZones, M_DEFAULT, M_DEFAULT, M_DEFAULT);
+   MimStatCalculate(MilStatContext, MilLarge, MilStatResult, M_DEFAULT);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (MIL_INT n = 0; n < RLE_NB_LOOP; n++)
+      MimStatCalculate(MilStatContext, MilLarge, MilStatResult, M_DEFAULT);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeMilStats);
+   MimGetResult(MilStatResult, M_STAT_MEAN, &Mean);
+   MbufSetRegion(MilLarge, M_NULL, M_DEFAULT, M_DELETE, M_DEFAULT);
+
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (MIL_INT n = 0; n < RLE_NB_LOOP; n++)
+      RleStats(MilLarge, Zones, Stats);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeRleStats);
+
+   // 3x3 erosion needed only inside the zones.
+   MimErode(MilLarge, MilEroded, 1, M_GRAYSCALE);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (MIL_INT n = 0; n < RLE_NB_LOOP; n++)
+      MimErode(MilLarge, MilEroded, 1, M_GRAYSCALE);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeMilErode);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (MIL_INT n = 0; n < RLE_NB_LOOP; n++)
+      RleRank3x3(MilLarge, MilRleEroded, Zones, true);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeRleErode);
+
+   // Pixels of the masked erosion different from MimErode inside the zones.
+   MimArith(MilEroded, MilRleEroded, MilRleEroded, M_SUB_ABS);
+   MbufSetRegion(MilRleEroded, MilZones, M_DEFAULT, M_DEFAULT, M_DEFAULT);
+   MIL_INT NbErodeDiff = CountNonZero(MilSystem, MilRleEroded);
+   MbufSetRegion(MilRleEroded, M_NULL, M_DEFAULT, M_DELETE, M_DEFAULT);
+
+   MosPrintf(MIL_TEXT("Mask built from the graphic list: %.2f ms\n"), TimeBuild * 1000.0);
+   MosPrintf(MIL_TEXT("Region mean, MimStatCalculate: %8.3f ms   run-length mask: %8.3f ms   (%.2f vs %.2f)\n"),
+             TimeMilStats * 1000.0 / RLE_NB_LOOP, TimeRleStats * 1000.0 / RLE_NB_LOOP,
+             Mean, Stats.Count ? Stats.Sum / Stats.Count : 0.0);
+   MosPrintf(MIL_TEXT("3x3 erosion,  MimErode (full): %8.3f ms   run-length mask: %8.3f ms   (%s)\n"),
+             TimeMilErode * 1000.0 / RLE_NB_LOOP, TimeRleErode * 1000.0 / RLE_NB_LOOP,
+             NbErodeDiff == 0 ? MIL_TEXT("identical inside the mask") : MIL_TEXT("DIFFERENT inside the mask"));
+
+   // Second set of zones overlapping the first by half a zone.
+   MIL_ID MilShifted = AllocZoneList(MilSystem, RLE_BENCH_ZONE_SIZE / 2);
+   RunLengthMask Shifted;
+   RleFromGraphicList(MilSystem, MilShifted, RLE_BENCH_SIZE, RLE_BENCH_SIZE, Shifted);
+   RleCheckOperations(MilSystem, Zones, Shifted);
+   MosPrintf(MIL_TEXT("\n"));
+   MgraFree(MilShifted);
+
+   MimFree(MilStatResult);
+   MimFree(MilStatContext);
+   MgraFree(MilZones);
+   MbufFree(MilRleEroded);
+   MbufFree(MilEroded);
+   MbufFree(MilLarge);
+   MbufFree(MilSource);
+   }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Region-aware grayscale opening.
+//
+// N iterations of a 3x3 erosion (dilation) equal one erosion (dilation) by a square of
+// side 2N + 1, which is separable into a horizontal and a vertical 1D min (max) filter.
+// Each 1D filter uses van Herk/Gil-Werman: a forward and a backward running extremum
+// over blocks of the window width give the result with 3 comparisons per pixel,
+// whatever N. The image is cut in tiles; only the tiles intersecting the region mask are
+// processed, each from a window of the tile plus a halo of 2N pixels (N for the erosion
+// and N for the dilation), so all iterations run on cache-resident data in one pass.
+//////////////////////////////////////////////////////////////////////////////////////////
+#define MORPHO_TILE_SIZE               128
+#define MORPHO_NB_LOOP                 5
+
+// van Herk/Gil-Werman 1D min (IsMin) or max over a window of 2 * Radius + 1 on Count
+// values read with Stride; outside [0, Count) the edge values are replicated.
+// Scratch must hold 3 * (Count + 2 * Radius + 2 * Radius + 1) values.
+template <class PixelType>
+static void VanHerkLine(const PixelType* Src, MIL_INT SrcStride, PixelType* Dst, MIL_INT DstStride,
+                        MIL_INT Count, MIL_INT Radius, bool IsMin, PixelType* Scratch)
+   {
+   MIL_INT Width  = 2 * Radius + 1;
+   MIL_INT Padded = Count + 2 * Radius;
+   MIL_INT Length = ((Padded + Width - 1) / Width) * Width;   // Whole blocks.
+   PixelType* Line     = Scratch;
+   PixelType* Forward  = Scratch + Length;
+   PixelType* Backward = Scratch + 2 * Length;
+
+   for (MIL_INT i = 0; i < Length; i++)
+      Line[i] = Src[std::min(std::max(i - Radius, (MIL_INT)0), Count - 1) * SrcStride];
+
+   for (MIL_INT Block = 0; Block < Length; Block += Width)
+      {
+      Forward[Block] = Line[Block];
+      for (MIL_INT i = Block + 1; i < Block + Width; i++)
+         Forward[i] = IsMin ? std::min(Forward[i - 1], Line[i]) : std::max(Forward[i - 1], Line[i]);
+      Backward[Block + Width - 1] = Line[Block + Width - 1];
+      for (MIL_INT i = Block + Width - 2; i >= Block; i--)
+         Backward[i] = IsMin ? std::min(Backward[i + 1], Line[i]) : std::max(Backward[i + 1], Line[i]);
+      }
+
+   // Output i covers padded positions [i, i + Width - 1].
+   for (MIL_INT i = 0; i < Count; i++)
+      Dst[i * DstStride] = IsMin ? std::min(Backward[i], Forward[i + Width - 1])
+                                 : std::max(Backward[i], Forward[i + Width - 1]);
+   }
+
+// Separable square min/max of Radius on a SizeX x SizeY window (pitch in pixels).
+template <class PixelType>
+static void SquareRank(const PixelType* Src, PixelType* Dst, PixelType* Temp, MIL_INT Pitch,
+                       MIL_INT SizeX, MIL_INT SizeY, MIL_INT Radius, bool IsMin, PixelType* Scratch)
+   {
+   for (MIL_INT y = 0; y < SizeY; y++)
+      VanHerkLine(Src + y * Pitch, 1, Temp + y * Pitch, 1, SizeX, Radius, IsMin, Scratch);
+   for (MIL_INT x = 0; x < SizeX; x++)
+      VanHerkLine(Temp + x, Pitch, Dst + x, Pitch, SizeY, Radius, IsMin, Scratch);
+   }
+
+// Opens the tiles listed in Tiles (tile indices), taking them from a shared counter.
+template <class PixelType>
+static void OpenTiles(const MIL_UINT8* SrcBase, MIL_INT SrcPitch, MIL_UINT8* DstBase, MIL_INT DstPitch,
+                      MIL_INT SizeX, MIL_INT SizeY, MIL_INT Iterations, const std::vector<MIL_INT>* Tiles,
+                      std::atomic<MIL_INT>* NextTile)
+   {
+   MIL_INT Halo     = 2 * Iterations;
+   MIL_INT MaxSide  = MORPHO_TILE_SIZE + 2 * Halo;
+   MIL_INT TilesX   = (SizeX + MORPHO_TILE_SIZE - 1) / MORPHO_TILE_SIZE;
+   std::vector<PixelType> Window(MaxSide * MaxSide), Eroded(MaxSide * MaxSide), Temp(MaxSide * MaxSide);
+   std::vector<PixelType> Scratch(3 * (MaxSide + 4 * Iterations + 1));
+
+   for (MIL_INT t = (*NextTile)++; t < (MIL_INT)Tiles->size(); t = (*NextTile)++)
+      {
+      MIL_INT TileX = ((*Tiles)[t] % TilesX) * MORPHO_TILE_SIZE;
+      MIL_INT TileY = ((*Tiles)[t] / TilesX) * MORPHO_TILE_SIZE;
+      MIL_INT TileW = std::min((MIL_INT)MORPHO_TILE_SIZE, SizeX - TileX);
+      MIL_INT TileH = std::min((MIL_INT)MORPHO_TILE_SIZE, SizeY - TileY);
+
+      // Window = tile + halo, clipped to the image: clipped sides are image borders,
+      // where replicating the edge gives the same result as the full-image operation.
+      MIL_INT X0 = std::max(TileX - Halo, (MIL_INT)0), X1 = std::min(TileX + TileW + Halo, SizeX);
+      MIL_INT Y0 = std::max(TileY - Halo, (MIL_INT)0), Y1 = std::min(TileY + TileH + Halo, SizeY);
+      MIL_INT W = X1 - X0, H = Y1 - Y0;
+
+      for (MIL_INT y = 0; y < H; y++)
+         memcpy(&Window[y * W], SrcBase + (Y0 + y) * SrcPitch + X0 * sizeof(PixelType), W * sizeof(PixelType));
+
+      SquareRank(&Window[0], &Eroded[0], &Temp[0], W, W, H, Iterations, true, &Scratch[0]);
+      SquareRank(&Eroded[0], &Window[0], &Temp[0], W, W, H, Iterations, false, &Scratch[0]);
+
+      for (MIL_INT y = 0; y < TileH; y++)
+         memcpy(DstBase + (TileY + y) * DstPitch + TileX * sizeof(PixelType),
+                &Window[(TileY - Y0 + y) * W + (TileX - X0)], TileW * sizeof(PixelType));
+      }
+   }
+
+// Grayscale opening (same result as MimOpen(Src, Dst, Iterations, M_GRAYSCALE) with a
+// 3x3 square) on the tiles that intersect the mask; pixels of the tiles that do not
+// intersect the mask are left untouched. Src and Dst must be different 8 or 16-bit unsigned
+// monochrome host buffers of the same size and type, and the mask must have that size with
+// all its runs inside; otherwise the whole image is opened with MimOpen. Returns the tile
+// count (all the tiles for MimOpen).
+MIL_INT RegionOpen(MIL_ID MilSrc, MIL_ID MilDst, const RunLengthMask& Mask, MIL_INT Iterations, MIL_INT NbThreads)
+   {
+   MIL_INT SizeX  = MbufInquire(MilSrc, M_SIZE_X, M_NULL);
+   MIL_INT SizeY  = MbufInquire(MilSrc, M_SIZE_Y, M_NULL);
+   MIL_INT TilesX = (SizeX + MORPHO_TILE_SIZE - 1) / MORPHO_TILE_SIZE;
+   MIL_INT TilesY = (SizeY + MORPHO_TILE_SIZE - 1) / MORPHO_TILE_SIZE;
+
+   if (MilSrc == MilDst || !IsHostMonoUnsigned(MilSrc) || !IsHostMonoUnsigned(MilDst) ||
+       MbufInquire(MilSrc, M_TYPE, M_NULL) != MbufInquire(MilDst, M_TYPE, M_NULL) ||
+       MbufInquire(MilDst, M_SIZE_X, M_NULL) != SizeX || MbufInquire(MilDst, M_SIZE_Y, M_NULL) != SizeY ||
+       !RleFitsImage(Mask, MilSrc) || !RleRunsInside(Mask))
+      {
+      MimOpen(MilSrc, MilDst, Iterations, M_GRAYSCALE);
+      return TilesX * TilesY;
+      }
+
+   // Tiles touched by at least one run.
+   std::vector<char> Touched(TilesX * TilesY, 0);
+   for (MIL_INT y = 0; y < Mask.SizeY; y++)
+      for (MIL_INT r = Mask.RowStart[y]; r < Mask.RowStart[y + 1]; r++)
+         for (MIL_INT tx = Mask.Runs[r].StartX / MORPHO_TILE_SIZE; tx <= (Mask.Runs[r].EndX - 1) / MORPHO_TILE_SIZE; tx++)
+            Touched[(y / MORPHO_TILE_SIZE) * TilesX + tx] = 1;
+   std::vector<MIL_INT> Tiles;
+   for (MIL_INT t = 0; t < TilesX * TilesY; t++)
+      if (Touched[t])
+         Tiles.push_back(t);
+
+   const MIL_UINT8* Src = (const MIL_UINT8*)MbufInquire(MilSrc, M_HOST_ADDRESS, M_NULL);
+   MIL_UINT8*       Dst = (MIL_UINT8*)MbufInquire(MilDst, M_HOST_ADDRESS, M_NULL);
+   MIL_INT SrcPitch = MbufInquire(MilSrc, M_PITCH_BYTE, M_NULL);
+   MIL_INT DstPitch = MbufInquire(MilDst, M_PITCH_BYTE, M_NULL);
+   auto Kernel = (MbufInquire(MilSrc, M_SIZE_BIT, M_NULL) > 8) ? OpenTiles<MIL_UINT16> : OpenTiles<MIL_UINT8>;
+
+   std::atomic<MIL_INT>     NextTile(0);
+   std::vector<std::thread> Workers;
+   NbThreads = std::max(std::min(NbThreads, (MIL_INT)Tiles.size()), (MIL_INT)1);
+   for (MIL_INT t = 1; t < NbThreads; t++)
+      Workers.push_back(std::thread(Kernel, Src, SrcPitch, Dst, DstPitch, SizeX, SizeY, Iterations, &Tiles, &NextTile));
+   Kernel(Src, SrcPitch, Dst, DstPitch, SizeX, SizeY, Iterations, &Tiles, &NextTile);
+   for (auto& Worker : Workers)
+      Worker.join();
+
+   return (MIL_INT)Tiles.size();
+   }
+
+// Largest absolute difference between two buffers over the pixels of the mask.
+template <class PixelType>
+static MIL_INT MaxDifferenceInMaskT(const MIL_UINT8* BaseA, MIL_INT PitchA, const MIL_UINT8* BaseB, MIL_INT PitchB,
+                                    const RunLengthMask& Mask)
+   {
+   MIL_INT Diff = 0;
+   for (MIL_INT y = 0; y < Mask.SizeY; y++)
+      {
+      const PixelType* RowA = (const PixelType*)(BaseA + y * PitchA);
+      const PixelType* RowB = (const PixelType*)(BaseB + y * PitchB);
+      for (MIL_INT r = Mask.RowStart[y]; r < Mask.RowStart[y + 1]; r++)
+         for (MIL_INT x = Mask.Runs[r].StartX; x < Mask.Runs[r].EndX; x++)
+            Diff = std::max(Diff, (MIL_INT)std::abs((int)RowA[x] - (int)RowB[x]));
+      }
+   return Diff;
+   }
+
+static MIL_INT MaxDifferenceInMask(MIL_ID MilA, MIL_ID MilB, const RunLengthMask& Mask)
+   {
+   const MIL_UINT8* A = (const MIL_UINT8*)MbufInquire(MilA, M_HOST_ADDRESS, M_NULL);
+   const MIL_UINT8* B = (const MIL_UINT8*)MbufInquire(MilB, M_HOST_ADDRESS, M_NULL);
+   MIL_INT PitchA = MbufInquire(MilA, M_PITCH_BYTE, M_NULL);
+   MIL_INT PitchB = MbufInquire(MilB, M_PITCH_BYTE, M_NULL);
+   if (MbufInquire(MilA, M_SIZE_BIT, M_NULL) > 8)
+      return MaxDifferenceInMaskT<MIL_UINT16>(A, PitchA, B, PitchB, Mask);
+   return MaxDifferenceInMaskT<MIL_UINT8>(A, PitchA, B, PitchB, Mask);
+   }
+
+// MimOpen over the whole image versus RegionOpen on the sparse zones and on a mask
+// covering the whole image, for a small and a large number of iterations.
+void RegionOpenBenchmark(MIL_ID MilSystem)
+   {
+   const MIL_INT IterationCounts[] = { 5, 15 };
+   MIL_INT NbCores = std::max((MIL_INT)std::thread::hardware_concurrency(), (MIL_INT)1);
+   MIL_ID  MilSource = MbufRestore(IMAGE_FILE, MilSystem, M_NULL);
+   MIL_INT Type      = MbufInquire(MilSource, M_TYPE, M_NULL);
+   MIL_ID  MilLarge  = MbufAlloc2d(MilSystem, RLE_BENCH_SIZE, RLE_BENCH_SIZE, Type, M_IMAGE + M_PROC, M_NULL);
+   MIL_ID  MilOpenMil  = MbufAlloc2d(MilSystem, RLE_BENCH_SIZE, RLE_BENCH_SIZE, Type, M_IMAGE + M_PROC, M_NULL);
+   MIL_ID  MilOpenFast = MbufAlloc2d(MilSystem, RLE_BENCH_SIZE, RLE_BENCH_SIZE, Type, M_IMAGE + M_PROC, M_NULL);
+   MimResize(MilSource, MilLarge, M_FILL_DESTINATION, M_FILL_DESTINATION, M_BILINEAR);
+
+   MIL_ID MilZones = AllocZoneList(MilSystem, 0);
+   RunLengthMask Zones, Everything;
+   RleFromGraphicList(MilSystem, MilZones, RLE_BENCH_SIZE, RLE_BENCH_SIZE, Zones);
+   RleFromThreshold(MilLarge, -1, Everything);
+
+   MosPrintf(MIL_TEXT("Region-aware opening (%d x %d tiles, %d threads) vs MimOpen on %d x %d:\n\n"),
+             MORPHO_TILE_SIZE, MORPHO_TILE_SIZE, (int)NbCores, RLE_BENCH_SIZE, RLE_BENCH_SIZE);
+   MosPrintf(MIL_TEXT("Iterations   Region        Tiles   MimOpen (ms)   Engine (ms)   Speedup   Max diff\n"));
+
+   for (MIL_INT i = 0; i < (MIL_INT)(sizeof(IterationCounts) / sizeof(IterationCounts[0])); i++)
+      {
+      MIL_INT    Iterations = IterationCounts[i];
+      MIL_DOUBLE TimeMil, TimeFast;
+
+      MimOpen(MilLarge, MilOpenMil, Iterations, M_GRAYSCALE);
+      MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+      for (MIL_INT n = 0; n < MORPHO_NB_LOOP; n++)
+         MimOpen(MilLarge, MilOpenMil, Iterations, M_GRAYSCALE);
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeMil);
+      TimeMil /= MORPHO_NB_LOOP;
+
+      for (MIL_INT m = 0; m < 2; m++)
+         {
+         const RunLengthMask& Mask = (m == 0) ? Zones : Everything;
+         MIL_INT NbTiles = RegionOpen(MilLarge, MilOpenFast, Mask, Iterations, NbCores);
+         MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+         for (MIL_INT n = 0; n < MORPHO_NB_LOOP; n++)
+            RegionOpen(MilLarge, MilOpenFast, Mask, Iterations, NbCores);
+         MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeFast);
+         TimeFast /= MORPHO_NB_LOOP;
+
+         MosPrintf(MIL_TEXT("%-13d%-14s%-8d%-15.2f%-14.2f%-10.1f%d\n"), (int)Iterations,
+                   (m == 0) ? MIL_TEXT("sparse zones") : MIL_TEXT("whole image"), (int)NbTiles,
+                   TimeMil * 1000.0, TimeFast * 1000.0, TimeMil / TimeFast,
+                   (int)MaxDifferenceInMask(MilOpenMil, MilOpenFast, Mask));
+         }
+      }
+   MosPrintf(MIL_TEXT("\n"));
+
+   MgraFree(MilZones);
+   MbufFree(MilOpenFast);
+   MbufFree(MilOpenMil);
+   MbufFree(MilLarge);
+   MbufFree(MilSource);
+   }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Multi-object extraction by parallel connected-component labeling.
+//
+// Pixels above the threshold are labeled with 8-connectivity by a block-based union-find:
+//  1) each row band is scanned by its own thread, uniting a pixel with its west and
+//     upper neighbors inside the band (roots are always the lowest pixel index),
+//  2) the first row of every band is united with the last row of the band above,
+//  3) components are numbered in raster order of their first pixel and every thread
+//     accumulates bounding box, area and centroid sums of the objects met in its band,
+//     then bands are merged and objects below the minimum area are dropped.
+// The result is a structure of arrays, one entry per object.
+//////////////////////////////////////////////////////////////////////////////////////////
+#define CCL_MIN_AREA                   50
+#define CCL_TRAY_SIZE                  4096
+#define CCL_TRAY_NB_PER_SIDE           8
+#define CCL_NB_LOOP                    5
+
+struct ObjectTable
+   {
+   std::vector<MIL_INT32>  MinX, MinY, MaxX, MaxY;
+   std::vector<MIL_INT64>  Area;
+   std::vector<MIL_DOUBLE> CenterX, CenterY;
+
+   MIL_INT Count() const { return (MIL_INT)Area.size(); }
+   };
+
+static inline MIL_INT32 FindRoot(const MIL_INT32* Parent, MIL_INT32 Index)
+   {
+   while (Parent[Index] != Index)
+      Index = Parent[Index];
+   return Index;
+   }
+
+static inline void UniteRoots(MIL_INT32* Parent, MIL_INT32 A, MIL_INT32 B)
+   {
+   A = FindRoot(Parent, A);
+   B = FindRoot(Parent, B);
+   if (A < B)
+      Parent[B] = A;
+   else if (B < A)
+      Parent[A] = B;
+   }
+
+// Step 1: local labeling of rows [StartY, EndY); background pixels get -1.
+template <class PixelType>
+static void CclBandLocal(const MIL_UINT8* Base, MIL_INT Pitch, MIL_INT SizeX, MIL_INT StartY, MIL_INT EndY,
+                         MIL_INT MinValue, MIL_INT32* Parent)
+   {
+   for (MIL_INT y = StartY; y < EndY; y++)
+      {
+      const PixelType* Row = (const PixelType*)(Base + y * Pitch);
+      MIL_INT32* Current = Parent + y * SizeX;
+      MIL_INT32* Above   = (y > StartY) ? Current - SizeX : nullptr;
+      for (MIL_INT x = 0; x < SizeX; x++)
+         {
+         if (Row[x] < MinValue)
+            {
+            Current[x] = -1;
+            continue;
+            }
+         MIL_INT32 Index = (MIL_INT32)(y * SizeX + x);
+         Current[x] = Index;
+         if (x > 0 && Current[x - 1] >= 0)
+            UniteRoots(Parent, Index, Current[x - 1]);
+         if (Above)
+            {
+            for (MIL_INT dx = -1; dx <= 1; dx++)
+               if (x + dx >= 0 && x + dx < SizeX && Above[x + dx] >= 0)
+                  UniteRoots(Parent, Index, Above[x + dx]);
+            }
+         }
+      }
+
+   // Flatten the band: parents always have a lower index, so one raster pass suffices.
+   for (MIL_INT i = StartY * SizeX; i < EndY * SizeX; i++)
+      if (Parent[i] >= 0)
+         Parent[i] = Parent[Parent[i]];
+   }
+
+// Sums of the objects met in one band; slot s holds object Object[s].
+struct CclBandSums
+   {
+   std::vector<MIL_INT32> Object;
+   std::vector<MIL_INT32> MinX, MinY, MaxX, MaxY;
+   std::vector<MIL_INT64> Area, SumX, SumY;
+   };
+
+// Step 3: per-band accumulation into compact object numbers. A band only holds slots for
+// the objects it meets, so its tables do not grow with the specks of the whole image. The
+// pixels of a horizontal run all belong to the same object: one lookup per run.
+static void AccumulateBand(const MIL_INT32* Parent, const MIL_INT32* ObjectOf, MIL_INT SizeX,
+                           MIL_INT StartY, MIL_INT EndY, CclBandSums* Sums)
+   {
+   std::unordered_map<MIL_INT32, MIL_INT32> SlotOf;
+   *Sums = CclBandSums();
+   for (MIL_INT y = StartY; y < EndY; y++)
+      {
+      const MIL_INT32* Row = Parent + y * SizeX;
+      MIL_INT x = 0;
+      while (x < SizeX)
+         {
+         if (Row[x] < 0)
+            {
+            x++;
+            continue;
+            }
+         MIL_INT Start = x;
+         while (x < SizeX && Row[x] >= 0)
+            x++;
+
+         MIL_INT32 Object = ObjectOf[FindRoot(Parent, Row[Start])];
+         auto Found = SlotOf.find(Object);
+         MIL_INT32 Slot;
+         if (Found != SlotOf.end())
+            Slot = Found->second;
+         else
+            {
+            Slot = (MIL_INT32)Sums->Object.size();
+            SlotOf.emplace(Object, Slot);
+            Sums->Object.push_back(Object);
+            Sums->MinX.push_back(std::numeric_limits<MIL_INT32>::max());
+            Sums->MinY.push_back((MIL_INT32)y);
+            Sums->MaxX.push_back(-1);
+            Sums->MaxY.push_back(-1);
+            Sums->Area.push_back(0);
+            Sums->SumX.push_back(0);
+            Sums->SumY.push_back(0);
+            }
+         MIL_INT64 Length = x - Start;
+         Sums->MinX[Slot] = std::min(Sums->MinX[Slot], (MIL_INT32)Start);
+         Sums->MaxX[Slot] = std::max(Sums->MaxX[Slot], (MIL_INT32)(x - 1));
+         Sums->MaxY[Slot] = (MIL_INT32)y;
+         Sums->Area[Slot] += Length;
+         Sums->SumX[Slot] += Length * (Start + x - 1) / 2;
+         Sums->SumY[Slot] += Length * y;
+         }
+      }
+   }
+
+// Bounding box, area and centroid of every 8-connected object of pixels greater than
+// Threshold, in raster order of their first pixel; objects below MinArea are dropped.
+// Supports 8 and 16-bit unsigned monochrome buffers with a host address whose pixels can
+// all be indexed by the 32-bit label tables; returns false (Objects left empty) otherwise.
+bool LabelObjects(MIL_ID MilImage, MIL_DOUBLE Threshold, MIL_INT MinArea, MIL_INT NbThreads, ObjectTable& Objects)
+   {
+   MIL_INT SizeX   = MbufInquire(MilImage, M_SIZE_X, M_NULL);
+   MIL_INT SizeY   = MbufInquire(MilImage, M_SIZE_Y, M_NULL);
+   Objects = ObjectTable();
+   if (!IsHostMonoUnsigned(MilImage) || (MIL_INT64)SizeX * SizeY > std::numeric_limits<MIL_INT32>::max())
+      return false;
+
+   MIL_INT Pitch   = MbufInquire(MilImage, M_PITCH_BYTE, M_NULL);
+   const MIL_UINT8* Base = (const MIL_UINT8*)MbufInquire(MilImage, M_HOST_ADDRESS, M_NULL);
+   MIL_INT MinValue = std::max((MIL_INT)floor(Threshold) + 1, (MIL_INT)0);
+   auto Local = (MbufInquire(MilImage, M_SIZE_BIT, M_NULL) > 8) ? CclBandLocal<MIL_UINT16> : CclBandLocal<MIL_UINT8>;
+
+   NbThreads = std::max(std::min(NbThreads, SizeY), (MIL_INT)1);
+   MIL_INT RowsPerThread = (SizeY + NbThreads - 1) / NbThreads;
+   std::vector<MIL_INT32> Parent(SizeX * SizeY);
+   std::vector<std::thread> Workers;
+
+   // 1) Bands labeled independently.
+   for (MIL_INT t = 1; t < NbThreads; t++)
+      {
+      MIL_INT StartY = std::min(t * RowsPerThread, SizeY);
+      Workers.push_back(std::thread(Local, Base, Pitch, SizeX, StartY, std::min(StartY + RowsPerThread, SizeY),
+                                    MinValue, &Parent[0]));
+      }
+   Local(Base, Pitch, SizeX, 0, std::min(RowsPerThread, SizeY), MinValue, &Parent[0]);
+   for (auto& Worker : Workers)
+      Worker.join();
+   Workers.clear();
+
+   // 2) Band seams.
+   for (MIL_INT t = 1; t < NbThreads; t++)
+      {
+      MIL_INT y = t * RowsPerThread;
+      if (y >= SizeY)
+         break;
+      const MIL_INT32* Current = &Parent[y * SizeX];
+      const MIL_INT32* Above   = Current - SizeX;
+      for (MIL_INT x = 0; x < SizeX; x++)
+         {
+         if (Current[x] < 0)
+            continue;
+         for (MIL_INT dx = -1; dx <= 1; dx++)
+            if (x + dx >= 0 && x + dx < SizeX && Above[x + dx] >= 0)
+               UniteRoots(&Parent[0], Current[x], Above[x + dx]);
+         }
+      }
+
+   // 3) Compact numbering of the roots (raster order), then per-band sums.
+   std::vector<MIL_INT32> ObjectOf(SizeX * SizeY);
+   MIL_INT NbObjects = 0;
+   for (MIL_INT i = 0; i < SizeX * SizeY; i++)
+      if (Parent[i] == (MIL_INT32)i)
+         ObjectOf[i] = (MIL_INT32)NbObjects++;
+
+   std::vector<CclBandSums> Sums(NbThreads);
+   for (MIL_INT t = 1; t < NbThreads; t++)
+      {
+      MIL_INT StartY = std::min(t * RowsPerThread, SizeY);
+      Workers.push_back(std::thread(AccumulateBand, &Parent[0], &ObjectOf[0], SizeX, StartY,
+                                    std::min(StartY + RowsPerThread, SizeY), &Sums[t]));
+      }
+   AccumulateBand(&Parent[0], &ObjectOf[0], SizeX, 0, std::min(RowsPerThread, SizeY), &Sums[0]);
+   for (auto& Worker : Workers)
+      Worker.join();
+
+   // Merge the band slots into one table, then drop the objects below MinArea.
+   CclBandSums Total;
+   Total.MinX.assign(NbObjects, std::numeric_limits<MIL_INT32>::max());
+   Total.MinY.assign(NbObjects, std::numeric_limits<MIL_INT32>::max());
+   Total.MaxX.assign(NbObjects, -1);
+   Total.MaxY.assign(NbObjects, -1);
+   Total.Area.assign(NbObjects, 0);
+   Total.SumX.assign(NbObjects, 0);
+   Total.SumY.assign(NbObjects, 0);
+   for (const auto& Band : Sums)
+      for (MIL_INT s = 0; s < (MIL_INT)Band.Object.size(); s++)
+         {
+         MIL_INT32 o = Band.Object[s];
+         Total.MinX[o] = std::min(Total.MinX[o], Band.MinX[s]);
+         Total.MinY[o] = std::min(Total.MinY[o], Band.MinY[s]);
+         Total.MaxX[o] = std::max(Total.MaxX[o], Band.MaxX[s]);
+         Total.MaxY[o] = std::max(Total.MaxY[o], Band.MaxY[s]);
+         Total.Area[o] += Band.Area[s];
+         Total.SumX[o] += Band.SumX[s];
+         Total.SumY[o] += Band.SumY[s];
+         }
+
+   for (MIL_INT o = 0; o < NbObjects; o++)
+      {
+      if (Total.Area[o] < MinArea)
+         continue;
+      Objects.MinX.push_back(Total.MinX[o]);
+      Objects.MinY.push_back(Total.MinY[o]);
+      Objects.MaxX.push_back(Total.MaxX[o]);
+      Objects.MaxY.push_back(Total.MaxY[o]);
+      Objects.Area.push_back(Total.Area[o]);
+      Objects.CenterX.push_back((MIL_DOUBLE)Total.SumX[o] / Total.Area[o]);
+      Objects.CenterY.push_back((MIL_DOUBLE)Total.SumY[o] / Total.Area[o]);
+      }
+   return true;
+   }
+
+// A tray of CCL_TRAY_NB_PER_SIDE^2 cookies: the labeler versus Mblob, and versus MimLabel
+// followed by one MimBoundingBox call per label.
+void LabelObjectsBenchmark(MIL_ID MilSystem, MIL_DOUBLE Threshold)
+   {
+   MIL_INT NbCores = std::max((MIL_INT)std::thread::hardware_concurrency(), (MIL_INT)1);
+   MIL_ID  MilSource = MbufRestore(IMAGE_FILE, MilSystem, M_NULL);
+   MIL_ID  MilTray   = MbufAlloc2d(MilSystem, CCL_TRAY_SIZE, CCL_TRAY_SIZE, MbufInquire(MilSource, M_TYPE, M_NULL),
+                                   M_IMAGE + M_PROC, M_NULL);
+   MIL_ID  MilBinary = MbufAlloc2d(MilSystem, CCL_TRAY_SIZE, CCL_TRAY_SIZE, 8 + M_UNSIGNED, M_IMAGE + M_PROC, M_NULL);
+   MIL_ID  MilLabels = MbufAlloc2d(MilSystem, CCL_TRAY_SIZE, CCL_TRAY_SIZE, 16 + M_UNSIGNED, M_IMAGE + M_PROC, M_NULL);
+
+   // Cookies scaled into the cells of a grid, with a background margin around each.
+   MIL_INT Cell = CCL_TRAY_SIZE / CCL_TRAY_NB_PER_SIDE, Margin = Cell / 8;
+   MbufClear(MilTray, 0);
+   for (MIL_INT i = 0; i < CCL_TRAY_NB_PER_SIDE * CCL_TRAY_NB_PER_SIDE; i++)
+      {
+      MIL_ID MilCell = MbufChild2d(MilTray, (i % CCL_TRAY_NB_PER_SIDE) * Cell + Margin,
+                                   (i / CCL_TRAY_NB_PER_SIDE) * Cell + Margin, Cell - 2 * Margin, Cell - 2 * Margin, M_NULL);
+      MimResize(MilSource, MilCell, M_FILL_DESTINATION, M_FILL_DESTINATION, M_NEAREST_NEIGHBOR);
+      MbufFree(MilCell);
+      }
+   MimBinarize(MilTray, MilBinary, M_GREATER, Threshold, M_NULL);
+
+   MIL_DOUBLE  TimeSingle, TimeMulti, TimeBlob, TimeLabel;
+   ObjectTable Objects;
+
+   // (a) Parallel labeler.
+   if (!LabelObjects(MilTray, Threshold, CCL_MIN_AREA, NbCores, Objects))
+      {
+      MosPrintf(MIL_TEXT("Labeler benchmark skipped: it needs an unsigned 8 or 16-bit host buffer.\n\n"));
+      MbufFree(MilLabels);
+      MbufFree(MilBinary);
+      MbufFree(MilTray);
+      MbufFree(MilSource);
+      return;
+      }
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (MIL_INT n = 0; n < CCL_NB_LOOP; n++)
+      LabelObjects(MilTray, Threshold, CCL_MIN_AREA, 1, Objects);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeSingle);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (MIL_INT n = 0; n < CCL_NB_LOOP; n++)
+      LabelObjects(MilTray, Threshold, CCL_MIN_AREA, NbCores, Objects);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeMulti);
+
+   // (b) Mblob with the same features and area filter.
+   MIL_ID MilBlobContext = MblobAlloc(MilSystem, M_DEFAULT, M_DEFAULT, M_NULL);
+   MIL_ID MilBlobResult  = MblobAllocResult(MilSystem, M_DEFAULT, M_DEFAULT, M_NULL);
+   MIL_INT NbBlobs = 0;
+   MblobControl(MilBlobContext, M_BOX, M_ENABLE);
+   MblobControl(MilBlobContext, M_CENTER_OF_GRAVITY + M_BINARY, M_ENABLE);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (MIL_INT n = 0; n < CCL_NB_LOOP; n++)
+      {
+      MblobCalculate(MilBlobContext, MilBinary, M_NULL, MilBlobResult);
+      MblobSelect(MilBlobResult, M_EXCLUDE, M_AREA, M_LESS, CCL_MIN_AREA, M_NULL);
+      MblobGetResult(MilBlobResult, M_DEFAULT, M_NUMBER + M_TYPE_MIL_INT, &NbBlobs);
+      }
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeBlob);
+
+   // (c) One MIL call per object after labeling.
+   MIL_INT NbLabels = 0;
+   MIL_ID MilStatContext = MimAlloc(MilSystem, M_STATISTICS_CONTEXT, M_DEFAULT, M_NULL);
+   MIL_ID MilStatResult  = MimAllocResult(MilSystem, M_DEFAULT, M_STATISTICS_RESULT, M_NULL);
+   MimControl(MilStatContext, M_STAT_MAX, M_ENABLE);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   MimLabel(MilBinary, MilLabels, M_DEFAULT);
+   MimStatCalculate(MilStatContext, MilLabels, MilStatResult, M_DEFAULT);
+   MimGetResult(MilStatResult, M_STAT_MAX + M_TYPE_MIL_INT, &NbLabels);
+   for (MIL_INT Label = 1; Label <= NbLabels; Label++)
+      {
+      MIL_INT MinX, MinY, MaxX, MaxY;
+      MimBoundingBox(MilLabels, M_EQUAL, (MIL_DOUBLE)Label, M_NULL, M_BOTH_CORNERS, &MinX, &MinY, &MaxX, &MaxY, M_DEFAULT);
+      }
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeLabel);
+
+   MosPrintf(MIL_TEXT("Per-object boxes, areas and centroids on a %d x %d tray:\n\n"), CCL_TRAY_SIZE, CCL_TRAY_SIZE);
+   MosPrintf(MIL_TEXT("Parallel labeler, 1 thread:   %8.2f ms  (%d objects)\n"),
+             TimeSingle * 1000.0 / CCL_NB_LOOP, (int)Objects.Count());
+   MosPrintf(MIL_TEXT("Parallel labeler, %2d threads: %8.2f ms\n"), (int)NbCores, TimeMulti * 1000.0 / CCL_NB_LOOP);
+   MosPrintf(MIL_TEXT("MblobCalculate:               %8.2f ms  (%d blobs)\n"), TimeBlob * 1000.0 / CCL_NB_LOOP, (int)NbBlobs);
+   MosPrintf(MIL_TEXT("MimLabel + %4d MimBoundingBox: %7.2f ms  (boxes only)\n\n"), (int)NbLabels, TimeLabel * 1000.0);
+
+   // Same boxes as Mblob when the counts agree (matched regardless of order).
+   if (NbBlobs == Objects.Count() && NbBlobs > 0)
+      {
+      std::vector<MIL_INT> BlobMinX(NbBlobs), BlobMinY(NbBlobs), BlobMaxX(NbBlobs), BlobMaxY(NbBlobs);
+      MblobGetResult(MilBlobResult, M_DEFAULT, M_BOX_X_MIN + M_TYPE_MIL_INT, &BlobMinX[0]);
+      MblobGetResult(MilBlobResult, M_DEFAULT, M_BOX_Y_MIN + M_TYPE_MIL_INT, &BlobMinY[0]);
+      MblobGetResult(MilBlobResult, M_DEFAULT, M_BOX_X_MAX + M_TYPE_MIL_INT, &BlobMaxX[0]);
+      MblobGetResult(MilBlobResult, M_DEFAULT, M_BOX_Y_MAX + M_TYPE_MIL_INT, &BlobMaxY[0]);
+      MIL_INT NbMatched = 0;
+      for (MIL_INT b = 0; b < NbBlobs; b++)
+         for (MIL_INT o = 0; o < Objects.Count(); o++)
+            if (BlobMinX[b] == Objects.MinX[o] && BlobMinY[b] == Objects.MinY[o] &&
+                BlobMaxX[b] == Objects.MaxX[o] && BlobMaxY[b] == Objects.MaxY[o])
+               {
+               NbMatched++;
+               break;
+               }
+      MosPrintf(MIL_TEXT("%d of %d boxes identical to Mblob.\n\n"), (int)NbMatched, (int)NbBlobs);
+      }
+
+   MimFree(MilStatResult);
+   MimFree(MilStatContext);
+   MblobFree(MilBlobResult);
+   MblobFree(MilBlobContext);
+   MbufFree(MilLabels);
+   MbufFree(MilBinary);
+   MbufFree(MilTray);
+   MbufFree(MilSource);
+   }
+
+//////////////////////////////////////////////////////////////////////////////////////////
+// Headless mode and display support cost.
+//
+// Building with MIL_HEADLESS=1 runs the example without a display: no MdispAlloc(), the
+// image is allocated without M_DISP, the annotations stay in a detached graphic list and
+// the key prompts do not block. In both builds the per-object boxes are drawn
+// ANNOTATION_NB_LOOP times into a detached list and, when a display exists, into a list
+// associated to it; the difference is what the display costs the annotation step.
+//////////////////////////////////////////////////////////////////////////////////////////
+#include "../Common/MilHeadless.h"
+#define ANNOTATION_NB_LOOP             1000
+
+static void DrawObjectBoxes(MIL_ID MilGraList, const ObjectTable& Objects)
+   {
+   MgraClear(M_DEFAULT, MilGraList);
+   for (MIL_INT o = 0; o < Objects.Count(); o++)
+      MgraRect(M_DEFAULT, MilGraList, Objects.MinX[o], Objects.MinY[o], Objects.MaxX[o], Objects.MaxY[o]);
+   }
+
+void DisplayCostBenchmark(MIL_ID MilSystem, MIL_ID MilDisplay, MIL_ID MilGraphicListDisp, const ObjectTable& Objects)
+   {
+   MIL_ID     MilGraList = MgraAllocList(MilSystem, M_DEFAULT, M_NULL);
+   MIL_DOUBLE TimeList, TimeDisplay;
+
+   DrawObjectBoxes(MilGraList, Objects);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (MIL_INT n = 0; n < ANNOTATION_NB_LOOP; n++)
+      DrawObjectBoxes(MilGraList, Objects);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeList);
+
+   MosPrintf(MIL_TEXT("Display support cost, %d object boxes redrawn %d times:\n\n"), (int)Objects.Count(), ANNOTATION_NB_LOOP);
+   MosPrintf(MIL_TEXT("Detached graphic list:        %8.4f ms\n"), TimeList * 1000.0 / ANNOTATION_NB_LOOP);
+
+   if (MilDisplay)
+      {
+      // Temporarily associate the scratch list so that the displayed annotations are kept.
+      MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, MilGraList);
+      MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+      for (MIL_INT n = 0; n < ANNOTATION_NB_LOOP; n++)
+         DrawObjectBoxes(MilGraList, Objects);
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeDisplay);
+      MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, MilGraphicListDisp);
+
+      MosPrintf(MIL_TEXT("Graphic list on the display:  %8.4f ms\n"), TimeDisplay * 1000.0 / ANNOTATION_NB_LOOP);
+      MosPrintf(MIL_TEXT("Display support:              %8.4f ms (%.1f%% of the annotation time)\n\n"),
+                (TimeDisplay - TimeList) * 1000.0 / ANNOTATION_NB_LOOP,
+                TimeDisplay > 0.0 ? 100.0 * (TimeDisplay - TimeList) / TimeDisplay : 0.0);
+      }
+   else
+      MosPrintf(MIL_TEXT("No display allocated (headless build).\n\n"));
+
+   MgraFree(MilGraList);
    }
 
 int MosMain()
@@ -48,7 +1876,11 @@ int MosMain()
    // Allocate objects.
    MappAlloc(M_NULL, M_DEFAULT, &MilApplication);
    MsysAlloc(MilApplication, M_SYSTEM_HOST, M_DEFAULT, M_DEFAULT, &MilSystem);
+#if MIL_HEADLESS
+   MilDisplay = M_NULL;
+#else
    MdispAlloc(MilSystem, M_DEFAULT, MIL_TEXT("M_DEFAULT"), M_WINDOWED, &MilDisplay);
+#endif
 
    // Allocate a graphic list used to set a region.
    MgraAllocList(MilSystem, M_DEFAULT, &MilGraphicListRegion);
@@ -56,17 +1888,28 @@ int MosMain()
    // Allocate a graphic list to hold the subpixel annotations to draw.
    MgraAllocList(MilSystem, M_DEFAULT, &MilGraphicListDisp);
    // Associate the graphic list to the display.
-   MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, MilGraphicListDisp);
+   if (MilDisplay)
+      MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, MilGraphicListDisp);
    MgraControl(M_DEFAULT, M_COLOR, AnnotationColor);
 
-   // Restore and display the original image.
+   // Restore and display the original image. Headless builds load it into a buffer
+   // allocated without M_DISP, as the other headless examples do.
+#if MIL_HEADLESS
+   MbufAlloc2d(MilSystem,
+               MbufDiskInquire(IMAGE_FILE, M_SIZE_X, M_NULL),
+               MbufDiskInquire(IMAGE_FILE, M_SIZE_Y, M_NULL),
+               MbufDiskInquire(IMAGE_FILE, M_TYPE, M_NULL), M_IMAGE + M_PROC, &MilImage);
+   MbufLoad(IMAGE_FILE, MilImage);
+#else
    MbufRestore(IMAGE_FILE, MilSystem, &MilImage);
-   MdispSelect(MilDisplay, MilImage);
+#endif
+   if (MilDisplay)
+      MdispSelect(MilDisplay, MilImage);
 
    // Pause to show the original image.
    MosPrintf(MIL_TEXT("The original image is displayed.\n\n")
    MIL_TEXT("Press any key to continue.\n\n"));
-   MosGetch();
+   WaitForKey(0);
 
    // Return the bounding box that contains all the pixels of the cookie.
    MIL_INT  TopLeftX, TopLeftY, BottomLeftX, BottomLeftY;
@@ -80,10 +1923,15 @@ int MosMain()
    MgraRectFill(M_DEFAULT, MilGraphicListRegion, TopLeftX, TopLeftY, BottomLeftX, BottomLeftY);
    MbufSetRegion(MilImage, MilGraphicListRegion, M_DEFAULT, M_DEFAULT, M_DEFAULT);
 
+   // The same region as a run-length mask, for the operations driven by the mask.
+   RunLengthMask RegionMask;
+   RleFromGraphicList(MilSystem, MilGraphicListRegion, MbufInquire(MilImage, M_SIZE_X, M_NULL),
+                      MbufInquire(MilImage, M_SIZE_Y, M_NULL), RegionMask);
+
    MosPrintf(MIL_TEXT("The minimum bounding box that contains all the pixels of the object\n")
       MIL_TEXT("is found. It is used to set a region of interest.\n\n"));
    MosPrintf(MIL_TEXT("Press any key to continue.\n\n"));
-   MosGetch();
+   WaitForKey(0);
    
    // Allocate the statistic context and result buffer. 
    MIL_ID MilStatContext = MimAlloc(MilSystem, M_STATISTICS_CONTEXT, M_DEFAULT, M_NULL);
@@ -115,26 +1963,81 @@ int MosMain()
 	   MosPrintf(MIL_TEXT("The mean pixel value is %.2f.\n"), StatMeanVal);
       MosPrintf(MIL_TEXT("The maximum pixel value is %.2f.\n\n"), StatMaxVal);
       MosPrintf(MIL_TEXT("Press any key to continue.\n\n"));
-      MosGetch();
+      WaitForKey(0);
       
       if (i == 0)
          {
-		   // Ignore the region in order to perform a morphological operation that does not support regions.
-         MbufControl(MilImage, M_REGION_USE, M_IGNORE);
-         MimOpen(MilImage, MilImage, 5, M_GRAYSCALE);
-         MosPrintf(MIL_TEXT("The region is ignored in order to perform a 5-iteration\n")
-            MIL_TEXT("open morphological operation.\n\n"));
+         // Open only the tiles meeting the region instead of ignoring the region for MimOpen.
+         // RegionOpen does not work in place, so it reads from a copy of the image.
+         MIL_ID MilOpenSource = MbufClone(MilImage, M_DEFAULT, M_DEFAULT, M_DEFAULT, M_DEFAULT, M_DEFAULT, M_COPY_SOURCE_DATA, M_NULL);
+         MIL_INT NbTiles = RegionOpen(MilOpenSource, MilImage, RegionMask, 5, std::thread::hardware_concurrency());
+         MbufFree(MilOpenSource);
+         MosPrintf(MIL_TEXT("A 5-iteration open morphological operation is performed on the %d tiles\n")
+            MIL_TEXT("of %d x %d pixels meeting the region; the region stays in use.\n\n"),
+            (int)NbTiles, MORPHO_TILE_SIZE, MORPHO_TILE_SIZE);
          MosPrintf(MIL_TEXT("Press any key to continue.\n\n"));
-         MosGetch();
-
-		   // Re-use the region to do some statstics inside the region.
-         MbufControl(MilImage, M_REGION_USE, M_USE);
-         MosPrintf(MIL_TEXT("The region is re-used.\n\n"));
+         WaitForKey(0);
          }
       }
    
+   // Compute the same box and the foreground statistics in a single fused pass.
+   RegionStats Stats;
+   FusedBoundingBoxStats(MilImage, BackGroundValue, std::thread::hardware_concurrency(), Stats);
+   MosPrintf(MIL_TEXT("The fused kernel returns the bounding box (%d, %d)-(%d, %d) and,\n")
+      MIL_TEXT("for the %d pixels above the background, a mean of %.2f, a minimum\n")
+      MIL_TEXT("of %d and a maximum of %d in a single pass.\n\n"),
+      (int)Stats.TopLeftX, (int)Stats.TopLeftY, (int)Stats.BottomRightX, (int)Stats.BottomRightY,
+      (int)Stats.Count, Stats.Count ? Stats.Sum / Stats.Count : 0.0, (int)Stats.Min, (int)Stats.Max);
+   MosPrintf(MIL_TEXT("Press any key to run the benchmark.\n\n"));
+   WaitForKey(0);
+
+   FusedStatsBenchmark(MilSystem, BackGroundValue);
+
+   // The region statistics again, from summed-area tables: O(1) for any rectangle.
+   IntegralImage Table;
+   if (IntegralImageBuild(MilImage, std::thread::hardware_concurrency(), Table))
+      MosPrintf(MIL_TEXT("From the integral image, the mean pixel value in the region is %.2f\n")
+         MIL_TEXT("(%.2f from MimStatCalculate).\n\n"),
+         IntegralMean(Table, TopLeftX, TopLeftY, BottomLeftX - TopLeftX + 1, BottomLeftY - TopLeftY + 1),
+         StatMeanVal);
+   else
+      MosPrintf(MIL_TEXT("The integral image needs an unsigned 8 or 16-bit host buffer; skipped.\n\n"));
+
+   IntegralStatsBenchmark(MilSystem);
+
+   // The region again, through its run-length mask.
+   if (RleStats(MilImage, RegionMask, Stats))
+      MosPrintf(MIL_TEXT("As a run-length mask the region holds %d runs; its mean pixel value\n")
+         MIL_TEXT("is %.2f and its maximum %d.\n\n"),
+         (int)RegionMask.Runs.size(), Stats.Count ? Stats.Sum / Stats.Count : 0.0, (int)Stats.Max);
+   else
+      MosPrintf(MIL_TEXT("The run-length statistics need an unsigned 8 or 16-bit host buffer; skipped.\n\n"));
+
+   RleBenchmark(MilSystem);
+
+   RegionOpenBenchmark(MilSystem);
+
+   // One box per object instead of one box around all the foreground pixels.
+   ObjectTable Objects;
+   if (LabelObjects(MilImage, BackGroundValue, CCL_MIN_AREA, std::thread::hardware_concurrency(), Objects))
+      MosPrintf(MIL_TEXT("The labeler finds %d object(s) of at least %d pixels.\n"), (int)Objects.Count(), CCL_MIN_AREA);
+   else
+      MosPrintf(MIL_TEXT("The labeler needs an unsigned 8 or 16-bit host buffer; skipped.\n"));
+   for (MIL_INT o = 0; o < Objects.Count(); o++)
+      {
+      MgraRect(M_DEFAULT, MilGraphicListDisp, Objects.MinX[o], Objects.MinY[o], Objects.MaxX[o], Objects.MaxY[o]);
+      MosPrintf(MIL_TEXT("  Object %d: box (%d, %d)-(%d, %d), area %d, centroid (%.1f, %.1f)\n"), (int)o,
+         (int)Objects.MinX[o], (int)Objects.MinY[o], (int)Objects.MaxX[o], (int)Objects.MaxY[o],
+         (int)Objects.Area[o], Objects.CenterX[o], Objects.CenterY[o]);
+      }
+   MosPrintf(MIL_TEXT("\n"));
+
+   LabelObjectsBenchmark(MilSystem, BackGroundValue);
+
+   DisplayCostBenchmark(MilSystem, MilDisplay, MilGraphicListDisp, Objects);
+
    MosPrintf(MIL_TEXT("Press any key to end.\n"));
-   MosGetch();
+   WaitForKey(0);
 
    // Free allocations.
    MimFree(MilStatResult);
@@ -142,7 +2045,8 @@ int MosMain()
    MgraFree(MilGraphicListRegion);
    MgraFree(MilGraphicListDisp);
    MbufFree(MilImage);
-   MdispFree(MilDisplay);
+   if (MilDisplay)
+      MdispFree(MilDisplay);
    MappFreeDefault(MilApplication, MilSystem, M_NULL, M_NULL, M_NULL);
    }
 
@@ -7,11 +7,48 @@
  *   그래픽 함수를 이용하여 환영 메시지를 화면에 표시하는 예제입니다.
  *   또한, 에러가 발생했을 때 이를 확인하는 방법을 보여줍니다.
  *
+ *   시작 지연 프로파일러(startup profiler):
+ *   MappAllocDefault() 대신 애플리케이션/시스템/디스플레이/이미지를 하나씩 할당하면서
+ *   각 단계의 시간과 Mgra 모듈의 첫 호출(글꼴 로드 포함) 시간을 두 번째 호출과 비교합니다.
+ *
  * 저작권(Copyright):
  *   © Matrox Electronic Systems Ltd., 1992-2025.
  *   All Rights Reserved.
  */
 #include <mil.h>   // MIL( Matrox Imaging Library ) 헤더 포함
+#include <chrono>
+
+/*------------------------------------------------------------*/
+/* 헤드리스(화면 없음) 실행 모드                              */
+/*------------------------------------------------------------*/
+// 모니터 없는 검사 서버에서는 MIL_HEADLESS=1 로 빌드합니다.
+//  - 디스플레이를 할당하지 않고, 이미지 버퍼는 M_DISP 없이 할당
+//  - 그래픽은 이미지 대신 그래픽 리스트에만 기록
+//  - 키 대기는 막지 않음(눌린 키가 없으면 바로 진행)
+#include "../../Common/MilHeadless.h"
+
+#define IMAGE_SIZE_X          640L   // 이미지 크기
+#define IMAGE_SIZE_Y          480L
+#define ANNOTATION_NB_LOOP    1000   // 디스플레이 비용 측정 반복 수
+#define PROFILE_MAX_STEPS     8
+
+/*------------------------------------------------------------*/
+/* 시작 프로파일: 단계 이름과 소요 시간(ms)을 순서대로 기록     */
+/*------------------------------------------------------------*/
+typedef struct
+{
+   const MIL_TEXT_CHAR* Name[PROFILE_MAX_STEPS];
+   double Ms[PROFILE_MAX_STEPS];
+   int Count;
+   std::chrono::steady_clock::time_point Start;  // 전체 시작 시각
+   std::chrono::steady_clock::time_point Mark;   // 직전 단계 종료 시각
+} STARTUP_PROFILE;
+
+void ProfileStart(STARTUP_PROFILE& Profile);
+void ProfileStep(STARTUP_PROFILE& Profile, const MIL_TEXT_CHAR* Name);
+void ProfilePrint(const STARTUP_PROFILE& Profile);
+void DrawWelcome(MIL_ID MilGraDest);
+void DisplayCostBenchmark(MIL_ID MilDisplay, MIL_ID MilImage);
 
 /*------------------------------------------------------------*/
 /* 프로그램 시작 함수                                         */
@@ -23,46 +60,65 @@ int MosMain(void)
    MIL_ID MilSystem;       // 시스템 ID
    MIL_ID MilDisplay;      // 디스플레이(화면) ID
    MIL_ID MilImage;        // 이미지 버퍼 ID
+   MIL_ID MilGraList;      // 그래픽 리스트 ID(헤드리스 모드에서만 사용)
+   STARTUP_PROFILE Profile;
 
    /*--------------------------------------------------------*/
    /* 1. MIL의 기본 자원 할당                               */
    /*--------------------------------------------------------*/
-   // MappAllocDefault() 함수는 기본적인 MIL 자원을 한 번에 생성하는 함수입니다.
-   //  - M_DEFAULT : 기본 설정으로 시스템을 선택
-   //  - MilApplication, MilSystem, MilDisplay, MilImage 등은 각각의 자원 ID를 반환받습니다.
-   //  - M_NULL : 사용하지 않는 디지타이저(Grabber)는 생략
-   MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem, 
-                                       &MilDisplay, M_NULL, &MilImage);
+   // MappAllocDefault()는 아래 자원을 한 번에 생성하지만, 단계별 시작 시간을
+   // 측정하기 위해 애플리케이션/시스템/디스플레이/이미지를 하나씩 할당합니다.
+   //  - M_SYSTEM_DEFAULT : MILConfig에 설정된 기본 시스템 선택
+   //  - 헤드리스: 디스플레이 없이 할당하고, 이미지는 처리 전용(M_DISP 없음)
+   ProfileStart(Profile);
+   MappAlloc(M_NULL, M_DEFAULT, &MilApplication);
+   ProfileStep(Profile, MIL_TEXT("MappAlloc"));
+
+   MsysAlloc(M_DEFAULT, M_SYSTEM_DEFAULT, M_DEFAULT, M_DEFAULT, &MilSystem);
+   ProfileStep(Profile, MIL_TEXT("MsysAlloc"));
+
+#if MIL_HEADLESS
+   MilDisplay = M_NULL;
+#else
+   MdispAlloc(MilSystem, M_DEFAULT, MIL_TEXT("M_DEFAULT"), M_DEFAULT, &MilDisplay);
+   ProfileStep(Profile, MIL_TEXT("MdispAlloc"));
+#endif
+
+   MbufAlloc2d(MilSystem, IMAGE_SIZE_X, IMAGE_SIZE_Y, 8 + M_UNSIGNED,
+               M_IMAGE + DISPLAY_ATTRIBUTE + M_PROC, &MilImage);
+   MbufClear(MilImage, 0);
+   ProfileStep(Profile, MIL_TEXT("MbufAlloc2d"));
+
+#if MIL_HEADLESS
+   MgraAllocList(MilSystem, M_DEFAULT, &MilGraList);
+   ProfileStep(Profile, MIL_TEXT("MgraAllocList"));
+#else
+   MdispSelect(MilDisplay, MilImage);
+   ProfileStep(Profile, MIL_TEXT("MdispSelect"));
+   MilGraList = M_NULL;
+#endif
 
    /*--------------------------------------------------------*/
    /* 2. 자원 할당 후 에러가 없는 경우 그래픽 처리 수행     */
    /*--------------------------------------------------------*/
    if (!MappGetError(M_DEFAULT, M_GLOBAL, M_NULL)) // 에러가 없으면 실행
    {
-      /* 그래픽 요소(텍스트, 사각형) 그리기 */
-
-      // 텍스트 색상 설정 (0xF0은 밝은 회색 계열)
-      MgraControl(M_DEFAULT, M_COLOR, 0xF0);
-
-      // 기본 큰 글꼴 설정
-      MgraFont(M_DEFAULT, M_FONT_DEFAULT_LARGE);
-
-      // 이미지 버퍼 위에 텍스트 출력 (좌표 160, 230)
-      MgraText(M_DEFAULT, MilImage, 160L, 230L, MIL_TEXT(" Welcome to MIL !!! "));
-
-      // 색상 변경 (0xC0은 좀 더 어두운 회색)
-      MgraControl(M_DEFAULT, M_COLOR, 0xC0);
+      /* 그래픽 요소(텍스트, 사각형) 그리기: 헤드리스면 그래픽 리스트에 기록 */
+      // 첫 호출은 Mgra 모듈 초기화와 글꼴 로드를 포함하므로 두 번째 호출과 비교합니다.
+      DrawWelcome(MIL_HEADLESS ? MilGraList : MilImage);
+      ProfileStep(Profile, MIL_TEXT("First Mgra call"));
+      DrawWelcome(MIL_HEADLESS ? MilGraList : MilImage);
+      ProfileStep(Profile, MIL_TEXT("Second Mgra call"));
+      ProfilePrint(Profile);
 
-      // 사각형 3개를 그려 장식 효과 (겹치는 테두리)
-      MgraRect(M_DEFAULT, MilImage, 100L, 150L, 530L, 340L);
-      MgraRect(M_DEFAULT, MilImage, 120L, 170L, 510L, 320L);
-      MgraRect(M_DEFAULT, MilImage, 140L, 190L, 490L, 300L);
-      
       /* 콘솔창에 텍스트 메시지 출력 */
       MosPrintf(MIL_TEXT("\nSYSTEM ALLOCATION:\n"));
       MosPrintf(MIL_TEXT("------------------\n\n"));
       MosPrintf(MIL_TEXT("System allocation successful.\n\n"));
       MosPrintf(MIL_TEXT("     \"Welcome to MIL !!!\"\n\n"));
+
+      /* 환영 그래픽을 반복해서 그릴 때 디스플레이가 차지하는 비용 측정 */
+      DisplayCostBenchmark(MilDisplay, MilImage);
    }
    else
    {
@@ -74,13 +130,123 @@ int MosMain(void)
    /* 3. 키 입력 대기 후 종료 처리                          */
    /*--------------------------------------------------------*/
    MosPrintf(MIL_TEXT("Press any key to end.\n"));
-   MosGetch();  // 사용자 키 입력 대기
+   WaitForKey(0);  // 사용자 키 입력 대기(헤드리스면 대기 없음)
 
    /*--------------------------------------------------------*/
    /* 4. 사용한 MIL 자원 해제                                */
    /*--------------------------------------------------------*/
-   // MappFreeDefault()는 MappAllocDefault()로 생성한 모든 자원을 한 번에 해제
+   // MappFreeDefault()는 개별 할당한 자원도 역순으로 한 번에 해제
+#if MIL_HEADLESS
+   MgraFree(MilGraList);
+   MbufFree(MilImage);
+   MappFreeDefault(MilApplication, MilSystem, M_NULL, M_NULL, M_NULL);
+#else
    MappFreeDefault(MilApplication, MilSystem, MilDisplay, M_NULL, MilImage);
+#endif
 
    return 0;  // 프로그램 정상 종료
+}
+
+/*------------------------------------------------------------*/
+/* 시작 프로파일                                              */
+/*------------------------------------------------------------*/
+static double ElapsedMs(std::chrono::steady_clock::time_point From,
+                        std::chrono::steady_clock::time_point To)
+{
+   return std::chrono::duration<double, std::milli>(To - From).count();
+}
+
+void ProfileStart(STARTUP_PROFILE& Profile)
+{
+   Profile.Count = 0;
+   Profile.Start = Profile.Mark = std::chrono::steady_clock::now();
+}
+
+// 직전 단계 이후 흐른 시간을 Name 단계로 기록
+void ProfileStep(STARTUP_PROFILE& Profile, const MIL_TEXT_CHAR* Name)
+{
+   std::chrono::steady_clock::time_point Now = std::chrono::steady_clock::now();
+   if (Profile.Count < PROFILE_MAX_STEPS)
+   {
+      Profile.Name[Profile.Count] = Name;
+      Profile.Ms[Profile.Count] = ElapsedMs(Profile.Mark, Now);
+      Profile.Count++;
+   }
+   Profile.Mark = Now;
+}
+
+void ProfilePrint(const STARTUP_PROFILE& Profile)
+{
+   MosPrintf(MIL_TEXT("\nSTARTUP PROFILE:\n"));
+   MosPrintf(MIL_TEXT("----------------\n\n"));
+   for (int i = 0; i < Profile.Count; i++)
+      MosPrintf(MIL_TEXT("  %-20s %9.2f ms\n"), Profile.Name[i], Profile.Ms[i]);
+   MosPrintf(MIL_TEXT("  %-20s %9.2f ms\n"), MIL_TEXT("Total"), ElapsedMs(Profile.Start, Profile.Mark));
+}
+
+/*------------------------------------------------------------*/
+/* 환영 그래픽 그리기(이미지 버퍼 또는 그래픽 리스트)          */
+/*------------------------------------------------------------*/
+void DrawWelcome(MIL_ID MilGraDest)
+{
+   // 텍스트 색상 설정 (0xF0은 밝은 회색 계열)
+   MgraControl(M_DEFAULT, M_COLOR, 0xF0);
+
+   // 기본 큰 글꼴 설정
+   MgraFont(M_DEFAULT, M_FONT_DEFAULT_LARGE);
+
+   // 이미지 버퍼 위에 텍스트 출력 (좌표 160, 230)
+   MgraText(M_DEFAULT, MilGraDest, 160L, 230L, MIL_TEXT(" Welcome to MIL !!! "));
+
+   // 색상 변경 (0xC0은 좀 더 어두운 회색)
+   MgraControl(M_DEFAULT, M_COLOR, 0xC0);
+
+   // 사각형 3개를 그려 장식 효과 (겹치는 테두리)
+   MgraRect(M_DEFAULT, MilGraDest, 100L, 150L, 530L, 340L);
+   MgraRect(M_DEFAULT, MilGraDest, 120L, 170L, 510L, 320L);
+   MgraRect(M_DEFAULT, MilGraDest, 140L, 190L, 490L, 300L);
+}
+
+/*------------------------------------------------------------*/
+/* 디스플레이 지원 비용 측정                                  */
+/*------------------------------------------------------------*/
+// 같은 환영 그래픽을 같은 이미지에 ANNOTATION_NB_LOOP번 그리면서
+//  - 이미지가 디스플레이에 선택된 경우(화면 갱신 포함)와
+//  - 선택 해제된 경우(헤드리스 경로)
+// 의 1회당 시간을 비교합니다. 헤드리스 빌드에서는 선택 해제 경로만 측정합니다.
+void DisplayCostBenchmark(MIL_ID MilDisplay, MIL_ID MilImage)
+{
+   MIL_DOUBLE TimeDisplay = 0.0, TimeHeadless = 0.0;
+   MIL_INT    n;
+
+   MosPrintf(MIL_TEXT("DISPLAY SUPPORT COST (welcome graphics, %d loops):\n"), ANNOTATION_NB_LOOP);
+   MosPrintf(MIL_TEXT("---------------------------------------------------\n\n"));
+
+#if !MIL_HEADLESS
+   /* 디스플레이에 선택된 이미지에 그리기(워밍업 1회 후 측정) */
+   DrawWelcome(MilImage);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (n = 0; n < ANNOTATION_NB_LOOP; n++)
+      DrawWelcome(MilImage);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeDisplay);
+   MdispSelect(MilDisplay, M_NULL);
+#endif
+
+   /* 같은 이미지를 디스플레이에서 선택 해제한 상태로 그리기 */
+   DrawWelcome(MilImage);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (n = 0; n < ANNOTATION_NB_LOOP; n++)
+      DrawWelcome(MilImage);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeHeadless);
+
+   MosPrintf(MIL_TEXT("No display selected    : %8.4f ms/loop\n"), TimeHeadless * 1000.0 / ANNOTATION_NB_LOOP);
+#if !MIL_HEADLESS
+   MdispSelect(MilDisplay, MilImage);
+   MosPrintf(MIL_TEXT("Display selected       : %8.4f ms/loop\n"), TimeDisplay * 1000.0 / ANNOTATION_NB_LOOP);
+   MosPrintf(MIL_TEXT("Display support costs  : %8.4f ms/loop (%.1fx)\n\n"),
+             (TimeDisplay - TimeHeadless) * 1000.0 / ANNOTATION_NB_LOOP,
+             TimeHeadless > 0.0 ? TimeDisplay / TimeHeadless : 0.0);
+#else
+   MosPrintf(MIL_TEXT("Headless build: no display to compare against.\n\n"));
+#endif
 }
\ No newline at end of file
@@ -16,12 +16,24 @@
  *   - MimConvert (RGB↔HSL): 색 공간 변환. 명도 조절은 보통 HSL의 L만 다루는 것이 자연스럽습니다.
  *   - MimArith + M_SATURATION: 산술 연산 시 포화(saturation) 옵션으로 오버/언더플로우를 안전하게 잘라줍니다.
  *   - MdispSelect: 디스플레이에 어떤 버퍼를 보여줄지 지정합니다. (여기서는 메인 버퍼 MilImage)
+ *   - FusedColorAdjust: RGB→HSL→(L/S/H 조정)→RGB를 픽셀당 한 번에 처리하는 융합 커널입니다.
+ *     캐시에 들어가는 행 묶음(타일) 단위로 여러 스레드가 나눠 처리하며, 3단계 MIL 체인과 속도/결과 차이를 비교합니다.
+ *     AVX2 지원 CPU에서는 8픽셀 단위 명시적 벡터 경로, 밴드별 호스트 메모리가 없는(packed 등) 버퍼는 MIL 체인으로 처리합니다.
+ *   - 레이아웃 엔진: 카메라 packed BGR ↔ planar 변환(SSSE3 셔플), 병렬 Bayer 디모자이크,
+ *     밴드 뷰(BandViewAlloc: planar면 복사 없는 MbufChildColor, packed면 복사 후 되쓰기)를 제공합니다.
+ *     엔진 경로는 8bit 호스트 버퍼 전용이며, 그 외 비트수/메모리는 MbufCopy/MbufBayer로 처리합니다.
  * 
  * 저작권:
  *   © Matrox Electronic Systems Ltd., 1992-2025. All Rights Reserved
  */
 
 #include <mil.h> 
+#include <math.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "../../Common/CpuFeatures.h"
+#include "../../Common/WorkerPool.h"
 
 /* 소스 MIL 이미지 파일 (예: 새 이미지) */
 #define IMAGE_FILE              M_IMAGE_PATH MIL_TEXT("Bird.mim")
@@ -29,6 +41,68 @@
 /* 명도(Luminance)에 더할 오프셋 값 */
 #define IMAGE_LUMINANCE_OFFSET  40L
 
+/* 융합 커널 파라미터: 타일 크기(입력 바이트), 벤치마크 반복 수,
+   MIL 체인 대비 허용 최대 차이(체인은 H/S/L을 8bit로 양자화하므로 몇 레벨 차이는 정상) */
+#define FUSED_TILE_BYTES        (128L * 1024L)
+#define FUSED_NB_LOOP           10
+#define FUSED_MAX_DIFF          8
+
+/* 레이아웃 벤치마크 크기/반복 수 */
+#define LAYOUT_SIZE_X           3840
+#define LAYOUT_SIZE_Y           2160
+#define LAYOUT_NB_LOOP          10
+
+/* 헤드리스 실행 모드: 1이면 디스플레이 없이 실행(MdispAlloc 없음, M_DISP 없음, 키 대기 없음) */
+#include "../../Common/MilHeadless.h"
+
+/* 디스플레이 비용 측정 반복 수, 선택/해제 순서를 번갈아 측정하는 라운드 수 */
+#define DISPLAY_COST_NB_LOOP    20
+#define DISPLAY_COST_NB_ROUND   4
+
+#define MosMin(a, b) (((a) < (b)) ? (a) : (b))
+#define MosMax(a, b) (((a) > (b)) ? (a) : (b))
+
+/* 색 조정량(8bit 기준 단위): L 오프셋, S 배율, H 이동(256 = 한 바퀴) */
+typedef struct
+{
+   MIL_DOUBLE LuminanceOffset;
+   MIL_DOUBLE SaturationGain;
+   MIL_DOUBLE HueShift;
+} COLOR_ADJUST;
+
+/* 평면 컬러 버퍼의 밴드별 호스트 메모리 뷰 */
+typedef struct
+{
+   MIL_UINT8* Band[3];
+   MIL_INT    PitchByte;
+   MIL_INT    SizeX, SizeY, SizeBit;
+} PLANAR_VIEW;
+
+bool GetPlanarView(MIL_ID MilColorImage, PLANAR_VIEW& View);
+void ColorAdjustChain(MIL_ID MilSourceImage, MIL_ID MilDestImage, const COLOR_ADJUST& Adjust);
+bool FusedColorAdjust(MIL_ID MilSourceImage, MIL_ID MilDestImage, const COLOR_ADJUST& Adjust, MIL_INT NbThreads);
+void ColorPoolAlloc(MIL_INT NbThreads);
+void ColorPoolFree();
+void FusedColorBenchmark(MIL_ID MilSystem, MIL_ID MilSourceImage);
+
+/* 밴드 뷰: planar면 자식 버퍼(복사 없음), packed면 단일 밴드 복사본 */
+typedef struct
+{
+   MIL_ID  MilBand;
+   MIL_ID  MilParent;
+   MIL_INT Band;
+   bool    IsCopy;
+} BAND_VIEW;
+
+bool IsPackedImage(MIL_ID MilColorImage);
+bool ConvertLayout(MIL_ID MilSourceImage, MIL_ID MilDestImage, MIL_INT NbThreads);
+bool DemosaicBayer(MIL_ID MilBayerImage, MIL_ID MilDestImage, MIL_INT NbThreads);
+void BandViewAlloc(MIL_ID MilColorImage, MIL_INT Band, BAND_VIEW& View);
+void BandViewFree(BAND_VIEW& View);
+void LayoutBenchmark(MIL_ID MilSystem, MIL_ID MilSourceImage);
+
+void DisplayCostBenchmark(MIL_ID MilDisplay, MIL_ID MilImage, MIL_ID MilLeftSubImage, MIL_ID MilRightSubImage);
+
 /* 메인 함수 */
 int MosMain(void)
 { 
@@ -46,8 +120,16 @@ int MosMain(void)
 
    MIL_INT SizeX, SizeY, SizeBand, Type;
 
-   /* 1) 기본 자원 할당(애플리케이션/시스템/디스플레이) */
+   /* 1) 기본 자원 할당(애플리케이션/시스템/디스플레이), 헤드리스면 디스플레이 제외 */
+#if MIL_HEADLESS
+   MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem, M_NULL, M_NULL, M_NULL);
+   MilDisplay = M_NULL;
+#else
    MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem, &MilDisplay, M_NULL, M_NULL);
+#endif
+
+   /* 융합 커널/레이아웃 변환용 상주 작업자 풀(호출마다 스레드를 만들지 않음) */
+   ColorPoolAlloc((MIL_INT)std::thread::hardware_concurrency());
 
    /* 2) 소스 이미지의 메타데이터(밴드 수, 크기, 타입)를 조회하여
          그 가로폭을 2배로 한 디스플레이용 컬러 버퍼를 할당 */
@@ -56,12 +138,14 @@ int MosMain(void)
                   MbufDiskInquire(IMAGE_FILE, M_SIZE_X, &SizeX) * 2,   // 가로 2배(좌:원본/우:결과)
                   MbufDiskInquire(IMAGE_FILE, M_SIZE_Y, &SizeY),       // 세로
                   MbufDiskInquire(IMAGE_FILE, M_TYPE,   &Type),        // 픽셀 타입
-                  M_IMAGE + M_DISP + M_PROC,                           // 이미지/표시/처리 가능 플래그
+                  M_IMAGE + DISPLAY_ATTRIBUTE + M_PROC,                // 이미지/표시/처리 가능 플래그
                   &MilImage);
 
    /* 디스플레이 버퍼 초기화(검정) 후 디스플레이에 선택 */
    MbufClear(MilImage, 0L);
+#if !MIL_HEADLESS
    MdispSelect(MilDisplay, MilImage);
+#endif
 
    /* 3) 디스플레이용 메인 버퍼(MilImage)를 좌/우로 나눈 Child 2D 버퍼 생성
          - 좌측: 원본 표시 영역
@@ -91,7 +175,7 @@ int MosMain(void)
    MosPrintf(MIL_TEXT("-----------------\n\n"));
    MosPrintf(MIL_TEXT("좌측에 컬러 원본을 로드하고, 각 R/G/B 밴드에 텍스트 주석을 그렸습니다.\n"));
    MosPrintf(MIL_TEXT("계속하려면 키를 누르세요.\n\n"));
-   MosGetch();
+   WaitForKey(0);
 
    /* 7) 좌측(원본) → 우측(처리)로 컬러 공간 변환: RGB → HSL */
    MimConvert(MilLeftSubImage, MilRightSubImage, M_RGB_TO_HSL);
@@ -108,8 +192,19 @@ int MosMain(void)
 
    /* 안내 메시지 */
    MosPrintf(MIL_TEXT("명도(L) 성분에 오프셋을 더해 이미지가 더 밝아졌습니다.\n"));
+   MosPrintf(MIL_TEXT("계속하려면 키를 누르세요.\n\n"));
+   WaitForKey(0);
+
+   /* 10-1) 같은 밝기 보정을 융합 커널로 한 번에 수행(원본 → 우측) 후 속도 비교 */
+   COLOR_ADJUST Adjust = { (MIL_DOUBLE)IMAGE_LUMINANCE_OFFSET, 1.0, 0.0 };
+   FusedColorAdjust(MilLeftSubImage, MilRightSubImage, Adjust, (MIL_INT)std::thread::hardware_concurrency());
+   MosPrintf(MIL_TEXT("우측 결과를 융합 커널(RGB→HSL→L 보정→RGB 한 번에)로 다시 계산했습니다.\n\n"));
+   FusedColorBenchmark(MilSystem, MilLeftSubImage);
+   LayoutBenchmark(MilSystem, MilLeftSubImage);
+   DisplayCostBenchmark(MilDisplay, MilImage, MilLeftSubImage, MilRightSubImage);
+
    MosPrintf(MIL_TEXT("종료하려면 키를 누르세요.\n"));
-   MosGetch();
+   WaitForKey(0);
 
    /* 11) 서브 이미지 및 메인 이미지 버퍼 해제(생성 역순 권장) */
    MbufFree(MilLumSubImage);
@@ -120,9 +215,834 @@ int MosMain(void)
    MbufFree(MilLeftSubImage);
    MbufFree(MilImage);
 
+   ColorPoolFree();
+
    /* 12) 기본 자원 해제(애플리케이션/시스템/디스플레이) */
    MappFreeDefault(MilApplication, MilSystem, MilDisplay, M_NULL, M_NULL);
 
    return 0;
 }
 
+/*****************************************************************************
+ * 융합 컬러 조정(RGB→HSL→조정→RGB 한 번에)
+ *  - 픽셀마다 HSL 계산 → L 오프셋/S 배율/H 이동 → 바로 RGB로 복원, 중간 버퍼 없음
+ *  - 분기 없는 float 식(min/max/선택)만 사용: 스칼라 행 함수와 같은 식을 AVX2로 8픽셀씩 계산하는
+ *    FusedAdjustRowAvx2를 따로 두고, CpuHasAvx2()로 실행 시점에 선택(나머지 픽셀은 스칼라)
+ *  - HSL→RGB: f(n) = L - a*max(-1, min(k-3, 9-k, 1)), k = (n + 12H) mod 12, a = S*min(L, 1-L)
+ *****************************************************************************/
+template <class T>
+static void FusedAdjustRow(const T* SrcR, const T* SrcG, const T* SrcB,
+                           T* DstR, T* DstG, T* DstB, MIL_INT SizeX,
+                           float MaxValue, float LumOffset, float SatGain, float HueShift)
+{
+   const float Norm = 1.0f / MaxValue;
+   for (MIL_INT x = 0; x < SizeX; x++)
+   {
+      float r = SrcR[x] * Norm, g = SrcG[x] * Norm, b = SrcB[x] * Norm;
+
+      /* RGB → HSL (H: 0~1 한 바퀴) */
+      float Max = fmaxf(r, fmaxf(g, b));
+      float Min = fminf(r, fminf(g, b));
+      float d   = Max - Min;
+      float l   = 0.5f * (Max + Min);
+      float s   = d / fmaxf(1.0f - fabsf(2.0f * l - 1.0f), 1e-6f);
+      float InvD = 1.0f / fmaxf(d, 1e-6f);
+      float h   = (Max == r) ? (g - b) * InvD :
+                  (Max == g) ? (b - r) * InvD + 2.0f :
+                               (r - g) * InvD + 4.0f;
+      h = h * (1.0f / 6.0f) + HueShift;
+
+      /* 조정 + 범위 포화 */
+      h = h - floorf(h);
+      l = fminf(fmaxf(l + LumOffset, 0.0f), 1.0f);
+      s = fminf(fmaxf(s * SatGain,   0.0f), 1.0f);
+
+      /* HSL → RGB */
+      float a  = s * fminf(l, 1.0f - l);
+      float kr = 12.0f * h;
+      float kg = kr + 8.0f;  kg = (kg >= 12.0f) ? kg - 12.0f : kg;
+      float kb = kr + 4.0f;  kb = (kb >= 12.0f) ? kb - 12.0f : kb;
+      r = l - a * fmaxf(-1.0f, fminf(fminf(kr - 3.0f, 9.0f - kr), 1.0f));
+      g = l - a * fmaxf(-1.0f, fminf(fminf(kg - 3.0f, 9.0f - kg), 1.0f));
+      b = l - a * fmaxf(-1.0f, fminf(fminf(kb - 3.0f, 9.0f - kb), 1.0f));
+
+      DstR[x] = (T)(r * MaxValue + 0.5f);
+      DstG[x] = (T)(g * MaxValue + 0.5f);
+      DstB[x] = (T)(b * MaxValue + 0.5f);
+   }
+}
+
+#if CPU_HAS_AVX2_KERNEL
+/* 8픽셀 로드/저장(8bit, 16bit): 정규화 전 float, 저장은 반올림 후 포화 */
+AVX2_TARGET static inline __m256 LoadPixels(const MIL_UINT8* Src)
+{
+   return _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)Src)));
+}
+
+AVX2_TARGET static inline __m256 LoadPixels(const MIL_UINT16* Src)
+{
+   return _mm256_cvtepi32_ps(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)Src)));
+}
+
+AVX2_TARGET static inline __m128i PackPixels(__m256 Value, __m256 MaxValue)
+{
+   __m256i Int = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(Value, MaxValue), _mm256_set1_ps(0.5f)));
+   return _mm_packus_epi32(_mm256_castsi256_si128(Int), _mm256_extracti128_si256(Int, 1));
+}
+
+AVX2_TARGET static inline void StorePixels(MIL_UINT8* Dst, __m256 Value, __m256 MaxValue)
+{
+   __m128i Word = PackPixels(Value, MaxValue);
+   _mm_storel_epi64((__m128i*)Dst, _mm_packus_epi16(Word, Word));
+}
+
+AVX2_TARGET static inline void StorePixels(MIL_UINT16* Dst, __m256 Value, __m256 MaxValue)
+{
+   _mm_storeu_si128((__m128i*)Dst, PackPixels(Value, MaxValue));
+}
+
+/* HSL→RGB 한 채널: L - a*max(-1, min(k-3, 9-k, 1)) */
+AVX2_TARGET static inline __m256 HslChannel(__m256 l, __m256 a, __m256 k)
+{
+   __m256 t = _mm256_min_ps(_mm256_min_ps(_mm256_sub_ps(k, _mm256_set1_ps(3.0f)),
+                                          _mm256_sub_ps(_mm256_set1_ps(9.0f), k)), _mm256_set1_ps(1.0f));
+   return _mm256_sub_ps(l, _mm256_mul_ps(a, _mm256_max_ps(t, _mm256_set1_ps(-1.0f))));
+}
+
+/* k = kr + Offset, 12 이상이면 12를 뺌 */
+AVX2_TARGET static inline __m256 HslWrap(__m256 kr, float Offset)
+{
+   __m256 k = _mm256_add_ps(kr, _mm256_set1_ps(Offset));
+   __m256 Twelve = _mm256_set1_ps(12.0f);
+   return _mm256_blendv_ps(k, _mm256_sub_ps(k, Twelve), _mm256_cmp_ps(k, Twelve, _CMP_GE_OQ));
+}
+
+/* FusedAdjustRow와 같은 식을 8픽셀씩 계산, 나머지는 스칼라 */
+template <class T>
+AVX2_TARGET static void FusedAdjustRowAvx2(const T* SrcR, const T* SrcG, const T* SrcB,
+                                           T* DstR, T* DstG, T* DstB, MIL_INT SizeX,
+                                           float MaxValue, float LumOffset, float SatGain, float HueShift)
+{
+   const __m256 Norm    = _mm256_set1_ps(1.0f / MaxValue);
+   const __m256 MaxVec  = _mm256_set1_ps(MaxValue);
+   const __m256 Zero    = _mm256_setzero_ps();
+   const __m256 One     = _mm256_set1_ps(1.0f);
+   const __m256 Half    = _mm256_set1_ps(0.5f);
+   const __m256 Epsilon = _mm256_set1_ps(1e-6f);
+   const __m256 SignBit = _mm256_set1_ps(-0.0f);
+   MIL_INT x = 0;
+
+   for (; x + 8 <= SizeX; x += 8)
+   {
+      __m256 r = _mm256_mul_ps(LoadPixels(SrcR + x), Norm);
+      __m256 g = _mm256_mul_ps(LoadPixels(SrcG + x), Norm);
+      __m256 b = _mm256_mul_ps(LoadPixels(SrcB + x), Norm);
+
+      /* RGB → HSL */
+      __m256 Max  = _mm256_max_ps(r, _mm256_max_ps(g, b));
+      __m256 Min  = _mm256_min_ps(r, _mm256_min_ps(g, b));
+      __m256 d    = _mm256_sub_ps(Max, Min);
+      __m256 l    = _mm256_mul_ps(Half, _mm256_add_ps(Max, Min));
+      __m256 Den  = _mm256_sub_ps(One, _mm256_andnot_ps(SignBit, _mm256_sub_ps(_mm256_add_ps(l, l), One)));
+      __m256 s    = _mm256_div_ps(d, _mm256_max_ps(Den, Epsilon));
+      __m256 InvD = _mm256_div_ps(One, _mm256_max_ps(d, Epsilon));
+      __m256 hr   = _mm256_mul_ps(_mm256_sub_ps(g, b), InvD);
+      __m256 hg   = _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(b, r), InvD), _mm256_set1_ps(2.0f));
+      __m256 hb   = _mm256_add_ps(_mm256_mul_ps(_mm256_sub_ps(r, g), InvD), _mm256_set1_ps(4.0f));
+      __m256 h    = _mm256_blendv_ps(hb, hg, _mm256_cmp_ps(Max, g, _CMP_EQ_OQ));
+      h = _mm256_blendv_ps(h, hr, _mm256_cmp_ps(Max, r, _CMP_EQ_OQ));
+      h = _mm256_add_ps(_mm256_mul_ps(h, _mm256_set1_ps(1.0f / 6.0f)), _mm256_set1_ps(HueShift));
+
+      /* 조정 + 범위 포화 */
+      h = _mm256_sub_ps(h, _mm256_floor_ps(h));
+      l = _mm256_min_ps(_mm256_max_ps(_mm256_add_ps(l, _mm256_set1_ps(LumOffset)), Zero), One);
+      s = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(s, _mm256_set1_ps(SatGain)), Zero), One);
+
+      /* HSL → RGB */
+      __m256 a  = _mm256_mul_ps(s, _mm256_min_ps(l, _mm256_sub_ps(One, l)));
+      __m256 kr = _mm256_mul_ps(_mm256_set1_ps(12.0f), h);
+      StorePixels(DstR + x, HslChannel(l, a, kr), MaxVec);
+      StorePixels(DstG + x, HslChannel(l, a, HslWrap(kr, 8.0f)), MaxVec);
+      StorePixels(DstB + x, HslChannel(l, a, HslWrap(kr, 4.0f)), MaxVec);
+   }
+   if (x < SizeX)
+      FusedAdjustRow(SrcR + x, SrcG + x, SrcB + x, DstR + x, DstG + x, DstB + x, SizeX - x,
+                     MaxValue, LumOffset, SatGain, HueShift);
+}
+#endif
+
+/* 타일(행 묶음) 단위 작업: 스레드들이 다음 타일 번호를 원자적으로 가져가 처리 */
+template <class T>
+static void FusedAdjustTiles(const PLANAR_VIEW* Src, const PLANAR_VIEW* Dst, const COLOR_ADJUST* Adjust,
+                             MIL_INT RowsPerTile, std::atomic<MIL_INT>* NextTile)
+{
+   const float MaxValue  = (float)((1 << (8 * sizeof(T))) - 1);
+   const float LumOffset = (float)(Adjust->LuminanceOffset / 255.0);
+   const float HueShift  = (float)(Adjust->HueShift / 256.0);
+   const float SatGain   = (float)Adjust->SaturationGain;
+   MIL_INT     NbTiles   = (Src->SizeY + RowsPerTile - 1) / RowsPerTile;
+   const bool  UseAvx2   = CpuHasAvx2();
+
+   for (MIL_INT Tile = (*NextTile)++; Tile < NbTiles; Tile = (*NextTile)++)
+   {
+      MIL_INT EndY = MosMin((Tile + 1) * RowsPerTile, Src->SizeY);
+      for (MIL_INT y = Tile * RowsPerTile; y < EndY; y++)
+      {
+         const T* SrcR = (const T*)(Src->Band[0] + y * Src->PitchByte);
+         const T* SrcG = (const T*)(Src->Band[1] + y * Src->PitchByte);
+         const T* SrcB = (const T*)(Src->Band[2] + y * Src->PitchByte);
+         T*       DstR = (T*)(Dst->Band[0] + y * Dst->PitchByte);
+         T*       DstG = (T*)(Dst->Band[1] + y * Dst->PitchByte);
+         T*       DstB = (T*)(Dst->Band[2] + y * Dst->PitchByte);
+#if CPU_HAS_AVX2_KERNEL
+         if (UseAvx2)
+         {
+            FusedAdjustRowAvx2(SrcR, SrcG, SrcB, DstR, DstG, DstB, Src->SizeX,
+                               MaxValue, LumOffset, SatGain, HueShift);
+            continue;
+         }
+#endif
+         FusedAdjustRow(SrcR, SrcG, SrcB, DstR, DstG, DstB, Src->SizeX,
+                        MaxValue, LumOffset, SatGain, HueShift);
+      }
+   }
+}
+
+/* 평면(planar) 컬러 버퍼의 밴드별 호스트 주소/피치
+   반환: false면 호스트 포인터로 직접 처리할 수 없는 버퍼(3밴드 아님, M_PACKED 저장,
+         호스트 주소 없음, 밴드별 피치 다름) */
+bool GetPlanarView(MIL_ID MilColorImage, PLANAR_VIEW& View)
+{
+   static const MIL_INT Bands[3] = { M_RED, M_GREEN, M_BLUE };
+   MIL_ID MilBand;
+
+   MbufInquire(MilColorImage, M_SIZE_X, &View.SizeX);
+   MbufInquire(MilColorImage, M_SIZE_Y, &View.SizeY);
+   View.SizeBit = MbufInquire(MilColorImage, M_SIZE_BIT, M_NULL);
+   if (MbufInquire(MilColorImage, M_SIZE_BAND, M_NULL) != 3 ||
+       (MbufInquire(MilColorImage, M_EXTENDED_ATTRIBUTE, M_NULL) & M_PACKED) != 0)
+      return false;
+
+   for (MIL_INT b = 0; b < 3; b++)
+   {
+      MbufChildColor(MilColorImage, Bands[b], &MilBand);
+      MIL_INT PitchByte = MbufInquire(MilBand, M_PITCH_BYTE, M_NULL);
+      View.Band[b] = (MIL_UINT8*)MbufInquire(MilBand, M_HOST_ADDRESS, M_NULL);
+      MbufFree(MilBand);
+      if (View.Band[b] == M_NULL || (b > 0 && PitchByte != View.PitchByte))
+         return false;
+      View.PitchByte = PitchByte;
+   }
+   return true;
+}
+
+/* 같은 조정을 MIL 3단계 체인으로: MimConvert(HSL) → 밴드별 MimArith → MimConvert(RGB)
+   (조정량은 8bit 단위이므로 버퍼 비트수에 맞춰 환산) */
+void ColorAdjustChain(MIL_ID MilSourceImage, MIL_ID MilDestImage, const COLOR_ADJUST& Adjust)
+{
+   MIL_INT    SizeBit = MbufInquire(MilDestImage, M_SIZE_BIT, M_NULL);
+   MIL_DOUBLE Scale   = (MIL_DOUBLE)((1 << SizeBit) - 1) / 255.0;
+   MIL_ID     MilBand;
+
+   MimConvert(MilSourceImage, MilDestImage, M_RGB_TO_HSL);
+   if (Adjust.HueShift != 0.0)
+   {
+      /* 포화 없이 더해 한 바퀴를 넘으면 감김 */
+      MbufChildColor(MilDestImage, M_HUE, &MilBand);
+      MimArith(MilBand, Adjust.HueShift * (MIL_DOUBLE)(1 << SizeBit) / 256.0, MilBand, M_ADD_CONST);
+      MbufFree(MilBand);
+   }
+   if (Adjust.SaturationGain != 1.0)
+   {
+      MbufChildColor(MilDestImage, M_SATURATION, &MilBand);
+      MimArith(MilBand, Adjust.SaturationGain, MilBand, M_MULT_CONST + M_SATURATION);
+      MbufFree(MilBand);
+   }
+   if (Adjust.LuminanceOffset != 0.0)
+   {
+      MbufChildColor(MilDestImage, M_LUMINANCE, &MilBand);
+      MimArith(MilBand, Adjust.LuminanceOffset * Scale, MilBand, M_ADD_CONST + M_SATURATION);
+      MbufFree(MilBand);
+   }
+   MimConvert(MilDestImage, MilDestImage, M_HSL_TO_RGB);
+}
+
+/* 융합 커널/레이아웃 작업자 풀(메인 스레드에서만 실행, NbThreads는 풀 크기 이하로 제한) */
+static WORKER_POOL ColorPool;
+
+void ColorPoolAlloc(MIL_INT NbThreads)
+{
+   WorkerPoolAlloc(ColorPool, MosMax(NbThreads, (MIL_INT)1));
+}
+
+void ColorPoolFree()
+{
+   WorkerPoolFree(ColorPool);
+}
+
+/* 반환: true면 융합 커널, false면 planar 호스트 버퍼가 아니어서 MIL 체인으로 처리 */
+bool FusedColorAdjust(MIL_ID MilSourceImage, MIL_ID MilDestImage, const COLOR_ADJUST& Adjust, MIL_INT NbThreads)
+{
+   PLANAR_VIEW Src, Dst;
+   if (!GetPlanarView(MilSourceImage, Src) || !GetPlanarView(MilDestImage, Dst) ||
+       Src.SizeX != Dst.SizeX || Src.SizeY != Dst.SizeY || Src.SizeBit != Dst.SizeBit ||
+       (Src.SizeBit != 8 && Src.SizeBit != 16))
+   {
+      ColorAdjustChain(MilSourceImage, MilDestImage, Adjust);
+      return false;
+   }
+
+   /* 타일 크기: 입력 3밴드가 FUSED_TILE_BYTES(L2 캐시 정도)에 들어가는 행 수 */
+   MIL_INT RowBytes    = 3 * Src.SizeX * ((Src.SizeBit + 7) / 8);
+   MIL_INT RowsPerTile = MosMax(FUSED_TILE_BYTES / RowBytes, (MIL_INT)1);
+   std::atomic<MIL_INT> NextTile(0);
+
+   NbThreads = MosMax(MosMin(NbThreads, WorkerPoolSize(ColorPool)), (MIL_INT)1);
+   WorkerPoolRun(ColorPool, NbThreads, [&](MIL_INT)
+   {
+      if (Src.SizeBit > 8)
+         FusedAdjustTiles<MIL_UINT16>(&Src, &Dst, &Adjust, RowsPerTile, &NextTile);
+      else
+         FusedAdjustTiles<MIL_UINT8>(&Src, &Dst, &Adjust, RowsPerTile, &NextTile);
+   });
+   return true;
+}
+
+/* 두 컬러 버퍼의 밴드별 최대 절대 차이 중 최댓값(MimArith M_SUB_ABS → MimFindExtreme) */
+static MIL_INT MaxAbsDiff(MIL_ID MilSystem, MIL_ID MilImageA, MIL_ID MilImageB)
+{
+   static const MIL_INT Bands[3] = { M_RED, M_GREEN, M_BLUE };
+   MIL_ID  MilDiff, MilBand, MilExtreme;
+   MIL_INT Value, MaxDiff = 0;
+
+   MbufAllocColor(MilSystem, 3, MbufInquire(MilImageA, M_SIZE_X, M_NULL), MbufInquire(MilImageA, M_SIZE_Y, M_NULL),
+                  MbufInquire(MilImageA, M_TYPE, M_NULL), M_IMAGE + M_PROC, &MilDiff);
+   MimAllocResult(MilSystem, 1L, M_EXTREME_LIST, &MilExtreme);
+   MimArith(MilImageA, MilImageB, MilDiff, M_SUB_ABS);
+   for (MIL_INT b = 0; b < 3; b++)
+   {
+      MbufChildColor(MilDiff, Bands[b], &MilBand);
+      MimFindExtreme(MilBand, MilExtreme, M_MAX_VALUE);
+      MimGetResult(MilExtreme, M_VALUE, &Value);
+      MaxDiff = MosMax(MaxDiff, Value);
+      MbufFree(MilBand);
+   }
+   MimFree(MilExtreme);
+   MbufFree(MilDiff);
+   return MaxDiff;
+}
+
+/*****************************************************************************
+ * 융합 컬러 조정 벤치마크: 3단계 MIL 체인(MimConvert→MimArith→MimConvert) vs 융합 커널
+ *  - 4K(3840x2160), 20MP(5472x3648) 8bit RGB
+ *  - 같은 입력에 대한 두 결과의 최대 절대 차이를 FUSED_MAX_DIFF와 비교해 출력
+ *****************************************************************************/
+void FusedColorBenchmark(MIL_ID MilSystem, MIL_ID MilSourceImage)
+{
+   static const MIL_INT     SizesX[] = { 3840, 5472 };
+   static const MIL_INT     SizesY[] = { 2160, 3648 };
+   static const MIL_CONST_TEXT_PTR Names[] = { MIL_TEXT("4K"), MIL_TEXT("20MP") };
+   MIL_INT    NbCores = MosMax((MIL_INT)std::thread::hardware_concurrency(), (MIL_INT)1);
+   MIL_ID     MilSrc, MilDst, MilChain;
+   MIL_DOUBLE Time, TimeChain, TimeFused1, TimeFusedMp;
+   MIL_INT    i, n, MaxDiff;
+   bool       Fused = true;
+   COLOR_ADJUST Adjust = { (MIL_DOUBLE)IMAGE_LUMINANCE_OFFSET, 1.0, 0.0 };
+
+   MosPrintf(MIL_TEXT("FUSED COLOR ADJUST BENCHMARK (ms/frame):\n"));
+   MosPrintf(MIL_TEXT("----------------------------------------\n\n"));
+   MosPrintf(MIL_TEXT("Fused kernel: %s.\n\n"),
+             CpuHasAvx2() ? MIL_TEXT("AVX2, 8 pixels per iteration (runtime CPUID)") : MIL_TEXT("scalar (no AVX2 on this CPU)"));
+   MosPrintf(MIL_TEXT("Size    3-call chain   fused 1 thread   fused %2d threads   max |diff|\n\n"), (int)NbCores);
+
+   for (i = 0; i < 2; i++)
+   {
+      MbufAllocColor(MilSystem, 3, SizesX[i], SizesY[i], 8 + M_UNSIGNED, M_IMAGE + M_PROC, &MilSrc);
+      MbufAllocColor(MilSystem, 3, SizesX[i], SizesY[i], 8 + M_UNSIGNED, M_IMAGE + M_PROC, &MilDst);
+      MbufAllocColor(MilSystem, 3, SizesX[i], SizesY[i], 8 + M_UNSIGNED, M_IMAGE + M_PROC, &MilChain);
+      MimResize(MilSourceImage, MilSrc, M_FILL_DESTINATION, M_FILL_DESTINATION, M_BILINEAR);
+
+      /* (a) 3단계 체인: 전체 메모리 왕복 3회 (워밍업 1회 후 측정) */
+      for (n = -1; n < FUSED_NB_LOOP; n++)
+      {
+         if (n == 0)
+         {
+            MthrWait(M_DEFAULT, M_THREAD_WAIT, M_NULL);
+            MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+         }
+         ColorAdjustChain(MilSrc, MilChain, Adjust);
+      }
+      MthrWait(M_DEFAULT, M_THREAD_WAIT, M_NULL);
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+      TimeChain = Time / FUSED_NB_LOOP;
+
+      /* (b) 융합 커널: 1스레드 / 전체 코어 */
+      Fused = FusedColorAdjust(MilSrc, MilDst, Adjust, 1) && Fused;
+      MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+      for (n = 0; n < FUSED_NB_LOOP; n++)
+         FusedColorAdjust(MilSrc, MilDst, Adjust, 1);
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+      TimeFused1 = Time / FUSED_NB_LOOP;
+
+      MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+      for (n = 0; n < FUSED_NB_LOOP; n++)
+         FusedColorAdjust(MilSrc, MilDst, Adjust, NbCores);
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+      TimeFusedMp = Time / FUSED_NB_LOOP;
+
+      /* (c) 결과 검증: 체인 결과 대비 최대 절대 차이 */
+      MaxDiff = MaxAbsDiff(MilSystem, MilChain, MilDst);
+
+      MosPrintf(MIL_TEXT("%-8s%-15.2f%-17.2f%-19.2f%d (%s)\n"), Names[i],
+                TimeChain * 1000.0, TimeFused1 * 1000.0, TimeFusedMp * 1000.0,
+                (int)MaxDiff, (MaxDiff <= FUSED_MAX_DIFF) ? MIL_TEXT("ok") : MIL_TEXT("MISMATCH"));
+
+      MbufFree(MilChain);
+      MbufFree(MilDst);
+      MbufFree(MilSrc);
+   }
+   MosPrintf(MIL_TEXT("\nmax |diff| is against the MIL chain; up to %d levels come from its 8-bit H/S/L quantization.\n"),
+             FUSED_MAX_DIFF);
+   if (!Fused)
+      MosPrintf(MIL_TEXT("Buffers were not planar host memory: the MIL chain was used instead of the fused kernel.\n"));
+   MosPrintf(MIL_TEXT("\n"));
+}
+
+/*****************************************************************************
+ * 컬러 레이아웃 엔진
+ *  - 카메라 packed BGR(B,G,R,B,G,R,...) ↔ MIL planar(R 평면, G 평면, B 평면)
+ *  - SSSE3 pshufb: 16픽셀(48바이트)을 3번 읽어 밴드별로 셔플/OR, CpuHasSsse3()로 실행 시점에 선택
+ *    (미지원 CPU/비 x86 빌드는 스칼라)
+ *  - 행 구간 단위로 스레드 분할
+ *  - 셔플/디모자이크 커널은 8bit 전용: 다른 비트수, 호스트 주소가 없는 버퍼, 크기가 다른 버퍼는
+ *    MIL(MbufCopy/MbufBayer)로 처리하고 false 반환
+ *****************************************************************************/
+#if CPU_HAS_SSSE3_KERNEL
+/* 셔플 마스크: [출력 벡터/밴드][입력 벡터/밴드] */
+typedef struct
+{
+   MIL_UINT8 PackedToPlanar[3][3][16];
+   MIL_UINT8 PlanarToPacked[3][3][16];
+} SHUFFLE_MASKS;
+
+static SHUFFLE_MASKS BuildShuffleMasks()
+{
+   SHUFFLE_MASKS Masks;
+   for (MIL_INT Out = 0; Out < 3; Out++)
+      for (MIL_INT In = 0; In < 3; In++)
+         for (MIL_INT i = 0; i < 16; i++)
+         {
+            /* packed→planar: 밴드 Out(B,G,R 순서 오프셋 2-Out)의 i번째 픽셀 = packed 바이트 3i + (2-Out) */
+            MIL_INT Byte = 3 * i + (2 - Out) - 16 * In;
+            Masks.PackedToPlanar[Out][In][i] = (Byte >= 0 && Byte < 16) ? (MIL_UINT8)Byte : 0x80;
+
+            /* planar→packed: 출력 벡터 Out의 바이트 i = 픽셀 (16*Out+i)/3, 채널 (16*Out+i)%3 (B,G,R) */
+            MIL_INT Packed = 16 * Out + i;
+            Masks.PlanarToPacked[Out][In][i] = ((2 - Packed % 3) == In) ? (MIL_UINT8)(Packed / 3) : 0x80;
+         }
+   return Masks;
+}
+
+/* 첫 호출에서 한 번 생성(함수 지역 static 초기화는 여러 스레드가 동시에 불러도 한 번만 실행) */
+static const SHUFFLE_MASKS& ShuffleMasks()
+{
+   static const SHUFFLE_MASKS Masks = BuildShuffleMasks();
+   return Masks;
+}
+
+/* 16픽셀 단위 셔플, 반환: 처리한 픽셀 수(나머지는 호출자가 스칼라로) */
+SSSE3_TARGET static MIL_INT PackedToPlanarRowSsse3(const MIL_UINT8* Src, MIL_UINT8* R, MIL_UINT8* G, MIL_UINT8* B,
+                                                   MIL_INT SizeX, const SHUFFLE_MASKS* Masks)
+{
+   MIL_INT x = 0;
+   for (; x + 16 <= SizeX; x += 16)
+   {
+      __m128i In[3];
+      for (MIL_INT k = 0; k < 3; k++)
+         In[k] = _mm_loadu_si128((const __m128i*)(Src + 3 * x + 16 * k));
+      MIL_UINT8* Out[3] = { R + x, G + x, B + x };
+      for (MIL_INT c = 0; c < 3; c++)
+      {
+         __m128i v = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(In[0], _mm_loadu_si128((const __m128i*)Masks->PackedToPlanar[c][0])),
+            _mm_shuffle_epi8(In[1], _mm_loadu_si128((const __m128i*)Masks->PackedToPlanar[c][1]))),
+            _mm_shuffle_epi8(In[2], _mm_loadu_si128((const __m128i*)Masks->PackedToPlanar[c][2])));
+         _mm_storeu_si128((__m128i*)Out[c], v);
+      }
+   }
+   return x;
+}
+
+SSSE3_TARGET static MIL_INT PlanarToPackedRowSsse3(const MIL_UINT8* R, const MIL_UINT8* G, const MIL_UINT8* B,
+                                                   MIL_UINT8* Dst, MIL_INT SizeX, const SHUFFLE_MASKS* Masks)
+{
+   MIL_INT x = 0;
+   for (; x + 16 <= SizeX; x += 16)
+   {
+      __m128i In[3] = { _mm_loadu_si128((const __m128i*)(R + x)),
+                        _mm_loadu_si128((const __m128i*)(G + x)),
+                        _mm_loadu_si128((const __m128i*)(B + x)) };
+      for (MIL_INT k = 0; k < 3; k++)
+      {
+         __m128i v = _mm_or_si128(_mm_or_si128(
+            _mm_shuffle_epi8(In[0], _mm_loadu_si128((const __m128i*)Masks->PlanarToPacked[k][0])),
+            _mm_shuffle_epi8(In[1], _mm_loadu_si128((const __m128i*)Masks->PlanarToPacked[k][1]))),
+            _mm_shuffle_epi8(In[2], _mm_loadu_si128((const __m128i*)Masks->PlanarToPacked[k][2])));
+         _mm_storeu_si128((__m128i*)(Dst + 3 * x + 16 * k), v);
+      }
+   }
+   return x;
+}
+#endif
+
+static void PackedToPlanarRows(const MIL_UINT8* Packed, MIL_INT PackedPitch, const PLANAR_VIEW* Dst,
+                               MIL_INT StartY, MIL_INT EndY)
+{
+#if CPU_HAS_SSSE3_KERNEL
+   const SHUFFLE_MASKS* Masks = CpuHasSsse3() ? &ShuffleMasks() : M_NULL;
+#endif
+   for (MIL_INT y = StartY; y < EndY; y++)
+   {
+      const MIL_UINT8* Src = Packed + y * PackedPitch;
+      MIL_UINT8* R = Dst->Band[0] + y * Dst->PitchByte;
+      MIL_UINT8* G = Dst->Band[1] + y * Dst->PitchByte;
+      MIL_UINT8* B = Dst->Band[2] + y * Dst->PitchByte;
+      MIL_INT x = 0;
+#if CPU_HAS_SSSE3_KERNEL
+      if (Masks)
+         x = PackedToPlanarRowSsse3(Src, R, G, B, Dst->SizeX, Masks);
+#endif
+      for (; x < Dst->SizeX; x++)
+      {
+         B[x] = Src[3 * x];
+         G[x] = Src[3 * x + 1];
+         R[x] = Src[3 * x + 2];
+      }
+   }
+}
+
+static void PlanarToPackedRows(const PLANAR_VIEW* Src, MIL_UINT8* Packed, MIL_INT PackedPitch,
+                               MIL_INT StartY, MIL_INT EndY)
+{
+#if CPU_HAS_SSSE3_KERNEL
+   const SHUFFLE_MASKS* Masks = CpuHasSsse3() ? &ShuffleMasks() : M_NULL;
+#endif
+   for (MIL_INT y = StartY; y < EndY; y++)
+   {
+      MIL_UINT8* Dst = Packed + y * PackedPitch;
+      const MIL_UINT8* R = Src->Band[0] + y * Src->PitchByte;
+      const MIL_UINT8* G = Src->Band[1] + y * Src->PitchByte;
+      const MIL_UINT8* B = Src->Band[2] + y * Src->PitchByte;
+      MIL_INT x = 0;
+#if CPU_HAS_SSSE3_KERNEL
+      if (Masks)
+         x = PlanarToPackedRowSsse3(R, G, B, Dst, Src->SizeX, Masks);
+#endif
+      for (; x < Src->SizeX; x++)
+      {
+         Dst[3 * x]     = B[x];
+         Dst[3 * x + 1] = G[x];
+         Dst[3 * x + 2] = R[x];
+      }
+   }
+}
+
+/* Bayer(RGGB) 쌍선형 디모자이크: 가장자리는 반사(mirror) 이웃 사용 */
+static void BayerRows(const MIL_UINT8* Raw, MIL_INT RawPitch, const PLANAR_VIEW* Dst,
+                      MIL_INT StartY, MIL_INT EndY)
+{
+   MIL_INT SizeX = Dst->SizeX, SizeY = Dst->SizeY;
+   for (MIL_INT y = StartY; y < EndY; y++)
+   {
+      const MIL_UINT8* Up   = Raw + ((y > 0) ? y - 1 : y + 1) * RawPitch;
+      const MIL_UINT8* Mid  = Raw + y * RawPitch;
+      const MIL_UINT8* Down = Raw + ((y < SizeY - 1) ? y + 1 : y - 1) * RawPitch;
+      MIL_UINT8* R = Dst->Band[0] + y * Dst->PitchByte;
+      MIL_UINT8* G = Dst->Band[1] + y * Dst->PitchByte;
+      MIL_UINT8* B = Dst->Band[2] + y * Dst->PitchByte;
+      bool EvenRow = ((y & 1) == 0);
+
+      for (MIL_INT x = 0; x < SizeX; x++)
+      {
+         MIL_INT xl = (x > 0) ? x - 1 : x + 1;
+         MIL_INT xr = (x < SizeX - 1) ? x + 1 : x - 1;
+         int Cross = (Up[x] + Down[x] + Mid[xl] + Mid[xr] + 2) >> 2;
+         int Diag  = (Up[xl] + Up[xr] + Down[xl] + Down[xr] + 2) >> 2;
+         int Horz  = (Mid[xl] + Mid[xr] + 1) >> 1;
+         int Vert  = (Up[x] + Down[x] + 1) >> 1;
+         bool EvenCol = ((x & 1) == 0);
+
+         if (EvenRow && EvenCol)        { R[x] = Mid[x]; G[x] = (MIL_UINT8)Cross; B[x] = (MIL_UINT8)Diag; }
+         else if (!EvenRow && !EvenCol) { B[x] = Mid[x]; G[x] = (MIL_UINT8)Cross; R[x] = (MIL_UINT8)Diag; }
+         else if (EvenRow)              { G[x] = Mid[x]; R[x] = (MIL_UINT8)Horz;  B[x] = (MIL_UINT8)Vert; }
+         else                           { G[x] = Mid[x]; B[x] = (MIL_UINT8)Horz;  R[x] = (MIL_UINT8)Vert; }
+      }
+   }
+}
+
+/* 행 구간 분할 실행(상주 풀) */
+template <class Func>
+static void ParallelRows(MIL_INT SizeY, MIL_INT NbThreads, Func RowFunc)
+{
+   NbThreads = MosMax(MosMin(NbThreads, WorkerPoolSize(ColorPool)), (MIL_INT)1);
+   MIL_INT RowsPerThread = MosMax((SizeY + NbThreads - 1) / NbThreads, (MIL_INT)1);
+   MIL_INT NbSlices      = (SizeY + RowsPerThread - 1) / RowsPerThread;
+   WorkerPoolRun(ColorPool, NbSlices, [&](MIL_INT Slice)
+   {
+      MIL_INT StartY = Slice * RowsPerThread;
+      RowFunc(StartY, MosMin(StartY + RowsPerThread, SizeY));
+   });
+}
+
+bool ConvertLayout(MIL_ID MilSourceImage, MIL_ID MilDestImage, MIL_INT NbThreads)
+{
+   bool SourcePacked = IsPackedImage(MilSourceImage);
+   bool DestPacked   = IsPackedImage(MilDestImage);
+   MIL_ID MilPacked  = SourcePacked ? MilSourceImage : MilDestImage;
+   MIL_ID MilPlanar  = SourcePacked ? MilDestImage   : MilSourceImage;
+
+   /* 같은 레이아웃이면 일반 복사 */
+   if (SourcePacked == DestPacked)
+   {
+      MbufCopy(MilSourceImage, MilDestImage);
+      return false;
+   }
+
+   /* 8bit 호스트 버퍼, 같은 크기일 때만 셔플 커널 */
+   PLANAR_VIEW View;
+   MIL_UINT8* Packed      = (MIL_UINT8*)MbufInquire(MilPacked, M_HOST_ADDRESS, M_NULL);
+   MIL_INT    PackedPitch = MbufInquire(MilPacked, M_PITCH_BYTE, M_NULL);
+   if (!GetPlanarView(MilPlanar, View) || View.SizeBit != 8 || Packed == M_NULL ||
+       MbufInquire(MilPacked, M_SIZE_BIT, M_NULL) != 8 ||
+       MbufInquire(MilPacked, M_SIZE_X, M_NULL) != View.SizeX ||
+       MbufInquire(MilPacked, M_SIZE_Y, M_NULL) != View.SizeY)
+   {
+      MbufCopy(MilSourceImage, MilDestImage);
+      return false;
+   }
+   const PLANAR_VIEW* ViewPtr = &View;
+
+   if (SourcePacked)
+      ParallelRows(View.SizeY, NbThreads, [=](MIL_INT StartY, MIL_INT EndY)
+         { PackedToPlanarRows(Packed, PackedPitch, ViewPtr, StartY, EndY); });
+   else
+      ParallelRows(View.SizeY, NbThreads, [=](MIL_INT StartY, MIL_INT EndY)
+         { PlanarToPackedRows(ViewPtr, Packed, PackedPitch, StartY, EndY); });
+   return true;
+}
+
+bool DemosaicBayer(MIL_ID MilBayerImage, MIL_ID MilDestImage, MIL_INT NbThreads)
+{
+   /* 8bit 원본/planar 8bit 대상, 같은 크기일 때만 엔진 커널 */
+   PLANAR_VIEW View;
+   const MIL_UINT8* Raw = (const MIL_UINT8*)MbufInquire(MilBayerImage, M_HOST_ADDRESS, M_NULL);
+   MIL_INT RawPitch = MbufInquire(MilBayerImage, M_PITCH_BYTE, M_NULL);
+   if (!GetPlanarView(MilDestImage, View) || View.SizeBit != 8 || Raw == M_NULL ||
+       MbufInquire(MilBayerImage, M_SIZE_BIT, M_NULL) != 8 ||
+       MbufInquire(MilBayerImage, M_SIZE_X, M_NULL) != View.SizeX ||
+       MbufInquire(MilBayerImage, M_SIZE_Y, M_NULL) != View.SizeY)
+   {
+      MbufBayer(MilBayerImage, MilDestImage, M_DEFAULT, M_BAYER_RG);
+      return false;
+   }
+   const PLANAR_VIEW* ViewPtr = &View;
+
+   ParallelRows(View.SizeY, NbThreads, [=](MIL_INT StartY, MIL_INT EndY)
+      { BayerRows(Raw, RawPitch, ViewPtr, StartY, EndY); });
+   return true;
+}
+
+bool IsPackedImage(MIL_ID MilColorImage)
+{
+   return (MbufInquire(MilColorImage, M_SIZE_BAND, M_NULL) == 3) &&
+          ((MbufInquire(MilColorImage, M_EXTENDED_ATTRIBUTE, M_NULL) & M_PACKED) != 0);
+}
+
+/*****************************************************************************
+ * 밴드 뷰: planar면 MbufChildColor(복사 없음), packed면 단일 밴드 버퍼로 복사 후 해제 시 되쓰기
+ *****************************************************************************/
+void BandViewAlloc(MIL_ID MilColorImage, MIL_INT Band, BAND_VIEW& View)
+{
+   View.MilParent = MilColorImage;
+   View.Band      = Band;
+   View.IsCopy    = IsPackedImage(MilColorImage);
+   if (!View.IsCopy)
+   {
+      MbufChildColor(MilColorImage, Band, &View.MilBand);
+      return;
+   }
+   MbufAlloc2d(MbufInquire(MilColorImage, M_OWNER_SYSTEM, M_NULL),
+               MbufInquire(MilColorImage, M_SIZE_X, M_NULL),
+               MbufInquire(MilColorImage, M_SIZE_Y, M_NULL),
+               MbufInquire(MilColorImage, M_TYPE, M_NULL), M_IMAGE + M_PROC, &View.MilBand);
+   MbufCopyColor(MilColorImage, View.MilBand, Band);
+}
+
+void BandViewFree(BAND_VIEW& View)
+{
+   /* 단일 밴드 복사본 → 부모의 해당 밴드로 되쓰기 */
+   if (View.IsCopy)
+      MbufCopyColor(View.MilBand, View.MilParent, View.Band);
+   MbufFree(View.MilBand);
+}
+
+/*****************************************************************************
+ * 레이아웃 벤치마크(4K 8bit): 변환/디모자이크 비용과, 레이아웃별 밴드 연산 vs 융합 컬러 연산
+ *****************************************************************************/
+template <class Op>
+static MIL_DOUBLE TimeOperation(Op Operation)
+{
+   MIL_DOUBLE Time;
+   Operation();                                   /* 워밍업 */
+   MthrWait(M_DEFAULT, M_THREAD_WAIT, M_NULL);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (MIL_INT n = 0; n < LAYOUT_NB_LOOP; n++)
+      Operation();
+   MthrWait(M_DEFAULT, M_THREAD_WAIT, M_NULL);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+   return 1000.0 * Time / LAYOUT_NB_LOOP;
+}
+
+void LayoutBenchmark(MIL_ID MilSystem, MIL_ID MilSourceImage)
+{
+   MIL_INT    NbCores = MosMax((MIL_INT)std::thread::hardware_concurrency(), (MIL_INT)1);
+   MIL_ID     MilPlanar, MilPacked, MilBayer, MilColorTmp, MilImages[2];
+   MIL_DOUBLE TimeBand[2], TimeConvert[2], TimeFused[2];
+   MIL_INT    l;
+   COLOR_ADJUST Adjust = { (MIL_DOUBLE)IMAGE_LUMINANCE_OFFSET, 1.0, 0.0 };
+
+   MosPrintf(MIL_TEXT("COLOR LAYOUT BENCHMARK (%d x %d, ms/frame):\n"), LAYOUT_SIZE_X, LAYOUT_SIZE_Y);
+   MosPrintf(MIL_TEXT("-------------------------------------------\n\n"));
+
+   /* 1) 같은 내용의 planar/packed BGR 버퍼, RGGB Bayer 원시 영상 준비 */
+   MbufAllocColor(MilSystem, 3, LAYOUT_SIZE_X, LAYOUT_SIZE_Y, 8 + M_UNSIGNED, M_IMAGE + M_PROC + M_PLANAR, &MilPlanar);
+   MbufAllocColor(MilSystem, 3, LAYOUT_SIZE_X, LAYOUT_SIZE_Y, 8 + M_UNSIGNED, M_IMAGE + M_PROC + M_BGR24 + M_PACKED, &MilPacked);
+   MbufAllocColor(MilSystem, 3, LAYOUT_SIZE_X, LAYOUT_SIZE_Y, 8 + M_UNSIGNED, M_IMAGE + M_PROC + M_PLANAR, &MilColorTmp);
+   MbufAlloc2d(MilSystem, LAYOUT_SIZE_X, LAYOUT_SIZE_Y, 8 + M_UNSIGNED, M_IMAGE + M_PROC, &MilBayer);
+   MimResize(MilSourceImage, MilPlanar, M_FILL_DESTINATION, M_FILL_DESTINATION, M_BILINEAR);
+   ConvertLayout(MilPlanar, MilPacked, NbCores);
+   MbufCopyColor(MilPlanar, MilBayer, M_GREEN);   /* 시뮬 원시 영상(값 분포만 사용) */
+   MilImages[0] = MilPlanar;
+   MilImages[1] = MilPacked;
+
+   /* 2) 레이아웃 변환/디모자이크: 엔진(1스레드/전체) vs MIL(MbufCopy/MbufBayer) */
+   MosPrintf(MIL_TEXT("Shuffle kernel: %s.\n\n"),
+             CpuHasSsse3() ? MIL_TEXT("SSSE3 pshufb, 16 pixels per iteration (runtime CPUID)") : MIL_TEXT("scalar (no SSSE3 on this CPU)"));
+   MosPrintf(MIL_TEXT("Conversion            engine 1 thread   engine %2d threads   MIL\n\n"), (int)NbCores);
+   MosPrintf(MIL_TEXT("Packed BGR -> planar  %-18.2f%-20.2f%.2f (MbufCopy)\n"),
+             TimeOperation([&]() { ConvertLayout(MilPacked, MilColorTmp, 1); }),
+             TimeOperation([&]() { ConvertLayout(MilPacked, MilColorTmp, NbCores); }),
+             TimeOperation([&]() { MbufCopy(MilPacked, MilColorTmp); }));
+   MosPrintf(MIL_TEXT("Planar -> packed BGR  %-18.2f%-20.2f%.2f (MbufCopy)\n"),
+             TimeOperation([&]() { ConvertLayout(MilPlanar, MilPacked, 1); }),
+             TimeOperation([&]() { ConvertLayout(MilPlanar, MilPacked, NbCores); }),
+             TimeOperation([&]() { MbufCopy(MilPlanar, MilPacked); }));
+   MosPrintf(MIL_TEXT("Bayer RGGB demosaic   %-18.2f%-20.2f%.2f (MbufBayer)\n\n"),
+             TimeOperation([&]() { DemosaicBayer(MilBayer, MilColorTmp, 1); }),
+             TimeOperation([&]() { DemosaicBayer(MilBayer, MilColorTmp, NbCores); }),
+             TimeOperation([&]() { MbufBayer(MilBayer, MilColorTmp, M_DEFAULT, M_BAYER_RG); }));
+
+   /* 3) 레이아웃별 연산
+         - 밴드 연산: 밴드 뷰 + MgraText + MimArith(R 밴드)
+         - 컬러 연산: MimConvert, 융합 커널(packed는 planar 변환 후 적용) */
+   MgraControl(M_DEFAULT, M_COLOR, 0xFF);
+   for (l = 0; l < 2; l++)
+   {
+      MIL_ID MilImage = MilImages[l];
+      TimeBand[l] = TimeOperation([&]()
+         {
+         BAND_VIEW Red;
+         BandViewAlloc(MilImage, M_RED, Red);
+         MgraText(M_DEFAULT, Red.MilBand, LAYOUT_SIZE_X / 16, LAYOUT_SIZE_Y / 8, MIL_TEXT(" TOUCAN "));
+         MimArith(Red.MilBand, 1, Red.MilBand, M_ADD_CONST + M_SATURATION);
+         BandViewFree(Red);
+         });
+      TimeConvert[l] = TimeOperation([&]() { MimConvert(MilImage, MilColorTmp, M_RGB_TO_HSL); });
+      TimeFused[l] = TimeOperation([&]()
+         {
+         if (IsPackedImage(MilImage))
+         {
+            ConvertLayout(MilImage, MilColorTmp, NbCores);
+            FusedColorAdjust(MilColorTmp, MilColorTmp, Adjust, NbCores);
+         }
+         else
+            FusedColorAdjust(MilImage, MilColorTmp, Adjust, NbCores);
+         });
+   }
+
+   MosPrintf(MIL_TEXT("Operation by layout            planar    packed BGR\n\n"));
+   MosPrintf(MIL_TEXT("Band view + MgraText/MimArith  %-10.2f%.2f\n"), TimeBand[0], TimeBand[1]);
+   MosPrintf(MIL_TEXT("MimConvert RGB->HSL            %-10.2f%.2f\n"), TimeConvert[0], TimeConvert[1]);
+   MosPrintf(MIL_TEXT("Fused color adjust             %-10.2f%.2f\n\n"), TimeFused[0], TimeFused[1]);
+   MosPrintf(MIL_TEXT("Planar band views are zero-copy children; packed band views copy out and back.\n\n"));
+
+   MbufFree(MilBayer);
+   MbufFree(MilColorTmp);
+   MbufFree(MilPacked);
+   MbufFree(MilPlanar);
+}
+
+/*****************************************************************************
+ * 디스플레이 지원 비용
+ *  - 본문의 밝기 보정 체인(RGB→HSL, L 오프셋, HSL→RGB)을 우측 영역에 반복 적용하면서
+ *    메인 버퍼가 디스플레이에 선택된 경우와 선택 해제된 경우의 프레임당 시간을 비교
+ *  - MIL 연산은 결과 버퍼의 변경을 디스플레이에 알리므로 화면 갱신 비용이 함께 잡힘
+ *    (호스트 포인터로 직접 쓰는 융합 커널은 갱신을 유발하지 않아 비교 대상에서 제외)
+ *  - 측정하지 않는 1회로 워밍업한 뒤, 라운드마다 선택/해제 측정 순서를 번갈아 평균
+ *****************************************************************************/
+static MIL_DOUBLE TimeLuminanceChain(MIL_ID MilLeftSubImage, MIL_ID MilRightSubImage)
+{
+   MIL_ID     MilLum;
+   MIL_DOUBLE Time;
+
+   MbufChildColor(MilRightSubImage, M_LUMINANCE, &MilLum);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (MIL_INT n = 0; n < DISPLAY_COST_NB_LOOP; n++)
+   {
+      MimConvert(MilLeftSubImage, MilRightSubImage, M_RGB_TO_HSL);
+      MimArith(MilLum, IMAGE_LUMINANCE_OFFSET, MilLum, M_ADD_CONST + M_SATURATION);
+      MimConvert(MilRightSubImage, MilRightSubImage, M_HSL_TO_RGB);
+   }
+   MthrWait(M_DEFAULT, M_THREAD_WAIT, M_NULL);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+   MbufFree(MilLum);
+   return 1000.0 * Time / DISPLAY_COST_NB_LOOP;
+}
+
+void DisplayCostBenchmark(MIL_ID MilDisplay, MIL_ID MilImage, MIL_ID MilLeftSubImage, MIL_ID MilRightSubImage)
+{
+   MIL_DOUBLE TimeDisplay = 0.0, TimeHeadless = 0.0;
+
+   MosPrintf(MIL_TEXT("DISPLAY SUPPORT COST (luminance chain, ms/frame):\n"));
+   MosPrintf(MIL_TEXT("-------------------------------------------------\n\n"));
+
+   /* 워밍업(측정 제외): 첫 호출의 모듈 초기화가 먼저 측정한 쪽에 잡히지 않도록 */
+   TimeLuminanceChain(MilLeftSubImage, MilRightSubImage);
+
+#if !MIL_HEADLESS
+   /* 짝수 라운드는 선택 → 해제, 홀수 라운드는 해제 → 선택 순서로 측정 */
+   for (MIL_INT Round = 0; Round < DISPLAY_COST_NB_ROUND; Round++)
+   {
+      for (MIL_INT Pass = 0; Pass < 2; Pass++)
+      {
+         bool Selected = ((Round + Pass) % 2) == 0;
+         MdispSelect(MilDisplay, Selected ? MilImage : M_NULL);
+         if (Selected)
+            TimeDisplay += TimeLuminanceChain(MilLeftSubImage, MilRightSubImage) / DISPLAY_COST_NB_ROUND;
+         else
+            TimeHeadless += TimeLuminanceChain(MilLeftSubImage, MilRightSubImage) / DISPLAY_COST_NB_ROUND;
+      }
+   }
+   MdispSelect(MilDisplay, MilImage);
+#else
+   TimeHeadless = TimeLuminanceChain(MilLeftSubImage, MilRightSubImage);
+#endif
+   MosPrintf(MIL_TEXT("No display selected : %8.3f\n"), TimeHeadless);
+#if !MIL_HEADLESS
+   MosPrintf(MIL_TEXT("Display selected    : %8.3f\n"), TimeDisplay);
+   MosPrintf(MIL_TEXT("Display support     : %8.3f (%.1f%%)\n\n"),
+             TimeDisplay - TimeHeadless, 100.0 * (TimeDisplay - TimeHeadless) / TimeDisplay);
+#else
+   MosPrintf(MIL_TEXT("Headless build: no display to compare against.\n\n"));
+#endif
+}
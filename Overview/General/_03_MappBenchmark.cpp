@@ -30,11 +30,15 @@
 #define ESTIMATION_NB_LOOP      10   /* 반복 횟수 추정을 위한 사전 측정 횟수 */
 #define DEFAULT_NB_LOOP        100   /* 기본 반복 횟수(초기값) */
 
+/* 헤드리스 실행 모드: 1이면 디스플레이 없이 실행(MdispAlloc 없음, 키 대기 없음) */
+#include "../../Common/MilHeadless.h"
+
 /* 처리 함수 파라미터 구조체: 입력/출력 버퍼 ID */
 typedef struct 
 {
    MIL_ID MilSourceImage;        /* 입력 이미지 버퍼 ID */
    MIL_ID MilDestinationImage;   /* 출력 이미지 버퍼 ID */
+   MIL_ID MilLiveImage;          /* 매 프레임 결과를 복사할 표시 버퍼(M_NULL이면 표시 안 함) */
 } PROC_PARAM;
 
 /* 벤치마크 함수: 평균 프레임 시간(ms)과 FPS 산출 */
@@ -59,18 +63,29 @@ int MosMain(void)
    MIL_INT    NbCoresUsed, NbCoresUsedNoCS;                /* 사용 코어 수 */
    MIL_INT    NbPerformanceLevel;                          /* 성능 레벨 수(하이브리드 CPU) */
    MIL_INT    CurrentMaxPerfLevel;
+   MIL_DOUBLE TimeLive, TimeHeadless, FPSLive, FPSHeadless; /* 디스플레이 비용 비교 */
 
-   /* 1) 기본 자원 할당: 애플리케이션/시스템/디스플레이 */
+   /* 1) 기본 자원 할당: 애플리케이션/시스템/디스플레이(헤드리스면 디스플레이 없음) */
+#if MIL_HEADLESS
+   MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem,
+                                 M_NULL, M_NULL, M_NULL);
+   MilDisplay = M_NULL;
+#else
    MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem,
                                  &MilDisplay, M_NULL, M_NULL);
+#endif
 
    /* 2) MP 제어/조회에 필요한 소유 앱/스레드 정보 획득 */
    MsysInquire(MilSystem, M_OWNER_APPLICATION, &MilSystemOwnerApplication);
    MsysInquire(MilSystem, M_CURRENT_THREAD_ID, &MilSystemCurrentThreadId);
 
-   /* 3) 디스플레이용 이미지 복원 및 표시 */
+   /* 3) 디스플레이용 이미지 복원 및 표시(헤드리스면 표시 버퍼 자체가 없음) */
+#if MIL_HEADLESS
+   MilDisplayImage = M_NULL;
+#else
    MbufRestore(IMAGE_FILE, MilSystem, &MilDisplayImage);
    MdispSelect(MilDisplay, MilDisplayImage);
+#endif
 
    /* 4) 처리 버퍼 준비(입/출력 할당 및 입력 이미지 로드) */
    ProcessingInit(MilSystem, ProcessingParam);
@@ -80,7 +95,7 @@ int MosMain(void)
    MosPrintf(MIL_TEXT("---------------------------------\n\n"));
    MosPrintf(MIL_TEXT("This program times a processing function under different conditions.\n"));
    MosPrintf(MIL_TEXT("Press any key to start.\n\n"));
-   MosGetch();
+   WaitForKey(0);
    MosPrintf(MIL_TEXT("PROCESSING TIME FOR %lldx%lld:\n" ),
              (long long)MbufInquire(ProcessingParam.MilDestinationImage, M_SIZE_X, M_NULL),
              (long long)MbufInquire(ProcessingParam.MilDestinationImage, M_SIZE_Y, M_NULL));
@@ -91,7 +106,8 @@ int MosMain(void)
    Benchmark(ProcessingParam, TimeOneCore, FPSOneCore);
 
    /* 결과 반영 및 출력 */
-   MbufCopy(ProcessingParam.MilDestinationImage, MilDisplayImage);
+   if (MilDisplayImage)
+      MbufCopy(ProcessingParam.MilDestinationImage, MilDisplayImage);
    MosPrintf(MIL_TEXT("Without multi-processing (  1 CPU core ): %5.3f ms (%6.1f fps)\n\n"),
              TimeOneCore, FPSOneCore);
    MappControlMp(MilSystemOwnerApplication, M_MP_USE, M_DEFAULT, M_DEFAULT, M_NULL);
@@ -120,7 +136,8 @@ int MosMain(void)
       if (NbCoresUsed > 1)
       {
          Benchmark(ProcessingParam, TimeAllCores, FPSAllCores);
-         MbufCopy(ProcessingParam.MilDestinationImage, MilDisplayImage);
+         if (MilDisplayImage)
+            MbufCopy(ProcessingParam.MilDestinationImage, MilDisplayImage);
          MosPrintf(MIL_TEXT("Using multi-processing   (%3d CPU cores): %5.3f ms (%6.1f fps)\n"),
                    (int)NbCoresUsed, TimeAllCores, FPSAllCores);
       }
@@ -135,7 +152,8 @@ int MosMain(void)
       if (NbCoresUsedNoCS != NbCoresUsed)
       {
          Benchmark(ProcessingParam, TimeAllCoresNoCS, FPSAllCoresNoCS);
-         MbufCopy(ProcessingParam.MilDestinationImage, MilDisplayImage);
+         if (MilDisplayImage)
+            MbufCopy(ProcessingParam.MilDestinationImage, MilDisplayImage);
          MosPrintf(MIL_TEXT("Using multi-processing   (%3d CPU cores): %5.3f ms (%6.1f fps), no Hyper-Thread.\n"),
                    (int)NbCoresUsedNoCS, TimeAllCoresNoCS, FPSAllCoresNoCS);
       }
@@ -160,15 +178,41 @@ int MosMain(void)
       }
    }
 
+   /* 8) 디스플레이 지원 비용: 매 프레임 결과를 표시 버퍼로 복사하는 라이브 뷰 vs 헤드리스
+         - 성능 레벨을 모두 다시 허용한 같은 MP 조건에서 두 경우를 측정 */
+   MappControlMp(MilSystemOwnerApplication, M_MP_USE_PERFORMANCE_LEVEL, M_ALL, M_ENABLE, M_NULL);
+   MosPrintf(MIL_TEXT("DISPLAY SUPPORT COST:\n"));
+   MosPrintf(MIL_TEXT("---------------------\n\n"));
+   Benchmark(ProcessingParam, TimeHeadless, FPSHeadless);
+   MosPrintf(MIL_TEXT("Headless (no display update)   : %5.3f ms (%6.1f fps)\n"),
+             TimeHeadless, FPSHeadless);
+   if (MilDisplayImage)
+   {
+      ProcessingParam.MilLiveImage = MilDisplayImage;
+      Benchmark(ProcessingParam, TimeLive, FPSLive);
+      ProcessingParam.MilLiveImage = M_NULL;
+      MosPrintf(MIL_TEXT("Live display update each frame : %5.3f ms (%6.1f fps)\n"),
+                TimeLive, FPSLive);
+      MosPrintf(MIL_TEXT("Display support costs %5.3f ms per frame (%.1f%% of the loop).\n\n"),
+                TimeLive - TimeHeadless, 100.0 * (TimeLive - TimeHeadless) / TimeLive);
+   }
+   else
+      MosPrintf(MIL_TEXT("Headless build: no display to compare against.\n\n"));
+   MappControlMp(MilSystemOwnerApplication, M_MP_USE_PERFORMANCE_LEVEL, M_ALL, M_DEFAULT, M_NULL);
+
    /* 종료 대기 */
    MosPrintf(MIL_TEXT("Press any key to end.\n"));
-   MosGetch();
+   WaitForKey(0);
 
    /* 자원 해제 */
    ProcessingFree(ProcessingParam);
+#if MIL_HEADLESS
+   MappFreeDefault(MilApplication, MilSystem, M_NULL, M_NULL, M_NULL);
+#else
    MdispSelect(MilDisplay, M_NULL);
    MbufFree(MilDisplayImage);
    MappFreeDefault(MilApplication, MilSystem, MilDisplay, M_NULL, M_NULL);
+#endif
    return 0;
 }
 
@@ -249,6 +293,9 @@ void ProcessingInit(MIL_ID MilSystem, PROC_PARAM& ProcParamPtr)
       MbufDiskInquire(IMAGE_FILE, M_SIZE_Y,    M_NULL),
       MbufDiskInquire(IMAGE_FILE, M_SIZE_BIT,  M_NULL) + M_UNSIGNED,
       M_IMAGE + M_PROC, &ProcParamPtr.MilDestinationImage);
+
+   /* 라이브 표시는 디스플레이 비용 측정 때만 켬 */
+   ProcParamPtr.MilLiveImage = M_NULL;
 }
 
 /*****************************************************************************
@@ -261,6 +308,10 @@ void ProcessingExecute(PROC_PARAM& ProcParamPtr)
    MimRotate(ProcParamPtr.MilSourceImage, ProcParamPtr.MilDestinationImage, ROTATE_ANGLE,
              M_DEFAULT, M_DEFAULT, M_DEFAULT, M_DEFAULT,
              M_BILINEAR + M_OVERSCAN_CLEAR);
+
+   /* 라이브 뷰: 결과를 디스플레이에 선택된 버퍼로 복사(화면 갱신 유발) */
+   if (ProcParamPtr.MilLiveImage)
+      MbufCopy(ProcParamPtr.MilDestinationImage, ProcParamPtr.MilLiveImage);
 }
 
 /*****************************************************************************
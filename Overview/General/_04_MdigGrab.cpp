@@ -19,6 +19,15 @@
  */
 #include <mil.h> 
 
+/* 헤드리스 실행 모드: 1이면 디스플레이 없이 실행
+   - MdispAlloc 없음, 그랩 버퍼는 M_DISP 없이 할당
+   - 키 대기는 막지 않고, 연속 취득은 HEADLESS_GRAB_TIME초 후 자동 정지 */
+#include "../../Common/MilHeadless.h"
+#define HEADLESS_GRAB_TIME    2.0   /* 헤드리스 연속 취득 시간(초) */
+#define DISPLAY_COST_NB_GRAB  30    /* 디스플레이 비용 측정용 단발 취득 수 */
+
+void DisplayCostBenchmark(MIL_ID MilDigitizer, MIL_ID MilDisplay, MIL_ID MilImage);
+
 int MosMain(void)
 { 
    /* MIL 리소스 식별자 */
@@ -29,9 +38,22 @@ int MosMain(void)
    MIL_ID MilImage;        /* 이미지 버퍼 ID */
 
    /* 1) 기본 리소스 할당
-      - 애플리케이션, 시스템, 디스플레이, 디지타이저, 이미지 버퍼를 한 번에 준비 */
+      - 애플리케이션, 시스템, 디스플레이, 디지타이저, 이미지 버퍼를 한 번에 준비
+      - 헤드리스: 디스플레이 없이 할당하고 그랩 버퍼는 직접(M_DISP 없이) 할당 */
+#if MIL_HEADLESS
+   MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem,
+                             M_NULL, &MilDigitizer, M_NULL);
+   MbufAllocColor(MilSystem,
+                  MdigInquire(MilDigitizer, M_SIZE_BAND, M_NULL),
+                  MdigInquire(MilDigitizer, M_SIZE_X, M_NULL),
+                  MdigInquire(MilDigitizer, M_SIZE_Y, M_NULL),
+                  8 + M_UNSIGNED, M_IMAGE + M_GRAB + M_PROC, &MilImage);
+   MbufClear(MilImage, 0);
+   MilDisplay = M_NULL;
+#else
    MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem,
                              &MilDisplay, &MilDigitizer, &MilImage);
+#endif
 
    /* 2) 연속 취득 시작
       - 카메라 프레임이 MilImage로 계속 들어오며, 디스플레이에 표시됨 */
@@ -42,7 +64,7 @@ int MosMain(void)
    MosPrintf(MIL_TEXT("----------------------\n\n"));
    MosPrintf(MIL_TEXT("Continuous image grab in progress.\n"));
    MosPrintf(MIL_TEXT("Press any key to stop.\n\n"));
-   MosGetch();
+   WaitForStop(HEADLESS_GRAB_TIME);
 
    /* 4) 연속 취득 중단 */
    MdigHalt(MilDigitizer);
@@ -50,18 +72,67 @@ int MosMain(void)
    /* 5) 상태 안내 및 단발 취득 준비 */
    MosPrintf(MIL_TEXT("Continuous grab stopped.\n\n"));
    MosPrintf(MIL_TEXT("Press any key to do a single image grab.\n\n"));
-   MosGetch();
+   WaitForKey(0);
 
    /* 6) 단발 취득(한 프레임 캡처) */
    MdigGrab(MilDigitizer, MilImage);
 
    /* 7) 결과 확인 후 종료 대기 */
    MosPrintf(MIL_TEXT("Displaying the grabbed image.\n"));
+   MosPrintf(MIL_TEXT("Press any key to continue.\n\n"));
+   WaitForKey(0);
+
+   /* 8) 단발 취득 루프에서 디스플레이 갱신이 차지하는 비용 측정 */
+   DisplayCostBenchmark(MilDigitizer, MilDisplay, MilImage);
    MosPrintf(MIL_TEXT("Press any key to end.\n\n"));
-   MosGetch();
+   WaitForKey(0);
 
-   /* 8) 리소스 해제(정리) */
+   /* 9) 리소스 해제(정리) */
+#if MIL_HEADLESS
+   MbufFree(MilImage);
+   MappFreeDefault(MilApplication, MilSystem, M_NULL, MilDigitizer, M_NULL);
+#else
    MappFreeDefault(MilApplication, MilSystem, MilDisplay, MilDigitizer, MilImage);
+#endif
 
    return 0;
 }
+
+/* 디스플레이 비용 측정
+   - 같은 버퍼로 DISPLAY_COST_NB_GRAB번 단발 취득하면서
+     디스플레이에 선택된 상태와 선택 해제된 상태(헤드리스 경로)의 프레임당 시간을 비교
+   - 취득 자체는 카메라 프레임레이트에 묶이므로, 차이는 화면 갱신이 다음 취득을
+     늦춘 만큼만 나타남 */
+void DisplayCostBenchmark(MIL_ID MilDigitizer, MIL_ID MilDisplay, MIL_ID MilImage)
+{
+   MIL_DOUBLE TimeDisplay = 0.0, TimeHeadless = 0.0;
+   MIL_INT    n;
+
+   MosPrintf(MIL_TEXT("DISPLAY SUPPORT COST (%d single grabs):\n"), DISPLAY_COST_NB_GRAB);
+   MosPrintf(MIL_TEXT("--------------------------------------\n\n"));
+
+#if !MIL_HEADLESS
+   MdigGrab(MilDigitizer, MilImage);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (n = 0; n < DISPLAY_COST_NB_GRAB; n++)
+      MdigGrab(MilDigitizer, MilImage);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeDisplay);
+   MdispSelect(MilDisplay, M_NULL);
+#endif
+
+   MdigGrab(MilDigitizer, MilImage);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (n = 0; n < DISPLAY_COST_NB_GRAB; n++)
+      MdigGrab(MilDigitizer, MilImage);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeHeadless);
+
+   MosPrintf(MIL_TEXT("No display selected : %7.2f ms/frame\n"), 1000.0 * TimeHeadless / DISPLAY_COST_NB_GRAB);
+#if !MIL_HEADLESS
+   MdispSelect(MilDisplay, MilImage);
+   MosPrintf(MIL_TEXT("Display selected    : %7.2f ms/frame\n"), 1000.0 * TimeDisplay / DISPLAY_COST_NB_GRAB);
+   MosPrintf(MIL_TEXT("Display support     : %7.2f ms/frame\n\n"),
+             1000.0 * (TimeDisplay - TimeHeadless) / DISPLAY_COST_NB_GRAB);
+#else
+   MosPrintf(MIL_TEXT("Headless build: no display to compare against.\n\n"));
+#endif
+}
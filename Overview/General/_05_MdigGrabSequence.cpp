@@ -32,6 +32,12 @@
 /* 멀티버퍼 그랩 최대 이미지 수 */
 #define NB_GRAB_IMAGE_MAX 20
 
+/* 헤드리스 실행 모드: 1이면 디스플레이 없이 실행
+   - MdispAlloc 없음, 버퍼는 M_DISP 없이 할당, 프레임 번호는 그래픽 리스트에만 기록
+   - 키 대기는 막지 않음(기본 선택 사용), 파일 기록은 HEADLESS_RECORD_TIME초 후 정지 */
+#include "../../Common/MilHeadless.h"
+#define HEADLESS_RECORD_TIME 5.0
+
 /* 사용자 레코드 훅 함수 프로토타입(프레임마다 호출) */
 MIL_INT MFTYPE RecordFunction(MIL_INT HookType, MIL_ID HookId, void* HookDataPtr);
 
@@ -42,8 +48,11 @@ typedef struct
    MIL_ID  MilDisplay;
    MIL_ID  MilImageDisp;        /* 디스플레이용 이미지 */
    MIL_ID  MilCompressedImage;  /* 압축 버퍼(선택) */
+   MIL_ID  MilGraList;          /* 헤드리스 주석용 그래픽 리스트 */
    MIL_INT NbGrabbedFrames;     /* 취득된 프레임 수 */
    MIL_INT SaveSequenceToDisk;  /* 파일 기록 여부 (M_YES/M_NO) */
+   MIL_DOUBLE HookTime;         /* 훅 전체 누적 시간(초) */
+   MIL_DOUBLE DisplayTime;      /* 그 중 표시(주석+디스플레이 복사)에 쓴 시간(초) */
 } HookDataStruct;
 
 /* 메인 함수 */
@@ -62,19 +71,26 @@ int MosMain(void)
    MIL_INT  SaveSequenceToDisk = M_NO;
    HookDataStruct UserHookData;
 
-   /* 1) 기본 리소스 할당 (App/System/Display/Digitizer) */
+   /* 1) 기본 리소스 할당 (App/System/Display/Digitizer), 헤드리스면 디스플레이 제외 */
+#if MIL_HEADLESS
+   MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem, M_NULL, &MilDigitizer, M_NULL);
+   MilDisplay = M_NULL;
+#else
    MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem, &MilDisplay, &MilDigitizer, M_NULL);
+#endif
 
-   /* 2) 디스플레이용 이미지 버퍼 할당 및 선택 */
+   /* 2) 디스플레이용 이미지 버퍼 할당 및 선택(헤드리스: 미리보기/재생 버퍼로만 사용) */
    MbufAllocColor(MilSystem,
                   MdigInquire(MilDigitizer, M_SIZE_BAND, M_NULL),
                   MdigInquire(MilDigitizer, M_SIZE_X,    M_NULL),
                   MdigInquire(MilDigitizer, M_SIZE_Y,    M_NULL),
                   8L + M_UNSIGNED,
-                  M_IMAGE + M_GRAB + M_DISP,
+                  M_IMAGE + M_GRAB + DISPLAY_ATTRIBUTE,
                   &MilImageDisp);
    MbufClear(MilImageDisp, 0x0);
+#if !MIL_HEADLESS
    MdispSelect(MilDisplay, MilImageDisp);
+#endif
 
    /* (연습화면) 디스플레이에서 연속 취득 시작 */
    MdigGrabContinuous(MilDigitizer, MilImageDisp);
@@ -121,7 +137,7 @@ int MosMain(void)
    while (!ValidSelection)
    {
       /* 1) 키 입력 대기: 한 글자 입력을 즉시 읽는다(엔터 필요 없음) */
-      Selection = MosGetch();
+      Selection = WaitForKey('1');
       ValidSelection = true;  // 일단 true로 두고, default에서 잘못된 입력이면 false로 되돌린다.
 
       /* 2) 입력값 스위치 처리 */
@@ -237,6 +253,13 @@ int MosMain(void)
    UserHookData.MilCompressedImage = MilCompressedImage;
    UserHookData.SaveSequenceToDisk = SaveSequenceToDisk;
    UserHookData.NbGrabbedFrames    = 0;
+   UserHookData.HookTime           = 0.0;
+   UserHookData.DisplayTime        = 0.0;
+#if MIL_HEADLESS
+   MgraAllocList(MilSystem, M_DEFAULT, &UserHookData.MilGraList);
+#else
+   UserHookData.MilGraList         = M_NULL;
+#endif
 
    /* 9) 시퀀스 취득 시작
          - 파일 기록: M_START(키로 정지)
@@ -249,7 +272,7 @@ int MosMain(void)
    if (SaveSequenceToDisk)
    {
       MosPrintf(MIL_TEXT("\nPress any key to stop recording.\n\n"));
-      MosGetch();
+      WaitForStop(HEADLESS_RECORD_TIME);
    }
 
    /* 프레임레이트 유효값 확보를 위해 최소 2프레임까지 기다림 */
@@ -271,13 +294,23 @@ int MosMain(void)
              MIL_TEXT("(%.1f ms/frame).\n\n"),
              (int)UserHookData.NbGrabbedFrames, (int)FrameMissed, FrameRate, 1000.0/FrameRate);
 
+   /* 디스플레이 지원 비용: 훅 안에서 주석/디스플레이 복사에 쓴 시간 */
+   if (UserHookData.NbGrabbedFrames > 0)
+   {
+      MosPrintf(MIL_TEXT("Record hook: %.3f ms/frame, of which display support %.3f ms (%.1f%%)%s.\n\n"),
+                1000.0 * UserHookData.HookTime / UserHookData.NbGrabbedFrames,
+                1000.0 * UserHookData.DisplayTime / UserHookData.NbGrabbedFrames,
+                UserHookData.HookTime > 0.0 ? 100.0 * UserHookData.DisplayTime / UserHookData.HookTime : 0.0,
+                MIL_HEADLESS ? MIL_TEXT(" [headless: annotation to graphic list only]") : MIL_TEXT(""));
+   }
+
    /* 파일 기록 시: AVI 클로즈(프레임레이트 기입) */
    if (SaveSequenceToDisk)
       MbufExportSequence(SEQUENCE_FILE, M_DEFAULT, M_NULL, M_NULL, FrameRate, M_CLOSE);
 
    /* 12) 재생 준비 */
    MosPrintf(MIL_TEXT("Press any key to start the sequence playback.\n"));
-   MosGetch();
+   WaitForKey(0);
 
    /* 13) 재생 루프 (Enter로 종료, 다른 키면 재생 반복) */
    if (UserHookData.NbGrabbedFrames > 0)
@@ -352,7 +385,7 @@ int MosMain(void)
                    MIL_TEXT("(%.1f ms/frame).\n\n"),
                    (int)NbFramesReplayed, n / TotalReplay, 1000.0 * TotalReplay / n);
          MosPrintf(MIL_TEXT("Press <Enter> to end (or any other key to playback again).\n"));
-         KeyPressed = MosGetch();
+         KeyPressed = WaitForKey('\r');
       }
       while ((KeyPressed != '\r') && (KeyPressed != '\n'));
    }
@@ -363,6 +396,8 @@ int MosMain(void)
       MbufFree(MilGrabImages[n]);
    if (MilCompressedImage)
       MbufFree(MilCompressedImage);
+   if (UserHookData.MilGraList)
+      MgraFree(UserHookData.MilGraList);
 
    /* 15) 기본 리소스 해제 */
    MappFreeDefault(MilApplication, MilSystem, MilDisplay, MilDigitizer, M_NULL);
@@ -384,6 +419,9 @@ MIL_INT MFTYPE RecordFunction(MIL_INT HookType, MIL_ID HookId, void* HookDataPtr
    HookDataStruct* UserHookDataPtr = (HookDataStruct*)HookDataPtr;
    MIL_ID ModifiedImage = 0;
    MIL_TEXT_CHAR Text[STRING_LENGTH_MAX] = { MIL_TEXT('\0'), };
+   MIL_DOUBLE StartTime, DisplayStartTime, EndTime;
+
+   MappTimer(M_DEFAULT, M_TIMER_READ, &StartTime);
 
    /* 1) 방금 취득된 버퍼 ID 얻기 */
    MdigGetHookInfo(HookId, M_MODIFIED_BUFFER + M_BUFFER_ID, &ModifiedImage);
@@ -392,16 +430,27 @@ MIL_INT MFTYPE RecordFunction(MIL_INT HookType, MIL_ID HookId, void* HookDataPtr
    UserHookDataPtr->NbGrabbedFrames++;
    MosPrintf(MIL_TEXT("Frame #%d               \r"), (int)UserHookDataPtr->NbGrabbedFrames);
 
-   /* 3) 옵션: 영상에 프레임 번호 텍스트로 주석 */
+   /* 3) 옵션: 영상에 프레임 번호 텍스트로 주석
+         - 헤드리스: 영상은 건드리지 않고 그래픽 리스트에만 기록(프레임마다 비움) */
+   MappTimer(M_DEFAULT, M_TIMER_READ, &DisplayStartTime);
    if (FRAME_NUMBER_ANNOTATION == M_YES)
    {
       MosSprintf(Text, STRING_LENGTH_MAX, MIL_TEXT(" %d "),
                  (int)UserHookDataPtr->NbGrabbedFrames);
+#if MIL_HEADLESS
+      MgraClear(M_DEFAULT, UserHookDataPtr->MilGraList);
+      MgraText(M_DEFAULT, UserHookDataPtr->MilGraList, STRING_POS_X, STRING_POS_Y, Text);
+#else
       MgraText(M_DEFAULT, ModifiedImage, STRING_POS_X, STRING_POS_Y, Text);
+#endif
    }
 
-   /* 4) 새 프레임을 디스플레이 버퍼로 복사 */
+   /* 4) 새 프레임을 디스플레이 버퍼로 복사(헤드리스에서는 생략) */
+#if !MIL_HEADLESS
    MbufCopy(ModifiedImage, UserHookDataPtr->MilImageDisp);
+#endif
+   MappTimer(M_DEFAULT, M_TIMER_READ, &EndTime);
+   UserHookDataPtr->DisplayTime += EndTime - DisplayStartTime;
 
    /* 5) 필요 시 압축 버퍼로 복사(파일 기록 시 압축 프레임 사용) */
    if (UserHookDataPtr->MilCompressedImage)
@@ -417,5 +466,8 @@ MIL_INT MFTYPE RecordFunction(MIL_INT HookType, MIL_ID HookId, void* HookDataPtr
                          1, M_DEFAULT, M_WRITE);
    }
 
+   MappTimer(M_DEFAULT, M_TIMER_READ, &EndTime);
+   UserHookDataPtr->HookTime += EndTime - StartTime;
+
    return 0;
 }
@@ -21,6 +21,13 @@
 /* 멀티버퍼 큐 크기(클수록 실시간성 ↑, 메모리 사용 ↑) */
 #define BUFFERING_SIZE_MAX 20
 
+/* 헤드리스 실행 모드: 1이면 디스플레이 없이 실행
+   - MdispAlloc 없음, 결과 버퍼는 M_DISP 없이 할당, 프레임 번호는 그래픽 리스트에만 기록
+   - 키 대기는 막지 않고, 처리 구간은 HEADLESS_PROCESS_TIME초 후 자동 정지 */
+#include "../../Common/MilHeadless.h"
+#define HEADLESS_PROCESS_TIME 5.0
+#define DISPLAY_COST_TIME     2.0   /* 디스플레이 해제 상태 처리 측정 시간(초) */
+
 /* 사용자 처리 콜백 프로토타입 */
 MIL_INT MFTYPE ProcessingFunction(MIL_INT HookType, MIL_ID HookId, void* HookDataPtr);
 
@@ -28,9 +35,15 @@ MIL_INT MFTYPE ProcessingFunction(MIL_INT HookType, MIL_ID HookId, void* HookDat
 typedef struct
 {
    MIL_ID  MilImageDisp;          /* 디스플레이용 이미지 버퍼 */
+   MIL_ID  MilGraList;            /* 헤드리스 주석용 그래픽 리스트 */
    MIL_INT ProcessedImageCount;   /* 처리된 프레임 수 */
+   MIL_DOUBLE HookTime;           /* 콜백 전체 누적 시간(초) */
 } HookDataStruct;
 
+/* 디스플레이 선택/해제 상태의 콜백 시간 비교 */
+void DisplayCostBenchmark(MIL_ID MilDigitizer, MIL_ID MilDisplay, MIL_ID* MilGrabBufferList,
+                          MIL_INT MilGrabBufferListSize, HookDataStruct* UserHookDataPtr);
+
 /* 메인 함수 */
 int MosMain(void)
 {
@@ -52,21 +65,29 @@ int MosMain(void)
    /* 콜백 데이터 */
    HookDataStruct UserHookData;
 
-   /* 1) 기본 리소스 할당 (App/System/Display/Digitizer) */
+   /* 1) 기본 리소스 할당 (App/System/Display/Digitizer), 헤드리스면 디스플레이 제외 */
+#if MIL_HEADLESS
+   MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem, M_NULL,
+                                        &MilDigitizer, M_NULL);
+   MilDisplay = M_NULL;
+#else
    MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem, &MilDisplay,
                                         &MilDigitizer, M_NULL);
+#endif
 
    /* 2) 단일 채널(8bit) 디스플레이 버퍼 할당 및 초기화 */
    MbufAlloc2d(MilSystem,
                MdigInquire(MilDigitizer, M_SIZE_X, M_NULL),
                MdigInquire(MilDigitizer, M_SIZE_Y, M_NULL),
                8 + M_UNSIGNED,
-               M_IMAGE + M_GRAB + M_PROC + M_DISP,
+               M_IMAGE + M_GRAB + M_PROC + DISPLAY_ATTRIBUTE,
                &MilImageDisp);
    MbufClear(MilImageDisp, M_COLOR_BLACK);
 
    /* 디스플레이 선택 */
+#if !MIL_HEADLESS
    MdispSelect(MilDisplay, MilImageDisp);
+#endif
 
    /* 안내 메시지 */
    MosPrintf(MIL_TEXT("\nMULTIPLE BUFFERED PROCESSING.\n"));
@@ -75,7 +96,7 @@ int MosMain(void)
 
    /* 3) 프리뷰: 디스플레이 버퍼로 연속 취득 후 키 입력 대기 */
    MdigGrabContinuous(MilDigitizer, MilImageDisp);
-   MosGetch();
+   WaitForKey(0);
 
    /* 프리뷰 정지 */
    MdigHalt(MilDigitizer);
@@ -106,6 +127,12 @@ int MosMain(void)
    /* 5) 콜백에 전달할 데이터 초기화 */
    UserHookData.MilImageDisp        = MilImageDisp;
    UserHookData.ProcessedImageCount = 0;
+   UserHookData.HookTime            = 0.0;
+#if MIL_HEADLESS
+   MgraAllocList(MilSystem, M_DEFAULT, &UserHookData.MilGraList);
+#else
+   UserHookData.MilGraList          = M_NULL;
+#endif
 
    /* 6) 실시간 처리 시작
          - 각 프레임이 도착할 때마다 ProcessingFunction 콜백 호출 */
@@ -116,7 +143,7 @@ int MosMain(void)
 
    /* 7) 키 입력으로 정지 */
    MosPrintf(MIL_TEXT("Press any key to stop.                    \n\n"));
-   MosGetch();
+   WaitForStop(HEADLESS_PROCESS_TIME);
 
    /* 실시간 처리 정지 */
    MdigProcess(MilDigitizer, MilGrabBufferList, MilGrabBufferListSize,
@@ -127,13 +154,19 @@ int MosMain(void)
    MdigInquire(MilDigitizer, M_PROCESS_FRAME_RATE,   &ProcessFrameRate);
    MosPrintf(MIL_TEXT("\n\n%d frames grabbed at %.1f frames/sec (%.1f ms/frame).\n"),
              (int)ProcessFrameCount, ProcessFrameRate, 1000.0/ProcessFrameRate);
+
+   /* 디스플레이 지원 비용: 같은 콜백을 디스플레이 버퍼 선택/해제 상태로 비교 */
+   DisplayCostBenchmark(MilDigitizer, MilDisplay, MilGrabBufferList, MilGrabBufferListSize, &UserHookData);
+
    MosPrintf(MIL_TEXT("Press any key to end.\n\n"));
-   MosGetch();
+   WaitForKey(0);
 
    /* 9) 자원 해제: 그랩 버퍼들 → 디스플레이 버퍼 → 기본 리소스 */
    while (MilGrabBufferListSize > 0)
       MbufFree(MilGrabBufferList[--MilGrabBufferListSize]);
 
+   if (UserHookData.MilGraList)
+      MgraFree(UserHookData.MilGraList);
    MbufFree(MilImageDisp);
    MappFreeDefault(MilApplication, MilSystem, MilDisplay, MilDigitizer, M_NULL);
 
@@ -154,6 +187,9 @@ MIL_INT MFTYPE ProcessingFunction(MIL_INT HookType, MIL_ID HookId, void* HookDat
    HookDataStruct* UserHookDataPtr = (HookDataStruct*)HookDataPtr;
    MIL_ID ModifiedBufferId;
    MIL_TEXT_CHAR Text[STRING_LENGTH_MAX] = { MIL_TEXT('\0'), };
+   MIL_DOUBLE StartTime, EndTime;
+
+   MappTimer(M_DEFAULT, M_TIMER_READ, &StartTime);
 
    /* 1) 방금 완료된 그랩 버퍼 ID 조회 */
    MdigGetHookInfo(HookId, M_MODIFIED_BUFFER + M_BUFFER_ID, &ModifiedBufferId);
@@ -161,16 +197,71 @@ MIL_INT MFTYPE ProcessingFunction(MIL_INT HookType, MIL_ID HookId, void* HookDat
    /* 2) 프레임 카운트 증가 */
    UserHookDataPtr->ProcessedImageCount++;
 
-   /* 3) (옵션) 콘솔/오버레이 표시 — 성능 최적화 필요 시 제거 권장 */
-   MosPrintf(MIL_TEXT("Processing frame #%d.\r"),
-             (int)UserHookDataPtr->ProcessedImageCount);
+   /* 3) (옵션) 콘솔/오버레이 표시 — 성능 최적화 필요 시 제거 권장
+         - 헤드리스: 콘솔 진행 표시 없이 그래픽 리스트에만 기록(프레임마다 비움) */
    MosSprintf(Text, STRING_LENGTH_MAX, MIL_TEXT("%d"),
               (int)UserHookDataPtr->ProcessedImageCount);
+#if MIL_HEADLESS
+   MgraClear(M_DEFAULT, UserHookDataPtr->MilGraList);
+   MgraText(M_DEFAULT, UserHookDataPtr->MilGraList, STRING_POS_X, STRING_POS_Y, Text);
+#else
+   MosPrintf(MIL_TEXT("Processing frame #%d.\r"),
+             (int)UserHookDataPtr->ProcessedImageCount);
    MgraText(M_DEFAULT, ModifiedBufferId, STRING_POS_X, STRING_POS_Y, Text);
+#endif
 
    /* 4) 사용자 처리 예시: NOT 연산 후 디스플레이 업데이트
          - 실제 프로젝트에서는 원하는 처리(MimFilter/Blob 등)로 교체 */
    MimArith(ModifiedBufferId, M_NULL, UserHookDataPtr->MilImageDisp, M_NOT);
 
+   MappTimer(M_DEFAULT, M_TIMER_READ, &EndTime);
+   UserHookDataPtr->HookTime += EndTime - StartTime;
+
    return 0;
 }
+
+/* 디스플레이 비용 측정
+   - 방금 끝난 처리 구간(디스플레이 버퍼가 선택된 상태)의 프레임당 콜백 시간과
+     디스플레이 버퍼를 선택 해제하고 DISPLAY_COST_TIME초 동안 다시 처리한 콜백 시간을 비교
+   - 두 구간 모두 같은 ProcessingFunction을 실행하므로, 차이는 화면 갱신 비용 */
+void DisplayCostBenchmark(MIL_ID MilDigitizer, MIL_ID MilDisplay, MIL_ID* MilGrabBufferList,
+                          MIL_INT MilGrabBufferListSize, HookDataStruct* UserHookDataPtr)
+{
+   MIL_DOUBLE TimeDisplay = 0.0, TimeHeadless = 0.0;
+
+   if (UserHookDataPtr->ProcessedImageCount == 0)
+      return;
+
+   MosPrintf(MIL_TEXT("DISPLAY SUPPORT COST (processing hook):\n"));
+   MosPrintf(MIL_TEXT("---------------------------------------\n\n"));
+
+#if MIL_HEADLESS
+   TimeHeadless = UserHookDataPtr->HookTime / UserHookDataPtr->ProcessedImageCount;
+#else
+   MIL_DOUBLE RunTime = DISPLAY_COST_TIME;
+   TimeDisplay = UserHookDataPtr->HookTime / UserHookDataPtr->ProcessedImageCount;
+
+   /* 디스플레이 버퍼를 선택 해제한 상태로 같은 콜백을 다시 실행 */
+   MdispSelect(MilDisplay, M_NULL);
+   UserHookDataPtr->ProcessedImageCount = 0;
+   UserHookDataPtr->HookTime            = 0.0;
+   MdigProcess(MilDigitizer, MilGrabBufferList, MilGrabBufferListSize,
+               M_START, M_DEFAULT, ProcessingFunction, UserHookDataPtr);
+   MappTimer(M_DEFAULT, M_TIMER_WAIT, &RunTime);
+   MdigProcess(MilDigitizer, MilGrabBufferList, MilGrabBufferListSize,
+               M_STOP, M_DEFAULT, ProcessingFunction, UserHookDataPtr);
+   MdispSelect(MilDisplay, UserHookDataPtr->MilImageDisp);
+
+   if (UserHookDataPtr->ProcessedImageCount > 0)
+      TimeHeadless = UserHookDataPtr->HookTime / UserHookDataPtr->ProcessedImageCount;
+   MosPrintf(MIL_TEXT("\n"));
+#endif
+
+   MosPrintf(MIL_TEXT("No display selected : %7.3f ms/frame\n"), 1000.0 * TimeHeadless);
+#if !MIL_HEADLESS
+   MosPrintf(MIL_TEXT("Display selected    : %7.3f ms/frame\n"), 1000.0 * TimeDisplay);
+   MosPrintf(MIL_TEXT("Display support     : %7.3f ms/frame\n\n"), 1000.0 * (TimeDisplay - TimeHeadless));
+#else
+   MosPrintf(MIL_TEXT("Headless build: no display to compare against.\n\n"));
+#endif
+}
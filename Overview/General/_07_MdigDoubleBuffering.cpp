@@ -28,6 +28,14 @@ typedef struct
 
 #define STRING_LENGTH_MAX  20
 
+/* 헤드리스 실행 모드: 1이면 디스플레이 없이 실행
+   - MdispAlloc 없음, 결과 버퍼는 M_DISP 없이 할당, 프레임 번호는 그래픽 리스트에만 기록
+   - 키 대기는 막지 않고, 루프는 HEADLESS_NB_FRAMES 프레임 후 자동 종료 */
+#include "../../Common/MilHeadless.h"
+#define HEADLESS_NB_FRAMES 300
+
+bool StopRequested(long NbProc);
+
 /* 메인 함수 */
 int MosMain(void)
 {
@@ -38,6 +46,7 @@ int MosMain(void)
    MIL_ID MilDisplay;
    MIL_ID MilImage[2];   /* 더블 버퍼링용 그랩/처리 버퍼 2개 */
    MIL_ID MilImageDisp;  /* 디스플레이 버퍼 */
+   MIL_ID MilGraList;    /* 헤드리스 주석용 그래픽 리스트 */
 
    /* 루프/통계 */
    long        NbProc = 0;  /* 처리한 프레임 수 */
@@ -45,22 +54,34 @@ int MosMain(void)
    MIL_DOUBLE  Time = 0.0;  /* 총 경과 시간(초) */
    MIL_TEXT_CHAR Text[STRING_LENGTH_MAX] = MIL_TEXT("0");
    UserDataStruct UserStruct;
+   MIL_DOUBLE  DisplayTime = 0.0;      /* 루프 중 표시(오버레이)에 쓴 누적 시간(초) */
+   MIL_DOUBLE  DisplayStart, DisplayEnd;
 
-   /* 1) 기본 리소스 할당 (App/System/Display/Digitizer) */
+   /* 1) 기본 리소스 할당 (App/System/Display/Digitizer), 헤드리스면 디스플레이 제외 */
+#if MIL_HEADLESS
+   MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem, M_NULL,
+                                      &MilDigitizer, M_NULL);
+   MgraAllocList(MilSystem, M_DEFAULT, &MilGraList);
+   MilDisplay = M_NULL;
+#else
    MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem, &MilDisplay,
                                       &MilDigitizer, M_NULL);
+   MilGraList = M_NULL;
+#endif
 
    /* 2) 단일 채널(8bit) 디스플레이 버퍼 할당 및 초기화 */
    MbufAlloc2d(MilSystem,
                MdigInquire(MilDigitizer, M_SIZE_X, M_NULL),
                MdigInquire(MilDigitizer, M_SIZE_Y, M_NULL),
                8 + M_UNSIGNED,
-               M_IMAGE + M_PROC + M_DISP,
+               M_IMAGE + M_PROC + DISPLAY_ATTRIBUTE,
                &MilImageDisp);
    MbufClear(MilImageDisp, M_COLOR_BLACK);
 
    /* 디스플레이 선택 */
+#if !MIL_HEADLESS
    MdispSelect(MilDisplay, MilImageDisp);
+#endif
 
    /* 3) 더블 버퍼링용 그랩 버퍼 2개 할당 (GRAB+PROC) */
    for (n = 0; n < 2; n++)
@@ -99,9 +120,18 @@ int MosMain(void)
       if (NbProc == 0)
          MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
 
-      /* (C) (옵션) 프레임 번호 오버레이 – 성능이 중요하면 제거 권장 */
+      /* (C) (옵션) 프레임 번호 오버레이 – 성능이 중요하면 제거 권장
+            - 헤드리스: 영상 대신 그래픽 리스트에만 기록(프레임마다 비움) */
+      MappTimer(M_DEFAULT, M_TIMER_READ, &DisplayStart);
       MosSprintf(Text, STRING_LENGTH_MAX, MIL_TEXT("%ld"), NbProc + 1);
+#if MIL_HEADLESS
+      MgraClear(M_DEFAULT, MilGraList);
+      MgraText(M_DEFAULT, MilGraList, 32, 32, Text);
+#else
       MgraText(M_DEFAULT, MilImage[n], 32, 32, Text);
+#endif
+      MappTimer(M_DEFAULT, M_TIMER_READ, &DisplayEnd);
+      DisplayTime += DisplayEnd - DisplayStart;
 
       /* (D) 사용자 처리 예시: 반전(NOT) → 디스플레이로 전송
             - 실제 프로젝트에서는 원하는 처리(필터/측정/검사 등)로 교체 */
@@ -111,19 +141,22 @@ int MosMain(void)
       NbProc++;
       n = 1 - n;
    }
-   while (!MosKbhit());  /* 키 입력 시 종료 */
+   while (!StopRequested(NbProc));  /* 키 입력(헤드리스: 프레임 수) 시 종료 */
 
    /* 8) 마지막 그랩 완료 대기 및 동기 타이머 읽기 */
    MdigGrabWait(MilDigitizer, M_GRAB_END);
    MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
-   MosGetch();
+   WaitForKey(0);
 
    /* 9) 통계 출력: 총 프레임, FPS, 프레임당 ms */
    MosPrintf(MIL_TEXT("%ld frames processed, at a frame rate of %.2f frames/sec ")
              MIL_TEXT("(%.2f ms/frame).\n"),
              NbProc, NbProc / Time, 1000.0 * Time / NbProc);
+   MosPrintf(MIL_TEXT("Display support (frame number overlay): %.3f ms/frame (%.1f%% of the loop)%s.\n"),
+             1000.0 * DisplayTime / NbProc, 100.0 * DisplayTime / Time,
+             MIL_HEADLESS ? MIL_TEXT(" [headless: graphic list only]") : MIL_TEXT(""));
    MosPrintf(MIL_TEXT("Press any key to end.\n\n"));
-   MosGetch();
+   WaitForKey(0);
 
    /* 10) 프레임 시작 훅 해제 */
    MdigHookFunction(MilDigitizer, M_GRAB_START + M_UNHOOK, GrabStart, (void*)(&UserStruct));
@@ -132,6 +165,8 @@ int MosMain(void)
    for (n = 0; n < 2; n++)
        MbufFree(MilImage[n]);
    MbufFree(MilImageDisp);
+   if (MilGraList)
+      MgraFree(MilGraList);
    MappFreeDefault(MilApplication, MilSystem, MilDisplay, MilDigitizer, M_NULL);
 
    return 0;
@@ -151,3 +186,13 @@ MIL_INT MFTYPE GrabStart(MIL_INT HookType, MIL_ID EventId, void* UserStructPtr)
 
    return 0;
 }
+
+/* 처리 루프 종료 조건: 키 입력, 헤드리스 모드에서는 HEADLESS_NB_FRAMES 처리 후에도 종료 */
+bool StopRequested(long NbProc)
+{
+#if MIL_HEADLESS
+   if (NbProc >= HEADLESS_NB_FRAMES)
+      return true;
+#endif
+   return MosKbhit() != 0;
+}
@@ -15,6 +15,21 @@
  *   - 탐색 파라미터: 시작/최소/최대 위치, 변동 허용치, 모드/민감도를 조절해
  *     속도와 안정성을 균형 있게 설정(M_SMART_SCAN + 1).
  *   - 시각화: DrawCursor()가 오버레이로 현재 포커스 위치를 표시.
+ *   - 피라미드 탐색: 축소 레벨(1/PYRAMID_FACTOR)에서 코스 스캔(M_EVALUATE) → 피크 주변만
+ *     전체 해상도 MdigFocus로 정밀 탐색. 스무딩용 임시 버퍼는 레벨별로 미리 할당해 재사용.
+ *   - 20MP 벤치마크: 전체 범위 전체 해상도 탐색 vs 피라미드 탐색 시간/스텝 수 비교.
+ *   - 포커스 측정 라이브러리: Tenengrad/Laplacian 분산/Brenner/정규화 분산을 임의 ROI에서
+ *     AVX2(실행 시점 CPUID 선택) + 상주 작업자 풀로 계산(FocusMetric). 8bit 모노 호스트 버퍼만 직접 읽고
+ *     호스트 주소가 없으면 ROI를 MbufGet2d로 복사. 작은 피두셜 ROI만 보는 자체 스마트 스캔(RoiSmartScan).
+ *   - 디포커스 스택: 위치별 흐림 단계를 세로로 긴 버퍼에 한 번만(필요할 때) 누적 계산하고,
+ *     그랩은 자식 버퍼 이동(MbufChildMove)으로 대체 → 탐색 전략을 초당 수천 스텝으로 비교.
+ *   - 전략 하네스: 녹화된 포커스 스택(위치별 프레임 디렉터리)을 재생하며 모드/민감도/최대 변동
+ *     조합마다 스텝 수, 실행 시간, 모터 이동 시간(모델), 정답 대비 오차를 표로 출력.
+ *   - 연속 초점: MdigProcess 처리 훅이 프레임 ROI를 별도 스레드에 넘겨 비동기로 측정하고, 점수가
+ *     떨어지면 같은 측정(Tenengrad, 같은 ROI)으로 직전 위치 + 운동 모델 예측의 좁은 창만
+ *     재탐색(경계에 걸리면 창을 넓힘). 재탐색은 훅 안에서 돌지 않고 프레임마다 한 단계씩 진행하는
+ *     상태 기계(렌즈 이동 콜백 → 다음 프레임 점수 → 다음 위치). 데모는 훅을 시뮬 MdigProcess 루프와
+ *     디포커스 스택으로 구동하고, 디지타이저가 있으면 렌즈 콜백이 실제 모터를 구동.
  *   - 결과: FocusPos(최적 위치), UserData.Iteration(탐색 스텝 수) 출력.
  *
  * 참고:
@@ -24,6 +39,14 @@
  *   © Matrox Electronic Systems Ltd., 1992-2025. All Rights Reserved
  */
 #include <mil.h>
+#include <stdio.h>
+#include <math.h>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <vector>
+#include "../../Common/CpuFeatures.h"
+#include "../../Common/WorkerPool.h"
 
 /* 소스 이미지 파일 */
 #define IMAGE_FILE                     M_IMAGE_PATH MIL_TEXT("BaboonMono.mim")
@@ -39,28 +62,245 @@
 #define FOCUS_MODE                     M_SMART_SCAN
 #define FOCUS_SENSITIVITY              1
 
+/* 피라미드 탐색 파라미터
+   - 3x3 스무딩 n회의 분산은 n에 비례 → 1/f 축소 레벨에선 n/f^2회가 같은 흐림
+   - 코스 레벨에서 f^2/2 이내 거리는 흐림 0회가 되므로 정밀 탐색 창을 코스 간격으로 잡음 */
+#define PYRAMID_FACTOR                 4
+#define COARSE_STEP                    ((PYRAMID_FACTOR * PYRAMID_FACTOR) / 2)
+#define FINE_HALF_WINDOW               COARSE_STEP
+
+/* 시뮬레이션의 중앙(베스트) 포커스 위치 */
+#define FOCUS_BEST_POSITION            (FOCUS_MAX_NB_POSITIONS/2)
+
+/* 20MP 센서 벤치마크 크기 */
+#define BENCH_SIZE_X                   5472
+#define BENCH_SIZE_Y                   3648
+
+/* 헤드리스 실행 모드: 1이면 디스플레이 없이 실행
+   - MdispAlloc 없음, 포커스 버퍼는 M_DISP 없이 할당
+   - 포커스 커서는 오버레이 대신 그래픽 리스트에만 기록, 키 대기는 막지 않음 */
+#include "../../Common/MilHeadless.h"
+#define DISPLAY_COST_NB_LOOP           10
+
+#define MosMin(a, b) (((a) < (b)) ? (a) : (b))
+#define MosMax(a, b) (((a) > (b)) ? (a) : (b))
+
+/* 포커스 측정 종류 */
+enum
+{
+   FOCUS_METRIC_TENENGRAD,
+   FOCUS_METRIC_LAPLACIAN_VAR,
+   FOCUS_METRIC_BRENNER,
+   FOCUS_METRIC_NORMALIZED_VAR,
+   FOCUS_NB_METRICS
+};
+
+/* 측정 영역(사각 ROI) */
+typedef struct
+{
+   MIL_INT OffsetX, OffsetY;
+   MIL_INT SizeX, SizeY;
+} FOCUS_ROI;
+
+/* 측정 파라미터: 멀티스레드 최소 ROI 크기, 피두셜 ROI 크기, ROI 스캔 초기 보폭, 반복 수 */
+#define FOCUS_MT_MIN_PIXELS            (256 * 256)
+#define FIDUCIAL_SIZE                  64
+#define ROI_SCAN_INITIAL_STEP          16
+#define METRIC_NB_LOOP_FRAME           50
+#define METRIC_NB_LOOP_ROI             2000
+
+/* 한 해상도 레벨의 시뮬 취득 자원(선명 원본 + 재사용 임시 버퍼) */
+typedef struct
+{
+   MIL_ID  Source;          /* 이 레벨의 선명 원본 */
+   MIL_ID  Temp[2];         /* 스무딩 핑퐁 버퍼(한 번 할당 후 재사용) */
+   MIL_INT SmoothDivider;   /* 거리 → 스무딩 횟수 환산(축소 배율^2) */
+} FOCUS_LEVEL;
+
 /* 훅에 전달할 사용자 데이터 */
 typedef struct
 {
-   MIL_ID  SourceImage;   /* 원본(선명) 이미지 */
+   FOCUS_LEVEL* Level;    /* 시뮬 취득 레벨(원본/임시 버퍼) */
    MIL_ID  FocusImage;    /* 현재 포커스 상태(디스플레이 대상) */
    MIL_ID  Display;       /* 디스플레이 ID(오버레이 표시에 사용) */
    long    Iteration;     /* 포커스 탐색 스텝 수(훅 호출 시 증가) */
 } DigHookUserData;
 
+/* 디포커스 스택(흐림 단계를 슬롯으로 쌓은 버퍼 + 현재 그랩을 가리키는 자식) */
+typedef struct
+{
+   MIL_ID              Buffer;    /* SizeX x (SizeY * NbSlots) */
+   MIL_ID              View;      /* 현재 "그랩" 슬롯(MbufChildMove로 이동) */
+   std::vector<MIL_ID> Slots;     /* 슬롯별 자식 버퍼(흐림 계산용) */
+   MIL_INT             NbSlots;
+   MIL_INT             NbReady;   /* 계산 완료된 슬롯 수(앞에서부터) */
+   MIL_INT             SizeY;
+   bool                Recorded;      /* 녹화 스택: 슬롯 = 렌즈 위치 */
+   MIL_INT             NbPositions;   /* 렌즈 위치 수 */
+   MIL_INT             TruePosition;  /* 정답 포커스 위치 */
+} DEFOCUS_STACK;
+
+/* 스택용 훅 사용자 데이터(모터 이동 거리/횟수도 누적) */
+typedef struct
+{
+   DEFOCUS_STACK* Stack;
+   long           Iteration;
+   MIL_INT        LastPosition;
+   MIL_INT        Travel;
+   long           Moves;
+} StackHookUserData;
+
+/* 스택 벤치마크: 시작 위치 간격 */
+#define STACK_START_STEP               3
+
+/* 전략 하네스: 녹화 스택 위치(FOCUS_STACK_ROOT/StackNN/PosNNN.mim), 모터 모델, 허용 오차 */
+#define FOCUS_STACK_ROOT               MIL_TEXT("FocusStacks")
+#define RECORDED_STACK_MAX             100
+#define FILE_NAME_LENGTH_MAX           512
+#define MOTOR_MS_PER_STEP              2.0
+#define MOTOR_SETTLE_MS                5.0
+#define FOCUS_ERROR_TOLERANCE          1.0
+
+/* 비동기 측정 워커 상태(프레임 훅 → 워커, 최신 점수 게시) */
+typedef struct
+{
+   std::mutex              Lock;
+   std::condition_variable Wake;
+   std::thread             Worker;
+   FOCUS_ROI               Roi;
+   std::vector<MIL_UINT8>  Staging;       /* 훅 전용: ROI 복사 */
+   std::vector<MIL_UINT8>  Pending;       /* 공유: 측정 대기 ROI */
+   std::vector<MIL_UINT8>  Working;       /* 워커 전용: 측정 중 ROI */
+   bool                    HasPending;
+   bool                    Stop;
+   MIL_INT                 PendingFrame;
+   MIL_DOUBLE              Score;         /* 최신 점수와 그 프레임 번호 */
+   MIL_INT                 ScoreFrame;
+   MIL_INT                 NbPushed, NbScored, NbDropped;
+} ASYNC_METRIC;
+
+/* 연속 초점 상태(현재 렌즈 위치 + 운동 모델) */
+typedef struct
+{
+   MIL_INT    LensPosition;
+   MIL_INT    LastBest;
+   MIL_INT    LastFrame;
+   MIL_DOUBLE Velocity;      /* 위치/프레임 */
+} CONTINUOUS_FOCUS;
+
+/* 재초점 스캔 상태(프레임마다 한 단계: 렌즈 이동 → 자리잡은 프레임의 점수 → 다음 위치) */
+typedef struct
+{
+   bool                    Active;
+   bool                    Predictive;
+   MIL_INT                 Low, High;         /* 현재 탐색 창 */
+   MIL_INT                 Position, Step;    /* 언덕 오르기 중심/보폭 */
+   MIL_INT                 Direction;         /* 다음에 확인할 이웃(-1, 0, 1) */
+   MIL_INT                 BestNext;
+   MIL_INT                 HalfWindow;
+   MIL_INT                 Probe;             /* 점수를 기다리는 렌즈 위치 */
+   MIL_INT                 ProbeFrame;        /* 그 위치가 반영된 첫 프레임 */
+   MIL_INT                 StartFrame;
+   MIL_INT                 Iteration, Travel, Widen;
+   std::vector<MIL_DOUBLE> Scores;            /* 위치별 점수 캐시(<0: 미측정) */
+} REFOCUS_SCAN;
+
+/* 렌즈 구동 콜백(MdigFocus 렌즈 훅과 같은 형식, HookType = M_CHANGE) */
+typedef MIL_INT (MFTYPE *LENS_HOOK_FUNCTION)(MIL_INT HookType, MIL_INT Position, void* UserDataHookPtr);
+
+/* MdigProcess 처리 훅 사용자 데이터(측정 워커, 프레임/렌즈 소스, 초점 상태, 재초점 통계)
+   - 시뮬: Stack = 디포커스 스택(현재 렌즈 위치로 그랩), LensHook = M_NULL
+   - 디지타이저: Stack = M_NULL, LensHook = 모터 구동 함수 */
+typedef struct
+{
+   ASYNC_METRIC*      Async;
+   DEFOCUS_STACK*     Stack;
+   LENS_HOOK_FUNCTION LensHook;
+   void*              LensHookData;
+   CONTINUOUS_FOCUS   Focus;
+   REFOCUS_SCAN       Scan;
+   bool               Predictive;
+   MIL_INT            Frame;        /* 처리한 프레임 수 */
+   MIL_INT            RefFrame;     /* 기준 점수로 쓸 첫 프레임 */
+   MIL_DOUBLE         RefScore;     /* 재초점 직후 기준 점수(<0: 아직 없음) */
+   MIL_INT            NbRefocus, TotalIter, TotalTravel, TotalWiden, TotalFrames;
+} ContinuousHookUserData;
+
+/* 연속 초점 파라미터 */
+#define ASYNC_METRIC_TYPE              FOCUS_METRIC_TENENGRAD
+#define REFOCUS_SCORE_RATIO            0.9
+#define PREDICT_HALF_WINDOW            3
+#define VELOCITY_SMOOTHING             0.5
+#define LENS_SETTLE_FRAMES             1
+#define CONTINUOUS_NB_FRAMES           600
+#define MOVING_PART_AMPLITUDE          20.0
+#define MOVING_PART_PERIOD             300.0
+#define MOVING_PART_STEP               12
+
 /* 렌즈 이동 훅(콜백) – 포커스 위치가 바뀔 때마다 호출됨 */
 MIL_INT MFTYPE MoveLensHookFunction(MIL_INT HookType,
                                     MIL_INT Position,
                                     void*   UserDataHookPtr);
 
 /* 카메라 그랩 시뮬 – 렌즈 위치에 따라 스무딩 횟수를 달리해 초점 상태를 흉내냄 */
-void SimulateGrabFromCamera(MIL_ID SourceImage,
+void SimulateGrabFromCamera(FOCUS_LEVEL& Level,
                             MIL_ID FocusImage,
                             MIL_INT Iteration,
                             MIL_ID AnnotationDisplay);
 
+/* 레벨 자원 할당/해제(Factor: 축소 배율, 1 = 전체 해상도) */
+void FocusLevelAlloc(MIL_ID MilSystem, MIL_ID MilSource, MIL_INT Factor, FOCUS_LEVEL& Level);
+void FocusLevelFree(FOCUS_LEVEL& Level);
+
+/* 피라미드 탐색: 코스 스캔(축소 레벨) → 정밀 MdigFocus(전체 해상도, 피크 주변) */
+void PyramidFocus(FOCUS_LEVEL& FullLevel, FOCUS_LEVEL& CoarseLevel, MIL_ID FocusImage,
+                  MIL_ID CoarseImage, MIL_ID Display, MIL_INT* FocusPosPtr,
+                  MIL_INT* CoarseIterPtr, MIL_INT* FineIterPtr);
+
+/* 20MP 크기에서 전체 탐색 vs 피라미드 탐색 비교 */
+void PyramidFocusBenchmark(MIL_ID MilSystem, MIL_ID MilSource);
+
+/* 포커스 측정(8bit 모노 버퍼의 ROI) 및 ROI 기반 자체 스마트 스캔
+   - 측정 작업자 풀은 MosMain에서 한 번 할당(메인 스레드 전용, 비동기 워커는 1스레드로 호출)
+   - 8bit 모노가 아닌 버퍼는 FOCUS_METRIC_INVALID 반환 */
+#define FOCUS_METRIC_INVALID           (-1.0)
+void       FocusMetricPoolAlloc(MIL_INT NbThreads);
+void       FocusMetricPoolFree();
+MIL_DOUBLE FocusMetric(MIL_ID MilImage, const FOCUS_ROI& Roi, MIL_INT Metric, MIL_INT NbThreads);
+MIL_DOUBLE FocusMetricHost(const MIL_UINT8* Base, MIL_INT Pitch, MIL_INT SizeX, MIL_INT SizeY,
+                           MIL_INT Metric, MIL_INT NbThreads);
+MIL_INT    RoiSmartScan(FOCUS_LEVEL& Level, MIL_ID FocusImage, const FOCUS_ROI& Roi,
+                        MIL_INT Metric, MIL_INT* IterationPtr);
+void       FocusMetricBenchmark(FOCUS_LEVEL& Level, MIL_ID FocusImage);
+
+/* 디포커스 스택 할당/해제, 그랩(자식 이동), 훅, 전략 벤치마크 */
+void    DefocusStackAlloc(MIL_ID MilSystem, MIL_ID MilSource, DEFOCUS_STACK& Stack);
+void    DefocusStackFree(DEFOCUS_STACK& Stack);
+MIL_ID  DefocusStackGrab(DEFOCUS_STACK& Stack, MIL_INT Position);
+MIL_INT MFTYPE StackLensHookFunction(MIL_INT HookType, MIL_INT Position, void* UserDataHookPtr);
+void    StackHookReset(StackHookUserData& UserData, DEFOCUS_STACK& Stack, MIL_INT StartPosition);
+void    DefocusStackBenchmark(MIL_ID MilSystem, MIL_ID MilSource);
+
+/* 녹화 스택 로드(없으면 false) 및 전략 하네스 */
+bool    DefocusStackLoad(MIL_ID MilSystem, MIL_CONST_TEXT_PTR Directory, DEFOCUS_STACK& Stack);
+void    RecordedStackHarness(MIL_ID MilSystem, MIL_ID MilSource);
+
+/* 연속 초점: 비동기 측정 워커, MdigProcess 훅, 예측 재초점, 데모 */
+void    AsyncMetricStart(ASYNC_METRIC& Async, const FOCUS_ROI& Roi);
+void    AsyncMetricStop(ASYNC_METRIC& Async);
+MIL_INT AsyncMetricPush(ASYNC_METRIC& Async, MIL_ID MilFrame);
+bool    AsyncMetricLatest(ASYNC_METRIC& Async, MIL_INT MinFrame, MIL_DOUBLE* ScorePtr);
+MIL_INT MFTYPE ContinuousFocusProcessingFunction(MIL_INT HookType, MIL_ID HookId, void* HookDataPtr);
+void    RefocusScanStart(REFOCUS_SCAN& Scan, const CONTINUOUS_FOCUS& Focus, bool Predictive, MIL_INT Frame);
+MIL_INT RefocusScanNext(REFOCUS_SCAN& Scan);
+void    ContinuousFocusDemo(MIL_ID MilSystem, MIL_ID MilSource);
+
 /* 현재 포커스 위치 오버레이(커서) 그리기 */
-void DrawCursor(MIL_ID AnnotationDisplay, MIL_INT Position);
+void DrawCursor(MIL_ID AnnotationDisplay, MIL_ID FocusImage, MIL_INT Position);
+
+/* 커서 주석 비용 측정 */
+void    DisplayCostBenchmark(FOCUS_LEVEL& FullLevel, FOCUS_LEVEL& CoarseLevel, MIL_ID FocusImage,
+                             MIL_ID CoarseImage, MIL_ID MilDisplay, MIL_ID Annotation);
 
 /* ------------------------- 메인 엔트리 ------------------------- */
 int MosMain(void)
@@ -69,64 +309,107 @@ int MosMain(void)
    MIL_ID  MilApplication;   /* 애플리케이션 */
    MIL_ID  MilSystem;        /* 시스템 */
    MIL_ID  MilDisplay;       /* 디스플레이 */
+   MIL_ID  MilAnnotation;    /* 커서 주석 대상(디스플레이, 헤드리스면 그래픽 리스트) */
    MIL_ID  MilSource;        /* 원본 이미지(선명) */
    MIL_ID  MilCameraFocus;   /* 포커스 상태 이미지(표시용) */
+   MIL_ID  MilCoarseFocus;   /* 코스 레벨 포커스 이미지 */
    MIL_INT FocusPos;         /* 최적 포커스 위치 결과 */
-   DigHookUserData UserData; /* 훅에 전달할 사용자 데이터 */
+   MIL_INT CoarseIter, FineIter;
+   FOCUS_LEVEL FullLevel, CoarseLevel;  /* 레벨별 원본/임시 버퍼 풀 */
 
-   /* 1) 기본 자원 할당 */
+   /* 1) 기본 자원 할당(헤드리스면 디스플레이 제외) */
+#if MIL_HEADLESS
+   MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem, M_NULL, M_NULL, M_NULL);
+   MilDisplay = M_NULL;
+#else
    MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem, &MilDisplay, M_NULL, M_NULL);
+#endif
 
    /* 2) 소스/포커스 버퍼 로드 및 초기화 */
    MbufRestore(IMAGE_FILE, MilSystem, &MilSource);
+#if MIL_HEADLESS
+   MbufAlloc2d(MilSystem,
+               MbufInquire(MilSource, M_SIZE_X, M_NULL),
+               MbufInquire(MilSource, M_SIZE_Y, M_NULL),
+               MbufInquire(MilSource, M_TYPE, M_NULL), M_IMAGE + M_PROC, &MilCameraFocus);
+   MgraAllocList(MilSystem, M_DEFAULT, &MilAnnotation);
+#else
    MbufRestore(IMAGE_FILE, MilSystem, &MilCameraFocus);
+   MilAnnotation = MilDisplay;
+#endif
    MbufClear(MilCameraFocus, 0);
 
    /* 디스플레이에 포커스 버퍼 선택 */
+#if !MIL_HEADLESS
    MdispSelect(MilDisplay, MilCameraFocus);
+#endif
 
-   /* 3) 시작 포커스 위치에서 1프레임 시뮬 취득 */
-   SimulateGrabFromCamera(MilSource, MilCameraFocus, FOCUS_START_POSITION, MilDisplay);
+   /* 2-1) 레벨 자원(전체 해상도, 1/PYRAMID_FACTOR)과 측정 작업자 풀 한 번만 할당 */
+   FocusMetricPoolAlloc((MIL_INT)std::thread::hardware_concurrency());
+   FocusLevelAlloc(MilSystem, MilSource, 1, FullLevel);
+   FocusLevelAlloc(MilSystem, MilSource, PYRAMID_FACTOR, CoarseLevel);
+   MbufAlloc2d(MilSystem,
+               MbufInquire(CoarseLevel.Source, M_SIZE_X, M_NULL),
+               MbufInquire(CoarseLevel.Source, M_SIZE_Y, M_NULL),
+               MbufInquire(CoarseLevel.Source, M_TYPE, M_NULL), M_IMAGE + M_PROC, &MilCoarseFocus);
 
-   /* 4) 훅 데이터 준비 */
-   UserData.SourceImage = MilSource;
-   UserData.FocusImage  = MilCameraFocus;
-   UserData.Iteration   = 0L;
-   UserData.Display     = MilDisplay;
+   /* 3) 시작 포커스 위치에서 1프레임 시뮬 취득 */
+   SimulateGrabFromCamera(FullLevel, MilCameraFocus, FOCUS_START_POSITION, MilAnnotation);
 
    /* 안내 메시지 */
    MosPrintf(MIL_TEXT("\nAUTOFOCUS:\n"));
    MosPrintf(MIL_TEXT("----------\n\n"));
    MosPrintf(MIL_TEXT("Automatic focusing operation will be done on this image.\n"));
    MosPrintf(MIL_TEXT("Press any key to continue.\n\n"));
-   MosGetch();
+   WaitForKey(0);
    MosPrintf(MIL_TEXT("Autofocusing...\n\n"));
 
-   /* 5) 오토포커스 실행
+   /* 4) 오토포커스 실행(피라미드 탐색)
          - 실제 환경에선 MoveLensHookFunction()에서 모터를 구동하고, 카메라로 그랩해야 함.
-         - 여기서는 훅에서 스무딩을 적용한 시뮬 취득으로 대체. */
-   MdigFocus(M_NULL,                 /* 디지타이저 없음(시뮬) */
-             MilCameraFocus,         /* 포커스 측정/표시 대상 버퍼 */
-             M_DEFAULT,              /* 기본 측정 파라미터 */
-             MoveLensHookFunction,   /* 렌즈 이동 훅 – 위치 변경 시 호출 */
-             &UserData,              /* 훅 사용자 데이터 */
-             FOCUS_MIN_POSITION,     /* 탐색 최소 위치 */
-             FOCUS_START_POSITION,   /* 시작 위치 */
-             FOCUS_MAX_POSITION,     /* 탐색 최대 위치 */
-             FOCUS_MAX_POSITION_VARIATION,          /* 위치 변동 허용치 */
-             FOCUS_MODE + FOCUS_SENSITIVITY,        /* 모드/민감도 */
-             &FocusPos);             /* 결과: 최적 포커스 위치 */
-
-   /* 6) 결과 출력 */
+         - 코스 스캔은 축소 레벨(카메라 비닝 또는 그랩 후 MimResize에 해당)에서 수행하고,
+           정밀 탐색만 전체 해상도 MdigFocus로 피크 주변 창에서 수행. */
+   PyramidFocus(FullLevel, CoarseLevel, MilCameraFocus, MilCoarseFocus, MilAnnotation,
+                &FocusPos, &CoarseIter, &FineIter);
+
+   /* 5) 결과 출력 */
    MosPrintf(MIL_TEXT("The best focus position is %d.\n"), (int)FocusPos);
-   MosPrintf(MIL_TEXT("The best focus position found in %d iterations.\n\n"),
-             (int)UserData.Iteration);
+   MosPrintf(MIL_TEXT("The best focus position found in %d iterations "
+                      "(%d coarse at 1/%d, %d at full resolution).\n\n"),
+             (int)(CoarseIter + FineIter), (int)CoarseIter, PYRAMID_FACTOR, (int)FineIter);
+   MosPrintf(MIL_TEXT("Press any key to run the 20 MP benchmark.\n\n"));
+   WaitForKey(0);
+
+   /* 5-0) 탐색 루프에서 커서 주석/화면 갱신이 차지하는 비용 */
+   DisplayCostBenchmark(FullLevel, CoarseLevel, MilCameraFocus, MilCoarseFocus, MilDisplay, MilAnnotation);
+
+   /* 5-1) 20MP 벤치마크 */
+   PyramidFocusBenchmark(MilSystem, MilSource);
+
+   /* 5-2) 포커스 측정 라이브러리(ROI) 벤치마크 */
+   FocusMetricBenchmark(FullLevel, MilCameraFocus);
+
+   /* 5-3) 캐시된 디포커스 스택으로 탐색 전략 비교 */
+   DefocusStackBenchmark(MilSystem, MilSource);
+
+   /* 5-4) 녹화(또는 합성) 스택으로 전략 조합 비교 표 */
+   RecordedStackHarness(MilSystem, MilSource);
+
+   /* 5-5) 움직이는 부품에 대한 연속(예측) 초점 */
+   ContinuousFocusDemo(MilSystem, MilSource);
+
    MosPrintf(MIL_TEXT("Press any key to end.\n"));
-   MosGetch();
+   WaitForKey(0);
 
-   /* 7) 자원 해제 */
+   /* 6) 자원 해제 */
+   FocusMetricPoolFree();
+   MbufFree(MilCoarseFocus);
+   FocusLevelFree(CoarseLevel);
+   FocusLevelFree(FullLevel);
    MbufFree(MilSource);
    MbufFree(MilCameraFocus);
+#if MIL_HEADLESS
+   MgraFree(MilAnnotation);
+#endif
    MappFreeDefault(MilApplication, MilSystem, MilDisplay, M_NULL, M_NULL);
 
    return 0;
@@ -147,7 +430,7 @@ MIL_INT MFTYPE MoveLensHookFunction(MIL_INT HookType,
    if (HookType == M_CHANGE || HookType == M_ON_FOCUS)
    {
       /* (시뮬) 렌즈 위치 변경 + 프레임 취득 */
-      SimulateGrabFromCamera(UserData->SourceImage,
+      SimulateGrabFromCamera(*UserData->Level,
                              UserData->FocusImage,
                              Position,
                              UserData->Display);
@@ -163,73 +446,1266 @@ MIL_INT MFTYPE MoveLensHookFunction(MIL_INT HookType,
 /*  - MIL-Lite에서는 MimConvolve 미지원 → 실제 그랩으로 대체 필요.     */
 /* ------------------------------------------------------------------ */
 
-/* 중앙(베스트) 포커스 위치 */
-#define FOCUS_BEST_POSITION   (FOCUS_MAX_NB_POSITIONS/2)
-
-void SimulateGrabFromCamera(MIL_ID SourceImage,
+void SimulateGrabFromCamera(FOCUS_LEVEL& Level,
                             MIL_ID FocusImage,
                             MIL_INT Iteration,
                             MIL_ID AnnotationDisplay)
 {
    MIL_INT NbSmoothNeeded;   /* 필요한 스무딩 횟수(초점 흐림 정도) */
-   MIL_INT BufType;          /* 버퍼 타입 */
-   MIL_INT BufSizeX, BufSizeY;
    MIL_INT Smooth;           /* 반복 인덱스 */
-   MIL_ID  TempBuffer;       /* 임시 버퍼 */
-   MIL_ID  SourceOwnerSystem;
 
    /* MIL-Lite 환경에서는 시뮬 불가(Convolve 미지원) → 컴파일 에러 유도 */
 #if (M_MIL_LITE)
 # error "Replace the SimulateGrabFromCamera() function with a true image grab."
 #endif
 
-   /* 초점 중심으로부터의 거리만큼 스무딩 횟수 증가 → 초점이 멀수록 흐림 */
-   NbSmoothNeeded = MosAbs(Iteration - FOCUS_BEST_POSITION);
-
-   /* 버퍼 정보 조회 */
-   BufType  = MbufInquire(FocusImage, M_TYPE,   M_NULL);
-   BufSizeX = MbufInquire(FocusImage, M_SIZE_X, M_NULL);
-   BufSizeY = MbufInquire(FocusImage, M_SIZE_Y, M_NULL);
+   /* 초점 중심으로부터의 거리만큼 스무딩 횟수 증가 → 초점이 멀수록 흐림
+      (축소 레벨은 같은 흐림을 내는 횟수로 환산) */
+   NbSmoothNeeded = (MosAbs(Iteration - FOCUS_BEST_POSITION) + Level.SmoothDivider / 2) /
+                    Level.SmoothDivider;
 
    if (NbSmoothNeeded == 0)
    {
       /* 최적 위치: 원본을 그대로 복사(가장 선명) */
-      MbufCopy(SourceImage, FocusImage);
+      MbufCopy(Level.Source, FocusImage);
    }
    else if (NbSmoothNeeded == 1)
    {
       /* 가벼운 흐림 1회 */
-      MimConvolve(SourceImage, FocusImage, M_SMOOTH);
+      MimConvolve(Level.Source, FocusImage, M_SMOOTH);
    }
    else
    {
-      /* 스무딩 다회 적용: 임시 버퍼 사용 */
-      SourceOwnerSystem = (MIL_ID)MbufInquire(SourceImage, M_OWNER_SYSTEM, M_NULL);
+      /* 스무딩 다회 적용: 미리 할당한 핑퐁 버퍼 사용(호출마다 할당/해제 없음) */
+      MimConvolve(Level.Source, Level.Temp[0], M_SMOOTH);
+      for (Smooth = 1; Smooth < NbSmoothNeeded - 1; Smooth++)
+         MimConvolve(Level.Temp[(Smooth - 1) & 1], Level.Temp[Smooth & 1], M_SMOOTH);
 
-      /* 임시 버퍼 할당 */
-      MbufAlloc2d(SourceOwnerSystem, BufSizeX, BufSizeY, BufType, M_IMAGE + M_PROC, &TempBuffer);
+      /* 마지막 스무딩: Temp → FocusImage */
+      MimConvolve(Level.Temp[(NbSmoothNeeded - 2) & 1], FocusImage, M_SMOOTH);
+   }
 
-      /* 첫 스무딩: Source → Temp */
-      MimConvolve(SourceImage, TempBuffer, M_SMOOTH);
+   /* 현재 포커스 위치를 오버레이로 표시(벤치마크 시엔 디스플레이 없음)
+      - 헤드리스 모드에서는 AnnotationDisplay가 그래픽 리스트 */
+   if (AnnotationDisplay != M_NULL)
+      DrawCursor(AnnotationDisplay, FocusImage, Iteration);
+}
 
-      /* 중간 스무딩 반복: Temp → Temp */
-      for (Smooth = 1; Smooth < NbSmoothNeeded - 1; Smooth++)
-         MimConvolve(TempBuffer, TempBuffer, M_SMOOTH);
+/* ------------------------------------------------------------------ */
+/* 레벨 자원 할당/해제                                                 */
+/*  - Factor > 1: 원본을 M_AVERAGE로 축소한 레벨(코스 스캔용)          */
+/* ------------------------------------------------------------------ */
+void FocusLevelAlloc(MIL_ID MilSystem, MIL_ID MilSource, MIL_INT Factor, FOCUS_LEVEL& Level)
+{
+   MIL_INT SizeX = MbufInquire(MilSource, M_SIZE_X, M_NULL) / Factor;
+   MIL_INT SizeY = MbufInquire(MilSource, M_SIZE_Y, M_NULL) / Factor;
+   MIL_INT Type  = MbufInquire(MilSource, M_TYPE, M_NULL);
 
-      /* 마지막 스무딩: Temp → FocusImage */
-      MimConvolve(TempBuffer, FocusImage, M_SMOOTH);
+   MbufAlloc2d(MilSystem, SizeX, SizeY, Type, M_IMAGE + M_PROC, &Level.Source);
+   MbufAlloc2d(MilSystem, SizeX, SizeY, Type, M_IMAGE + M_PROC, &Level.Temp[0]);
+   MbufAlloc2d(MilSystem, SizeX, SizeY, Type, M_IMAGE + M_PROC, &Level.Temp[1]);
+   if (Factor > 1)
+      MimResize(MilSource, Level.Source, 1.0 / Factor, 1.0 / Factor, M_AVERAGE);
+   else
+      MbufCopy(MilSource, Level.Source);
+   Level.SmoothDivider = Factor * Factor;
+}
+
+void FocusLevelFree(FOCUS_LEVEL& Level)
+{
+   MbufFree(Level.Temp[1]);
+   MbufFree(Level.Temp[0]);
+   MbufFree(Level.Source);
+}
+
+/* ------------------------------------------------------------------ */
+/* 피라미드 탐색                                                       */
+/*  1) 코스: 축소 레벨에서 COARSE_STEP 간격으로 취득 + M_EVALUATE 측정  */
+/*  2) 정밀: 코스 최고 위치 ±FINE_HALF_WINDOW 범위만 전체 해상도       */
+/*     MdigFocus(M_SMART_SCAN)로 탐색                                   */
+/* ------------------------------------------------------------------ */
+void PyramidFocus(FOCUS_LEVEL& FullLevel, FOCUS_LEVEL& CoarseLevel, MIL_ID FocusImage,
+                  MIL_ID CoarseImage, MIL_ID Display, MIL_INT* FocusPosPtr,
+                  MIL_INT* CoarseIterPtr, MIL_INT* FineIterPtr)
+{
+   MIL_INT Position, BestPosition = FOCUS_START_POSITION, FocusValue, BestValue = -1;
+   DigHookUserData UserData;
+
+   /* 1) 코스 스캔 */
+   *CoarseIterPtr = 0;
+   for (Position = FOCUS_MIN_POSITION; Position <= FOCUS_MAX_POSITION; Position += COARSE_STEP)
+   {
+      SimulateGrabFromCamera(CoarseLevel, CoarseImage, Position, M_NULL);
+      MdigFocus(M_NULL, CoarseImage, M_DEFAULT, M_NULL, M_NULL,
+                M_DEFAULT, M_DEFAULT, M_DEFAULT, M_DEFAULT, M_EVALUATE, &FocusValue);
+      if (FocusValue > BestValue)
+      {
+         BestValue    = FocusValue;
+         BestPosition = Position;
+      }
+      (*CoarseIterPtr)++;
+   }
+
+   /* 2) 정밀 탐색(전체 해상도, 피크 주변 창) */
+   UserData.Level      = &FullLevel;
+   UserData.FocusImage = FocusImage;
+   UserData.Iteration  = 0L;
+   UserData.Display    = Display;
+   SimulateGrabFromCamera(FullLevel, FocusImage, BestPosition, Display);
+   MdigFocus(M_NULL, FocusImage, M_DEFAULT, MoveLensHookFunction, &UserData,
+             MosMax(BestPosition - FINE_HALF_WINDOW, FOCUS_MIN_POSITION),
+             BestPosition,
+             MosMin(BestPosition + FINE_HALF_WINDOW, FOCUS_MAX_POSITION),
+             FOCUS_MAX_POSITION_VARIATION,
+             FOCUS_MODE + FOCUS_SENSITIVITY,
+             FocusPosPtr);
+   *FineIterPtr = UserData.Iteration;
+}
+
+/* ------------------------------------------------------------------ */
+/* 20MP 벤치마크: 전체 범위/전체 해상도 MdigFocus vs 피라미드 탐색       */
+/* ------------------------------------------------------------------ */
+void PyramidFocusBenchmark(MIL_ID MilSystem, MIL_ID MilSource)
+{
+   MIL_ID      MilLarge, MilFocus, MilCoarse;
+   MIL_INT     FocusPos, CoarseIter, FineIter;
+   MIL_DOUBLE  TimeFull, TimePyramid;
+   FOCUS_LEVEL FullLevel, CoarseLevel;
+   DigHookUserData UserData;
+
+   MosPrintf(MIL_TEXT("AUTOFOCUS BENCHMARK (%d x %d):\n"), BENCH_SIZE_X, BENCH_SIZE_Y);
+   MosPrintf(MIL_TEXT("------------------------------\n\n"));
+   MosPrintf(MIL_TEXT("The full resolution search can take a while...\n\n"));
+
+   /* 20MP 원본 및 레벨 자원 */
+   MbufAlloc2d(MilSystem, BENCH_SIZE_X, BENCH_SIZE_Y, MbufInquire(MilSource, M_TYPE, M_NULL),
+               M_IMAGE + M_PROC, &MilLarge);
+   MimResize(MilSource, MilLarge, M_FILL_DESTINATION, M_FILL_DESTINATION, M_BILINEAR);
+   MbufAlloc2d(MilSystem, BENCH_SIZE_X, BENCH_SIZE_Y, MbufInquire(MilSource, M_TYPE, M_NULL),
+               M_IMAGE + M_PROC, &MilFocus);
+   FocusLevelAlloc(MilSystem, MilLarge, 1, FullLevel);
+   FocusLevelAlloc(MilSystem, MilLarge, PYRAMID_FACTOR, CoarseLevel);
+   MbufAlloc2d(MilSystem,
+               MbufInquire(CoarseLevel.Source, M_SIZE_X, M_NULL),
+               MbufInquire(CoarseLevel.Source, M_SIZE_Y, M_NULL),
+               MbufInquire(CoarseLevel.Source, M_TYPE, M_NULL), M_IMAGE + M_PROC, &MilCoarse);
+
+   /* (a) 기존 방식: 시작 위치부터 전체 범위를 전체 해상도로 탐색 */
+   UserData.Level      = &FullLevel;
+   UserData.FocusImage = MilFocus;
+   UserData.Iteration  = 0L;
+   UserData.Display    = M_NULL;
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   SimulateGrabFromCamera(FullLevel, MilFocus, FOCUS_START_POSITION, M_NULL);
+   MdigFocus(M_NULL, MilFocus, M_DEFAULT, MoveLensHookFunction, &UserData,
+             FOCUS_MIN_POSITION, FOCUS_START_POSITION, FOCUS_MAX_POSITION,
+             FOCUS_MAX_POSITION_VARIATION, FOCUS_MODE + FOCUS_SENSITIVITY, &FocusPos);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeFull);
+   MosPrintf(MIL_TEXT("Full resolution search: position %3d, %3d iterations, %8.1f ms\n"),
+             (int)FocusPos, (int)UserData.Iteration, TimeFull * 1000.0);
+
+   /* (b) 피라미드 탐색 */
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   PyramidFocus(FullLevel, CoarseLevel, MilFocus, MilCoarse, M_NULL, &FocusPos, &CoarseIter, &FineIter);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimePyramid);
+   MosPrintf(MIL_TEXT("Pyramid search:         position %3d, %3d iterations, %8.1f ms "
+                      "(%d coarse + %d fine)\n"),
+             (int)FocusPos, (int)(CoarseIter + FineIter), TimePyramid * 1000.0,
+             (int)CoarseIter, (int)FineIter);
+   MosPrintf(MIL_TEXT("Speedup: %.1fx\n\n"), TimeFull / TimePyramid);
+
+   MbufFree(MilCoarse);
+   FocusLevelFree(CoarseLevel);
+   FocusLevelFree(FullLevel);
+   MbufFree(MilFocus);
+   MbufFree(MilLarge);
+}
+
+/* ------------------------------------------------------------------ */
+/* 포커스 측정 라이브러리(8bit 모노, 사각 ROI)                          */
+/*  - Tenengrad       : 평균(Gx^2 + Gy^2), 3x3 Sobel(ROI 내부 픽셀)     */
+/*  - Laplacian 분산  : Var(상하좌우 - 4*중앙)                          */
+/*  - Brenner         : 평균((I(x+2) - I(x))^2)                         */
+/*  - 정규화 분산     : Var(I) / Mean(I)                                */
+/*  - AVX2 CPU는 16픽셀 단위 정수 벡터 연산, 그 외는 스칼라(실행 시 선택) */
+/*  - 큰 ROI는 행 구간을 상주 풀에 나눠 부분합을 더함                   */
+/* ------------------------------------------------------------------ */
+typedef struct
+{
+   MIL_INT64 Sum;
+   MIL_INT64 SumSq;
+   MIL_INT64 Count;
+} FOCUS_SUMS;
+
+/* 측정 작업자 풀(메인 스레드에서만 여러 구간으로 실행) */
+static WORKER_POOL FocusPool;
+
+void FocusMetricPoolAlloc(MIL_INT NbThreads)
+{
+   WorkerPoolAlloc(FocusPool, MosMax(NbThreads, (MIL_INT)1));
+}
+
+void FocusMetricPoolFree()
+{
+   WorkerPoolFree(FocusPool);
+}
+
+/* 측정별 처리 열 [First, Last) */
+static void FocusMetricColumns(MIL_INT Metric, MIL_INT SizeX, MIL_INT* FirstPtr, MIL_INT* LastPtr)
+{
+   switch (Metric)
+   {
+   case FOCUS_METRIC_TENENGRAD:     *FirstPtr = 1; *LastPtr = SizeX - 1; break;
+   case FOCUS_METRIC_LAPLACIAN_VAR: *FirstPtr = 1; *LastPtr = SizeX - 1; break;
+   case FOCUS_METRIC_BRENNER:       *FirstPtr = 0; *LastPtr = SizeX - 2; break;
+   default:                         *FirstPtr = 0; *LastPtr = SizeX;     break;
+   }
+}
+
+/* 한 행의 열 [x, Last) 스칼라 누적 */
+static void FocusMetricSpan(MIL_INT Metric, const MIL_UINT8* r0, const MIL_UINT8* r1, const MIL_UINT8* r2,
+                            MIL_INT x, MIL_INT Last, MIL_INT64& Sum, MIL_INT64& SumSq)
+{
+   for (; x < Last; x++)
+   {
+      int v, w;
+      switch (Metric)
+      {
+      case FOCUS_METRIC_TENENGRAD:
+         v = (r0[x + 1] + 2 * r1[x + 1] + r2[x + 1]) - (r0[x - 1] + 2 * r1[x - 1] + r2[x - 1]);
+         w = (r2[x - 1] + 2 * r2[x] + r2[x + 1]) - (r0[x - 1] + 2 * r0[x] + r0[x + 1]);
+         SumSq += v * v + w * w;
+         break;
+      case FOCUS_METRIC_LAPLACIAN_VAR:
+         v = r0[x] + r2[x] + r1[x - 1] + r1[x + 1] - 4 * r1[x];
+         Sum += v;
+         SumSq += v * v;
+         break;
+      case FOCUS_METRIC_BRENNER:
+         v = r1[x + 2] - r1[x];
+         SumSq += v * v;
+         break;
+      default:
+         v = r1[x];
+         Sum += v;
+         SumSq += v * v;
+         break;
+      }
+   }
+}
+
+/* 행 [StartY, EndY) 부분합(Y는 ROI 기준, 스칼라). 경계가 필요한 측정은 호출부에서 내부 행만 전달 */
+static void FocusMetricRows(MIL_INT Metric, const MIL_UINT8* Base, MIL_INT Pitch, MIL_INT SizeX,
+                            MIL_INT StartY, MIL_INT EndY, FOCUS_SUMS* Sums)
+{
+   MIL_INT64 Sum = 0, SumSq = 0, Count = 0;
+   MIL_INT   First, Last;
+
+   FocusMetricColumns(Metric, SizeX, &First, &Last);
+   for (MIL_INT y = StartY; y < EndY; y++)
+   {
+      FocusMetricSpan(Metric, Base + (y - 1) * Pitch, Base + y * Pitch, Base + (y + 1) * Pitch,
+                      First, Last, Sum, SumSq);
+      Count += MosMax(Last - First, (MIL_INT)0);
+   }
+   Sums->Sum   = Sum;
+   Sums->SumSq = SumSq;
+   Sums->Count = Count;
+}
+
+#if CPU_HAS_AVX2_KERNEL
+/* 32bit 누적 벡터 → 64bit 스칼라(누적 후 0으로 초기화) */
+AVX2_TARGET static inline MIL_INT64 FlushSum32(__m256i& Acc)
+{
+   MIL_INT32 Lanes[8];
+   _mm256_storeu_si256((__m256i*)Lanes, Acc);
+   Acc = _mm256_setzero_si256();
+   MIL_INT64 Sum = 0;
+   for (int i = 0; i < 8; i++)
+      Sum += Lanes[i];
+   return Sum;
+}
+#define LOAD16(Ptr)  _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i*)(Ptr)))
+#define FLUSH_EVERY  128
+
+/* FocusMetricRows와 같은 부분합: 16픽셀 단위 AVX2, 나머지 열은 스칼라 */
+AVX2_TARGET static void FocusMetricRowsAvx2(MIL_INT Metric, const MIL_UINT8* Base, MIL_INT Pitch, MIL_INT SizeX,
+                                            MIL_INT StartY, MIL_INT EndY, FOCUS_SUMS* Sums)
+{
+   MIL_INT64 Sum = 0, SumSq = 0, Count = 0;
+   MIL_INT   First, Last;
+   const __m256i Ones = _mm256_set1_epi16(1);
+
+   FocusMetricColumns(Metric, SizeX, &First, &Last);
+   for (MIL_INT y = StartY; y < EndY; y++)
+   {
+      const MIL_UINT8* r0 = Base + (y - 1) * Pitch;
+      const MIL_UINT8* r1 = Base + y * Pitch;
+      const MIL_UINT8* r2 = Base + (y + 1) * Pitch;
+      __m256i AccSum = _mm256_setzero_si256(), AccSq = _mm256_setzero_si256();
+      MIL_INT x = First, Iter = 0;
+      Count += MosMax(Last - First, (MIL_INT)0);
+
+      for (; x + 16 <= Last; x += 16)
+      {
+         __m256i v, w;
+         switch (Metric)
+         {
+         case FOCUS_METRIC_TENENGRAD:
+            {
+            __m256i a0 = LOAD16(r0 + x - 1), b0 = LOAD16(r0 + x), c0 = LOAD16(r0 + x + 1);
+            __m256i a1 = LOAD16(r1 + x - 1),                      c1 = LOAD16(r1 + x + 1);
+            __m256i a2 = LOAD16(r2 + x - 1), b2 = LOAD16(r2 + x), c2 = LOAD16(r2 + x + 1);
+            v = _mm256_sub_epi16(_mm256_add_epi16(_mm256_add_epi16(c0, c2), _mm256_slli_epi16(c1, 1)),
+                                 _mm256_add_epi16(_mm256_add_epi16(a0, a2), _mm256_slli_epi16(a1, 1)));
+            w = _mm256_sub_epi16(_mm256_add_epi16(_mm256_add_epi16(a2, c2), _mm256_slli_epi16(b2, 1)),
+                                 _mm256_add_epi16(_mm256_add_epi16(a0, c0), _mm256_slli_epi16(b0, 1)));
+            AccSq = _mm256_add_epi32(AccSq, _mm256_add_epi32(_mm256_madd_epi16(v, v), _mm256_madd_epi16(w, w)));
+            break;
+            }
+         case FOCUS_METRIC_LAPLACIAN_VAR:
+            v = _mm256_sub_epi16(_mm256_add_epi16(_mm256_add_epi16(LOAD16(r0 + x), LOAD16(r2 + x)),
+                                                  _mm256_add_epi16(LOAD16(r1 + x - 1), LOAD16(r1 + x + 1))),
+                                 _mm256_slli_epi16(LOAD16(r1 + x), 2));
+            AccSum = _mm256_add_epi32(AccSum, _mm256_madd_epi16(v, Ones));
+            AccSq  = _mm256_add_epi32(AccSq,  _mm256_madd_epi16(v, v));
+            break;
+         case FOCUS_METRIC_BRENNER:
+            v = _mm256_sub_epi16(LOAD16(r1 + x + 2), LOAD16(r1 + x));
+            AccSq = _mm256_add_epi32(AccSq, _mm256_madd_epi16(v, v));
+            break;
+         default:
+            v = LOAD16(r1 + x);
+            AccSum = _mm256_add_epi32(AccSum, _mm256_madd_epi16(v, Ones));
+            AccSq  = _mm256_add_epi32(AccSq,  _mm256_madd_epi16(v, v));
+            break;
+         }
+         if (++Iter == FLUSH_EVERY)
+         {
+            Sum   += FlushSum32(AccSum);
+            SumSq += FlushSum32(AccSq);
+            Iter = 0;
+         }
+      }
+      Sum   += FlushSum32(AccSum);
+      SumSq += FlushSum32(AccSq);
+
+      /* 나머지 열 */
+      FocusMetricSpan(Metric, r0, r1, r2, x, Last, Sum, SumSq);
+   }
+   Sums->Sum   = Sum;
+   Sums->SumSq = SumSq;
+   Sums->Count = Count;
+}
+#endif
+
+/* CPU에 맞는 커널로 한 행 구간 처리 */
+static void FocusMetricBand(MIL_INT Metric, const MIL_UINT8* Base, MIL_INT Pitch, MIL_INT SizeX,
+                            MIL_INT StartY, MIL_INT EndY, FOCUS_SUMS* Sums)
+{
+#if CPU_HAS_AVX2_KERNEL
+   if (CpuHasAvx2())
+   {
+      FocusMetricRowsAvx2(Metric, Base, Pitch, SizeX, StartY, EndY, Sums);
+      return;
+   }
+#endif
+   FocusMetricRows(Metric, Base, Pitch, SizeX, StartY, EndY, Sums);
+}
+
+MIL_DOUBLE FocusMetric(MIL_ID MilImage, const FOCUS_ROI& Roi, MIL_INT Metric, MIL_INT NbThreads)
+{
+   /* 8bit 모노만 지원 */
+   if (MbufInquire(MilImage, M_SIZE_BIT, M_NULL) != 8 || MbufInquire(MilImage, M_SIZE_BAND, M_NULL) != 1)
+      return FOCUS_METRIC_INVALID;
+
+   /* ROI를 영상 안으로 자름 */
+   MIL_INT OffsetX = MosMax(Roi.OffsetX, (MIL_INT)0);
+   MIL_INT OffsetY = MosMax(Roi.OffsetY, (MIL_INT)0);
+   MIL_INT SizeX   = MosMin(Roi.OffsetX + Roi.SizeX, MbufInquire(MilImage, M_SIZE_X, M_NULL)) - OffsetX;
+   MIL_INT SizeY   = MosMin(Roi.OffsetY + Roi.SizeY, MbufInquire(MilImage, M_SIZE_Y, M_NULL)) - OffsetY;
+   if (SizeX <= 0 || SizeY <= 0)
+      return FOCUS_METRIC_INVALID;
+
+   const MIL_UINT8* Host = (const MIL_UINT8*)MbufInquire(MilImage, M_HOST_ADDRESS, M_NULL);
+   if (Host == M_NULL)
+   {
+      /* 호스트 주소가 없는 버퍼(보드 메모리 등): ROI만 호스트로 복사해 측정 */
+      std::vector<MIL_UINT8> Copy(SizeX * SizeY);
+      MbufGet2d(MilImage, OffsetX, OffsetY, SizeX, SizeY, &Copy[0]);
+      return FocusMetricHost(&Copy[0], SizeX, SizeX, SizeY, Metric, NbThreads);
+   }
+
+   MIL_INT Pitch = MbufInquire(MilImage, M_PITCH_BYTE, M_NULL);
+   return FocusMetricHost(Host + OffsetY * Pitch + OffsetX, Pitch, SizeX, SizeY, Metric, NbThreads);
+}
+
+/* 호스트 메모리(ROI 복사본 등)에서 직접 측정 */
+MIL_DOUBLE FocusMetricHost(const MIL_UINT8* Base, MIL_INT Pitch, MIL_INT SizeX, MIL_INT SizeY,
+                           MIL_INT Metric, MIL_INT NbThreads)
+{
+   /* 3x3 이웃이 필요한 측정은 ROI 내부 행만 */
+   bool    NeedsBorder = (Metric == FOCUS_METRIC_TENENGRAD || Metric == FOCUS_METRIC_LAPLACIAN_VAR);
+   MIL_INT StartY = NeedsBorder ? 1 : 0;
+   MIL_INT EndY   = NeedsBorder ? SizeY - 1 : SizeY;
+   MIL_INT NbRows = MosMax(EndY - StartY, (MIL_INT)0);
+
+   /* 작은 ROI는 구간 분배 비용이 더 크므로 단일 구간, 구간 수는 풀 크기 이하 */
+   if (SizeX * SizeY < FOCUS_MT_MIN_PIXELS)
+      NbThreads = 1;
+   NbThreads = MosMax(MosMin(MosMin(NbThreads, NbRows), WorkerPoolSize(FocusPool)), (MIL_INT)1);
+
+   std::vector<FOCUS_SUMS> Partial(NbThreads);
+   FOCUS_SUMS* PartialPtr = &Partial[0];
+   MIL_INT RowsPerThread = (NbRows + NbThreads - 1) / NbThreads;
+   if (NbThreads == 1)
+      FocusMetricBand(Metric, Base, Pitch, SizeX, StartY, EndY, PartialPtr);
+   else
+      WorkerPoolRun(FocusPool, NbThreads, [=](MIL_INT t)
+         {
+         MIL_INT y0 = MosMin(StartY + t * RowsPerThread, EndY);
+         FocusMetricBand(Metric, Base, Pitch, SizeX, y0, MosMin(y0 + RowsPerThread, EndY), &PartialPtr[t]);
+         });
+
+   MIL_DOUBLE Sum = 0.0, SumSq = 0.0, Count = 0.0;
+   for (MIL_INT t = 0; t < NbThreads; t++)
+   {
+      Sum   += (MIL_DOUBLE)Partial[t].Sum;
+      SumSq += (MIL_DOUBLE)Partial[t].SumSq;
+      Count += (MIL_DOUBLE)Partial[t].Count;
+   }
+   if (Count == 0.0)
+      return 0.0;
+
+   MIL_DOUBLE Mean = Sum / Count;
+   switch (Metric)
+   {
+   case FOCUS_METRIC_LAPLACIAN_VAR: return SumSq / Count - Mean * Mean;
+   case FOCUS_METRIC_NORMALIZED_VAR: return (Mean > 0.0) ? (SumSq / Count - Mean * Mean) / Mean : 0.0;
+   default:                         return SumSq / Count;
+   }
+}
+
+/* ------------------------------------------------------------------ */
+/* ROI 스마트 스캔: 사용자 측정(ROI)으로 언덕 오르기 + 보폭 절반 축소  */
+/*  - 방문한 위치의 점수는 기억해 재취득하지 않음                        */
+/* ------------------------------------------------------------------ */
+MIL_INT RoiSmartScan(FOCUS_LEVEL& Level, MIL_ID FocusImage, const FOCUS_ROI& Roi,
+                     MIL_INT Metric, MIL_INT* IterationPtr)
+{
+   MIL_DOUBLE Scores[FOCUS_MAX_NB_POSITIONS];
+   MIL_INT    Position = FOCUS_START_POSITION, Step = ROI_SCAN_INITIAL_STEP, p, d;
+
+   for (p = 0; p < FOCUS_MAX_NB_POSITIONS; p++)
+      Scores[p] = -1.0;
+   *IterationPtr = 0;
+
+   while (Step > 0)
+   {
+      MIL_INT BestNext = Position;
+      for (d = -1; d <= 1; d++)
+      {
+         p = MosMin(MosMax(Position + d * Step, FOCUS_MIN_POSITION), FOCUS_MAX_POSITION);
+         if (Scores[p] < 0.0)
+         {
+            SimulateGrabFromCamera(Level, FocusImage, p, M_NULL);
+            Scores[p] = FocusMetric(FocusImage, Roi, Metric, 1);
+            (*IterationPtr)++;
+         }
+         if (Scores[p] > Scores[BestNext])
+            BestNext = p;
+      }
+      if (BestNext == Position)
+         Step /= 2;        /* 양옆보다 높음 → 보폭 축소 */
+      else
+         Position = BestNext;
+   }
+   return Position;
+}
+
+/* ------------------------------------------------------------------ */
+/* 측정 라이브러리 벤치마크                                            */
+/*  - 전체 프레임(1스레드/전체 코어), 작은 피두셜 ROI(µs)                */
+/*  - 각 측정으로 ROI 스마트 스캔 수행 → 최적 위치/스텝 수              */
+/* ------------------------------------------------------------------ */
+void FocusMetricBenchmark(FOCUS_LEVEL& Level, MIL_ID FocusImage)
+{
+   static const MIL_CONST_TEXT_PTR MetricNames[FOCUS_NB_METRICS] =
+      { MIL_TEXT("Tenengrad"), MIL_TEXT("Laplacian var"), MIL_TEXT("Brenner"), MIL_TEXT("Normalized var") };
+   MIL_INT    NbCores = MosMax((MIL_INT)std::thread::hardware_concurrency(), (MIL_INT)1);
+   MIL_INT    SizeX = MbufInquire(FocusImage, M_SIZE_X, M_NULL);
+   MIL_INT    SizeY = MbufInquire(FocusImage, M_SIZE_Y, M_NULL);
+   FOCUS_ROI  Frame = { 0, 0, SizeX, SizeY };
+   FOCUS_ROI  Fiducial = { (SizeX - FIDUCIAL_SIZE) / 2, (SizeY - FIDUCIAL_SIZE) / 2, FIDUCIAL_SIZE, FIDUCIAL_SIZE };
+   MIL_DOUBLE Time, TimeFrame1, TimeFrameMp, TimeRoi;
+   MIL_INT    Metric, n, Position, Iterations;
+   volatile MIL_DOUBLE Score = 0.0;
+
+   MosPrintf(MIL_TEXT("FOCUS METRIC LIBRARY (%d x %d frame, %d x %d fiducial ROI):\n"),
+             (int)SizeX, (int)SizeY, FIDUCIAL_SIZE, FIDUCIAL_SIZE);
+   MosPrintf(MIL_TEXT("------------------------------------------------------------\n\n"));
+   MosPrintf(MIL_TEXT("Kernel: %s, %d pooled thread(s).\n\n"),
+             CpuHasAvx2() ? MIL_TEXT("AVX2, 16 pixels per iteration (runtime CPUID)") : MIL_TEXT("scalar (no AVX2 on this CPU)"),
+             (int)WorkerPoolSize(FocusPool));
+   MosPrintf(MIL_TEXT("Metric          frame 1 thr   frame %2d thr   ROI      ROI scan\n"), (int)NbCores);
+   MosPrintf(MIL_TEXT("                (ms)          (ms)           (us)     position/iterations\n\n"));
+
+   SimulateGrabFromCamera(Level, FocusImage, FOCUS_BEST_POSITION, M_NULL);
+   for (Metric = 0; Metric < FOCUS_NB_METRICS; Metric++)
+   {
+      Score = FocusMetric(FocusImage, Frame, Metric, 1);
+      MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+      for (n = 0; n < METRIC_NB_LOOP_FRAME; n++)
+         Score = FocusMetric(FocusImage, Frame, Metric, 1);
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+      TimeFrame1 = Time / METRIC_NB_LOOP_FRAME;
+
+      MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+      for (n = 0; n < METRIC_NB_LOOP_FRAME; n++)
+         Score = FocusMetric(FocusImage, Frame, Metric, NbCores);
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+      TimeFrameMp = Time / METRIC_NB_LOOP_FRAME;
+
+      MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+      for (n = 0; n < METRIC_NB_LOOP_ROI; n++)
+         Score = FocusMetric(FocusImage, Fiducial, Metric, NbCores);
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+      TimeRoi = Time / METRIC_NB_LOOP_ROI;
+
+      Position = RoiSmartScan(Level, FocusImage, Fiducial, Metric, &Iterations);
+      MosPrintf(MIL_TEXT("%-16s%-14.3f%-15.3f%-9.1f%d/%d\n"), MetricNames[Metric],
+                TimeFrame1 * 1000.0, TimeFrameMp * 1000.0, TimeRoi * 1.0e6,
+                (int)Position, (int)Iterations);
+   }
+   MosPrintf(MIL_TEXT("\n"));
+}
+
+/* ------------------------------------------------------------------ */
+/* 캐시된 디포커스 스택                                                */
+/*  - 세로로 긴 버퍼 하나에 흐림 단계를 슬롯으로 쌓음(슬롯 n = 스무딩 n회)*/
+/*  - 슬롯은 필요할 때 한 번만 계산: blur(n+1) = smooth(blur(n))       */
+/*  - 그랩 = View 자식 버퍼를 해당 슬롯으로 MbufChildMove(복사 없음)   */
+/* ------------------------------------------------------------------ */
+void DefocusStackAlloc(MIL_ID MilSystem, MIL_ID MilSource, DEFOCUS_STACK& Stack)
+{
+   MIL_INT SizeX = MbufInquire(MilSource, M_SIZE_X, M_NULL);
+   MIL_INT SizeY = MbufInquire(MilSource, M_SIZE_Y, M_NULL);
+   MIL_INT Slot;
 
-      /* 임시 버퍼 해제 */
-      MbufFree(TempBuffer);
+   /* 가장 먼 위치까지의 거리 + 1 = 필요한 흐림 단계 수 */
+   Stack.NbSlots = MosMax(FOCUS_BEST_POSITION - FOCUS_MIN_POSITION,
+                          FOCUS_MAX_POSITION - FOCUS_BEST_POSITION) + 1;
+   Stack.SizeY   = SizeY;
+   Stack.NbReady = 1;
+   Stack.Recorded     = false;
+   Stack.NbPositions  = FOCUS_MAX_NB_POSITIONS;
+   Stack.TruePosition = FOCUS_BEST_POSITION;
+
+   MbufAlloc2d(MilSystem, SizeX, SizeY * Stack.NbSlots, MbufInquire(MilSource, M_TYPE, M_NULL),
+               M_IMAGE + M_PROC, &Stack.Buffer);
+   Stack.Slots.resize(Stack.NbSlots);
+   for (Slot = 0; Slot < Stack.NbSlots; Slot++)
+      MbufChild2d(Stack.Buffer, 0, Slot * SizeY, SizeX, SizeY, &Stack.Slots[Slot]);
+   MbufChild2d(Stack.Buffer, 0, 0, SizeX, SizeY, &Stack.View);
+
+   /* 슬롯 0 = 선명 원본 */
+   MbufCopy(MilSource, Stack.Slots[0]);
+}
+
+void DefocusStackFree(DEFOCUS_STACK& Stack)
+{
+   MbufFree(Stack.View);
+   for (size_t Slot = Stack.Slots.size(); Slot > 0; Slot--)
+      MbufFree(Stack.Slots[Slot - 1]);
+   Stack.Slots.clear();
+   MbufFree(Stack.Buffer);
+}
+
+/* 렌즈 위치 → 슬롯 번호 */
+static MIL_INT DefocusStackSlot(const DEFOCUS_STACK& Stack, MIL_INT Position)
+{
+   if (Stack.Recorded)
+      return MosMin(MosMax(Position, (MIL_INT)0), Stack.NbSlots - 1);
+   return MosMin(MosAbs(Position - Stack.TruePosition), Stack.NbSlots - 1);
+}
+
+/* 필요한 흐림 단계까지 누적 계산(이미 계산된 단계는 재사용) */
+static void DefocusStackPrepare(DEFOCUS_STACK& Stack, MIL_INT Slot)
+{
+   for (; Stack.NbReady <= Slot; Stack.NbReady++)
+      MimConvolve(Stack.Slots[Stack.NbReady - 1], Stack.Slots[Stack.NbReady], M_SMOOTH);
+}
+
+/* 그랩: View를 해당 위치 슬롯으로 이동(이미지 복사 없음) */
+MIL_ID DefocusStackGrab(DEFOCUS_STACK& Stack, MIL_INT Position)
+{
+   MIL_INT Slot = DefocusStackSlot(Stack, Position);
+
+   DefocusStackPrepare(Stack, Slot);
+   MbufChildMove(Stack.View, 0, Slot * Stack.SizeY,
+                 MbufInquire(Stack.View, M_SIZE_X, M_NULL), Stack.SizeY, M_DEFAULT);
+   return Stack.View;
+}
+
+/* 스택용 렌즈 이동 훅: 프레임 취득 대신 View 이동 */
+MIL_INT MFTYPE StackLensHookFunction(MIL_INT HookType, MIL_INT Position, void* UserDataHookPtr)
+{
+   StackHookUserData* UserData = (StackHookUserData*)UserDataHookPtr;
+
+   if (HookType == M_CHANGE || HookType == M_ON_FOCUS)
+   {
+      DefocusStackGrab(*UserData->Stack, Position);
+      UserData->Iteration++;
+      if (Position != UserData->LastPosition)
+      {
+         UserData->Travel += MosAbs(Position - UserData->LastPosition);
+         UserData->Moves++;
+         UserData->LastPosition = Position;
+      }
+   }
+   return 0;
+}
+
+/* 탐색 시작 전 카운터 초기화 + 시작 위치 그랩 */
+void StackHookReset(StackHookUserData& UserData, DEFOCUS_STACK& Stack, MIL_INT StartPosition)
+{
+   UserData.Stack        = &Stack;
+   UserData.Iteration    = 0L;
+   UserData.LastPosition = StartPosition;
+   UserData.Travel       = 0;
+   UserData.Moves        = 0L;
+   DefocusStackGrab(Stack, StartPosition);
+}
+
+/* ------------------------------------------------------------------ */
+/* 디포커스 스택 벤치마크                                              */
+/*  - 스택 전체 계산 비용, 기존 시뮬(매 그랩 재계산) vs 스택 그랩 비교   */
+/*  - 탐색 전략별(전체 스캔/스마트 스캔 민감도) 초당 반복 수            */
+/*    여러 시작 위치에서 반복해 평균 스텝 수와 위치 오차를 함께 출력     */
+/* ------------------------------------------------------------------ */
+void DefocusStackBenchmark(MIL_ID MilSystem, MIL_ID MilSource)
+{
+   static const struct
+   {
+      MIL_CONST_TEXT_PTR Name;
+      MIL_INT            Mode;
+   } Strategies[] =
+   {
+      { MIL_TEXT("M_SCAN_ALL"),       M_SCAN_ALL       },
+      { MIL_TEXT("M_SMART_SCAN + 0"), M_SMART_SCAN + 0 },
+      { MIL_TEXT("M_SMART_SCAN + 1"), M_SMART_SCAN + 1 },
+      { MIL_TEXT("M_SMART_SCAN + 2"), M_SMART_SCAN + 2 },
+      { MIL_TEXT("M_SMART_SCAN + 4"), M_SMART_SCAN + 4 },
+   };
+   const MIL_INT   NbStrategies = sizeof(Strategies) / sizeof(Strategies[0]);
+   DEFOCUS_STACK   Stack;
+   FOCUS_LEVEL     Level;
+   MIL_ID          MilFocus;
+   MIL_INT         FocusPos, Start, NbStarts, s, TotalIter, TotalError;
+   MIL_DOUBLE      Time, TimeSimulated;
+   StackHookUserData StackData;
+   DigHookUserData   UserData;
+
+   MosPrintf(MIL_TEXT("CACHED DEFOCUS STACK:\n"));
+   MosPrintf(MIL_TEXT("---------------------\n\n"));
+
+   /* (a) 스택 전체 계산 비용(처음 한 번만 발생) */
+   DefocusStackAlloc(MilSystem, MilSource, Stack);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   DefocusStackPrepare(Stack, Stack.NbSlots - 1);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+   MosPrintf(MIL_TEXT("Stack of %d blur levels built in %.1f ms.\n\n"), (int)Stack.NbSlots, Time * 1000.0);
+
+   /* (b) 기존 시뮬 vs 스택: 같은 M_SMART_SCAN 한 번 */
+   FocusLevelAlloc(MilSystem, MilSource, 1, Level);
+   MbufAlloc2d(MilSystem, MbufInquire(MilSource, M_SIZE_X, M_NULL), MbufInquire(MilSource, M_SIZE_Y, M_NULL),
+               MbufInquire(MilSource, M_TYPE, M_NULL), M_IMAGE + M_PROC, &MilFocus);
+   UserData.Level      = &Level;
+   UserData.FocusImage = MilFocus;
+   UserData.Display    = M_NULL;
+   UserData.Iteration  = 0L;
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   SimulateGrabFromCamera(Level, MilFocus, FOCUS_START_POSITION, M_NULL);
+   MdigFocus(M_NULL, MilFocus, M_DEFAULT, MoveLensHookFunction, &UserData,
+             FOCUS_MIN_POSITION, FOCUS_START_POSITION, FOCUS_MAX_POSITION,
+             FOCUS_MAX_POSITION_VARIATION, FOCUS_MODE + FOCUS_SENSITIVITY, &FocusPos);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeSimulated);
+
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   StackHookReset(StackData, Stack, FOCUS_START_POSITION);
+   MdigFocus(M_NULL, Stack.View, M_DEFAULT, StackLensHookFunction, &StackData,
+             FOCUS_MIN_POSITION, FOCUS_START_POSITION, FOCUS_MAX_POSITION,
+             FOCUS_MAX_POSITION_VARIATION, FOCUS_MODE + FOCUS_SENSITIVITY, &FocusPos);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+   MosPrintf(MIL_TEXT("One smart scan (%d iterations): %.2f ms recomputed, %.2f ms from stack (%.1fx).\n\n"),
+             (int)StackData.Iteration, TimeSimulated * 1000.0, Time * 1000.0, TimeSimulated / Time);
+
+   /* (c) 전략별 처리량: 모든 시작 위치에서 탐색 */
+   MosPrintf(MIL_TEXT("Strategy           avg iter   avg error   iterations/s\n\n"));
+   NbStarts = (FOCUS_MAX_POSITION - FOCUS_MIN_POSITION) / STACK_START_STEP + 1;
+   for (s = 0; s < NbStrategies; s++)
+   {
+      TotalIter = TotalError = 0;
+      MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+      for (Start = FOCUS_MIN_POSITION; Start <= FOCUS_MAX_POSITION; Start += STACK_START_STEP)
+      {
+         StackHookReset(StackData, Stack, Start);
+         MdigFocus(M_NULL, Stack.View, M_DEFAULT, StackLensHookFunction, &StackData,
+                   FOCUS_MIN_POSITION, Start, FOCUS_MAX_POSITION,
+                   FOCUS_MAX_POSITION_VARIATION, Strategies[s].Mode, &FocusPos);
+         TotalIter  += StackData.Iteration;
+         TotalError += MosAbs(FocusPos - FOCUS_BEST_POSITION);
+      }
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+      MosPrintf(MIL_TEXT("%-19s%-11.1f%-12.2f%.0f\n"), Strategies[s].Name,
+                (MIL_DOUBLE)TotalIter / NbStarts, (MIL_DOUBLE)TotalError / NbStarts,
+                TotalIter / Time);
+   }
+   MosPrintf(MIL_TEXT("\n"));
+
+   MbufFree(MilFocus);
+   FocusLevelFree(Level);
+   DefocusStackFree(Stack);
+}
+
+/* ------------------------------------------------------------------ */
+/* 녹화된 포커스 스택 로드                                             */
+/*  - Directory/Pos000.mim, Pos001.mim, ... 연속된 프레임(위치 순서)    */
+/*  - 슬롯 = 렌즈 위치. 정답 위치는 M_EVALUATE 값이 최대인 프레임       */
+/*  - 스택 크기는 디렉터리의 연속 프레임 수(FOCUS_MAX_NB_POSITIONS와 무관)*/
+/*  - 프레임이 3장 미만이거나 모노가 아니면 false                       */
+/* ------------------------------------------------------------------ */
+static void RecordedFrameName(MIL_CONST_TEXT_PTR Directory, MIL_INT Position, MIL_TEXT_CHAR* FileName)
+{
+   MosSprintf(FileName, FILE_NAME_LENGTH_MAX, MIL_TEXT("%s/Pos%03d.mim"), Directory, (int)Position);
+}
+
+bool DefocusStackLoad(MIL_ID MilSystem, MIL_CONST_TEXT_PTR Directory, DEFOCUS_STACK& Stack)
+{
+   MIL_TEXT_CHAR FileName[FILE_NAME_LENGTH_MAX];
+   MIL_INT       NbFrames, SizeX, SizeY, Position, FocusValue, BestValue = -1;
+   FILE*         File;
+
+   /* 연속된 프레임 수(파일 존재 여부만 확인, 첫 빈 번호까지 전부) */
+   for (NbFrames = 0; ; NbFrames++)
+   {
+      RecordedFrameName(Directory, NbFrames, FileName);
+      if ((File = MosFopen(FileName, MIL_TEXT("rb"))) == NULL)
+         break;
+      MosFclose(File);
+   }
+   if (NbFrames < 3)
+      return false;
+
+   RecordedFrameName(Directory, 0, FileName);
+   if (MbufDiskInquire(FileName, M_SIZE_BAND, M_NULL) != 1)
+      return false;
+   SizeX = MbufDiskInquire(FileName, M_SIZE_X, M_NULL);
+   SizeY = MbufDiskInquire(FileName, M_SIZE_Y, M_NULL);
+
+   Stack.Recorded    = true;
+   Stack.NbPositions = NbFrames;
+   Stack.NbSlots     = NbFrames;
+   Stack.NbReady     = NbFrames;
+   Stack.SizeY       = SizeY;
+   MbufAlloc2d(MilSystem, SizeX, SizeY * NbFrames,
+               MbufDiskInquire(FileName, M_SIZE_BIT, M_NULL) + M_UNSIGNED,
+               M_IMAGE + M_PROC, &Stack.Buffer);
+   Stack.Slots.resize(NbFrames);
+   for (Position = 0; Position < NbFrames; Position++)
+   {
+      MbufChild2d(Stack.Buffer, 0, Position * SizeY, SizeX, SizeY, &Stack.Slots[Position]);
+      RecordedFrameName(Directory, Position, FileName);
+      MbufLoad(FileName, Stack.Slots[Position]);
+
+      /* 정답(참값) 위치: 전체 프레임 측정값 최대 */
+      MdigFocus(M_NULL, Stack.Slots[Position], M_DEFAULT, M_NULL, M_NULL,
+                M_DEFAULT, M_DEFAULT, M_DEFAULT, M_DEFAULT, M_EVALUATE, &FocusValue);
+      if (FocusValue > BestValue)
+      {
+         BestValue          = FocusValue;
+         Stack.TruePosition = Position;
+      }
+   }
+   MbufChild2d(Stack.Buffer, 0, 0, SizeX, SizeY, &Stack.View);
+   return true;
+}
+
+/* ------------------------------------------------------------------ */
+/* 전략 비교 표(스택 하나)                                             */
+/*  - 모드 x 민감도 x 최대 변동 모든 조합, 여러 시작 위치 평균          */
+/*  - 모터 시간 = 이동 거리 * MOTOR_MS_PER_STEP + 이동 횟수 * 안정화 시간*/
+/*  - 오차 = |결과 - 정답 위치|                                         */
+/*  - 마지막에 허용 오차 이내에서 모터 시간이 가장 짧은 조합을 추천      */
+/* ------------------------------------------------------------------ */
+static void StrategyTable(DEFOCUS_STACK& Stack, MIL_CONST_TEXT_PTR Name)
+{
+   static const MIL_INT Sensitivities[] = { 0, 1, 2, 4 };
+   static const MIL_INT MaxVariations[] = { M_DEFAULT, 4, 8, 16 };
+   const MIL_INT NbSens = sizeof(Sensitivities) / sizeof(Sensitivities[0]);
+   const MIL_INT NbVar  = sizeof(MaxVariations) / sizeof(MaxVariations[0]);
+   const MIL_INT MaxPos = Stack.NbPositions - 1;
+   const MIL_INT Starts[] = { MaxPos / 10, (3 * MaxPos) / 10, (7 * MaxPos) / 10, (9 * MaxPos) / 10 };
+   const MIL_INT NbStarts = sizeof(Starts) / sizeof(Starts[0]);
+   MIL_INT    m, s, v, i, FocusPos, TotalIter, TotalError, TotalTravel, TotalMoves;
+   MIL_INT    BestMode = -1, BestSens = 0, BestVar = 0;
+   MIL_DOUBLE Time, MotorMs, Error, BestMotorMs = 0.0;
+   StackHookUserData StackData;
+
+   MosPrintf(MIL_TEXT("Stack: %s (%d positions, true focus %d)\n\n"),
+             Name, (int)Stack.NbPositions, (int)Stack.TruePosition);
+   MosPrintf(MIL_TEXT("Mode          Sens  MaxVar   Iter    Wall(ms)   Motor(ms)   Error\n"));
+
+   for (m = 0; m < 2; m++)
+   {
+      /* 전체 스캔은 민감도 무관 → 한 번만 */
+      for (s = 0; s < ((m == 0) ? 1 : NbSens); s++)
+      {
+         for (v = 0; v < NbVar; v++)
+         {
+            MIL_INT Mode = (m == 0) ? M_SCAN_ALL : M_SMART_SCAN + Sensitivities[s];
+            TotalIter = TotalError = TotalTravel = TotalMoves = 0;
+
+            MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+            for (i = 0; i < NbStarts; i++)
+            {
+               StackHookReset(StackData, Stack, Starts[i]);
+               MdigFocus(M_NULL, Stack.View, M_DEFAULT, StackLensHookFunction, &StackData,
+                         0, Starts[i], MaxPos, MaxVariations[v], Mode, &FocusPos);
+               TotalIter   += StackData.Iteration;
+               TotalTravel += StackData.Travel;
+               TotalMoves  += StackData.Moves;
+               TotalError  += MosAbs(FocusPos - Stack.TruePosition);
+            }
+            MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+
+            MotorMs = (TotalTravel * MOTOR_MS_PER_STEP + TotalMoves * MOTOR_SETTLE_MS) / NbStarts;
+            Error   = (MIL_DOUBLE)TotalError / NbStarts;
+            if (m == 0)
+               MosPrintf(MIL_TEXT("M_SCAN_ALL    -     "));
+            else
+               MosPrintf(MIL_TEXT("M_SMART_SCAN  %-6d"), (int)Sensitivities[s]);
+            if (MaxVariations[v] == M_DEFAULT)
+               MosPrintf(MIL_TEXT("default  "));
+            else
+               MosPrintf(MIL_TEXT("%-9d"), (int)MaxVariations[v]);
+            MosPrintf(MIL_TEXT("%-8.1f%-11.3f%-12.1f%.2f\n"), (MIL_DOUBLE)TotalIter / NbStarts,
+                      Time * 1000.0 / NbStarts, MotorMs, Error);
+
+            if (Error <= FOCUS_ERROR_TOLERANCE && (BestMode < 0 || MotorMs < BestMotorMs))
+            {
+               BestMode    = m;
+               BestSens    = Sensitivities[s];
+               BestVar     = MaxVariations[v];
+               BestMotorMs = MotorMs;
+            }
+         }
+      }
+   }
+
+   if (BestMode < 0)
+      MosPrintf(MIL_TEXT("\nNo strategy reached the focus within %.1f positions.\n\n"),
+                FOCUS_ERROR_TOLERANCE);
+   else
+   {
+      MosPrintf(MIL_TEXT("\nFewest lens motion within %.1f positions: "), FOCUS_ERROR_TOLERANCE);
+      if (BestMode == 0)
+         MosPrintf(MIL_TEXT("M_SCAN_ALL"));
+      else
+         MosPrintf(MIL_TEXT("M_SMART_SCAN + %d"), (int)BestSens);
+      if (BestVar == M_DEFAULT)
+         MosPrintf(MIL_TEXT(", default max variation (%.1f ms motor).\n\n"), BestMotorMs);
+      else
+         MosPrintf(MIL_TEXT(", max variation %d (%.1f ms motor).\n\n"), (int)BestVar, BestMotorMs);
+   }
+}
+
+/* ------------------------------------------------------------------ */
+/* 녹화 스택 하네스                                                    */
+/*  - FOCUS_STACK_ROOT/Stack00 ~ StackNN 디렉터리를 차례로 재생         */
+/*  - 녹화 스택이 하나도 없으면 합성 디포커스 스택으로 대체              */
+/*    (녹화 스택처럼 모든 슬롯을 측정 전에 미리 계산해 흐림 비용 제외)   */
+/* ------------------------------------------------------------------ */
+void RecordedStackHarness(MIL_ID MilSystem, MIL_ID MilSource)
+{
+   MIL_TEXT_CHAR Directory[FILE_NAME_LENGTH_MAX];
+   MIL_INT       d, NbLoaded = 0;
+   MIL_DOUBLE    TimeBuild;
+   DEFOCUS_STACK Stack;
+
+   MosPrintf(MIL_TEXT("AUTOFOCUS STRATEGY HARNESS:\n"));
+   MosPrintf(MIL_TEXT("---------------------------\n\n"));
+   MosPrintf(MIL_TEXT("Motor model: %.1f ms per position + %.1f ms settle per move.\n\n"),
+             MOTOR_MS_PER_STEP, MOTOR_SETTLE_MS);
+
+   for (d = 0; d < RECORDED_STACK_MAX; d++)
+   {
+      MosSprintf(Directory, FILE_NAME_LENGTH_MAX, MIL_TEXT("%s/Stack%02d"), FOCUS_STACK_ROOT, (int)d);
+      if (DefocusStackLoad(MilSystem, Directory, Stack))
+      {
+         StrategyTable(Stack, Directory);
+         DefocusStackFree(Stack);
+         NbLoaded++;
+      }
+   }
+
+   if (NbLoaded == 0)
+   {
+      MosPrintf(MIL_TEXT("No recorded stack found in %s/StackNN (Pos000.mim, Pos001.mim, ...).\n"),
+                FOCUS_STACK_ROOT);
+      MosPrintf(MIL_TEXT("Using the synthetic defocus stack instead.\n\n"));
+      DefocusStackAlloc(MilSystem, MilSource, Stack);
+      MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+      DefocusStackPrepare(Stack, Stack.NbSlots - 1);
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &TimeBuild);
+      MosPrintf(MIL_TEXT("Synthetic stack prebuilt: %d blur steps in %.1f ms (not included below).\n\n"),
+                (int)Stack.NbSlots, TimeBuild * 1000.0);
+      StrategyTable(Stack, MIL_TEXT("synthetic"));
+      DefocusStackFree(Stack);
+   }
+}
+
+/* ------------------------------------------------------------------ */
+/* 비동기 포커스 측정 워커                                             */
+/*  - 프레임 훅은 피두셜 ROI만 호스트로 복사해 넘기고 바로 반환         */
+/*  - 워커가 측정을 계산해 최신 점수(프레임 번호와 함께)를 게시         */
+/*  - 워커가 밀리면 이전 대기 프레임은 버림(항상 최신 프레임만 측정)    */
+/*  - 버퍼 3개(Staging/Pending/Working)를 교체만 하므로 할당 없음       */
+/* ------------------------------------------------------------------ */
+static void AsyncMetricWorker(ASYNC_METRIC* Async)
+{
+   std::unique_lock<std::mutex> Lock(Async->Lock);
+   for (;;)
+   {
+      Async->Wake.wait(Lock, [Async] { return Async->HasPending || Async->Stop; });
+      if (Async->Stop)
+         break;
+      Async->Pending.swap(Async->Working);
+      Async->HasPending = false;
+      MIL_INT Frame = Async->PendingFrame;
+      Lock.unlock();
+
+      MIL_DOUBLE Score = FocusMetricHost(&Async->Working[0], Async->Roi.SizeX, Async->Roi.SizeX,
+                                         Async->Roi.SizeY, ASYNC_METRIC_TYPE, 1);
+
+      Lock.lock();
+      Async->Score      = Score;
+      Async->ScoreFrame = Frame;
+      Async->NbScored++;
+   }
+}
+
+void AsyncMetricStart(ASYNC_METRIC& Async, const FOCUS_ROI& Roi)
+{
+   Async.Roi          = Roi;
+   Async.Stop         = false;
+   Async.HasPending   = false;
+   Async.PendingFrame = -1;
+   Async.Score        = 0.0;
+   Async.ScoreFrame   = -1;
+   Async.NbPushed     = 0;
+   Async.NbScored     = 0;
+   Async.NbDropped    = 0;
+   Async.Staging.assign(Roi.SizeX * Roi.SizeY, 0);
+   Async.Pending.assign(Roi.SizeX * Roi.SizeY, 0);
+   Async.Working.assign(Roi.SizeX * Roi.SizeY, 0);
+   Async.Worker = std::thread(AsyncMetricWorker, &Async);
+}
+
+void AsyncMetricStop(ASYNC_METRIC& Async)
+{
+   {
+   std::lock_guard<std::mutex> Lock(Async.Lock);
+   Async.Stop = true;
+   }
+   Async.Wake.notify_one();
+   Async.Worker.join();
+}
+
+/* 프레임 하나 제출: ROI 복사(호출 스레드) → 워커로 넘김. 프레임 번호 반환 */
+MIL_INT AsyncMetricPush(ASYNC_METRIC& Async, MIL_ID MilFrame)
+{
+   MIL_INT FrameIndex = Async.NbPushed++;
+
+   MbufGet2d(MilFrame, Async.Roi.OffsetX, Async.Roi.OffsetY, Async.Roi.SizeX, Async.Roi.SizeY,
+             &Async.Staging[0]);
+   {
+   std::lock_guard<std::mutex> Lock(Async.Lock);
+   if (Async.HasPending)
+      Async.NbDropped++;
+   Async.Pending.swap(Async.Staging);
+   Async.HasPending   = true;
+   Async.PendingFrame = FrameIndex;
+   }
+   Async.Wake.notify_one();
+   return FrameIndex;
+}
+
+/* 최신 점수 읽기(MinFrame 이후 프레임의 점수가 아직 없으면 false) */
+bool AsyncMetricLatest(ASYNC_METRIC& Async, MIL_INT MinFrame, MIL_DOUBLE* ScorePtr)
+{
+   std::lock_guard<std::mutex> Lock(Async.Lock);
+   if (Async.ScoreFrame < MinFrame)
+      return false;
+   *ScorePtr = Async.Score;
+   return true;
+}
+
+/* ------------------------------------------------------------------ */
+/* 재초점 스캔(상태 기계)                                               */
+/*  - 트리거와 같은 측정(ASYNC_METRIC_TYPE, 같은 ROI)으로 [Low, High]에서 */
+/*    언덕 오르기 + 보폭 절반 축소(RoiSmartScan과 동일)                   */
+/*  - RefocusScanNext는 점수가 없는 위치를 만나면 그 위치를 반환하고      */
+/*    멈춤. 호출자가 렌즈를 옮기고 그 위치의 점수를 채운 뒤 다시 호출     */
+/*  - 예측: 시작 = 직전 최적 위치 + 속도 * 경과 프레임, ±PREDICT_HALF_WINDOW*/
+/*    창만 탐색. 결과가 창 경계에 붙으면(피크가 창 밖) 창을 2배로 넓힘    */
+/*  - 전체 범위: FOCUS_START_POSITION부터 전체 범위                      */
+/* ------------------------------------------------------------------ */
+static void RefocusScanWindow(REFOCUS_SCAN& Scan, MIL_INT Center)
+{
+   Scan.Low       = MosMax(Center - Scan.HalfWindow, FOCUS_MIN_POSITION);
+   Scan.High      = MosMin(Center + Scan.HalfWindow, FOCUS_MAX_POSITION);
+   Scan.Position  = Center;
+   Scan.Step      = MosMax((Scan.HalfWindow + 1) / 2, (MIL_INT)1);
+   Scan.Direction = -1;
+   Scan.BestNext  = Center;
+}
+
+void RefocusScanStart(REFOCUS_SCAN& Scan, const CONTINUOUS_FOCUS& Focus, bool Predictive, MIL_INT Frame)
+{
+   Scan.Active     = true;
+   Scan.Predictive = Predictive;
+   Scan.StartFrame = Frame;
+   Scan.Iteration  = Scan.Travel = Scan.Widen = 0;
+   Scan.Scores.assign(FOCUS_MAX_NB_POSITIONS, -1.0);
+
+   if (Predictive)
+   {
+      MIL_INT Predicted = Focus.LastBest;
+      if (Focus.LastFrame >= 0)
+         Predicted += (MIL_INT)floor(Focus.Velocity * (Frame - Focus.LastFrame) + 0.5);
+      Scan.HalfWindow = PREDICT_HALF_WINDOW;
+      RefocusScanWindow(Scan, MosMin(MosMax(Predicted, FOCUS_MIN_POSITION), FOCUS_MAX_POSITION));
+   }
+   else
+   {
+      Scan.Low       = FOCUS_MIN_POSITION;
+      Scan.High      = FOCUS_MAX_POSITION;
+      Scan.Position  = FOCUS_START_POSITION;
+      Scan.Step      = ROI_SCAN_INITIAL_STEP;
+      Scan.Direction = -1;
+      Scan.BestNext  = FOCUS_START_POSITION;
+   }
+}
+
+/* 반환: 다음에 측정할 렌즈 위치, 스캔이 끝났으면 -1(결과는 Scan.Position) */
+MIL_INT RefocusScanNext(REFOCUS_SCAN& Scan)
+{
+   for (;;)
+   {
+      while (Scan.Step > 0)
+      {
+         for (; Scan.Direction <= 1; Scan.Direction++)
+         {
+            MIL_INT p = MosMin(MosMax(Scan.Position + Scan.Direction * Scan.Step, Scan.Low), Scan.High);
+            if (Scan.Scores[p] < 0.0)
+               return p;
+            if (Scan.Scores[p] > Scan.Scores[Scan.BestNext])
+               Scan.BestNext = p;
+         }
+         if (Scan.BestNext == Scan.Position)
+            Scan.Step /= 2;        /* 양옆보다 높음 → 보폭 축소 */
+         else
+            Scan.Position = Scan.BestNext;
+         Scan.Direction = -1;
+         Scan.BestNext  = Scan.Position;
+      }
+
+      /* 창 내부에서 피크를 찾았거나 이미 전체 범위면 종료 */
+      if (!Scan.Predictive ||
+          ((Scan.Position > Scan.Low || Scan.Low == FOCUS_MIN_POSITION) &&
+           (Scan.Position < Scan.High || Scan.High == FOCUS_MAX_POSITION)))
+         return -1;
+      Scan.HalfWindow *= 2;
+      Scan.Widen++;
+      RefocusScanWindow(Scan, Scan.Position);
+   }
+}
+
+/* 렌즈 이동: 콜백(실제 모터) 호출 + 이동 거리 누적. 새 위치가 반영되는 첫 프레임 번호 반환 */
+static MIL_INT ContinuousMoveLens(ContinuousHookUserData& HookData, MIL_INT Position, MIL_INT FrameIndex)
+{
+   HookData.Scan.Travel += MosAbs(Position - HookData.Focus.LensPosition);
+   HookData.Focus.LensPosition = Position;
+   if (HookData.LensHook)
+      HookData.LensHook(M_CHANGE, Position, HookData.LensHookData);
+   return FrameIndex + LENS_SETTLE_FRAMES;
+}
+
+/* 스캔 한 단계: 다음 탐색 위치로 렌즈 이동. 끝났으면 결과 위치로 옮기고 통계/운동 모델 갱신 */
+static void RefocusStep(ContinuousHookUserData& HookData, MIL_INT FrameIndex)
+{
+   REFOCUS_SCAN&     Scan  = HookData.Scan;
+   CONTINUOUS_FOCUS& Focus = HookData.Focus;
+   MIL_INT           Next  = RefocusScanNext(Scan);
+
+   if (Next >= 0)
+   {
+      Scan.Probe      = Next;
+      Scan.ProbeFrame = ContinuousMoveLens(HookData, Next, FrameIndex);
+      Scan.Iteration++;
+      return;
    }
 
-   /* 현재 포커스 위치를 오버레이로 표시 */
-   DrawCursor(AnnotationDisplay, Iteration);
+   HookData.RefFrame = ContinuousMoveLens(HookData, Scan.Position, FrameIndex);
+   HookData.RefScore = -1.0;
+
+   /* 운동 모델 갱신(예측 모드만, 속도 지수 평활) */
+   if (Scan.Predictive && Focus.LastFrame >= 0 && HookData.Frame > Focus.LastFrame)
+      Focus.Velocity = VELOCITY_SMOOTHING * (MIL_DOUBLE)(Scan.Position - Focus.LastBest) / (HookData.Frame - Focus.LastFrame) +
+                       (1.0 - VELOCITY_SMOOTHING) * Focus.Velocity;
+   Focus.LastBest = Scan.Position;
+   if (Scan.Predictive)
+      Focus.LastFrame = HookData.Frame;
+
+   HookData.NbRefocus++;
+   HookData.TotalIter   += Scan.Iteration;
+   HookData.TotalTravel += Scan.Travel;
+   HookData.TotalWiden  += Scan.Widen;
+   HookData.TotalFrames += HookData.Frame + 1 - Scan.StartFrame;
+   Scan.Active = false;
+}
+
+/* ------------------------------------------------------------------ */
+/* MdigProcess 처리 훅                                                  */
+/*  - 그랩된 버퍼의 ROI를 측정 워커에 넘기고 바로 반환(탐색은 훅에서 돌지 않음)*/
+/*  - 최신 점수가 기준 대비 REFOCUS_SCORE_RATIO 미만이면 재초점 스캔 시작 */
+/*  - 스캔 중: 탐색 위치가 반영된 프레임의 점수가 나오면 한 단계 진행    */
+/*  (HookData.Stack = M_NULL, HookData.LensHook = 모터 구동 함수 후      */
+/*   MdigProcess(MilDigitizer, ..., M_START, M_DEFAULT,                  */
+/*               ContinuousFocusProcessingFunction, &HookData))          */
+/*  HookId == M_NULL: 시뮬 루프 – 현재 렌즈 위치로 스택에서 그랩         */
+/* ------------------------------------------------------------------ */
+MIL_INT MFTYPE ContinuousFocusProcessingFunction(MIL_INT HookType, MIL_ID HookId, void* HookDataPtr)
+{
+   ContinuousHookUserData* HookData = (ContinuousHookUserData*)HookDataPtr;
+   REFOCUS_SCAN&           Scan     = HookData->Scan;
+   MIL_ID     ModifiedBufferId;
+   MIL_INT    FrameIndex;
+   MIL_DOUBLE Score;
+
+   if (HookId != M_NULL)
+      MdigGetHookInfo(HookId, M_MODIFIED_BUFFER + M_BUFFER_ID, &ModifiedBufferId);
+   else
+      ModifiedBufferId = DefocusStackGrab(*HookData->Stack, HookData->Focus.LensPosition);
+   FrameIndex = AsyncMetricPush(*HookData->Async, ModifiedBufferId);
+
+   if (Scan.Active)
+   {
+      /* 렌즈가 탐색 위치에 있는 동안의 점수 → 다음 위치 */
+      if (AsyncMetricLatest(*HookData->Async, Scan.ProbeFrame, &Score))
+      {
+         Scan.Scores[Scan.Probe] = Score;
+         RefocusStep(*HookData, FrameIndex);
+      }
+   }
+   else if (AsyncMetricLatest(*HookData->Async, HookData->RefFrame, &Score))
+   {
+      /* 기준 점수: 재초점 직후 첫 측정. 이후 떨어지면 같은 측정/ROI로 재초점 */
+      if (HookData->RefScore < 0.0)
+         HookData->RefScore = Score;
+      else if (Score < REFOCUS_SCORE_RATIO * HookData->RefScore)
+      {
+         RefocusScanStart(Scan, HookData->Focus, HookData->Predictive, HookData->Frame);
+         RefocusStep(*HookData, FrameIndex);
+      }
+   }
+   HookData->Frame++;
+   return 0;
+}
+
+/* 움직이는 부품의 참 포커스 위치(시뮬): 느린 사인 변화 + 중간에 부품 교체(단차) */
+static MIL_INT MovingPartFocus(MIL_INT Frame)
+{
+   MIL_DOUBLE Position = FOCUS_BEST_POSITION +
+                         MOVING_PART_AMPLITUDE * sin(2.0 * 3.14159265358979 * Frame / MOVING_PART_PERIOD);
+   if (Frame >= CONTINUOUS_NB_FRAMES / 2)
+      Position += MOVING_PART_STEP;
+   return MosMin(MosMax((MIL_INT)floor(Position + 0.5), FOCUS_MIN_POSITION), FOCUS_MAX_POSITION);
+}
+
+/* ------------------------------------------------------------------ */
+/* 연속 초점 데모(스트림 시뮬)                                          */
+/*  - 시뮬 MdigProcess 루프: 매 프레임 부품 이동 후 처리 훅 호출        */
+/*    (훅이 현재 렌즈 위치로 그랩 → ROI 제출 → 필요 시 재초점 한 단계)  */
+/*  - frames/refocus: 재초점 시작부터 결과 위치로 옮길 때까지 프레임 수 */
+/*  - 예측 재초점 vs 전체 범위 재초점 비교                               */
+/* ------------------------------------------------------------------ */
+void ContinuousFocusDemo(MIL_ID MilSystem, MIL_ID MilSource)
+{
+   DEFOCUS_STACK          Stack;
+   ASYNC_METRIC           Async;
+   ContinuousHookUserData HookData;
+   MIL_INT    SizeX = MbufInquire(MilSource, M_SIZE_X, M_NULL);
+   MIL_INT    SizeY = MbufInquire(MilSource, M_SIZE_Y, M_NULL);
+   FOCUS_ROI  Fiducial = { (SizeX - FIDUCIAL_SIZE) / 2, (SizeY - FIDUCIAL_SIZE) / 2, FIDUCIAL_SIZE, FIDUCIAL_SIZE };
+   MIL_INT    Predictive, Frame, TotalError;
+   MIL_DOUBLE Time;
+
+   MosPrintf(MIL_TEXT("CONTINUOUS AUTOFOCUS (moving part, %d frames):\n"), CONTINUOUS_NB_FRAMES);
+   MosPrintf(MIL_TEXT("----------------------------------------------\n\n"));
+   MosPrintf(MIL_TEXT("Mode          refocus   iter/refocus   frames/refocus   travel/refocus   widen   "
+                      "mean error   scored/dropped   ms\n"));
+
+   DefocusStackAlloc(MilSystem, MilSource, Stack);
+   for (Predictive = 0; Predictive <= 1; Predictive++)
+   {
+      HookData.Async      = &Async;
+      HookData.Stack      = &Stack;
+      HookData.LensHook     = M_NULL;
+      HookData.LensHookData = M_NULL;
+      HookData.Scan.Active  = false;
+      HookData.Predictive = (Predictive != 0);
+      HookData.Focus.LensPosition = FOCUS_START_POSITION;
+      HookData.Focus.LastBest     = FOCUS_START_POSITION;
+      HookData.Focus.LastFrame    = -1;
+      HookData.Focus.Velocity     = 0.0;
+      HookData.Frame     = 0;
+      HookData.RefFrame  = 0;
+      HookData.RefScore  = -1.0;
+      HookData.NbRefocus = HookData.TotalIter = HookData.TotalTravel = HookData.TotalWiden = 0;
+      HookData.TotalFrames = 0;
+      TotalError = 0;
+      AsyncMetricStart(Async, Fiducial);
+
+      MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+      for (Frame = 0; Frame < CONTINUOUS_NB_FRAMES; Frame++)
+      {
+         /* 부품 이동 → 처리 훅(MdigProcess가 프레임마다 호출하는 것과 동일) */
+         Stack.TruePosition = MovingPartFocus(Frame);
+         ContinuousFocusProcessingFunction(M_MODIFIED_BUFFER, M_NULL, &HookData);
+         TotalError += MosAbs(HookData.Focus.LensPosition - Stack.TruePosition);
+      }
+      MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+      AsyncMetricStop(Async);
+
+      MosPrintf(MIL_TEXT("%-14s%-10d%-15.1f%-17.1f%-17.1f%-8d%-13.2f%7d/%-9d%.1f\n"),
+                Predictive ? MIL_TEXT("predictive") : MIL_TEXT("full range"), (int)HookData.NbRefocus,
+                HookData.NbRefocus ? (MIL_DOUBLE)HookData.TotalIter / HookData.NbRefocus : 0.0,
+                HookData.NbRefocus ? (MIL_DOUBLE)HookData.TotalFrames / HookData.NbRefocus : 0.0,
+                HookData.NbRefocus ? (MIL_DOUBLE)HookData.TotalTravel / HookData.NbRefocus : 0.0,
+                (int)HookData.TotalWiden,
+                (MIL_DOUBLE)TotalError / CONTINUOUS_NB_FRAMES,
+                (int)Async.NbScored, (int)Async.NbDropped, Time * 1000.0);
+   }
+   MosPrintf(MIL_TEXT("\n"));
+   DefocusStackFree(Stack);
 }
 
 /* --------------------------------------------------------------- */
 /* 포커스 위치 커서(오버레이) 그리기                               */
 /*   - 화면 하단 7/8 높이에 수평선 + 현재 위치를 가리키는 화살표   */
+/*   - 헤드리스: 오버레이 대신 그래픽 리스트를 비우고 다시 기록    */
 /* --------------------------------------------------------------- */
 
 /* 커서 스타일 */
@@ -237,18 +1713,26 @@ void SimulateGrabFromCamera(MIL_ID SourceImage,
 #define CURSOR_SIZE       14
 #define CURSOR_COLOR      M_COLOR_GREEN
 
-void DrawCursor(MIL_ID AnnotationDisplay, MIL_INT Position)
+void DrawCursor(MIL_ID AnnotationDisplay, MIL_ID FocusImage, MIL_INT Position)
 {
    MIL_ID     AnnotationImage;
    MIL_INT    BufSizeX, BufSizeY, n;
    MIL_DOUBLE CursorColor;
 
+#if MIL_HEADLESS
+   /* 그래픽 리스트 초기화, 크기는 포커스 버퍼 기준 */
+   AnnotationImage = AnnotationDisplay;
+   MgraClear(M_DEFAULT, AnnotationImage);
+   MbufInquire(FocusImage, M_SIZE_X, &BufSizeX);
+   MbufInquire(FocusImage, M_SIZE_Y, &BufSizeY);
+#else
    /* 오버레이 활성화 및 초기화 */
    MdispControl(AnnotationDisplay, M_OVERLAY, M_ENABLE);
    MdispControl(AnnotationDisplay, M_OVERLAY_CLEAR, M_DEFAULT);
    MdispInquire(AnnotationDisplay, M_OVERLAY_ID, &AnnotationImage);
    MbufInquire(AnnotationImage, M_SIZE_X, &BufSizeX);
    MbufInquire(AnnotationImage, M_SIZE_Y, &BufSizeY);
+#endif
 
    /* 그리기 색상 설정 */
    CursorColor = CURSOR_COLOR;
@@ -277,3 +1761,50 @@ void DrawCursor(MIL_ID AnnotationDisplay, MIL_INT Position)
             Position*n - CURSOR_SIZE,  CURSOR_POSITION,
             Position*n + CURSOR_SIZE,  CURSOR_POSITION);
 }
+
+/* --------------------------------------------------------------- */
+/* 디스플레이 지원 비용: 피라미드 탐색 루프(훅마다 그랩 시뮬 + 커서) */
+/*   - 커서 주석 + 화면에 선택된 포커스 버퍼 vs 주석/디스플레이 없음 */
+/*   - 헤드리스 빌드에서는 그래픽 리스트 주석 비용만 측정          */
+/* --------------------------------------------------------------- */
+static MIL_DOUBLE TimePyramidFocus(FOCUS_LEVEL& FullLevel, FOCUS_LEVEL& CoarseLevel, MIL_ID FocusImage,
+                                   MIL_ID CoarseImage, MIL_ID Annotation, MIL_INT* IterationsPtr)
+{
+   MIL_INT    FocusPos, CoarseIter, FineIter;
+   MIL_DOUBLE Time;
+
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (MIL_INT n = 0; n < DISPLAY_COST_NB_LOOP; n++)
+      PyramidFocus(FullLevel, CoarseLevel, FocusImage, CoarseImage, Annotation,
+                   &FocusPos, &CoarseIter, &FineIter);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+   *IterationsPtr = CoarseIter + FineIter;
+   return 1000.0 * Time / DISPLAY_COST_NB_LOOP;
+}
+
+void DisplayCostBenchmark(FOCUS_LEVEL& FullLevel, FOCUS_LEVEL& CoarseLevel, MIL_ID FocusImage,
+                          MIL_ID CoarseImage, MIL_ID MilDisplay, MIL_ID Annotation)
+{
+   MIL_DOUBLE TimeAnnotated, TimeBare;
+   MIL_INT    Iterations;
+
+   MosPrintf(MIL_TEXT("DISPLAY SUPPORT COST (pyramid search, %d runs):\n"), DISPLAY_COST_NB_LOOP);
+   MosPrintf(MIL_TEXT("------------------------------------------------\n\n"));
+
+   TimeAnnotated = TimePyramidFocus(FullLevel, CoarseLevel, FocusImage, CoarseImage, Annotation, &Iterations);
+#if !MIL_HEADLESS
+   MdispSelect(MilDisplay, M_NULL);
+#endif
+   TimeBare = TimePyramidFocus(FullLevel, CoarseLevel, FocusImage, CoarseImage, M_NULL, &Iterations);
+#if !MIL_HEADLESS
+   MdispSelect(MilDisplay, FocusImage);
+#endif
+
+   MosPrintf(MIL_TEXT("%-34s %8.2f ms/search\n"),
+             MIL_HEADLESS ? MIL_TEXT("Cursor to graphic list:") : MIL_TEXT("Displayed buffer + overlay cursor:"),
+             TimeAnnotated);
+   MosPrintf(MIL_TEXT("%-34s %8.2f ms/search\n"), MIL_TEXT("No annotation, no display:"), TimeBare);
+   MosPrintf(MIL_TEXT("Display support costs %.3f ms per search step (%d steps, %.1f%%).\n\n"),
+             (TimeAnnotated - TimeBare) / MosMax(Iterations, (MIL_INT)1), (int)Iterations,
+             100.0 * (TimeAnnotated - TimeBare) / TimeAnnotated);
+}
@@ -11,26 +11,58 @@
  *   - 키 조작:
  *       ←/→: 윈도우 좌/우 이동,  ↓/↑: 윈도우 좁힘/넓힘,
  *       L/U: 인플렉션(출력 레벨) 내림/올림,  R: 전체 초기화.
- *   - MgenLutRamp 3회로 [0~Start], [Start~End], [End~Max] 구간 램프/포화 LUT 생성 → MdispLut 즉시 반영.
- *   - DrawLutShape로 LUT 모양을 영상 위에 그려 시각화(성능 비용 높음 → 필요 시 비활성).
+ *   - [0~Start], [Start~End], [End~Max] 구간 램프/포화 LUT → MdispLut 즉시 반영.
+ *   - LUT 관리자: 앞/뒤 2개 LUT 더블버퍼링, 뒤 LUT가 마지막으로 담은 파라미터와 비교해
+ *     구간(0/램프/상단 램프)별로 바뀔 수 있는 범위만 다시 계산하고, 호스트 사본과 값이 다른
+ *     항목 묶음만 MbufPut1d로 갱신 후 교체(16bit 65536항목 LUT도 드래그 속도로 갱신).
+ *   - 마우스 드래그: 좌우=레벨(윈도우 이동), 상하=윈도우 폭.
+ *   - 자동 윈도우/레벨(A 키): 스레드별 전용 빈 병렬 히스토그램 → 0.5~99.5% 백분위로 Start/End 결정.
+ *     라이브 프레임은 서브샘플 히스토그램 + 지수 평활로 점진 갱신.
+ *     히스토그램 작업자와 전용 빈은 한 번 할당해 재사용, 5MP 12bit 프레임 1 ms 예산 통과 여부 출력.
+ *   - DrawLutShape로 LUT 모양을 디스플레이 그래픽 리스트에 그려 시각화
+ *     (영상 픽셀은 건드리지 않음, 갱신 비용은 곡선 크기에 비례).
+ *   - 라이브 레벨링 엔진: 고비트(10/12/16bit) 프레임마다 16→8bit LUT 룩업을 벡터화(AVX2 gather)
+ *     + 행 구간 멀티스레드로 적용해 8bit 표시 버퍼 생성, MimLutMap/MdispLut 경로와 처리량 비교.
+ *     작업자 스레드는 엔진 할당 시 한 번 생성(상주 풀), AVX2 커널은 실행 시점 CPUID로 선택,
+ *     호스트 주소가 없거나 16→8bit가 아닌 버퍼는 MimLutMap으로 처리.
  *
  * 저작권:
  *   © Matrox Electronic Systems Ltd., 1992-2025. All Rights Reserved
  */
 #include <mil.h>
 #include <stdlib.h>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "../../Common/CpuFeatures.h"
+#include "../../Common/WorkerPool.h"
 
 /* 로드할 이미지(10-bit 모노) */
 #define IMAGE_NAME      MIL_TEXT("ArmsMono10bit.mim")
 #define IMAGE_FILE      M_IMAGE_PATH IMAGE_NAME
 
-/* LUT 모양 그리기(성능↑) — 필요 시 M_NO */
+/* LUT 모양 그리기(그래픽 리스트) — 필요 시 M_NO */
 #define DRAW_LUT_SHAPE  M_YES
 
+/* 자동 윈도우/레벨 백분위(%) */
+#define AUTO_LOW_PERCENT    0.5
+#define AUTO_HIGH_PERCENT   99.5
+
+/* 헤드리스 실행 모드: 1이면 디스플레이 없이 실행
+   - MdispAlloc/MdispLut/마우스 훅 없음, 표시 버퍼는 M_DISP 없이 할당
+   - 8bit 출력 기준으로 자동 윈도우/레벨을 한 번 계산하고 LUT 모양은 그래픽 리스트에만 기록
+   - 키 대기는 막지 않음 */
+#include "../../Common/MilHeadless.h"
+#if MIL_HEADLESS
+#define HEADLESS_SIZE_BIT   8
+#endif
+
 /* 유틸 함수 및 매크로 */
 void DrawLutShape(MIL_ID MilDisplay,
-                  MIL_ID MilOriginalImage,
-                  MIL_ID MilImage,
+                  MIL_ID MilGraphicList,
+                  MIL_INT ImageSizeX,
+                  MIL_INT ImageSizeY,
                   MIL_INT Start,
                   MIL_INT End,
                   MIL_INT InflexionIntensity,
@@ -39,6 +71,89 @@ void DrawLutShape(MIL_ID MilDisplay,
 #define MosMin(a, b) (((a) < (b)) ? (a) : (b))
 #define MosMax(a, b) (((a) > (b)) ? (a) : (b))
 
+/* 3구간 윈도우/레벨 매핑값(MgenLutRamp 3회와 동일한 결과) */
+MIL_INT LutMappingValue(MIL_INT Index, MIL_INT Start, MIL_INT End, MIL_INT InflectionLevel,
+                        MIL_INT ImageMaxValue, MIL_INT DisplayMaxValue);
+
+/* 더블버퍼 LUT 관리자: 바뀐 구간만 뒤 LUT에 쓰고 MdispLut로 교체 */
+typedef struct
+{
+   MIL_ID               MilDisplay;
+   MIL_ID               MilLut[2];
+   MIL_INT              Front;               /* 디스플레이에 적용 중인 LUT */
+   MIL_INT              Params[2][3];        /* LUT별 Start/End/Inflection */
+   MIL_INT              ImageMaxValue;
+   MIL_INT              DisplayMaxValue;
+   MIL_INT              EntrySize;           /* 항목 바이트 수(1/2) */
+   std::vector<MIL_UINT8> Shadow[2];         /* LUT별 현재 내용의 호스트 사본 */
+
+   /* 통계 */
+   MIL_INT              NbUpdates;
+   MIL_INT              NbEntriesComputed;   /* 다시 계산한 항목 수 */
+   MIL_INT              NbEntriesWritten;    /* MbufPut1d로 전송한 항목 수 */
+   MIL_INT              NbPutCalls;
+   MIL_DOUBLE           UpdateTime;
+} LUT_MANAGER;
+
+void    LutManagerAlloc(MIL_ID MilSystem, MIL_ID MilDisplay, MIL_INT ImageMaxValue,
+                        MIL_INT DisplayMaxValue, LUT_MANAGER& Manager);
+MIL_INT LutManagerUpdate(LUT_MANAGER& Manager, MIL_INT Start, MIL_INT End, MIL_INT InflectionLevel);
+void    LutManagerFree(LUT_MANAGER& Manager);
+
+/* 키보드 루프와 마우스 훅이 공유하는 윈도우/레벨 상태 */
+typedef struct
+{
+   std::mutex   Lock;
+   LUT_MANAGER* Manager;
+   MIL_INT      Start, End, InflectionLevel;
+   MIL_INT      ImageMaxValue, DisplayMaxValue;
+   MIL_ID       MilDisplay, MilGraphicList;   /* LUT 모양 표시용 */
+   MIL_INT      ImageSizeX, ImageSizeY;
+   MIL_DOUBLE   ValuesPerPixel;   /* 드래그 1픽셀당 입력값 변화 */
+   bool         Dragging;
+   MIL_INT      DragX, DragY, DragStart, DragEnd;
+} LEVELING_STATE;
+
+void ClampWindow(LEVELING_STATE& State);
+MIL_INT MFTYPE MouseDragHook(MIL_INT HookType, MIL_ID EventId, void* HookDataPtr);
+
+/* 라이브 스트림용 레벨링 엔진: 16bit 입력 → 8bit 표시 버퍼 */
+typedef struct
+{
+   std::vector<MIL_INT32> Lut;      /* 입력값 → 출력값(gather용 32bit 항목) */
+   MIL_INT                LutMaxIndex;
+   MIL_INT                NbThreads;   /* 프레임을 나눌 행 구간 수(풀 크기 이하) */
+   MIL_ID                 MilLut;      /* 같은 매핑의 8bit MIL LUT(MimLutMap 대체 경로) */
+   WORKER_POOL            Pool;        /* 할당 시 생성되는 상주 작업자 */
+   bool                   UseAvx2;     /* 실행 시점 CPU 판별 결과 */
+   MIL_INT                NbFallbacks; /* MimLutMap으로 처리한 프레임 수 */
+} LEVELING_ENGINE;
+
+void LevelingEngineAlloc(MIL_ID MilSystem, LEVELING_ENGINE& Engine, MIL_INT LutMaxIndex, MIL_INT NbThreads);
+void LevelingEngineSetWindow(LEVELING_ENGINE& Engine, MIL_INT Start, MIL_INT End,
+                             MIL_INT InflectionLevel, MIL_INT ImageMaxValue);
+void LevelingEngineApply(LEVELING_ENGINE& Engine, MIL_ID MilSource16, MIL_ID MilDest8);
+void LevelingEngineFree(LEVELING_ENGINE& Engine);
+
+/* 병렬 히스토그램 작업자: 상주 풀 + 행 구간별 전용 빈(호출 간 재사용) */
+typedef struct
+{
+   WORKER_POOL             Pool;
+   std::vector<MIL_UINT32> PrivateBins;   /* 구간 수 × 빈 개수 */
+   std::vector<MIL_INT32>  MilBins;       /* MimHistogram 대체 경로 결과 */
+   MIL_INT                 NbFallbacks;   /* MimHistogram으로 처리한 호출 수 */
+} HISTOGRAM_WORKERS;
+
+void HistogramWorkersAlloc(HISTOGRAM_WORKERS& Workers, MIL_INT NbThreads);
+void HistogramWorkersFree(HISTOGRAM_WORKERS& Workers);
+void ParallelHistogram(HISTOGRAM_WORKERS& Workers, MIL_ID MilSource16, MIL_INT NbBins, MIL_INT NbThreads,
+                       MIL_INT Subsample, std::vector<MIL_UINT32>& Histogram);
+void PercentileWindow(const std::vector<MIL_UINT32>& Histogram, MIL_DOUBLE LowPercent,
+                      MIL_DOUBLE HighPercent, MIL_INT* StartPtr, MIL_INT* EndPtr);
+void AutoLevelingBenchmark(MIL_ID MilSystem, MIL_ID MilImage, MIL_INT ImageMaxValue);
+void LiveLevelingBenchmark(MIL_ID MilSystem, MIL_ID MilDisplay, MIL_ID MilImage,
+                           MIL_INT Start, MIL_INT End, MIL_INT InflectionLevel, MIL_INT ImageMaxValue);
+
 int MosMain(void)
 {
    /* 기본 MIL 자원 */
@@ -46,19 +161,29 @@ int MosMain(void)
    MIL_ID MilSystem;             /* 시스템 ID */
    MIL_ID MilDisplay;            /* 디스플레이 ID */
    MIL_ID MilImage;              /* 표시/처리용 이미지 버퍼 */
-   MIL_ID MilOriginalImage = 0;  /* LUT 모양 오버레이를 위한 원본 이미지 (지연 로드) */
-   MIL_ID MilLut;                /* LUT 버퍼 */
+   MIL_ID MilGraphicList;        /* LUT 모양 오버레이용 그래픽 리스트 */
+   LUT_MANAGER LutManager;       /* 더블버퍼 LUT */
+   LEVELING_STATE State;         /* 키보드/마우스 공유 상태 */
+   HISTOGRAM_WORKERS HistWorkers;   /* 자동 윈도우(A 키)용 히스토그램 작업자 */
 
    /* 영상/디스플레이 파라미터 */
    MIL_INT ImageSizeX, ImageSizeY, ImageMaxValue;
    MIL_INT DisplaySizeBit, DisplayMaxValue;
 
-   /* 윈도우/레벨 파라미터 */
-   MIL_INT Start, End, Step, InflectionLevel;
+   /* 윈도우/레벨 파라미터(마우스 훅과 공유) */
+   MIL_INT& Start = State.Start;
+   MIL_INT& End   = State.End;
+   MIL_INT& InflectionLevel = State.InflectionLevel;
+   MIL_INT Step;
    MIL_INT Ch;
 
-   /* 1) 애플리케이션/시스템/디스플레이 할당 */
+   /* 1) 애플리케이션/시스템/디스플레이 할당(헤드리스면 디스플레이 제외) */
+#if MIL_HEADLESS
+   MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem, M_NULL, M_NULL, M_NULL);
+   MilDisplay = M_NULL;
+#else
    MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem, &MilDisplay, M_NULL, M_NULL);
+#endif
 
    /* 2) 대상 이미지 로드 */
    MbufRestore(IMAGE_FILE, MilSystem, &MilImage);
@@ -74,10 +199,23 @@ int MosMain(void)
    MbufControl(MilImage, M_MAX, (MIL_DOUBLE)ImageMaxValue);
 
    /* 4) 디스플레이에 선택(별도 윈도우 쓰려면 MdispSelectWindow 사용) */
+#if !MIL_HEADLESS
    MdispSelect(MilDisplay, MilImage);
+#endif
+
+   /* LUT 모양은 디스플레이에 연결한 그래픽 리스트에 그림(영상 데이터 보존, LUT 영향 없음)
+      - 헤드리스: 리스트에만 기록(연결할 디스플레이 없음) */
+   MgraAllocList(MilSystem, M_DEFAULT, &MilGraphicList);
+#if !MIL_HEADLESS
+   MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, MilGraphicList);
+#endif
 
-   /* 5) 디스플레이 출력 비트 수 확인 → 최대 출력값 계산 */
+   /* 5) 디스플레이 출력 비트 수 확인 → 최대 출력값 계산(헤드리스: 8bit 출력 기준) */
+#if MIL_HEADLESS
+   DisplaySizeBit = HEADLESS_SIZE_BIT;
+#else
    MdispInquire(MilDisplay, M_SIZE_BIT, &DisplaySizeBit);
+#endif
    DisplayMaxValue = (1 << DisplaySizeBit) - 1;
 
    /* 안내 메시지 */
@@ -90,35 +228,53 @@ int MosMain(void)
    MosPrintf(MIL_TEXT("Image max  : %4d\n"),   (int)ImageMaxValue);
    MosPrintf(MIL_TEXT("Display max: %4d\n\n"), (int)DisplayMaxValue);
 
-   /* 6) LUT 버퍼 할당(길이: 이미지 최대값+1, 타입: 디스플레이 비트수 기준 8/16bit) */
-   MbufAlloc1d(MilSystem, ImageMaxValue + 1,
-               ((DisplaySizeBit > 8) ? 16 : 8) + M_UNSIGNED, M_LUT, &MilLut);
+   /* 6~8) 더블버퍼 LUT 할당(길이: 이미지 최대값+1, 타입: 디스플레이 비트수 기준 8/16bit)
+         → 두 LUT 모두 전체 범위 램프(0→DisplayMax)로 초기화 후 디스플레이에 적용 */
+#if !MIL_HEADLESS
+   LutManagerAlloc(MilSystem, MilDisplay, ImageMaxValue, DisplayMaxValue, LutManager);
+#else
+   LutManager.NbUpdates = 0;
+#endif
 
-   /* 7) 초기 LUT: 전체 범위 램프(0→DisplayMax) + LUT 최대값 등록 */
-   MgenLutRamp(MilLut, 0, 0, ImageMaxValue, (MIL_DOUBLE)DisplayMaxValue);
-   MbufControl(MilLut, M_MAX, (MIL_DOUBLE)DisplayMaxValue);
-
-   /* 8) 디스플레이에 LUT 적용 */
-   MdispLut(MilDisplay, MilLut);
+   HistogramWorkersAlloc(HistWorkers, (MIL_INT)std::thread::hardware_concurrency());
 
    /* 9) 조작 안내 */
    MosPrintf(MIL_TEXT("Keys assignment:\n\n"));
    MosPrintf(MIL_TEXT("Arrow keys :    Left=move Left, Right=move Right, Down=Narrower, Up=Wider.\n"));
-   MosPrintf(MIL_TEXT("Intensity keys: L=Lower,  U=Upper,  R=Reset.\n"));
+   MosPrintf(MIL_TEXT("Intensity keys: L=Lower,  U=Upper,  R=Reset,  A=Auto (%.1f%% - %.1f%%).\n"),
+             AUTO_LOW_PERCENT, AUTO_HIGH_PERCENT);
+   MosPrintf(MIL_TEXT("Mouse drag :    Left/Right=level, Up/Down=window width.\n"));
    MosPrintf(MIL_TEXT("Press any key to end.\n\n"));
 
-   /* 10) 인터랙티브 윈도우/레벨 조정 루프 */
-   Ch = 0;
+   /* 10) 인터랙티브 윈도우/레벨 조정 루프
+         - 헤드리스: 자동 윈도우(A)를 한 번 계산하고, 눌린 키가 없으면 바로 종료 */
+   Ch = MIL_HEADLESS ? 'A' : 0;
    Start = 0;
    End   = ImageMaxValue;
    InflectionLevel = DisplayMaxValue;
 
+   State.Manager         = &LutManager;
+   State.ImageMaxValue   = ImageMaxValue;
+   State.DisplayMaxValue = DisplayMaxValue;
+   State.MilDisplay      = MilDisplay;
+   State.MilGraphicList  = MilGraphicList;
+   State.ImageSizeX      = ImageSizeX;
+   State.ImageSizeY      = ImageSizeY;
+   State.ValuesPerPixel  = (MIL_DOUBLE)(ImageMaxValue + 1) / (MIL_DOUBLE)ImageSizeX;
+   State.Dragging        = false;
+#if !MIL_HEADLESS
+   MdispHookFunction(MilDisplay, M_MOUSE_LEFT_BUTTON_DOWN, MouseDragHook, &State);
+   MdispHookFunction(MilDisplay, M_MOUSE_MOVE,             MouseDragHook, &State);
+   MdispHookFunction(MilDisplay, M_MOUSE_LEFT_BUTTON_UP,   MouseDragHook, &State);
+#endif
+
    /* Step: 영상 다이내믹 레인지에 비례하게 설정(최소 4) */
    Step = (ImageMaxValue + 1) / 128;
    Step = MosMax(Step, 4);
 
    while (Ch != '\r')  /* Enter로 종료 */
    {
+      std::unique_lock<std::mutex> Guard(State.Lock);
       switch (Ch)
       {
       /* ←: 윈도우 좌로 이동 */
@@ -138,75 +294,103 @@ int MosMain(void)
       /* R: 초기화 */
       case 'R':
       case 'r': { Start = 0; End = ImageMaxValue; InflectionLevel = DisplayMaxValue; break; }
+      /* A: 히스토그램 백분위 기반 자동 윈도우 */
+      case 'A':
+      case 'a':
+         {
+         std::vector<MIL_UINT32> Histogram;
+         ParallelHistogram(HistWorkers, MilImage, ImageMaxValue + 1, WorkerPoolSize(HistWorkers.Pool), 1, Histogram);
+         PercentileWindow(Histogram, AUTO_LOW_PERCENT, AUTO_HIGH_PERCENT, &Start, &End);
+         InflectionLevel = DisplayMaxValue;
+         break;
+         }
       }
 
       /* 10-1) 범위 포화(Clamp) — 인덱스/레벨 모두 유효 범위 유지 */
-      End   = MosMin(End, ImageMaxValue);
-      Start = MosMin(Start, End);
-      End   = MosMax(End, Start);
-      Start = MosMax(Start, 0);
-      End   = MosMax(End, 0);
-      InflectionLevel = MosMax(InflectionLevel, 0);
-      InflectionLevel = MosMin(InflectionLevel, DisplayMaxValue);
+      ClampWindow(State);
 
       MosPrintf(MIL_TEXT("Inflection points: Low=(%d,0), High=(%d,%d).   \r"),
-                (int)Start, (int)End, InflectionLevel);
+                (int)Start, (int)End, (int)InflectionLevel);
 
-      /* 10-2) 3구간 LUT 생성: [0~Start], [Start~End], [End~Max] */
-      MgenLutRamp(MilLut, 0, 0, Start, 0);  /* 좌측 포화 */
-      MgenLutRamp(MilLut, Start, 0, End, (MIL_DOUBLE)InflectionLevel); /* 윈도우 구간 */
-      MgenLutRamp(MilLut, End, (MIL_DOUBLE)InflectionLevel, ImageMaxValue, (MIL_DOUBLE)DisplayMaxValue); /* 우측 포화 */
+      /* 10-2,3) 3구간 LUT 중 바뀐 항목만 뒤 LUT에 쓰고 교체 적용 */
+#if !MIL_HEADLESS
+      LutManagerUpdate(LutManager, Start, End, InflectionLevel);
+#endif
 
-      /* 10-3) LUT 적용 */
-      MdispLut(MilDisplay, MilLut);
-
-      /* 10-4) (옵션) LUT 모양을 영상 위에 그려 시각화 — 성능 비용 큼 */
+      /* 10-4) (옵션) LUT 모양을 그래픽 리스트에 다시 그림 */
       if (DRAW_LUT_SHAPE)
       {
-         if (!MilOriginalImage)
-            MbufRestore(IMAGE_FILE, MilSystem, &MilOriginalImage);
-
-         DrawLutShape(MilDisplay, MilOriginalImage, MilImage,
+         DrawLutShape(MilDisplay, MilGraphicList, ImageSizeX, ImageSizeY,
                       Start, End, InflectionLevel, ImageMaxValue, DisplayMaxValue);
       }
+      Guard.unlock();
 
       /* 10-5) 특수키(화살표) 처리: 0xE0 접두어 다음 코드 읽기 */
-      if ((Ch = MosGetch()) == 0xE0)
-         Ch = MosGetch();
+      if ((Ch = WaitForKey('\r')) == 0xE0)
+         Ch = WaitForKey('\r');
    }
+#if !MIL_HEADLESS
+   MdispHookFunction(MilDisplay, M_MOUSE_LEFT_BUTTON_DOWN + M_UNHOOK, MouseDragHook, &State);
+   MdispHookFunction(MilDisplay, M_MOUSE_MOVE + M_UNHOOK,             MouseDragHook, &State);
+   MdispHookFunction(MilDisplay, M_MOUSE_LEFT_BUTTON_UP + M_UNHOOK,   MouseDragHook, &State);
+#endif
    MosPrintf(MIL_TEXT("\n\n"));
 
-   /* 11) 자원 해제 */
-   MbufFree(MilLut);
+   /* LUT 갱신 통계 */
+   if (LutManager.NbUpdates > 0)
+   {
+      MosPrintf(MIL_TEXT("LUT updates: %d, average entries recomputed: %.0f, written: %.0f of %d ")
+                MIL_TEXT("(%.1f MbufPut1d calls), average update: %.3f ms\n\n"),
+                (int)LutManager.NbUpdates,
+                (MIL_DOUBLE)LutManager.NbEntriesComputed / LutManager.NbUpdates,
+                (MIL_DOUBLE)LutManager.NbEntriesWritten / LutManager.NbUpdates,
+                (int)(ImageMaxValue + 1),
+                (MIL_DOUBLE)LutManager.NbPutCalls / LutManager.NbUpdates,
+                LutManager.UpdateTime * 1000.0 / LutManager.NbUpdates);
+   }
+
+   /* 벤치마크 중에는 LUT 모양을 숨김 */
+   MgraClear(M_DEFAULT, MilGraphicList);
+
+   /* 11) 현재 윈도우/레벨로 라이브 스트림 레벨링 처리량 측정 */
+   LiveLevelingBenchmark(MilSystem, MilDisplay, MilImage,
+                         Start, End, InflectionLevel, ImageMaxValue);
+
+   /* 12) 히스토그램 기반 자동 윈도우/레벨 비용 측정 */
+   AutoLevelingBenchmark(MilSystem, MilImage, ImageMaxValue);
+
+   /* 13) 자원 해제 */
+   HistogramWorkersFree(HistWorkers);
+#if !MIL_HEADLESS
+   LutManagerFree(LutManager);
+   MdispControl(MilDisplay, M_ASSOCIATED_GRAPHIC_LIST_ID, M_NULL);
+#endif
+   MgraFree(MilGraphicList);
    MbufFree(MilImage);
-   if (MilOriginalImage)
-      MbufFree(MilOriginalImage);
    MappFreeDefault(MilApplication, MilSystem, MilDisplay, M_NULL, M_NULL);
 
    return 0;
 }
 
 /* ------------------------------------------------------------------------------------
- * DrawLutShape: 현재 LUT의 형태를 영상에 그려 시각화
- *  - 단순 주석(Annotation) 방식: 매번 전체 이미지를 다시 칠해 CPU 비용 큼(성능 주의)
+ * DrawLutShape: 현재 LUT의 형태를 그래픽 리스트에 그려 시각화
+ *  - 리스트만 비우고 다시 그림: 영상 복사 없음, 비용은 주석 개수에 비례
+ *  - 리스트 갱신을 잠시 멈춰 비운 상태가 화면에 보이지 않도록 함(깜빡임 방지)
+ *  - MilDisplay가 M_NULL(헤드리스)이면 리스트에만 기록
  * ------------------------------------------------------------------------------------ */
 void DrawLutShape(MIL_ID MilDisplay,
-                  MIL_ID MilOriginalImage,
-                  MIL_ID MilImage,
+                  MIL_ID MilGraphicList,
+                  MIL_INT ImageSizeX,
+                  MIL_INT ImageSizeY,
                   MIL_INT Start,
                   MIL_INT End,
                   MIL_INT InflexionIntensity,
                   MIL_INT ImageMaxValue,
                   MIL_INT DisplayMaxValue)
 {
-   MIL_INT        ImageSizeX, ImageSizeY;
    MIL_DOUBLE     Xstart, Xend, Xstep, Ymin, Yinf, Ymax, Ystep;
    MIL_TEXT_CHAR  String[8];
 
-   /* 크기 질의 */
-   MbufInquire(MilImage, M_SIZE_X, &ImageSizeX);
-   MbufInquire(MilImage, M_SIZE_Y, &ImageSizeY);
-
    /* 좌표 변환 파라미터 계산
       - X축: 입력(이미지) 값 범위를 화면 너비로 스케일
       - Y축: 출력(디스플레이) 값을 화면 높이의 하단 1/4에 스케일 (아래로 갈수록 값 큼) */
@@ -218,25 +402,814 @@ void DrawLutShape(MIL_ID MilDisplay,
    Yinf   = Ymin - (InflexionIntensity * Ystep);          /* 인플렉션 출력 위치 */
    Ymax   = Ymin - (DisplayMaxValue   * Ystep);           /* 상단(최대 출력) */
 
-   /* 성능 향상을 위해 모든 주석 완료까지 디스플레이 갱신 비활성 */
-   MdispControl(MilDisplay, M_UPDATE, M_DISABLE);
+   /* 모든 주석 완료까지 그래픽 리스트 갱신 비활성 */
+   if (MilDisplay)
+      MdispControl(MilDisplay, M_UPDATE_GRAPHIC_LIST, M_DISABLE);
 
-   /* 원본 영상 복원(이전 라인 지우기) */
-   MbufCopy(MilOriginalImage, MilImage);
+   /* 이전 곡선 지우기(리스트만 비움) */
+   MgraClear(M_DEFAULT, MilGraphicList);
 
    /* 축 레이블/눈금 텍스트 */
-   MgraControl(M_DEFAULT, M_COLOR, (MIL_DOUBLE)ImageMaxValue);
-   MgraText(M_DEFAULT, MilImage, 4, (MIL_INT)Ymin - 22, MIL_TEXT("0"));
+   MgraControl(M_DEFAULT, M_COLOR, M_COLOR_WHITE);
+   MgraText(M_DEFAULT, MilGraphicList, 4, (MIL_INT)Ymin - 22, MIL_TEXT("0"));
    MosSprintf(String, 8, MIL_TEXT("%d"), (int)DisplayMaxValue);
-   MgraText(M_DEFAULT, MilImage, 4, (MIL_INT)Ymax - 16, String);
+   MgraText(M_DEFAULT, MilGraphicList, 4, (MIL_INT)Ymax - 16, String);
    MosSprintf(String, 8, MIL_TEXT("%d"), (int)ImageMaxValue);
-   MgraText(M_DEFAULT, MilImage, ImageSizeX - 38, (MIL_INT)Ymin - 22, String);
+   MgraText(M_DEFAULT, MilGraphicList, ImageSizeX - 38, (MIL_INT)Ymin - 22, String);
 
    /* LUT 모양(3구간) 그리기: X=입력(이미지 값), Y=출력(디스플레이 값) */
-   MgraLine(M_DEFAULT, MilImage, 0, (MIL_INT)Ymin, (MIL_INT)Xstart, (MIL_INT)Ymin);
-   MgraLine(M_DEFAULT, MilImage, (MIL_INT)Xstart, (MIL_INT)Ymin, (MIL_INT)Xend, (MIL_INT)Yinf);
-   MgraLine(M_DEFAULT, MilImage, (MIL_INT)Xend, (MIL_INT)Yinf, ImageSizeX - 1, (MIL_INT)Ymax);
+   MgraLine(M_DEFAULT, MilGraphicList, 0, (MIL_INT)Ymin, (MIL_INT)Xstart, (MIL_INT)Ymin);
+   MgraLine(M_DEFAULT, MilGraphicList, (MIL_INT)Xstart, (MIL_INT)Ymin, (MIL_INT)Xend, (MIL_INT)Yinf);
+   MgraLine(M_DEFAULT, MilGraphicList, (MIL_INT)Xend, (MIL_INT)Yinf, ImageSizeX - 1, (MIL_INT)Ymax);
 
    /* 갱신 재개 */
-   MdispControl(MilDisplay, M_UPDATE, M_ENABLE);
-}
\ No newline at end of file
+   if (MilDisplay)
+      MdispControl(MilDisplay, M_UPDATE_GRAPHIC_LIST, M_ENABLE);
+}
+
+/* ------------------------------------------------------------------------------------
+ * LutMappingValue: [0~Start]=0, [Start~End]=0→Inflection, [End~Max]=Inflection→DisplayMax
+ *  - MgenLutRamp 3회 호출 순서(뒤 구간이 경계값을 덮어씀)와 같은 값을 계산
+ * ------------------------------------------------------------------------------------ */
+MIL_INT LutMappingValue(MIL_INT Index, MIL_INT Start, MIL_INT End, MIL_INT InflectionLevel,
+                        MIL_INT ImageMaxValue, MIL_INT DisplayMaxValue)
+{
+   if (Index >= End)
+   {
+      if (ImageMaxValue <= End)
+         return InflectionLevel;
+      return InflectionLevel + ((DisplayMaxValue - InflectionLevel) * (Index - End) +
+                                (ImageMaxValue - End) / 2) / (ImageMaxValue - End);
+   }
+   if (Index > Start)
+      return (InflectionLevel * (Index - Start) + (End - Start) / 2) / (End - Start);
+   return 0;
+}
+
+/* ------------------------------------------------------------------------------------
+ * LUT 관리자
+ *  - LUT 2개를 번갈아 사용: 디스플레이가 쓰는(앞) LUT는 건드리지 않고 뒤 LUT만 갱신
+ *  - 뒤 LUT가 마지막으로 담은 파라미터와 새 파라미터를 비교해 구간별 후보 범위를 구함
+ *      · min(Start) 이하 항목은 양쪽 모두 0 → 불변
+ *      · Start/End/Inflection 중 하나라도 다르면 램프 구간 (min Start, max End]
+ *      · End/Inflection이 다르면 상단 램프 구간 [min End, Max]
+ *  - 후보 범위 안에서도 호스트 사본과 값이 같은 항목은 건너뛰고, 다른 항목 묶음만 전송
+ *    (LUT_RUN_MAX_GAP 이하로 떨어진 묶음은 MbufPut1d 1회로 합침)
+ * ------------------------------------------------------------------------------------ */
+#define LUT_RUN_MAX_GAP     32
+
+/* [First, Last]를 다시 계산해 사본과 다른 항목만 MilLut에 기록. 반환: 전송 항목 수 */
+template <class T>
+static MIL_INT LutWriteChanged(LUT_MANAGER& Manager, MIL_INT Back, MIL_INT First, MIL_INT Last,
+                               MIL_INT Start, MIL_INT End, MIL_INT InflectionLevel)
+{
+   T*      Shadow = (T*)&Manager.Shadow[Back][0];
+   MIL_INT NbWritten = 0, RunFirst = -1, RunLast = -1;
+
+   for (MIL_INT i = First; i <= Last; i++)
+   {
+      T Value = (T)LutMappingValue(i, Start, End, InflectionLevel,
+                                   Manager.ImageMaxValue, Manager.DisplayMaxValue);
+      if (Value == Shadow[i])
+         continue;
+      Shadow[i] = Value;
+
+      /* 앞 묶음과 멀리 떨어졌으면 앞 묶음 전송 후 새 묶음 시작 */
+      if (RunFirst >= 0 && i - RunLast > LUT_RUN_MAX_GAP)
+      {
+         MbufPut1d(Manager.MilLut[Back], RunFirst, RunLast - RunFirst + 1, Shadow + RunFirst);
+         NbWritten += RunLast - RunFirst + 1;
+         Manager.NbPutCalls++;
+         RunFirst = -1;
+      }
+      if (RunFirst < 0)
+         RunFirst = i;
+      RunLast = i;
+   }
+   if (RunFirst >= 0)
+   {
+      MbufPut1d(Manager.MilLut[Back], RunFirst, RunLast - RunFirst + 1, Shadow + RunFirst);
+      NbWritten += RunLast - RunFirst + 1;
+      Manager.NbPutCalls++;
+   }
+   Manager.NbEntriesComputed += Last - First + 1;
+   return NbWritten;
+}
+
+void LutManagerAlloc(MIL_ID MilSystem, MIL_ID MilDisplay, MIL_INT ImageMaxValue,
+                     MIL_INT DisplayMaxValue, LUT_MANAGER& Manager)
+{
+   Manager.MilDisplay       = MilDisplay;
+   Manager.ImageMaxValue    = ImageMaxValue;
+   Manager.DisplayMaxValue  = DisplayMaxValue;
+   Manager.EntrySize        = (DisplayMaxValue > 255) ? 2 : 1;
+   Manager.Front            = 0;
+   Manager.NbUpdates         = 0;
+   Manager.NbEntriesComputed = 0;
+   Manager.NbEntriesWritten  = 0;
+   Manager.NbPutCalls        = 0;
+   Manager.UpdateTime        = 0.0;
+
+   for (MIL_INT b = 0; b < 2; b++)
+   {
+      MbufAlloc1d(MilSystem, ImageMaxValue + 1, 8 * Manager.EntrySize + M_UNSIGNED, M_LUT, &Manager.MilLut[b]);
+      MgenLutRamp(Manager.MilLut[b], 0, 0, ImageMaxValue, (MIL_DOUBLE)DisplayMaxValue);
+      MbufControl(Manager.MilLut[b], M_MAX, (MIL_DOUBLE)DisplayMaxValue);
+      Manager.Shadow[b].resize((ImageMaxValue + 1) * Manager.EntrySize);
+      MbufGet1d(Manager.MilLut[b], 0, ImageMaxValue + 1, &Manager.Shadow[b][0]);
+      Manager.Params[b][0] = 0;
+      Manager.Params[b][1] = ImageMaxValue;
+      Manager.Params[b][2] = DisplayMaxValue;
+   }
+   MdispLut(MilDisplay, Manager.MilLut[Manager.Front]);
+}
+
+/* 반환: 이번 갱신에서 쓴 항목 수(0이면 변화 없음) */
+MIL_INT LutManagerUpdate(LUT_MANAGER& Manager, MIL_INT Start, MIL_INT End, MIL_INT InflectionLevel)
+{
+   const MIL_INT* FrontParams = Manager.Params[Manager.Front];
+   if (FrontParams[0] == Start && FrontParams[1] == End && FrontParams[2] == InflectionLevel)
+      return 0;
+
+   MIL_DOUBLE StartTime, EndTime;
+   MappTimer(M_DEFAULT, M_TIMER_READ, &StartTime);
+
+   /* 뒤 LUT의 현재 내용 대비 구간별 후보 범위: 램프 [RampFirst, RampLast], 상단 [UpperFirst, Max] */
+   MIL_INT  Back = 1 - Manager.Front;
+   MIL_INT* BackParams = Manager.Params[Back];
+   bool     RampChanged  = (BackParams[0] != Start || BackParams[1] != End || BackParams[2] != InflectionLevel);
+   bool     UpperChanged = (BackParams[1] != End || BackParams[2] != InflectionLevel);
+   MIL_INT  RampFirst  = MosMin(BackParams[0], Start) + 1;
+   MIL_INT  RampLast   = MosMax(BackParams[1], End);
+   MIL_INT  UpperFirst = MosMin(BackParams[1], End);
+   MIL_INT  NbEntries  = 0;
+
+   if (UpperChanged && RampChanged && UpperFirst <= RampLast + 1)
+   {
+      /* 두 범위가 이어지면 한 번에 처리 */
+      RampLast = Manager.ImageMaxValue;
+      UpperChanged = false;
+   }
+   for (MIL_INT Range = 0; Range < 2; Range++)
+   {
+      MIL_INT First = (Range == 0) ? RampFirst : UpperFirst;
+      MIL_INT Last  = (Range == 0) ? MosMin(RampLast, Manager.ImageMaxValue) : Manager.ImageMaxValue;
+      if (!((Range == 0) ? RampChanged : UpperChanged) || First > Last)
+         continue;
+      if (Manager.EntrySize == 2)
+         NbEntries += LutWriteChanged<MIL_UINT16>(Manager, Back, First, Last, Start, End, InflectionLevel);
+      else
+         NbEntries += LutWriteChanged<MIL_UINT8>(Manager, Back, First, Last, Start, End, InflectionLevel);
+   }
+   BackParams[0] = Start;
+   BackParams[1] = End;
+   BackParams[2] = InflectionLevel;
+
+   /* 완성된 뒤 LUT를 디스플레이에 적용 후 앞/뒤 교체 */
+   MdispLut(Manager.MilDisplay, Manager.MilLut[Back]);
+   Manager.Front = Back;
+
+   MappTimer(M_DEFAULT, M_TIMER_READ, &EndTime);
+   Manager.NbUpdates++;
+   Manager.NbEntriesWritten += NbEntries;
+   Manager.UpdateTime += EndTime - StartTime;
+   return NbEntries;
+}
+
+void LutManagerFree(LUT_MANAGER& Manager)
+{
+   MdispLut(Manager.MilDisplay, M_DEFAULT);
+   MbufFree(Manager.MilLut[0]);
+   MbufFree(Manager.MilLut[1]);
+}
+
+/* 윈도우/레벨 범위 포화(Clamp) */
+void ClampWindow(LEVELING_STATE& State)
+{
+   State.End   = MosMin(State.End, State.ImageMaxValue);
+   State.Start = MosMin(State.Start, State.End);
+   State.End   = MosMax(State.End, State.Start);
+   State.Start = MosMax(State.Start, 0);
+   State.End   = MosMax(State.End, 0);
+   State.InflectionLevel = MosMax(State.InflectionLevel, 0);
+   State.InflectionLevel = MosMin(State.InflectionLevel, State.DisplayMaxValue);
+}
+
+/* ------------------------------------------------------------------------------------
+ * MouseDragHook: 왼쪽 버튼 드래그로 윈도우/레벨 조정
+ *  - 좌우 이동: 윈도우 중심(레벨) 이동, 상하 이동: 윈도우 폭 변경(위로 넓힘)
+ * ------------------------------------------------------------------------------------ */
+MIL_INT MFTYPE MouseDragHook(MIL_INT HookType, MIL_ID EventId, void* HookDataPtr)
+{
+   LEVELING_STATE* State = (LEVELING_STATE*)HookDataPtr;
+   MIL_INT MouseX, MouseY;
+
+   MdispGetHookInfo(EventId, M_MOUSE_POSITION_X, &MouseX);
+   MdispGetHookInfo(EventId, M_MOUSE_POSITION_Y, &MouseY);
+
+   std::lock_guard<std::mutex> Guard(State->Lock);
+   if (HookType == M_MOUSE_LEFT_BUTTON_DOWN)
+   {
+      State->Dragging  = true;
+      State->DragX     = MouseX;
+      State->DragY     = MouseY;
+      State->DragStart = State->Start;
+      State->DragEnd   = State->End;
+   }
+   else if (HookType == M_MOUSE_LEFT_BUTTON_UP)
+   {
+      State->Dragging = false;
+   }
+   else if (State->Dragging)
+   {
+      MIL_INT Level = (MIL_INT)((MouseX - State->DragX) * State->ValuesPerPixel);
+      MIL_INT Width = (MIL_INT)((State->DragY - MouseY) * State->ValuesPerPixel);
+      State->Start = State->DragStart + Level - Width / 2;
+      State->End   = State->DragEnd   + Level + Width / 2;
+      ClampWindow(*State);
+
+      MosPrintf(MIL_TEXT("Inflection points: Low=(%d,0), High=(%d,%d).   \r"),
+                (int)State->Start, (int)State->End, (int)State->InflectionLevel);
+      LutManagerUpdate(*State->Manager, State->Start, State->End, State->InflectionLevel);
+      if (DRAW_LUT_SHAPE)
+      {
+         DrawLutShape(State->MilDisplay, State->MilGraphicList, State->ImageSizeX, State->ImageSizeY,
+                      State->Start, State->End, State->InflectionLevel,
+                      State->ImageMaxValue, State->DisplayMaxValue);
+      }
+   }
+   return 0;
+}
+
+/* ------------------------------------------------------------------------------------
+ * 라이브 레벨링 엔진
+ *  - LUT는 32bit 항목으로 보관(AVX2 gather가 32bit 단위로 읽음), 출력은 0~255
+ *  - 프레임을 행 구간으로 나눠 상주 풀의 스레드마다 16→8bit 룩업 수행
+ *  - AVX2 커널은 CpuHasAvx2()가 참일 때만 호출(빌드 옵션과 무관)
+ * ------------------------------------------------------------------------------------ */
+#define LEVELING_DISPLAY_MAX    255
+
+void LevelingEngineAlloc(MIL_ID MilSystem, LEVELING_ENGINE& Engine, MIL_INT LutMaxIndex, MIL_INT NbThreads)
+{
+   Engine.LutMaxIndex = LutMaxIndex;
+   Engine.NbThreads   = MosMax(NbThreads, 1);
+   Engine.UseAvx2     = CpuHasAvx2();
+   Engine.NbFallbacks = 0;
+   Engine.Lut.assign(LutMaxIndex + 1, 0);
+   MbufAlloc1d(MilSystem, LutMaxIndex + 1, 8 + M_UNSIGNED, M_LUT, &Engine.MilLut);
+   MbufClear(Engine.MilLut, 0);
+   WorkerPoolAlloc(Engine.Pool, Engine.NbThreads);
+}
+
+void LevelingEngineSetWindow(LEVELING_ENGINE& Engine, MIL_INT Start, MIL_INT End,
+                             MIL_INT InflectionLevel, MIL_INT ImageMaxValue)
+{
+   /* InflectionLevel은 8bit 출력 기준 */
+   std::vector<MIL_UINT8> Lut8(Engine.LutMaxIndex + 1);
+   for (MIL_INT i = 0; i <= Engine.LutMaxIndex; i++)
+   {
+      MIL_INT Index = MosMin(i, ImageMaxValue);
+      Engine.Lut[i] = (MIL_INT32)LutMappingValue(Index, Start, End, InflectionLevel,
+                                                 ImageMaxValue, LEVELING_DISPLAY_MAX);
+      Lut8[i] = (MIL_UINT8)Engine.Lut[i];
+   }
+   MbufPut1d(Engine.MilLut, 0, Engine.LutMaxIndex + 1, &Lut8[0]);
+}
+
+/* 한 행 구간 룩업(스칼라): [StartY, EndY) */
+static void LevelingRows(const LEVELING_ENGINE* Engine,
+                         const MIL_UINT8* SrcBase, MIL_INT SrcPitchByte,
+                         MIL_UINT8* DstBase, MIL_INT DstPitchByte,
+                         MIL_INT SizeX, MIL_INT StartY, MIL_INT EndY)
+{
+   const MIL_INT32* Lut = &Engine->Lut[0];
+   MIL_UINT16       MaxIndex = (MIL_UINT16)Engine->LutMaxIndex;
+
+   for (MIL_INT y = StartY; y < EndY; y++)
+   {
+      const MIL_UINT16* Src = (const MIL_UINT16*)(SrcBase + y * SrcPitchByte);
+      MIL_UINT8*        Dst = DstBase + y * DstPitchByte;
+      for (MIL_INT x = 0; x < SizeX; x++)
+         Dst[x] = (MIL_UINT8)Lut[MosMin(Src[x], MaxIndex)];
+   }
+}
+
+#if CPU_HAS_AVX2_KERNEL
+/* 한 행 구간 룩업(AVX2): 16픽셀 단위 gather, 나머지는 스칼라 */
+AVX2_TARGET static void LevelingRowsAvx2(const LEVELING_ENGINE* Engine,
+                                         const MIL_UINT8* SrcBase, MIL_INT SrcPitchByte,
+                                         MIL_UINT8* DstBase, MIL_INT DstPitchByte,
+                                         MIL_INT SizeX, MIL_INT StartY, MIL_INT EndY)
+{
+   const MIL_INT32* Lut = &Engine->Lut[0];
+   MIL_UINT16       MaxIndex = (MIL_UINT16)Engine->LutMaxIndex;
+   const __m256i    MaxIndexVec = _mm256_set1_epi16((short)MaxIndex);
+
+   for (MIL_INT y = StartY; y < EndY; y++)
+   {
+      const MIL_UINT16* Src = (const MIL_UINT16*)(SrcBase + y * SrcPitchByte);
+      MIL_UINT8*        Dst = DstBase + y * DstPitchByte;
+      MIL_INT x = 0;
+
+      /* 인덱스 포화 → 32bit 확장 → gather 2회 → 8bit로 압축 */
+      for (; x + 16 <= SizeX; x += 16)
+      {
+         __m256i Index16 = _mm256_min_epu16(_mm256_loadu_si256((const __m256i*)(Src + x)), MaxIndexVec);
+         __m256i IndexLo = _mm256_cvtepu16_epi32(_mm256_castsi256_si128(Index16));
+         __m256i IndexHi = _mm256_cvtepu16_epi32(_mm256_extracti128_si256(Index16, 1));
+         __m256i ValueLo = _mm256_i32gather_epi32((const int*)Lut, IndexLo, 4);
+         __m256i ValueHi = _mm256_i32gather_epi32((const int*)Lut, IndexHi, 4);
+
+         /* packus는 128bit 레인 단위로 섞이므로 64bit 순서를 재배치 */
+         __m256i Value16 = _mm256_permute4x64_epi64(_mm256_packus_epi32(ValueLo, ValueHi), 0xD8);
+         __m256i Value8  = _mm256_permute4x64_epi64(_mm256_packus_epi16(Value16, Value16), 0x08);
+         _mm_storeu_si128((__m128i*)(Dst + x), _mm256_castsi256_si128(Value8));
+      }
+      for (; x < SizeX; x++)
+         Dst[x] = (MIL_UINT8)Lut[MosMin(Src[x], MaxIndex)];
+   }
+}
+#endif
+
+/* CPU에 맞는 커널로 한 행 구간 처리 */
+static void LevelingBand(const LEVELING_ENGINE* Engine,
+                         const MIL_UINT8* SrcBase, MIL_INT SrcPitchByte,
+                         MIL_UINT8* DstBase, MIL_INT DstPitchByte,
+                         MIL_INT SizeX, MIL_INT StartY, MIL_INT EndY)
+{
+#if CPU_HAS_AVX2_KERNEL
+   if (Engine->UseAvx2)
+   {
+      LevelingRowsAvx2(Engine, SrcBase, SrcPitchByte, DstBase, DstPitchByte, SizeX, StartY, EndY);
+      return;
+   }
+#endif
+   LevelingRows(Engine, SrcBase, SrcPitchByte, DstBase, DstPitchByte, SizeX, StartY, EndY);
+}
+
+void LevelingEngineApply(LEVELING_ENGINE& Engine, MIL_ID MilSource16, MIL_ID MilDest8)
+{
+   MIL_INT SizeX = MosMin(MbufInquire(MilSource16, M_SIZE_X, M_NULL), MbufInquire(MilDest8, M_SIZE_X, M_NULL));
+   MIL_INT SizeY = MosMin(MbufInquire(MilSource16, M_SIZE_Y, M_NULL), MbufInquire(MilDest8, M_SIZE_Y, M_NULL));
+   const MIL_UINT8* SrcBase = (const MIL_UINT8*)MbufInquire(MilSource16, M_HOST_ADDRESS, M_NULL);
+   MIL_UINT8*       DstBase = (MIL_UINT8*)MbufInquire(MilDest8, M_HOST_ADDRESS, M_NULL);
+   MIL_INT SrcPitchByte = MbufInquire(MilSource16, M_PITCH_BYTE, M_NULL);
+   MIL_INT DstPitchByte = MbufInquire(MilDest8,    M_PITCH_BYTE, M_NULL);
+
+   /* 호스트 메모리에 없거나(보드 메모리 등) 16→8bit가 아니면 MIL LUT 경로 */
+   if (SrcBase == M_NULL || DstBase == M_NULL ||
+       MbufInquire(MilSource16, M_SIZE_BIT, M_NULL) != 16 ||
+       MbufInquire(MilDest8,    M_SIZE_BIT, M_NULL) != 8)
+   {
+      MimLutMap(MilSource16, MilDest8, Engine.MilLut);
+      Engine.NbFallbacks++;
+      return;
+   }
+
+   /* 행 구간 분할 → 상주 풀에서 처리(구간 1개면 호출 스레드에서 바로 실행) */
+   MIL_INT NbBands = MosMin(Engine.NbThreads, WorkerPoolSize(Engine.Pool));
+   MIL_INT RowsPerBand = (SizeY + NbBands - 1) / NbBands;
+   const LEVELING_ENGINE* EnginePtr = &Engine;
+   WorkerPoolRun(Engine.Pool, (SizeY + RowsPerBand - 1) / RowsPerBand, [=](MIL_INT Band)
+      { LevelingBand(EnginePtr, SrcBase, SrcPitchByte, DstBase, DstPitchByte, SizeX,
+                     Band * RowsPerBand, MosMin((Band + 1) * RowsPerBand, SizeY)); });
+}
+
+void LevelingEngineFree(LEVELING_ENGINE& Engine)
+{
+   WorkerPoolFree(Engine.Pool);
+   MbufFree(Engine.MilLut);
+}
+
+/* ------------------------------------------------------------------------------------
+ * LiveLevelingBenchmark: 고비트 라이브 스트림(시뮬) 레벨링 처리량 비교
+ *  - 프레임: 원본을 LIVE 크기/비트수로 확대 후 위치를 조금씩 바꿔 여러 장 생성
+ *  - 비교: 엔진(1스레드/전체), MimLutMap(16→8bit), MdispLut(디스플레이 LUT 경로)
+ *  - 디스플레이 지원 비용: 실제 라이브 루프(엔진 → 표시 버퍼 갱신 알림)를 표시 버퍼가
+ *    선택된 상태와 선택 해제된 상태로 실행해 비교(워밍업 후 라운드마다 순서를 번갈아 평균)
+ * ------------------------------------------------------------------------------------ */
+#define LIVE_SIZE_X          2048
+#define LIVE_SIZE_Y          2048
+#define LIVE_SIZE_BIT        12
+#define LIVE_NB_FRAMES       8
+#define LIVE_NB_LOOP         200
+#define LIVE_TARGET_FPS      200.0
+#define LIVE_NB_ROUND        2
+
+/* 라이브 루프: 프레임마다 엔진으로 레벨링한 뒤 표시 버퍼 변경을 알림
+   (호스트 포인터 쓰기는 MIL이 모르므로 M_MODIFIED로 화면 갱신을 요청) */
+static MIL_DOUBLE TimeLiveLoop(LEVELING_ENGINE& Engine, const MIL_ID* MilFrames, MIL_ID MilDisplay8)
+{
+   MIL_DOUBLE Time;
+
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (MIL_INT n = 0; n < LIVE_NB_LOOP; n++)
+   {
+      LevelingEngineApply(Engine, MilFrames[n % LIVE_NB_FRAMES], MilDisplay8);
+      MbufControl(MilDisplay8, M_MODIFIED, M_DEFAULT);
+   }
+   MthrWait(M_DEFAULT, M_THREAD_WAIT, M_NULL);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+   return Time / LIVE_NB_LOOP;
+}
+
+void LiveLevelingBenchmark(MIL_ID MilSystem, MIL_ID MilDisplay, MIL_ID MilImage,
+                           MIL_INT Start, MIL_INT End, MIL_INT InflectionLevel, MIL_INT ImageMaxValue)
+{
+   MIL_ID     MilFrames[LIVE_NB_FRAMES], MilDisplay8, MilLut8, MilLiveLut, MilScaled;
+   MIL_INT    LiveMaxValue = (1 << LIVE_SIZE_BIT) - 1, n;
+   MIL_INT    NbCores = (MIL_INT)std::thread::hardware_concurrency();
+   MIL_DOUBLE Time, TimeOneThread, TimeAllThreads, TimeLutMap, TimeDispLut = 0.0;
+   MIL_DOUBLE TimeLiveShown = 0.0, TimeLiveHidden = 0.0;
+   LEVELING_ENGINE Engine;
+
+   MosPrintf(MIL_TEXT("LIVE WINDOW LEVELING (%d-bit, %d x %d):\n"),
+             LIVE_SIZE_BIT, LIVE_SIZE_X, LIVE_SIZE_Y);
+   MosPrintf(MIL_TEXT("--------------------------------------\n\n"));
+
+   /* 1) 시뮬 스트림 프레임 생성(원본 → 확대 → 비트수 맞춤 → 프레임마다 이동) */
+   MbufAlloc2d(MilSystem, LIVE_SIZE_X, LIVE_SIZE_Y, 16 + M_UNSIGNED, M_IMAGE + M_PROC, &MilScaled);
+   MimResize(MilImage, MilScaled, M_FILL_DESTINATION, M_FILL_DESTINATION, M_BILINEAR);
+   MimArith(MilScaled, (MIL_DOUBLE)LiveMaxValue / (MIL_DOUBLE)MosMax(ImageMaxValue, 1),
+            MilScaled, M_MULT_CONST + M_SATURATION);
+   for (n = 0; n < LIVE_NB_FRAMES; n++)
+   {
+      MbufAlloc2d(MilSystem, LIVE_SIZE_X, LIVE_SIZE_Y, 16 + M_UNSIGNED, M_IMAGE + M_PROC, &MilFrames[n]);
+      MimTranslate(MilScaled, MilFrames[n], (MIL_DOUBLE)(4 * n), 0.0, M_DEFAULT);
+   }
+   MbufAlloc2d(MilSystem, LIVE_SIZE_X, LIVE_SIZE_Y, 8 + M_UNSIGNED, M_IMAGE + M_PROC + DISPLAY_ATTRIBUTE, &MilDisplay8);
+
+   /* 2) 현재 윈도우를 라이브 비트수로 환산해 엔진/MIL LUT 준비 */
+   MIL_INT LiveStart = Start * LiveMaxValue / MosMax(ImageMaxValue, 1);
+   MIL_INT LiveEnd   = End   * LiveMaxValue / MosMax(ImageMaxValue, 1);
+#if MIL_HEADLESS
+   MIL_INT DisplaySizeBit = HEADLESS_SIZE_BIT;
+#else
+   MIL_INT DisplaySizeBit = MdispInquire(MilDisplay, M_SIZE_BIT, M_NULL);
+#endif
+   MIL_INT DisplayMaxValue = (1 << DisplaySizeBit) - 1;
+   MIL_INT Inflection8 = InflectionLevel * LEVELING_DISPLAY_MAX / DisplayMaxValue;
+
+   /* 풀은 전체 코어로 한 번 생성, 1스레드 측정은 행 구간 1개로 실행 */
+   LevelingEngineAlloc(MilSystem, Engine, LiveMaxValue, MosMax(NbCores, 1));
+   Engine.NbThreads = 1;
+   LevelingEngineSetWindow(Engine, LiveStart, LiveEnd, Inflection8, LiveMaxValue);
+
+   MbufAlloc1d(MilSystem, LiveMaxValue + 1, 8 + M_UNSIGNED, M_LUT, &MilLut8);
+   MgenLutRamp(MilLut8, 0, 0, LiveStart, 0);
+   MgenLutRamp(MilLut8, LiveStart, 0, LiveEnd, (MIL_DOUBLE)Inflection8);
+   MgenLutRamp(MilLut8, LiveEnd, (MIL_DOUBLE)Inflection8, LiveMaxValue, (MIL_DOUBLE)LEVELING_DISPLAY_MAX);
+
+   /* 3) 엔진: 1스레드 → 전체 코어(같은 상주 풀 재사용) */
+   LevelingEngineApply(Engine, MilFrames[0], MilDisplay8); /* 워밍업 */
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (n = 0; n < LIVE_NB_LOOP; n++)
+      LevelingEngineApply(Engine, MilFrames[n % LIVE_NB_FRAMES], MilDisplay8);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+   TimeOneThread = Time / LIVE_NB_LOOP;
+
+   Engine.NbThreads = MosMax(NbCores, 1);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (n = 0; n < LIVE_NB_LOOP; n++)
+      LevelingEngineApply(Engine, MilFrames[n % LIVE_NB_FRAMES], MilDisplay8);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+   TimeAllThreads = Time / LIVE_NB_LOOP;
+
+   /* 4) MimLutMap: 같은 LUT를 MIL 처리 함수로 적용 */
+   MimLutMap(MilFrames[0], MilDisplay8, MilLut8);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (n = 0; n < LIVE_NB_LOOP; n++)
+      MimLutMap(MilFrames[n % LIVE_NB_FRAMES], MilDisplay8, MilLut8);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+   TimeLutMap = Time / LIVE_NB_LOOP;
+
+   /* 5) MdispLut: 16bit 프레임을 표시 버퍼로 복사, 디스플레이 LUT로 변환 */
+   MbufAlloc1d(MilSystem, LiveMaxValue + 1, (DisplaySizeBit > 8 ? 16 : 8) + M_UNSIGNED, M_LUT, &MilLiveLut);
+   MgenLutRamp(MilLiveLut, 0, 0, LiveStart, 0);
+   MgenLutRamp(MilLiveLut, LiveStart, 0, LiveEnd, (MIL_DOUBLE)InflectionLevel);
+   MgenLutRamp(MilLiveLut, LiveEnd, (MIL_DOUBLE)InflectionLevel, LiveMaxValue, (MIL_DOUBLE)DisplayMaxValue);
+   MbufControl(MilScaled, M_MAX, (MIL_DOUBLE)LiveMaxValue);
+#if !MIL_HEADLESS
+   MdispSelect(MilDisplay, MilScaled);
+   MdispLut(MilDisplay, MilLiveLut);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (n = 0; n < LIVE_NB_LOOP; n++)
+      MbufCopy(MilFrames[n % LIVE_NB_FRAMES], MilScaled);
+   MthrWait(M_DEFAULT, M_THREAD_WAIT, M_NULL);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+   TimeDispLut = Time / LIVE_NB_LOOP;
+   MdispLut(MilDisplay, M_DEFAULT);
+   MdispSelect(MilDisplay, M_NULL);
+#endif
+
+   /* 5-1) 라이브 루프를 표시 버퍼 선택/해제 상태로 실행 → 차이가 디스플레이 지원 비용
+           워밍업 1회(측정 제외) 후, 짝수 라운드는 선택 → 해제, 홀수 라운드는 해제 → 선택 */
+   TimeLiveLoop(Engine, MilFrames, MilDisplay8);
+#if !MIL_HEADLESS
+   for (MIL_INT Round = 0; Round < LIVE_NB_ROUND; Round++)
+   {
+      for (MIL_INT Pass = 0; Pass < 2; Pass++)
+      {
+         bool Selected = ((Round + Pass) % 2) == 0;
+         MdispSelect(MilDisplay, Selected ? MilDisplay8 : M_NULL);
+         if (Selected)
+            TimeLiveShown += TimeLiveLoop(Engine, MilFrames, MilDisplay8) / LIVE_NB_ROUND;
+         else
+            TimeLiveHidden += TimeLiveLoop(Engine, MilFrames, MilDisplay8) / LIVE_NB_ROUND;
+      }
+   }
+   MdispSelect(MilDisplay, M_NULL);
+#else
+   TimeLiveHidden = TimeLiveLoop(Engine, MilFrames, MilDisplay8);
+#endif
+
+   /* 6) 결과: 프레임당 시간, fps, 목표 프레임레이트에서의 코어 점유율 */
+   MosPrintf(MIL_TEXT("Method                    ms/frame   frames/s   core use @ %.0f fps\n\n"), LIVE_TARGET_FPS);
+   MosPrintf(MIL_TEXT("Engine (1 thread)         %-11.3f%-11.1f%.0f%%\n"),
+             TimeOneThread * 1000.0, 1.0 / TimeOneThread, TimeOneThread * LIVE_TARGET_FPS * 100.0);
+   MosPrintf(MIL_TEXT("Engine (%2d threads)       %-11.3f%-11.1f-\n"),
+             (int)Engine.NbThreads, TimeAllThreads * 1000.0, 1.0 / TimeAllThreads);
+   MosPrintf(MIL_TEXT("MimLutMap                 %-11.3f%-11.1f-\n"),
+             TimeLutMap * 1000.0, 1.0 / TimeLutMap);
+#if !MIL_HEADLESS
+   MosPrintf(MIL_TEXT("MdispLut (copy + display) %-11.3f%-11.1f-\n"),
+             TimeDispLut * 1000.0, 1.0 / TimeDispLut);
+#endif
+#if !MIL_HEADLESS
+   MosPrintf(MIL_TEXT("Engine, display selected  %-11.3f%-11.1f-\n"),
+             TimeLiveShown * 1000.0, 1.0 / TimeLiveShown);
+#endif
+   MosPrintf(MIL_TEXT("Engine, no display        %-11.3f%-11.1f-\n\n"),
+             TimeLiveHidden * 1000.0, 1.0 / TimeLiveHidden);
+   MosPrintf(MIL_TEXT("Engine kernel: %s, %d MimLutMap fallback frame(s).\n"),
+             Engine.UseAvx2 ? MIL_TEXT("AVX2 gather (runtime CPUID)") : MIL_TEXT("scalar (no AVX2 on this CPU)"),
+             (int)Engine.NbFallbacks);
+#if !MIL_HEADLESS
+   MosPrintf(MIL_TEXT("Display support costs %.3f ms/frame in the live loop (%.1f%%).\n\n"),
+             (TimeLiveShown - TimeLiveHidden) * 1000.0, 100.0 * (TimeLiveShown - TimeLiveHidden) / TimeLiveShown);
+#else
+   MosPrintf(MIL_TEXT("Headless build: MdispLut path skipped, engine output stays in host memory.\n\n"));
+#endif
+
+   /* 엔진 결과 표시 */
+   LevelingEngineApply(Engine, MilFrames[0], MilDisplay8);
+#if !MIL_HEADLESS
+   MdispSelect(MilDisplay, MilDisplay8);
+   MosPrintf(MIL_TEXT("The engine output is displayed.\n"));
+#endif
+   MosPrintf(MIL_TEXT("Press any key to end.\n\n"));
+   WaitForKey(0);
+
+   /* 해제 */
+#if !MIL_HEADLESS
+   MdispSelect(MilDisplay, M_NULL);
+#endif
+   LevelingEngineFree(Engine);
+   MbufFree(MilLiveLut);
+   MbufFree(MilLut8);
+   MbufFree(MilDisplay8);
+   for (n = 0; n < LIVE_NB_FRAMES; n++)
+      MbufFree(MilFrames[n]);
+   MbufFree(MilScaled);
+}
+
+/* ------------------------------------------------------------------------------------
+ * 병렬 히스토그램(구간별 전용 빈 → 합산)
+ *  - Subsample: 행/열 간격(1=전체, 4=1/16 픽셀). 빈 개수를 넘는 값은 마지막 빈에 누적
+ *  - 구간 처리는 상주 풀에서, 전용 빈은 HISTOGRAM_WORKERS에 두고 매 호출 재사용
+ * ------------------------------------------------------------------------------------ */
+static void HistogramRows(const MIL_UINT8* SrcBase, MIL_INT SrcPitchByte, MIL_INT SizeX,
+                          MIL_INT StartY, MIL_INT EndY, MIL_INT Subsample,
+                          MIL_UINT32* Bins, MIL_INT NbBins)
+{
+   MIL_UINT16 MaxBin = (MIL_UINT16)(NbBins - 1);
+   for (MIL_INT y = StartY; y < EndY; y += Subsample)
+   {
+      const MIL_UINT16* Src = (const MIL_UINT16*)(SrcBase + y * SrcPitchByte);
+      for (MIL_INT x = 0; x < SizeX; x += Subsample)
+         Bins[MosMin(Src[x], MaxBin)]++;
+   }
+}
+
+void HistogramWorkersAlloc(HISTOGRAM_WORKERS& Workers, MIL_INT NbThreads)
+{
+   WorkerPoolAlloc(Workers.Pool, MosMax(NbThreads, 1));
+   Workers.NbFallbacks = 0;
+}
+
+void HistogramWorkersFree(HISTOGRAM_WORKERS& Workers)
+{
+   WorkerPoolFree(Workers.Pool);
+}
+
+void ParallelHistogram(HISTOGRAM_WORKERS& Workers, MIL_ID MilSource16, MIL_INT NbBins, MIL_INT NbThreads,
+                       MIL_INT Subsample, std::vector<MIL_UINT32>& Histogram)
+{
+   MIL_INT SizeX = MbufInquire(MilSource16, M_SIZE_X, M_NULL);
+   MIL_INT SizeY = MbufInquire(MilSource16, M_SIZE_Y, M_NULL);
+   const MIL_UINT8* SrcBase = (const MIL_UINT8*)MbufInquire(MilSource16, M_HOST_ADDRESS, M_NULL);
+   MIL_INT SrcPitchByte = MbufInquire(MilSource16, M_PITCH_BYTE, M_NULL);
+
+   Histogram.assign(NbBins, 0);
+
+   /* 호스트 메모리에 없거나(보드 메모리 등) 16bit 단일 밴드가 아니면 MimHistogram 경로(부표본 없음) */
+   if (SrcBase == M_NULL ||
+       MbufInquire(MilSource16, M_SIZE_BIT, M_NULL) != 16 ||
+       MbufInquire(MilSource16, M_SIZE_BAND, M_NULL) != 1)
+   {
+      MIL_ID MilHistResult = MimAllocResult(MbufInquire(MilSource16, M_OWNER_SYSTEM, M_NULL),
+                                            NbBins, M_HIST_LIST, M_NULL);
+      Workers.MilBins.resize(NbBins);
+      MimHistogram(MilSource16, MilHistResult);
+      MimGetResult(MilHistResult, M_VALUE + M_TYPE_MIL_INT32, &Workers.MilBins[0]);
+      MimFree(MilHistResult);
+      for (MIL_INT b = 0; b < NbBins; b++)
+         Histogram[b] = (MIL_UINT32)Workers.MilBins[b];
+      Workers.NbFallbacks++;
+      return;
+   }
+
+   NbThreads = MosMin(MosMax(NbThreads, 1), WorkerPoolSize(Workers.Pool));
+   if (NbThreads == 1)
+   {
+      HistogramRows(SrcBase, SrcPitchByte, SizeX, 0, SizeY, Subsample, &Histogram[0], NbBins);
+      return;
+   }
+
+   /* 행 구간 시작은 Subsample 배수로 맞춰 단일 스레드와 같은 표본을 사용 */
+   MIL_INT RowsPerThread = (SizeY + NbThreads - 1) / NbThreads;
+   RowsPerThread = ((RowsPerThread + Subsample - 1) / Subsample) * Subsample;
+   MIL_INT NbBands = (SizeY + RowsPerThread - 1) / RowsPerThread;
+
+   /* 전용 빈은 필요할 때만 늘리고, 매 호출 0으로만 초기화 */
+   if ((MIL_INT)Workers.PrivateBins.size() < NbBands * NbBins)
+      Workers.PrivateBins.resize(NbBands * NbBins);
+   MIL_UINT32* Bins = &Workers.PrivateBins[0];
+   WorkerPoolRun(Workers.Pool, NbBands, [=](MIL_INT Band)
+      {
+      MIL_INT StartY = Band * RowsPerThread;
+      MIL_UINT32* BandBins = Bins + Band * NbBins;
+      std::fill(BandBins, BandBins + NbBins, 0u);
+      HistogramRows(SrcBase, SrcPitchByte, SizeX, StartY, MosMin(StartY + RowsPerThread, SizeY),
+                    Subsample, BandBins, NbBins);
+      });
+   for (MIL_INT t = 0; t < NbBands; t++)
+      for (MIL_INT b = 0; b < NbBins; b++)
+         Histogram[b] += Bins[t * NbBins + b];
+}
+
+/* 누적 비율이 LowPercent/HighPercent에 도달하는 빈 → 윈도우 Start/End */
+void PercentileWindow(const std::vector<MIL_UINT32>& Histogram, MIL_DOUBLE LowPercent,
+                      MIL_DOUBLE HighPercent, MIL_INT* StartPtr, MIL_INT* EndPtr)
+{
+   MIL_DOUBLE Total = 0.0, Sum = 0.0;
+   MIL_INT    NbBins = (MIL_INT)Histogram.size(), b;
+   for (b = 0; b < NbBins; b++)
+      Total += Histogram[b];
+
+   MIL_DOUBLE LowCount  = Total * LowPercent  / 100.0;
+   MIL_DOUBLE HighCount = Total * HighPercent / 100.0;
+   *StartPtr = 0;
+   *EndPtr   = NbBins - 1;
+   for (b = 0; b < NbBins && Sum + Histogram[b] <= LowCount; b++)
+      Sum += Histogram[b];
+   *StartPtr = MosMin(b, NbBins - 1);
+   for (; b < NbBins && Sum + Histogram[b] < HighCount; b++)
+      Sum += Histogram[b];
+   *EndPtr = MosMax(MosMin(b, NbBins - 1), *StartPtr);
+}
+
+/* ------------------------------------------------------------------------------------
+ * AutoLevelingBenchmark: 히스토그램 기반 자동 윈도우/레벨
+ *  - 5MP 12bit 프레임에서 전체 히스토그램(1스레드/전체 코어/서브샘플) vs MimHistogram
+ *  - 각 방식이 프레임당 AUTO_BUDGET_MS 예산을 지키는지 PASS/FAIL로 출력
+ *  - 라이브: 서브샘플 히스토그램 → 백분위 윈도우 → 지수 평활로 점진 갱신 → 엔진 LUT 반영
+ * ------------------------------------------------------------------------------------ */
+#define AUTO_SIZE_X          2448
+#define AUTO_SIZE_Y          2048
+#define AUTO_SIZE_BIT        12
+#define AUTO_NB_FRAMES       8
+#define AUTO_NB_LOOP         100
+#define AUTO_SUBSAMPLE       4
+#define AUTO_SMOOTHING       0.25
+#define AUTO_BUDGET_MS       1.0
+
+static const MIL_TEXT_CHAR* BudgetResult(MIL_DOUBLE Time)
+{
+   return (Time * 1000.0 <= AUTO_BUDGET_MS) ? MIL_TEXT("PASS") : MIL_TEXT("FAIL");
+}
+
+void AutoLevelingBenchmark(MIL_ID MilSystem, MIL_ID MilImage, MIL_INT ImageMaxValue)
+{
+   MIL_ID     MilFrames[AUTO_NB_FRAMES], MilScaled, MilDisplay8, MilHistResult;
+   MIL_INT    AutoMaxValue = (1 << AUTO_SIZE_BIT) - 1, NbBins = AutoMaxValue + 1, n;
+   MIL_INT    NbCores = MosMax((MIL_INT)std::thread::hardware_concurrency(), 1);
+   MIL_INT    Start, End, NewStart, NewEnd;
+   MIL_DOUBLE Time, TimeOneThread, TimeAllThreads, TimeSubsampled, TimeMil, TimeLive;
+   MIL_DOUBLE SmoothStart, SmoothEnd;
+   std::vector<MIL_UINT32> Histogram;
+   HISTOGRAM_WORKERS HistWorkers;
+   LEVELING_ENGINE Engine;
+
+   MosPrintf(MIL_TEXT("HISTOGRAM AUTO WINDOW LEVELING (%d-bit, %d x %d):\n"),
+             AUTO_SIZE_BIT, AUTO_SIZE_X, AUTO_SIZE_Y);
+   MosPrintf(MIL_TEXT("-----------------------------------------------\n\n"));
+
+   /* 1) 시뮬 프레임: 원본 확대 → 프레임마다 이동 → 12bit 환산 + 밝기 변화 */
+   MbufAlloc2d(MilSystem, AUTO_SIZE_X, AUTO_SIZE_Y, 16 + M_UNSIGNED, M_IMAGE + M_PROC, &MilScaled);
+   MimResize(MilImage, MilScaled, M_FILL_DESTINATION, M_FILL_DESTINATION, M_BILINEAR);
+   for (n = 0; n < AUTO_NB_FRAMES; n++)
+   {
+      MIL_DOUBLE Gain = (MIL_DOUBLE)AutoMaxValue / (MIL_DOUBLE)MosMax(ImageMaxValue, 1) *
+                        (1.0 - 0.05 * n);
+      MbufAlloc2d(MilSystem, AUTO_SIZE_X, AUTO_SIZE_Y, 16 + M_UNSIGNED, M_IMAGE + M_PROC, &MilFrames[n]);
+      MimTranslate(MilScaled, MilFrames[n], (MIL_DOUBLE)(4 * n), 0.0, M_DEFAULT);
+      MimArith(MilFrames[n], Gain, MilFrames[n], M_MULT_CONST + M_SATURATION);
+   }
+   MbufFree(MilScaled);
+   MbufAlloc2d(MilSystem, AUTO_SIZE_X, AUTO_SIZE_Y, 8 + M_UNSIGNED, M_IMAGE + M_PROC, &MilDisplay8);
+   MimAllocResult(MilSystem, NbBins, M_HIST_LIST, &MilHistResult);
+   HistogramWorkersAlloc(HistWorkers, NbCores);
+
+   /* 2) 히스토그램 비용: 1스레드 / 전체 코어 / 서브샘플 / MimHistogram */
+   ParallelHistogram(HistWorkers, MilFrames[0], NbBins, 1, 1, Histogram); /* 워밍업 */
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (n = 0; n < AUTO_NB_LOOP; n++)
+      ParallelHistogram(HistWorkers, MilFrames[n % AUTO_NB_FRAMES], NbBins, 1, 1, Histogram);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+   TimeOneThread = Time / AUTO_NB_LOOP;
+
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (n = 0; n < AUTO_NB_LOOP; n++)
+      ParallelHistogram(HistWorkers, MilFrames[n % AUTO_NB_FRAMES], NbBins, NbCores, 1, Histogram);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+   TimeAllThreads = Time / AUTO_NB_LOOP;
+
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (n = 0; n < AUTO_NB_LOOP; n++)
+      ParallelHistogram(HistWorkers, MilFrames[n % AUTO_NB_FRAMES], NbBins, NbCores, AUTO_SUBSAMPLE, Histogram);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+   TimeSubsampled = Time / AUTO_NB_LOOP;
+
+   MimHistogram(MilFrames[0], MilHistResult);
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (n = 0; n < AUTO_NB_LOOP; n++)
+      MimHistogram(MilFrames[n % AUTO_NB_FRAMES], MilHistResult);
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+   TimeMil = Time / AUTO_NB_LOOP;
+
+   /* 3) 라이브 자동 레벨링: 첫 프레임은 전체 히스토그램, 이후 서브샘플 + 평활 */
+   ParallelHistogram(HistWorkers, MilFrames[0], NbBins, NbCores, 1, Histogram);
+   PercentileWindow(Histogram, AUTO_LOW_PERCENT, AUTO_HIGH_PERCENT, &Start, &End);
+   SmoothStart = (MIL_DOUBLE)Start;
+   SmoothEnd   = (MIL_DOUBLE)End;
+
+   LevelingEngineAlloc(MilSystem, Engine, AutoMaxValue, NbCores);
+   LevelingEngineSetWindow(Engine, Start, End, LEVELING_DISPLAY_MAX, AutoMaxValue);
+
+   MappTimer(M_DEFAULT, M_TIMER_RESET + M_SYNCHRONOUS, M_NULL);
+   for (n = 0; n < AUTO_NB_LOOP; n++)
+   {
+      MIL_ID MilFrame = MilFrames[n % AUTO_NB_FRAMES];
+      ParallelHistogram(HistWorkers, MilFrame, NbBins, NbCores, AUTO_SUBSAMPLE, Histogram);
+      PercentileWindow(Histogram, AUTO_LOW_PERCENT, AUTO_HIGH_PERCENT, &NewStart, &NewEnd);
+      SmoothStart += (NewStart - SmoothStart) * AUTO_SMOOTHING;
+      SmoothEnd   += (NewEnd   - SmoothEnd)   * AUTO_SMOOTHING;
+
+      /* 정수 경계가 바뀐 경우에만 LUT 재생성 */
+      if ((MIL_INT)SmoothStart != Start || (MIL_INT)SmoothEnd != End)
+      {
+         Start = (MIL_INT)SmoothStart;
+         End   = MosMax((MIL_INT)SmoothEnd, Start);
+         LevelingEngineSetWindow(Engine, Start, End, LEVELING_DISPLAY_MAX, AutoMaxValue);
+      }
+      LevelingEngineApply(Engine, MilFrame, MilDisplay8);
+   }
+   MappTimer(M_DEFAULT, M_TIMER_READ + M_SYNCHRONOUS, &Time);
+   TimeLive = Time / AUTO_NB_LOOP;
+
+   /* 4) 결과 */
+   MosPrintf(MIL_TEXT("Histogram (%d bins)             ms/frame   budget %.1f ms\n\n"), (int)NbBins, AUTO_BUDGET_MS);
+   MosPrintf(MIL_TEXT("Private bins, 1 thread          %-11.3f%s\n"),
+             TimeOneThread * 1000.0, BudgetResult(TimeOneThread));
+   MosPrintf(MIL_TEXT("Private bins, %2d threads        %-11.3f%s\n"),
+             (int)NbCores, TimeAllThreads * 1000.0, BudgetResult(TimeAllThreads));
+   MosPrintf(MIL_TEXT("Private bins, %2d threads, 1/%-2d  %-11.3f%s\n"),
+             (int)NbCores, AUTO_SUBSAMPLE * AUTO_SUBSAMPLE, TimeSubsampled * 1000.0, BudgetResult(TimeSubsampled));
+   MosPrintf(MIL_TEXT("MimHistogram                    %-11.3f%s\n\n"), TimeMil * 1000.0, BudgetResult(TimeMil));
+   MosPrintf(MIL_TEXT("Full-frame histogram budget (%.1f ms on %d x %d %d-bit): %s.\n"),
+             AUTO_BUDGET_MS, AUTO_SIZE_X, AUTO_SIZE_Y, AUTO_SIZE_BIT,
+             (TimeAllThreads * 1000.0 <= AUTO_BUDGET_MS) ? MIL_TEXT("PASSED") : MIL_TEXT("FAILED"));
+   MosPrintf(MIL_TEXT("Live auto leveling (histogram + window + LUT apply): %.3f ms/frame.\n"),
+             TimeLive * 1000.0);
+   MosPrintf(MIL_TEXT("Final window (%.1f%% - %.1f%%): Start=%d, End=%d.\n\n"),
+             AUTO_LOW_PERCENT, AUTO_HIGH_PERCENT, (int)Start, (int)End);
+
+   /* 해제 */
+   LevelingEngineFree(Engine);
+   HistogramWorkersFree(HistWorkers);
+   MimFree(MilHistResult);
+   MbufFree(MilDisplay8);
+   for (n = 0; n < AUTO_NB_FRAMES; n++)
+      MbufFree(MilFrames[n]);
+}
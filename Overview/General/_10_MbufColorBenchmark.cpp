@@ -0,0 +1,284 @@
+﻿/*****************************************************************************/
+/*
+ * 파일명: MbufColorBenchmark.cpp
+ *
+ * 개요:
+ *  - MbufColor 예제의 컬러 처리 흐름(밴드 추출 → RGB→HSL → L 오프셋 → HSL→RGB)을
+ *    해상도/비트 깊이/코어 수별로 측정하는 벤치마크.
+ *  - 컬러 카메라 해상도와 호스트 CPU 선정을 위한 기준 데이터를 제공.
+ *
+ * 핵심 요약:
+ *  - 해상도: VGA ~ 50MP, 비트 깊이: 8/16bit, 레이아웃: 3밴드 planar / packed(M_BGR24, M_RGB48) 버퍼.
+ *  - 단계별 측정: MbufChildColor + MbufCopy(밴드 추출), MimConvert(RGB→HSL),
+ *    MimArith(M_LUMINANCE 자식 → 별도 단일 밴드, M_ADD_CONST + M_SATURATION), MimConvert(HSL→RGB),
+ *    전체 파이프라인.
+ *  - 단일 코어 vs MP: MappControlMp(M_MP_USE)로 멀티프로세싱 on/off.
+ *  - 반복마다 시간을 기록해 p50/p90/p99(ms)와 처리량(MPix/s) 출력.
+ *
+ * 저작권:
+ *  © Matrox Electronic Systems Ltd., 1992-2025. All Rights Reserved
+ */
+#include <mil.h>
+#include <algorithm>
+#include <vector>
+
+/* 소스 컬러 이미지(각 해상도로 확대/축소해 사용) */
+#define IMAGE_FILE              M_IMAGE_PATH MIL_TEXT("Bird.mim")
+
+/* 명도(Luminance)에 더할 오프셋 값(8bit 기준, 16bit는 257배) */
+#define IMAGE_LUMINANCE_OFFSET  40L
+
+/* 측정 파라미터: 최소/최대 반복 수, 조건별 최소 측정 시간(초) */
+#define MIN_NB_SAMPLES          20
+#define MAX_NB_SAMPLES          200
+#define MINIMUM_BENCHMARK_TIME  1.0
+
+/* 헤드리스 실행 모드: 이 벤치마크는 원래 디스플레이를 쓰지 않으므로 키 대기만 막지 않음 */
+#include "../../Common/MilHeadless.h"
+
+/* 측정 해상도 목록 */
+typedef struct
+{
+   MIL_CONST_TEXT_PTR Name;
+   MIL_INT            SizeX;
+   MIL_INT            SizeY;
+} RESOLUTION;
+
+static const RESOLUTION Resolutions[] =
+{
+   { MIL_TEXT("VGA"),     640,  480 },
+   { MIL_TEXT("2MP"),    1920, 1080 },
+   { MIL_TEXT("5MP"),    2448, 2048 },
+   { MIL_TEXT("12MP"),   4096, 3000 },
+   { MIL_TEXT("20MP"),   5472, 3648 },
+   { MIL_TEXT("50MP"),   8192, 6144 },
+};
+#define NB_RESOLUTIONS  (sizeof(Resolutions) / sizeof(Resolutions[0]))
+
+/* 측정 레이아웃: MIL 기본 planar, 카메라 출력과 같은 packed(8bit M_BGR24, 16bit M_RGB48) */
+enum { LAYOUT_PLANAR, LAYOUT_PACKED, NB_LAYOUTS };
+static const MIL_CONST_TEXT_PTR LayoutNames[NB_LAYOUTS] =
+{
+   MIL_TEXT("planar"),
+   MIL_TEXT("packed"),
+};
+
+/* 측정 단계 */
+enum { STAGE_BAND_EXTRACT, STAGE_RGB_TO_HSL, STAGE_LUM_OFFSET, STAGE_HSL_TO_RGB, STAGE_PIPELINE, NB_STAGES };
+static const MIL_CONST_TEXT_PTR StageNames[NB_STAGES] =
+{
+   MIL_TEXT("band extract"),
+   MIL_TEXT("RGB->HSL"),
+   MIL_TEXT("L offset"),
+   MIL_TEXT("HSL->RGB"),
+   MIL_TEXT("full pipeline"),
+};
+
+/* 처리 파라미터 구조체: 입력/HSL/밴드 출력 버퍼 */
+typedef struct
+{
+   MIL_ID  MilSourceImage;    /* RGB 입력 */
+   MIL_ID  MilHslImage;       /* HSL 중간 결과 */
+   MIL_ID  MilRgbImage;       /* HSL → RGB 출력 */
+   MIL_ID  MilLumImage;       /* HSL 버퍼의 L 밴드 자식 */
+   MIL_ID  MilBandImage;      /* 밴드 추출/L 오프셋 대상(단일 밴드) */
+   MIL_INT LuminanceOffset;
+} PROC_PARAM;
+
+/* 처리 파이프라인(초기화/단계 실행/해제) */
+void ProcessingInit(MIL_ID MilSystem, MIL_ID MilSourceImage, MIL_INT SizeX, MIL_INT SizeY,
+                    MIL_INT SizeBit, MIL_INT Layout, PROC_PARAM& ProcParam);
+void ProcessingExecute(PROC_PARAM& ProcParam, MIL_INT Stage);
+void ProcessingFree(PROC_PARAM& ProcParam);
+
+/* 벤치마크: 반복별 시간(초) 기록 → 백분위(ms) */
+void Benchmark(PROC_PARAM& ProcParam, MIL_INT Stage, MIL_DOUBLE Percentiles[3]);
+
+int MosMain(void)
+{
+   MIL_ID     MilApplication, MilSystem, MilSource;
+   MIL_ID     MilSystemOwnerApplication;
+   MIL_ID     MilSystemCurrentThreadId;
+   MIL_INT    NbCoresMp, Mp, Stage;
+   MIL_DOUBLE Percentiles[3];
+   PROC_PARAM ProcessingParam;
+   static const MIL_INT SizeBits[] = { 8, 16 };
+
+   /* 1) 기본 자원 할당(디스플레이 없음) */
+   MappAllocDefault(M_DEFAULT, &MilApplication, &MilSystem, M_NULL, M_NULL, M_NULL);
+   MsysInquire(MilSystem, M_OWNER_APPLICATION, &MilSystemOwnerApplication);
+   MsysInquire(MilSystem, M_CURRENT_THREAD_ID, &MilSystemCurrentThreadId);
+   MthrInquireMp(MilSystemCurrentThreadId, M_CORE_NUM_EFFECTIVE, M_DEFAULT, M_DEFAULT, &NbCoresMp);
+
+   /* 2) 소스 이미지 복원 */
+   MbufRestore(IMAGE_FILE, MilSystem, &MilSource);
+
+   MosPrintf(MIL_TEXT("\nCOLOR PIPELINE BENCHMARK:\n"));
+   MosPrintf(MIL_TEXT("-------------------------\n\n"));
+   MosPrintf(MIL_TEXT("Times are per call in ms (p50 / p90 / p99), throughput from p50.\n"));
+   MosPrintf(MIL_TEXT("MP runs use %d CPU cores.\n\n"), (int)NbCoresMp);
+   MosPrintf(MIL_TEXT("Size  Bits Layout Cores Stage           p50       p90       p99       MPix/s\n"));
+   MosPrintf(MIL_TEXT("---------------------------------------------------------------------------------\n"));
+
+   /* 3) 해상도 × 비트 깊이 × 레이아웃 × (1코어, MP) × 단계 */
+   for (size_t r = 0; r < NB_RESOLUTIONS; r++)
+   {
+      for (size_t b = 0; b < sizeof(SizeBits) / sizeof(SizeBits[0]); b++)
+      {
+         for (MIL_INT Layout = 0; Layout < NB_LAYOUTS; Layout++)
+         {
+            ProcessingInit(MilSystem, MilSource, Resolutions[r].SizeX, Resolutions[r].SizeY,
+                           SizeBits[b], Layout, ProcessingParam);
+            MIL_DOUBLE MegaPixels = (MIL_DOUBLE)(Resolutions[r].SizeX * Resolutions[r].SizeY) / 1.0e6;
+
+            for (Mp = 0; Mp < 2; Mp++)
+            {
+               MappControlMp(MilSystemOwnerApplication, M_MP_USE, M_DEFAULT, Mp ? M_ENABLE : M_DISABLE, M_NULL);
+               for (Stage = 0; Stage < NB_STAGES; Stage++)
+               {
+                  Benchmark(ProcessingParam, Stage, Percentiles);
+                  MosPrintf(MIL_TEXT("%-6s%-5d%-7s%-6d%-16s%-10.3f%-10.3f%-10.3f%.1f\n"),
+                            Resolutions[r].Name, (int)SizeBits[b], LayoutNames[Layout], Mp ? (int)NbCoresMp : 1,
+                            StageNames[Stage], Percentiles[0], Percentiles[1], Percentiles[2],
+                            MegaPixels / (Percentiles[0] / 1000.0));
+               }
+               MappControlMp(MilSystemOwnerApplication, M_MP_USE, M_DEFAULT, M_DEFAULT, M_NULL);
+            }
+            ProcessingFree(ProcessingParam);
+         }
+      }
+   }
+
+   MosPrintf(MIL_TEXT("\nPress any key to end.\n"));
+   WaitForKey(0);
+
+   /* 4) 자원 해제 */
+   MbufFree(MilSource);
+   MappFreeDefault(MilApplication, MilSystem, M_NULL, M_NULL, M_NULL);
+   return 0;
+}
+
+/*****************************************************************************
+ * 벤치마크 함수
+ *  - 1회 워밍업 후 반복마다 MthrWait로 완료를 맞춰 개별 시간 기록
+ *  - MIN_NB_SAMPLES 이상, MINIMUM_BENCHMARK_TIME 이상(최대 MAX_NB_SAMPLES) 측정
+ *  - 정렬 후 p50/p90/p99(ms) 반환
+ *****************************************************************************/
+void Benchmark(PROC_PARAM& ProcParam, MIL_INT Stage, MIL_DOUBLE Percentiles[3])
+{
+   static const MIL_DOUBLE Ranks[3] = { 0.50, 0.90, 0.99 };
+   std::vector<MIL_DOUBLE> Samples;
+   MIL_DOUBLE StartTime, EndTime, TotalTime = 0.0;
+
+   /* 워밍업(DLL 로드/캐시 등 초기 지연 제거) */
+   MthrWait(M_DEFAULT, M_THREAD_WAIT, M_NULL);
+   ProcessingExecute(ProcParam, Stage);
+   MthrWait(M_DEFAULT, M_THREAD_WAIT, M_NULL);
+
+   while ((MIL_INT)Samples.size() < MAX_NB_SAMPLES &&
+          ((MIL_INT)Samples.size() < MIN_NB_SAMPLES || TotalTime < MINIMUM_BENCHMARK_TIME))
+   {
+      MappTimer(M_DEFAULT, M_TIMER_READ, &StartTime);
+      ProcessingExecute(ProcParam, Stage);
+      MthrWait(M_DEFAULT, M_THREAD_WAIT, M_NULL);
+      MappTimer(M_DEFAULT, M_TIMER_READ, &EndTime);
+      Samples.push_back(EndTime - StartTime);
+      TotalTime += EndTime - StartTime;
+   }
+
+   std::sort(Samples.begin(), Samples.end());
+   for (MIL_INT i = 0; i < 3; i++)
+   {
+      size_t Index = (size_t)(Ranks[i] * (Samples.size() - 1) + 0.5);
+      Percentiles[i] = Samples[Index] * 1000.0;
+   }
+}
+
+/*****************************************************************************
+ * 처리 초기화
+ *  - 지정 해상도/비트 깊이/레이아웃의 3밴드 입력/HSL(+L 자식)/RGB 출력, 단일 밴드 버퍼 할당
+ *    (packed는 8bit M_BGR24, 16bit M_RGB48)
+ *  - 입력: 소스 이미지를 8bit로 확대/축소 후 필요 시 16bit로 확장(<<8)
+ *****************************************************************************/
+void ProcessingInit(MIL_ID MilSystem, MIL_ID MilSourceImage, MIL_INT SizeX, MIL_INT SizeY,
+                    MIL_INT SizeBit, MIL_INT Layout, PROC_PARAM& ProcParam)
+{
+   MIL_ID  MilResized;
+   MIL_INT Attribute = M_IMAGE + M_PROC;
+   if (Layout == LAYOUT_PACKED)
+      Attribute += M_PACKED + ((SizeBit > 8) ? M_RGB48 : M_BGR24);
+
+   MbufAllocColor(MilSystem, 3, SizeX, SizeY, SizeBit + M_UNSIGNED, Attribute, &ProcParam.MilSourceImage);
+   MbufAllocColor(MilSystem, 3, SizeX, SizeY, SizeBit + M_UNSIGNED, Attribute, &ProcParam.MilHslImage);
+   MbufAllocColor(MilSystem, 3, SizeX, SizeY, SizeBit + M_UNSIGNED, Attribute, &ProcParam.MilRgbImage);
+   MbufAlloc2d(MilSystem, SizeX, SizeY, SizeBit + M_UNSIGNED, M_IMAGE + M_PROC, &ProcParam.MilBandImage);
+   MbufChildColor(ProcParam.MilHslImage, M_LUMINANCE, &ProcParam.MilLumImage);
+
+   MbufAllocColor(MilSystem, 3, SizeX, SizeY, 8 + M_UNSIGNED, M_IMAGE + M_PROC, &MilResized);
+   MimResize(MilSourceImage, MilResized, M_FILL_DESTINATION, M_FILL_DESTINATION, M_BILINEAR);
+   MbufCopy(MilResized, ProcParam.MilSourceImage);
+   if (SizeBit > 8)
+      MimShift(ProcParam.MilSourceImage, ProcParam.MilSourceImage, SizeBit - 8);
+   MbufFree(MilResized);
+
+   ProcParam.LuminanceOffset = (SizeBit > 8) ? IMAGE_LUMINANCE_OFFSET * 257 : IMAGE_LUMINANCE_OFFSET;
+
+   /* HSL 단계 단독 측정을 위해 HSL 버퍼 미리 채움 */
+   MimConvert(ProcParam.MilSourceImage, ProcParam.MilHslImage, M_RGB_TO_HSL);
+}
+
+/*****************************************************************************
+ * 단계 실행
+ *  - 밴드 추출: MbufChildColor로 R/G/B 자식 생성 → 단일 밴드 버퍼로 복사 → 자식 해제
+ *  - L 오프셋 단독: L 자식 → 단일 밴드 버퍼(제자리로 더하면 반복마다 누적되어 포화값만 측정됨)
+ *  - 파이프라인: MbufColor 예제와 같은 3단계(RGB→HSL, L 오프셋, HSL→RGB), 매번 HSL을 다시 계산하므로 제자리
+ *****************************************************************************/
+void ProcessingExecute(PROC_PARAM& ProcParam, MIL_INT Stage)
+{
+   static const MIL_INT Bands[3] = { M_RED, M_GREEN, M_BLUE };
+   MIL_ID MilBandChild;
+
+   switch (Stage)
+   {
+   case STAGE_BAND_EXTRACT:
+      for (MIL_INT b = 0; b < 3; b++)
+      {
+         MbufChildColor(ProcParam.MilSourceImage, Bands[b], &MilBandChild);
+         MbufCopy(MilBandChild, ProcParam.MilBandImage);
+         MbufFree(MilBandChild);
+      }
+      break;
+
+   case STAGE_RGB_TO_HSL:
+      MimConvert(ProcParam.MilSourceImage, ProcParam.MilHslImage, M_RGB_TO_HSL);
+      break;
+
+   case STAGE_LUM_OFFSET:
+      MimArith(ProcParam.MilLumImage, ProcParam.LuminanceOffset, ProcParam.MilBandImage,
+               M_ADD_CONST + M_SATURATION);
+      break;
+
+   case STAGE_HSL_TO_RGB:
+      MimConvert(ProcParam.MilHslImage, ProcParam.MilRgbImage, M_HSL_TO_RGB);
+      break;
+
+   case STAGE_PIPELINE:
+      MimConvert(ProcParam.MilSourceImage, ProcParam.MilHslImage, M_RGB_TO_HSL);
+      MimArith(ProcParam.MilLumImage, ProcParam.LuminanceOffset, ProcParam.MilLumImage,
+               M_ADD_CONST + M_SATURATION);
+      MimConvert(ProcParam.MilHslImage, ProcParam.MilRgbImage, M_HSL_TO_RGB);
+      break;
+   }
+}
+
+/*****************************************************************************
+ * 처리 해제
+ *****************************************************************************/
+void ProcessingFree(PROC_PARAM& ProcParam)
+{
+   MbufFree(ProcParam.MilLumImage);
+   MbufFree(ProcParam.MilBandImage);
+   MbufFree(ProcParam.MilRgbImage);
+   MbufFree(ProcParam.MilHslImage);
+   MbufFree(ProcParam.MilSourceImage);
+}